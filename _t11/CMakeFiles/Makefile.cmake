@@ -0,0 +1,114 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/cmake/internal_utils.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPythonInterp.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/gtest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_main.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_allocations.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-allocations_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-death-test_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_environment_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_fail_on_leak_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-filepath_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-latency_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-linked_ptr_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-listener_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_main_unittest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-message_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-message_allocation_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_no_test_unittest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-options_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-param-test_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-port_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_pred_impl_unittest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-printers_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_prod_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_repeat_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_sole_header_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-string_allocation_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_stress_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_overhead_benchmark_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_memory_benchmark_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_overhead_benchmark.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-test-part_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_throw_on_failure_ex_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-typed-test_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_unittest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-unittest-api_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_no_exception.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_main_no_exception.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_main_no_rtti.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-death-test_ex_nocatch_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-death-test_ex_catch_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_no_rtti_unittest.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_dll.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_dll_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_main_use_own_tuple.dir/DependInfo.cmake"
+  "CMakeFiles/gtest-tuple_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_use_own_tuple_test.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_break_on_failure_unittest_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_catch_exceptions_no_ex_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_catch_exceptions_ex_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_color_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_env_var_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_filter_unittest_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_help_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_list_tests_unittest_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_output_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_shuffle_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_throw_on_failure_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_uninitialized_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_xml_outfile1_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_xml_outfile2_test_.dir/DependInfo.cmake"
+  "CMakeFiles/gtest_xml_output_unittest_.dir/DependInfo.cmake"
+  )
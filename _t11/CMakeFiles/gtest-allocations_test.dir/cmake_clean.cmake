@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-allocations_test.dir/test/gtest-allocations_test.cc.o"
+  "CMakeFiles/gtest-allocations_test.dir/test/gtest-allocations_test.cc.o.d"
+  "gtest-allocations_test"
+  "gtest-allocations_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-allocations_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
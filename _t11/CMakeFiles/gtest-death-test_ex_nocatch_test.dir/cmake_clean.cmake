@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-death-test_ex_nocatch_test.dir/test/gtest-death-test_ex_test.cc.o"
+  "CMakeFiles/gtest-death-test_ex_nocatch_test.dir/test/gtest-death-test_ex_test.cc.o.d"
+  "gtest-death-test_ex_nocatch_test"
+  "gtest-death-test_ex_nocatch_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-death-test_ex_nocatch_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
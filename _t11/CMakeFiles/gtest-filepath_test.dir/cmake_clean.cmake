@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-filepath_test.dir/test/gtest-filepath_test.cc.o"
+  "CMakeFiles/gtest-filepath_test.dir/test/gtest-filepath_test.cc.o.d"
+  "gtest-filepath_test"
+  "gtest-filepath_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-filepath_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
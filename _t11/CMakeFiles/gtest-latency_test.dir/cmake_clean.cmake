@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-latency_test.dir/test/gtest-latency_test.cc.o"
+  "CMakeFiles/gtest-latency_test.dir/test/gtest-latency_test.cc.o.d"
+  "gtest-latency_test"
+  "gtest-latency_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-latency_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-linked_ptr_test.dir/test/gtest-linked_ptr_test.cc.o"
+  "CMakeFiles/gtest-linked_ptr_test.dir/test/gtest-linked_ptr_test.cc.o.d"
+  "gtest-linked_ptr_test"
+  "gtest-linked_ptr_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-linked_ptr_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
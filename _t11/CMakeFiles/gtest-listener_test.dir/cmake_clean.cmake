@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-listener_test.dir/test/gtest-listener_test.cc.o"
+  "CMakeFiles/gtest-listener_test.dir/test/gtest-listener_test.cc.o.d"
+  "gtest-listener_test"
+  "gtest-listener_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-listener_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-message_allocation_test.dir/test/gtest-message_allocation_test.cc.o"
+  "CMakeFiles/gtest-message_allocation_test.dir/test/gtest-message_allocation_test.cc.o.d"
+  "gtest-message_allocation_test"
+  "gtest-message_allocation_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-message_allocation_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
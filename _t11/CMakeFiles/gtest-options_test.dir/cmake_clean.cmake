@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-options_test.dir/test/gtest-options_test.cc.o"
+  "CMakeFiles/gtest-options_test.dir/test/gtest-options_test.cc.o.d"
+  "gtest-options_test"
+  "gtest-options_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-options_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-param-test_test.dir/test/gtest-param-test2_test.cc.o"
+  "CMakeFiles/gtest-param-test_test.dir/test/gtest-param-test2_test.cc.o.d"
+  "CMakeFiles/gtest-param-test_test.dir/test/gtest-param-test_test.cc.o"
+  "CMakeFiles/gtest-param-test_test.dir/test/gtest-param-test_test.cc.o.d"
+  "gtest-param-test_test"
+  "gtest-param-test_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-param-test_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-port_test.dir/test/gtest-port_test.cc.o"
+  "CMakeFiles/gtest-port_test.dir/test/gtest-port_test.cc.o.d"
+  "gtest-port_test"
+  "gtest-port_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-port_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-printers_test.dir/test/gtest-printers_test.cc.o"
+  "CMakeFiles/gtest-printers_test.dir/test/gtest-printers_test.cc.o.d"
+  "gtest-printers_test"
+  "gtest-printers_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-printers_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-string_allocation_test.dir/test/gtest-string_allocation_test.cc.o"
+  "CMakeFiles/gtest-string_allocation_test.dir/test/gtest-string_allocation_test.cc.o.d"
+  "gtest-string_allocation_test"
+  "gtest-string_allocation_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-string_allocation_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-test-part_test.dir/test/gtest-test-part_test.cc.o"
+  "CMakeFiles/gtest-test-part_test.dir/test/gtest-test-part_test.cc.o.d"
+  "gtest-test-part_test"
+  "gtest-test-part_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-test-part_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
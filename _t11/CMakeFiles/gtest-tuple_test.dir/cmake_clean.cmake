@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-tuple_test.dir/test/gtest-tuple_test.cc.o"
+  "CMakeFiles/gtest-tuple_test.dir/test/gtest-tuple_test.cc.o.d"
+  "gtest-tuple_test"
+  "gtest-tuple_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-tuple_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-typed-test_test.dir/test/gtest-typed-test2_test.cc.o"
+  "CMakeFiles/gtest-typed-test_test.dir/test/gtest-typed-test2_test.cc.o.d"
+  "CMakeFiles/gtest-typed-test_test.dir/test/gtest-typed-test_test.cc.o"
+  "CMakeFiles/gtest-typed-test_test.dir/test/gtest-typed-test_test.cc.o.d"
+  "gtest-typed-test_test"
+  "gtest-typed-test_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-typed-test_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
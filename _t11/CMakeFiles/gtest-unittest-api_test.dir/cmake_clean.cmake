@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest-unittest-api_test.dir/test/gtest-unittest-api_test.cc.o"
+  "CMakeFiles/gtest-unittest-api_test.dir/test/gtest-unittest-api_test.cc.o.d"
+  "gtest-unittest-api_test"
+  "gtest-unittest-api_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest-unittest-api_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
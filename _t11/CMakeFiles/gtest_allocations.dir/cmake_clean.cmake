@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_allocations.dir/src/gtest-allocations.cc.o"
+  "CMakeFiles/gtest_allocations.dir/src/gtest-allocations.cc.o.d"
+  "libgtest_allocations.a"
+  "libgtest_allocations.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_allocations.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
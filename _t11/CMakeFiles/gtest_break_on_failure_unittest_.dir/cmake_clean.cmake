@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_break_on_failure_unittest_.dir/test/gtest_break_on_failure_unittest_.cc.o"
+  "CMakeFiles/gtest_break_on_failure_unittest_.dir/test/gtest_break_on_failure_unittest_.cc.o.d"
+  "gtest_break_on_failure_unittest_"
+  "gtest_break_on_failure_unittest_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_break_on_failure_unittest_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_color_test_.dir/test/gtest_color_test_.cc.o"
+  "CMakeFiles/gtest_color_test_.dir/test/gtest_color_test_.cc.o.d"
+  "gtest_color_test_"
+  "gtest_color_test_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_color_test_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
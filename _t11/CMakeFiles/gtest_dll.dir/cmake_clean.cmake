@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_dll.dir/src/gtest-all.cc.o"
+  "CMakeFiles/gtest_dll.dir/src/gtest-all.cc.o.d"
+  "CMakeFiles/gtest_dll.dir/src/gtest_main.cc.o"
+  "CMakeFiles/gtest_dll.dir/src/gtest_main.cc.o.d"
+  "libgtest_dll.pdb"
+  "libgtest_dll.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_dll.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
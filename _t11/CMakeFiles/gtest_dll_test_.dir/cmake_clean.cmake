@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_dll_test_.dir/test/gtest_all_test.cc.o"
+  "CMakeFiles/gtest_dll_test_.dir/test/gtest_all_test.cc.o.d"
+  "gtest_dll_test_"
+  "gtest_dll_test_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_dll_test_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
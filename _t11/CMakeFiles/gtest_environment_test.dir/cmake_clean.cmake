@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_environment_test.dir/test/gtest_environment_test.cc.o"
+  "CMakeFiles/gtest_environment_test.dir/test/gtest_environment_test.cc.o.d"
+  "gtest_environment_test"
+  "gtest_environment_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_environment_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
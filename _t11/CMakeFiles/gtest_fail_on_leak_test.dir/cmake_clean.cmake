@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_fail_on_leak_test.dir/test/gtest_fail_on_leak_test.cc.o"
+  "CMakeFiles/gtest_fail_on_leak_test.dir/test/gtest_fail_on_leak_test.cc.o.d"
+  "gtest_fail_on_leak_test"
+  "gtest_fail_on_leak_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_fail_on_leak_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
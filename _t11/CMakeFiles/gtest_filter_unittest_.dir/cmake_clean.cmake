@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_filter_unittest_.dir/test/gtest_filter_unittest_.cc.o"
+  "CMakeFiles/gtest_filter_unittest_.dir/test/gtest_filter_unittest_.cc.o.d"
+  "gtest_filter_unittest_"
+  "gtest_filter_unittest_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_filter_unittest_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_help_test_.dir/test/gtest_help_test_.cc.o"
+  "CMakeFiles/gtest_help_test_.dir/test/gtest_help_test_.cc.o.d"
+  "gtest_help_test_"
+  "gtest_help_test_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_help_test_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_list_tests_unittest_.dir/test/gtest_list_tests_unittest_.cc.o"
+  "CMakeFiles/gtest_list_tests_unittest_.dir/test/gtest_list_tests_unittest_.cc.o.d"
+  "gtest_list_tests_unittest_"
+  "gtest_list_tests_unittest_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_list_tests_unittest_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_main_no_rtti.dir/src/gtest-all.cc.o"
+  "CMakeFiles/gtest_main_no_rtti.dir/src/gtest-all.cc.o.d"
+  "CMakeFiles/gtest_main_no_rtti.dir/src/gtest_main.cc.o"
+  "CMakeFiles/gtest_main_no_rtti.dir/src/gtest_main.cc.o.d"
+  "libgtest_main_no_rtti.a"
+  "libgtest_main_no_rtti.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_main_no_rtti.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,3 @@
+file(REMOVE_RECURSE
+  "libgtest_main_no_rtti.a"
+)
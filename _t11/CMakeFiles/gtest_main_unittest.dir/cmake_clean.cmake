@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_main_unittest.dir/test/gtest_main_unittest.cc.o"
+  "CMakeFiles/gtest_main_unittest.dir/test/gtest_main_unittest.cc.o.d"
+  "gtest_main_unittest"
+  "gtest_main_unittest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_main_unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_memory_benchmark_.dir/test/gtest_memory_benchmark_.cc.o"
+  "CMakeFiles/gtest_memory_benchmark_.dir/test/gtest_memory_benchmark_.cc.o.d"
+  "gtest_memory_benchmark_"
+  "gtest_memory_benchmark_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_memory_benchmark_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_no_exception.dir/src/gtest-all.cc.o"
+  "CMakeFiles/gtest_no_exception.dir/src/gtest-all.cc.o.d"
+  "libgtest_no_exception.a"
+  "libgtest_no_exception.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_no_exception.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_no_rtti_unittest.dir/test/gtest_unittest.cc.o"
+  "CMakeFiles/gtest_no_rtti_unittest.dir/test/gtest_unittest.cc.o.d"
+  "gtest_no_rtti_unittest"
+  "gtest_no_rtti_unittest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_no_rtti_unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_no_test_unittest.dir/test/gtest_no_test_unittest.cc.o"
+  "CMakeFiles/gtest_no_test_unittest.dir/test/gtest_no_test_unittest.cc.o.d"
+  "gtest_no_test_unittest"
+  "gtest_no_test_unittest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_no_test_unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_overhead_benchmark"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/gtest_overhead_benchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
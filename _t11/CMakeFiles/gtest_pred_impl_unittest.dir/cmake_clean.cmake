@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_pred_impl_unittest.dir/test/gtest_pred_impl_unittest.cc.o"
+  "CMakeFiles/gtest_pred_impl_unittest.dir/test/gtest_pred_impl_unittest.cc.o.d"
+  "gtest_pred_impl_unittest"
+  "gtest_pred_impl_unittest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_pred_impl_unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_prod_test.dir/test/gtest_prod_test.cc.o"
+  "CMakeFiles/gtest_prod_test.dir/test/gtest_prod_test.cc.o.d"
+  "CMakeFiles/gtest_prod_test.dir/test/production.cc.o"
+  "CMakeFiles/gtest_prod_test.dir/test/production.cc.o.d"
+  "gtest_prod_test"
+  "gtest_prod_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_prod_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_sole_header_test.dir/test/gtest_sole_header_test.cc.o"
+  "CMakeFiles/gtest_sole_header_test.dir/test/gtest_sole_header_test.cc.o.d"
+  "gtest_sole_header_test"
+  "gtest_sole_header_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_sole_header_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
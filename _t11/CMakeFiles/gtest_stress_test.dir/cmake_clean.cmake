@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_stress_test.dir/test/gtest_stress_test.cc.o"
+  "CMakeFiles/gtest_stress_test.dir/test/gtest_stress_test.cc.o.d"
+  "gtest_stress_test"
+  "gtest_stress_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_stress_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_throw_on_failure_ex_test.dir/test/gtest_throw_on_failure_ex_test.cc.o"
+  "CMakeFiles/gtest_throw_on_failure_ex_test.dir/test/gtest_throw_on_failure_ex_test.cc.o.d"
+  "gtest_throw_on_failure_ex_test"
+  "gtest_throw_on_failure_ex_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_throw_on_failure_ex_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_throw_on_failure_test_.dir/test/gtest_throw_on_failure_test_.cc.o"
+  "CMakeFiles/gtest_throw_on_failure_test_.dir/test/gtest_throw_on_failure_test_.cc.o.d"
+  "gtest_throw_on_failure_test_"
+  "gtest_throw_on_failure_test_.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_throw_on_failure_test_.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_unittest.dir/test/gtest_unittest.cc.o"
+  "CMakeFiles/gtest_unittest.dir/test/gtest_unittest.cc.o.d"
+  "gtest_unittest"
+  "gtest_unittest.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_unittest.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/test/gtest-param-test2_test.cc" "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test2_test.cc.o" "gcc" "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test2_test.cc.o.d"
+  "/root/repo/test/gtest-param-test_test.cc" "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test_test.cc.o" "gcc" "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test_test.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_t11/CMakeFiles/gtest_main_use_own_tuple.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
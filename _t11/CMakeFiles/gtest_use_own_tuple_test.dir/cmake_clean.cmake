@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test2_test.cc.o"
+  "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test2_test.cc.o.d"
+  "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test_test.cc.o"
+  "CMakeFiles/gtest_use_own_tuple_test.dir/test/gtest-param-test_test.cc.o.d"
+  "gtest_use_own_tuple_test"
+  "gtest_use_own_tuple_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/gtest_use_own_tuple_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,100 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_t11
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(gtest-allocations_test "gtest-allocations_test")
+set_tests_properties(gtest-allocations_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;119;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-death-test_test "gtest-death-test_test")
+set_tests_properties(gtest-death-test_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;120;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_environment_test "gtest_environment_test")
+set_tests_properties(gtest_environment_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;121;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_fail_on_leak_test "gtest_fail_on_leak_test")
+set_tests_properties(gtest_fail_on_leak_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;122;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-filepath_test "gtest-filepath_test")
+set_tests_properties(gtest-filepath_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;123;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-latency_test "gtest-latency_test")
+set_tests_properties(gtest-latency_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;124;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-linked_ptr_test "gtest-linked_ptr_test")
+set_tests_properties(gtest-linked_ptr_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;125;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-listener_test "gtest-listener_test")
+set_tests_properties(gtest-listener_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;126;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_main_unittest "gtest_main_unittest")
+set_tests_properties(gtest_main_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;127;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-message_test "gtest-message_test")
+set_tests_properties(gtest-message_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;128;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-message_allocation_test "gtest-message_allocation_test")
+set_tests_properties(gtest-message_allocation_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;129;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_no_test_unittest "gtest_no_test_unittest")
+set_tests_properties(gtest_no_test_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;130;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-options_test "gtest-options_test")
+set_tests_properties(gtest-options_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;131;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-param-test_test "gtest-param-test_test")
+set_tests_properties(gtest-param-test_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;132;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-port_test "gtest-port_test")
+set_tests_properties(gtest-port_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;134;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_pred_impl_unittest "gtest_pred_impl_unittest")
+set_tests_properties(gtest_pred_impl_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;135;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-printers_test "gtest-printers_test")
+set_tests_properties(gtest-printers_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;136;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_prod_test "gtest_prod_test")
+set_tests_properties(gtest_prod_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;137;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_repeat_test "gtest_repeat_test")
+set_tests_properties(gtest_repeat_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;139;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_sole_header_test "gtest_sole_header_test")
+set_tests_properties(gtest_sole_header_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;140;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-string_allocation_test "gtest-string_allocation_test")
+set_tests_properties(gtest-string_allocation_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;141;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_stress_test "gtest_stress_test")
+set_tests_properties(gtest_stress_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;142;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_overhead_benchmark_smoke_test "gtest_overhead_benchmark_" "10")
+set_tests_properties(gtest_overhead_benchmark_smoke_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;148;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_memory_benchmark_smoke_test "gtest_memory_benchmark_" "10")
+set_tests_properties(gtest_memory_benchmark_smoke_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;150;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-test-part_test "gtest-test-part_test")
+set_tests_properties(gtest-test-part_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;159;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_throw_on_failure_ex_test "gtest_throw_on_failure_ex_test")
+set_tests_properties(gtest_throw_on_failure_ex_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;160;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-typed-test_test "gtest-typed-test_test")
+set_tests_properties(gtest-typed-test_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;161;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_unittest "gtest_unittest")
+set_tests_properties(gtest_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;163;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-unittest-api_test "gtest-unittest-api_test")
+set_tests_properties(gtest-unittest-api_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/cmake/internal_utils.cmake;206;cxx_test_with_flags;/root/repo/CMakeLists.txt;164;cxx_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-death-test_ex_nocatch_test "gtest-death-test_ex_nocatch_test")
+set_tests_properties(gtest-death-test_ex_nocatch_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/CMakeLists.txt;179;cxx_test_with_flags;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-death-test_ex_catch_test "gtest-death-test_ex_catch_test")
+set_tests_properties(gtest-death-test_ex_catch_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/CMakeLists.txt;182;cxx_test_with_flags;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_no_rtti_unittest "gtest_no_rtti_unittest")
+set_tests_properties(gtest_no_rtti_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/CMakeLists.txt;186;cxx_test_with_flags;/root/repo/CMakeLists.txt;0;")
+add_test(gtest-tuple_test "gtest-tuple_test")
+set_tests_properties(gtest-tuple_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/CMakeLists.txt;207;cxx_test_with_flags;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_use_own_tuple_test "gtest_use_own_tuple_test")
+set_tests_properties(gtest_use_own_tuple_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;197;add_test;/root/repo/CMakeLists.txt;210;cxx_test_with_flags;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_break_on_failure_unittest "/root/.pyenv/shims/python" "/root/repo/test/gtest_break_on_failure_unittest.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_break_on_failure_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;219;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_catch_exceptions_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_catch_exceptions_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_catch_exceptions_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;235;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_color_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_color_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_color_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;238;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_env_var_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_env_var_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_env_var_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;241;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_filter_unittest "/root/.pyenv/shims/python" "/root/repo/test/gtest_filter_unittest.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_filter_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;244;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_help_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_help_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_help_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;247;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_list_tests_unittest "/root/.pyenv/shims/python" "/root/repo/test/gtest_list_tests_unittest.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_list_tests_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;250;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_output_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_output_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_output_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;253;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_shuffle_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_shuffle_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_shuffle_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;256;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_throw_on_failure_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_throw_on_failure_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_throw_on_failure_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;264;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_uninitialized_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_uninitialized_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_uninitialized_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;268;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_xml_outfiles_test "/root/.pyenv/shims/python" "/root/repo/test/gtest_xml_outfiles_test.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_xml_outfiles_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;272;py_test;/root/repo/CMakeLists.txt;0;")
+add_test(gtest_xml_output_unittest "/root/.pyenv/shims/python" "/root/repo/test/gtest_xml_output_unittest.py" "--build_dir=/root/repo/_t11/${CTEST_CONFIGURATION_TYPE}")
+set_tests_properties(gtest_xml_output_unittest PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/cmake/internal_utils.cmake;222;add_test;/root/repo/CMakeLists.txt;275;py_test;/root/repo/CMakeLists.txt;0;")
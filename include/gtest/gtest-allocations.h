@@ -0,0 +1,153 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This header file defines the EXPECT_NO_HEAP_ALLOCATIONS() and
+// EXPECT_ALLOCATIONS_LE() families of assertions, which check how many
+// times a statement calls the global operator new.
+//
+// They are opt-in: a test that uses them must also link with the
+// gtest_allocations library, which replaces the global operator new and
+// operator delete with versions that count the allocations made by each
+// thread.  Without it, the test doesn't link.
+
+#ifndef GTEST_INCLUDE_GTEST_GTEST_ALLOCATIONS_H_
+#define GTEST_INCLUDE_GTEST_GTEST_ALLOCATIONS_H_
+
+#include "gtest/gtest.h"
+
+namespace testing {
+namespace internal {
+
+// Returns the number of times the calling thread has called the global
+// operator new (in any of its forms) so far.  Where the compiler doesn't
+// provide thread-local storage, the count is shared by all threads.
+GTEST_API_ Int64 GetHeapAllocationCount();
+
+// Checks the number of heap allocations made by a statement.  The
+// allocations are counted between BeginCounting() and EndCounting().
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+class GTEST_API_ HeapAllocationCheck {
+ public:
+  explicit HeapAllocationCheck(Int64 max_count)
+      : max_count_(max_count), start_count_(0), end_count_(0) {}
+
+  // Always true, so that an object can be declared in an if condition.
+  operator bool() const { return true; }
+
+  // Starts counting allocations on the calling thread, and remembers
+  // where they come from.
+  void BeginCounting();
+
+  // Stops counting allocations.
+  void EndCounting();
+
+  // Returns true iff no more than max_count allocations were counted.
+  bool Passed() const { return end_count_ - start_count_ <= max_count_; }
+
+  // Returns the failure message for the given statement, which lists
+  // the call sites of the first allocations.
+  String FailureMessage(const char* statement) const;
+
+ private:
+  Int64 max_count_;
+  Int64 start_count_;
+  Int64 end_count_;
+};
+
+// Calls BeginCounting() on a HeapAllocationCheck on construction, and
+// EndCounting() on destruction, so that counting stops even if the
+// statement returns or throws.
+class GTEST_API_ HeapAllocationCheckScope {
+ public:
+  explicit HeapAllocationCheckScope(HeapAllocationCheck* check)
+      : check_(check) {
+    check_->BeginCounting();
+  }
+  ~HeapAllocationCheckScope() { check_->EndCounting(); }
+
+ private:
+  HeapAllocationCheck* const check_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(HeapAllocationCheckScope);
+};
+
+}  // namespace internal
+
+// Implements the EXPECT_ALLOCATIONS_LE() family of assertions.  The
+// local names end with the line number, so that the assertions can be
+// nested in each other's statement without shadowing.
+#define GTEST_TEST_ALLOCATIONS_LE_(max_count, statement, fail) \
+  GTEST_AMBIGUOUS_ELSE_BLOCKER_ \
+  if (::testing::internal::HeapAllocationCheck \
+      GTEST_CONCAT_TOKEN_(gtest_allocation_check_, __LINE__) = \
+      ::testing::internal::HeapAllocationCheck(max_count)) { \
+    { \
+      const ::testing::internal::HeapAllocationCheckScope \
+          GTEST_CONCAT_TOKEN_(gtest_allocation_check_scope_, __LINE__)( \
+              &GTEST_CONCAT_TOKEN_(gtest_allocation_check_, __LINE__)); \
+      GTEST_SUPPRESS_UNREACHABLE_CODE_WARNING_BELOW_(statement); \
+    } \
+    if (!GTEST_CONCAT_TOKEN_(gtest_allocation_check_, __LINE__).Passed()) { \
+      goto GTEST_CONCAT_TOKEN_(gtest_label_testallocations_, __LINE__); \
+    } \
+  } else \
+    GTEST_CONCAT_TOKEN_(gtest_label_testallocations_, __LINE__): \
+      fail(GTEST_CONCAT_TOKEN_(gtest_allocation_check_, __LINE__). \
+           FailureMessage(#statement).c_str())
+
+// Asserts that statement calls the global operator new at most n times
+// on the current thread, e.g.
+//
+//   cache.Lookup(1);  // Warms up the cache.
+//   EXPECT_NO_HEAP_ALLOCATIONS(cache.Lookup(1));
+//   EXPECT_ALLOCATIONS_LE(1, cache.Insert(2, "two"));
+//
+// On failure, the call sites of the first few allocations are printed
+// where the platform supports it.  Allocations made by other threads
+// aren't counted, except where the compiler doesn't provide thread-local
+// storage: there the count is shared, and call sites aren't recorded.
+// The test must be linked with gtest_allocations.
+#define EXPECT_ALLOCATIONS_LE(n, statement) \
+  GTEST_TEST_ALLOCATIONS_LE_(n, statement, GTEST_NONFATAL_FAILURE_)
+#define ASSERT_ALLOCATIONS_LE(n, statement) \
+  GTEST_TEST_ALLOCATIONS_LE_(n, statement, GTEST_FATAL_FAILURE_)
+
+// Asserts that statement doesn't call the global operator new on the
+// current thread.
+#define EXPECT_NO_HEAP_ALLOCATIONS(statement) \
+  EXPECT_ALLOCATIONS_LE(0, statement)
+#define ASSERT_NO_HEAP_ALLOCATIONS(statement) \
+  ASSERT_ALLOCATIONS_LE(0, statement)
+
+}  // namespace testing
+
+#endif  // GTEST_INCLUDE_GTEST_GTEST_ALLOCATIONS_H_
@@ -0,0 +1,171 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This header file defines LatencyRecorder, which records the
+// distribution of operation latencies in a test, and the
+// EXPECT_PERCENTILE_LT() family of assertions on it.
+
+#ifndef GTEST_INCLUDE_GTEST_GTEST_LATENCY_H_
+#define GTEST_INCLUDE_GTEST_GTEST_LATENCY_H_
+
+#include <vector>
+#include "gtest/internal/gtest-internal.h"
+#include "gtest/internal/gtest-string.h"
+
+namespace testing {
+
+// Records latencies in a histogram whose buckets grow exponentially,
+// each divided into linear sub-buckets (like an HDR histogram).  Any
+// latency is kept with a relative error of at most 1/32, in memory that
+// grows only with the logarithm of the largest latency recorded.
+//
+//   LatencyRecorder recorder;
+//   for (int i = 0; i < 10000; i++) {
+//     LatencyTimer timer(&recorder);
+//     cache.Lookup(i);
+//   }
+//   EXPECT_PERCENTILE_LT(recorder, 99.9, 250);  // In microseconds.
+//   recorder.RecordAsProperties("lookup_latency");
+//
+// A LatencyRecorder isn't thread-safe.  To record latencies on several
+// threads, use one recorder per thread and Merge() them.
+class GTEST_API_ LatencyRecorder {
+ public:
+  LatencyRecorder();
+
+  // Returns the current time of the clock used by LatencyTimer, in
+  // nanoseconds since an arbitrary point.  It's a monotonic clock where
+  // the platform has one.
+  static internal::Int64 NowNanos();
+
+  // Records one latency, in nanoseconds.  A negative latency is
+  // recorded as 0.
+  void RecordNanos(internal::Int64 nanos);
+
+  // Adds all the latencies recorded by other to this recorder.
+  void Merge(const LatencyRecorder& other);
+
+  // Returns the number of latencies recorded.
+  internal::Int64 count() const { return count_; }
+
+  // Returns the smallest and the largest latency recorded, in
+  // nanoseconds, or 0 if none has been recorded.
+  internal::Int64 min_nanos() const { return count_ == 0 ? 0 : min_nanos_; }
+  internal::Int64 max_nanos() const { return max_nanos_; }
+
+  // Returns the mean latency in nanoseconds, or 0 if none has been
+  // recorded.
+  double mean_nanos() const;
+
+  // Returns the latency at the given percentile (0 to 100), in
+  // nanoseconds: no more than (100 - percentile)% of the recorded
+  // latencies exceed it, up to the histogram's precision.  Returns 0 if
+  // no latency has been recorded.
+  internal::Int64 PercentileNanos(double percentile) const;
+
+  // Returns a one-line summary, e.g.
+  // "count=1000 min=1.2us p50=3.1us p90=4.0us p99=9.8us p99.9=12.6us
+  // max=13.0us".
+  internal::String Summary() const;
+
+  // Returns the non-empty buckets of the histogram as space-separated
+  // "<lowest latency in ns>:<count>" pairs, in increasing latency order.
+  internal::String SerializeHistogram() const;
+
+  // Records the summary and the serialized histogram as the
+  // <name>_latency_summary and <name>_latency_histogram properties of
+  // the current test, so that they appear in the XML report and are
+  // streamed to a result server.
+  void RecordAsProperties(const char* name) const;
+
+ private:
+  // Returns the index of the bucket holding the given latency.
+  static int BucketIndex(internal::UInt64 nanos);
+
+  // Returns the lowest and the highest latency held by the given bucket.
+  static internal::UInt64 BucketLowestNanos(int index);
+  static internal::UInt64 BucketHighestNanos(int index);
+
+  // counts_[i] is the number of latencies in bucket i.  It only grows
+  // up to the bucket of the largest latency recorded.
+  std::vector<internal::Int64> counts_;
+  internal::Int64 count_;
+  internal::Int64 min_nanos_;
+  internal::Int64 max_nanos_;
+  double total_nanos_;
+};
+
+// Measures the time from its construction to its destruction and
+// records it in a LatencyRecorder.
+class GTEST_API_ LatencyTimer {
+ public:
+  explicit LatencyTimer(LatencyRecorder* recorder)
+      : recorder_(recorder), start_nanos_(LatencyRecorder::NowNanos()) {}
+
+  ~LatencyTimer() {
+    recorder_->RecordNanos(LatencyRecorder::NowNanos() - start_nanos_);
+  }
+
+ private:
+  LatencyRecorder* const recorder_;
+  const internal::Int64 start_nanos_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(LatencyTimer);
+};
+
+namespace internal {
+
+// Helper function for implementing {EXPECT|ASSERT}_PERCENTILE_LT.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult CmpHelperPercentileLT(
+    const char* recorder_expr, const char* percentile_expr,
+    const char* micros_expr, const LatencyRecorder& recorder,
+    double percentile, double micros);
+
+}  // namespace internal
+
+// Asserts that the given percentile (0 to 100) of the latencies in a
+// LatencyRecorder is less than the given number of microseconds, e.g.
+//
+//   EXPECT_PERCENTILE_LT(recorder, 99.9, 250);
+//
+// The assertion fails if no latency has been recorded.
+#define EXPECT_PERCENTILE_LT(recorder, percentile, micros) \
+  EXPECT_PRED_FORMAT3(::testing::internal::CmpHelperPercentileLT, \
+                      recorder, percentile, micros)
+#define ASSERT_PERCENTILE_LT(recorder, percentile, micros) \
+  ASSERT_PRED_FORMAT3(::testing::internal::CmpHelperPercentileLT, \
+                      recorder, percentile, micros)
+
+}  // namespace testing
+
+#endif  // GTEST_INCLUDE_GTEST_GTEST_LATENCY_H_
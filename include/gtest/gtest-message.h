@@ -58,7 +58,8 @@ namespace testing {
 // Typical usage:
 //
 //   1. You stream a bunch of values to a Message object.
-//      It will remember the text in a stringstream.
+//      It will remember the text in a small buffer, or in a
+//      stringstream once the text needs formatting or grows.
 //   2. Then you stream the Message object to an ostream.
 //      This causes the text in the Message to be streamed
 //      to the ostream.
@@ -87,26 +88,34 @@ class GTEST_API_ Message {
 
  public:
   // Constructs an empty Message.
-  // We allocate the stringstream separately because otherwise each use of
-  // ASSERT/EXPECT in a procedure adds over 200 bytes to the procedure's
-  // stack frame leading to huge stack frames in some cases; gcc does not reuse
-  // the stack space.
-  Message() : ss_(new ::std::stringstream) {
-    // By default, we want there to be enough precision when printing
-    // a double to a Message.
-    *ss_ << std::setprecision(std::numeric_limits<double>::digits10 + 2);
-  }
+  //
+  // Text made of strings is kept in a small buffer inside the object.
+  // The stringstream is only created when a value that needs formatting
+  // is streamed, or when the text outgrows the buffer.  We allocate the
+  // stringstream separately because otherwise each use of ASSERT/EXPECT
+  // in a procedure adds over 200 bytes to the procedure's stack frame
+  // leading to huge stack frames in some cases; gcc does not reuse the
+  // stack space.  For the same reason the buffer shares its bytes with
+  // the pointer to the stringstream.
+  Message() { set_buffer_length(0); }
 
-  // Copy constructor.
-  Message(const Message& msg) : ss_(new ::std::stringstream) {  // NOLINT
-    *ss_ << msg.GetString();
-  }
+  // Copy constructor.  Doesn't allocate if the text fits in the buffer.
+  Message(const Message& msg);  // NOLINT
+
+#if GTEST_LANG_CXX11
+  // Move constructor.  Takes over msg's stringstream, if any.
+  Message(Message&& msg);  // NOLINT
+#endif  // GTEST_LANG_CXX11
 
   // Constructs a Message from a C-string.
-  explicit Message(const char* str) : ss_(new ::std::stringstream) {
-    *ss_ << str;
+  explicit Message(const char* str) {
+    set_buffer_length(0);
+    AppendCString(str);
   }
 
+  // Deletes the stringstream, if there's one.
+  ~Message();
+
 #if GTEST_OS_SYMBIAN
   // Streams a value (either a pointer or not) to this object.
   template <typename T>
@@ -118,7 +127,7 @@ class GTEST_API_ Message {
   // Streams a non-pointer value to this object.
   template <typename T>
   inline Message& operator <<(const T& val) {
-    ::GTestStreamToHelper(ss_.get(), val);
+    ::GTestStreamToHelper(GetStream(), val);
     return *this;
   }
 
@@ -138,14 +147,37 @@ class GTEST_API_ Message {
   template <typename T>
   inline Message& operator <<(T* const& pointer) {  // NOLINT
     if (pointer == NULL) {
-      *ss_ << "(null)";
+      AppendCString(NULL);
     } else {
-      ::GTestStreamToHelper(ss_.get(), pointer);
+      ::GTestStreamToHelper(GetStream(), pointer);
     }
     return *this;
   }
 #endif  // GTEST_OS_SYMBIAN
 
+  // Strings don't need formatting, so these overloads copy them to the
+  // buffer while it has room.  A NULL C string is streamed as "(null)".
+  Message& operator <<(const char* str) {
+    AppendCString(str);
+    return *this;
+  }
+  Message& operator <<(char* str) {
+    AppendCString(str);
+    return *this;
+  }
+  Message& operator <<(const ::std::string& str) {
+    Append(str.data(), str.length());
+    return *this;
+  }
+  Message& operator <<(const internal::String& str) {
+    if (str.c_str() == NULL) {
+      AppendCString(NULL);
+    } else {
+      Append(str.c_str(), str.length());
+    }
+    return *this;
+  }
+
   // Since the basic IO manipulators are overloaded for both narrow
   // and wide streams, we have to provide this specialized definition
   // of operator <<, even though its body is the same as the
@@ -153,7 +185,7 @@ class GTEST_API_ Message {
   // endl or other basic IO manipulators to Message will confuse the
   // compiler.
   Message& operator <<(BasicNarrowIoManip val) {
-    *ss_ << val;
+    *GetStream() << val;
     return *this;
   }
 
@@ -187,11 +219,18 @@ class GTEST_API_ Message {
   // Each '\0' character in the buffer is replaced with "\\0".
   //
   // INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
-  internal::String GetString() const {
-    return internal::StringStreamToString(ss_.get());
-  }
+  internal::String GetString() const;
 
  private:
+  // The size of the storage that holds either the short text or the
+  // pointer to the stringstream.  It's the whole Message, so that a
+  // Message is no larger than when it always had a stringstream.
+  enum { kStorageSize = 16 };
+
+  // The longest text kept in the buffer.  The last byte of the storage
+  // holds the length of that text, or kHasStream.
+  enum { kBufferCapacity = kStorageSize - 1 };
+  enum { kHasStream = kStorageSize };
 
 #if GTEST_OS_SYMBIAN
   // These are needed as the Nokia Symbian Compiler cannot decide between
@@ -201,19 +240,60 @@ class GTEST_API_ Message {
   template <typename T>
   inline void StreamHelper(internal::true_type /*dummy*/, T* pointer) {
     if (pointer == NULL) {
-      *ss_ << "(null)";
+      AppendCString(NULL);
     } else {
-      ::GTestStreamToHelper(ss_.get(), pointer);
+      ::GTestStreamToHelper(GetStream(), pointer);
     }
   }
   template <typename T>
   inline void StreamHelper(internal::false_type /*dummy*/, const T& value) {
-    ::GTestStreamToHelper(ss_.get(), value);
+    ::GTestStreamToHelper(GetStream(), value);
   }
 #endif  // GTEST_OS_SYMBIAN
 
-  // We'll hold the text streamed to this object here.
-  const internal::scoped_ptr< ::std::stringstream> ss_;
+  // Appends the given characters to the text, in the buffer if they fit
+  // and there is no stringstream yet.
+  void Append(const char* str, size_t length) {
+    if (!has_stream() && length <= kBufferCapacity - buffer_length()) {
+      memcpy(buffer_ + buffer_length(), str, length);
+      set_buffer_length(buffer_length() + length);
+    } else {
+      GetStream()->write(str, static_cast< ::std::streamsize>(length));
+    }
+  }
+
+  // Appends a C string, or "(null)" if str is NULL.
+  void AppendCString(const char* str) {
+    if (str == NULL)
+      str = "(null)";
+    Append(str, strlen(str));
+  }
+
+  // Returns the stringstream, creating it on first use.  The text in the
+  // buffer is moved to the new stringstream.
+  ::std::stringstream* GetStream();
+
+  // Returns true iff the text has moved to the stringstream.
+  bool has_stream() const { return buffer_[kBufferCapacity] == kHasStream; }
+
+  // Gets and sets the length of the text in the buffer, which is only
+  // meaningful while there's no stringstream.
+  size_t buffer_length() const {
+    return static_cast<size_t>(buffer_[kBufferCapacity]);
+  }
+  void set_buffer_length(size_t length) {
+    buffer_[kBufferCapacity] = static_cast<char>(length);
+  }
+
+  union {
+    // Holds the text streamed to this object until a stringstream is
+    // created.  Only the first buffer_length() characters are used.
+    char buffer_[kStorageSize];
+
+    // Holds the text streamed to this object once has_stream() is true.
+    // The object owns it.
+    ::std::stringstream* ss_;
+  };
 
   // We declare (but don't implement) this to prevent the compiler
   // from implementing the assignment operator.
@@ -342,8 +342,17 @@ internal::ParamGenerator<typename Container::value_type> ValuesIn(
 //
 // INSTANTIATE_TEST_CASE_P(FloatingNumbers, BazTest, Values(1, 2, 3.5));
 //
-// Currently, Values() supports from 1 to 50 parameters.
+// With a C++11 compiler Values() accepts any number of parameters;
+// otherwise it supports from 1 to 50 parameters.
 //
+# if GTEST_LANG_CXX11
+
+template <typename... Ts>
+internal::ValueArray<Ts...> Values(Ts... v) {
+  return internal::ValueArray<Ts...>(v...);
+}
+
+# else  // !GTEST_LANG_CXX11
 template <typename T1>
 internal::ValueArray1<T1> Values(T1 v1) {
   return internal::ValueArray1<T1>(v1);
@@ -1196,6 +1205,7 @@ internal::ValueArray50<T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13,
       v34, v35, v36, v37, v38, v39, v40, v41, v42, v43, v44, v45, v46, v47,
       v48, v49, v50);
 }
+# endif  // GTEST_LANG_CXX11
 
 // Bool() allows generating tests with parameters in a set of (false, true).
 //
@@ -1233,9 +1243,10 @@ inline internal::ParamGenerator<bool> Bool() {
 //     tuple<T1, T2, ..., TN> where T1, T2, ..., TN are the types
 //     of elements from sequences produces by gen1, gen2, ..., genN.
 //
-// Combine can have up to 10 arguments. This number is currently limited
-// by the maximum number of elements in the tuple implementation used by Google
-// Test.
+// Without variadic templates Combine can have up to 10 arguments. This number
+// is limited by the maximum number of elements in the tuple implementation
+// used by Google Test.  With a C++11 compiler and a variadic tr1::tuple
+// (i.e. GTEST_USE_OWN_TR1_TUPLE is 0) there is no such limit.
 //
 // Example:
 //
@@ -1270,6 +1281,15 @@ inline internal::ParamGenerator<bool> Bool() {
 // INSTANTIATE_TEST_CASE_P(TwoBoolSequence, FlagDependentTest,
 //                         Combine(Bool(), Bool()));
 //
+#  if GTEST_HAS_VARIADIC_COMBINE_
+
+template <typename... Generators>
+internal::CartesianProductHolder<Generators...> Combine(
+    const Generators&... g) {
+  return internal::CartesianProductHolder<Generators...>(g...);
+}
+
+#  else  // !GTEST_HAS_VARIADIC_COMBINE_
 template <typename Generator1, typename Generator2>
 internal::CartesianProductHolder2<Generator1, Generator2> Combine(
     const Generator1& g1, const Generator2& g2) {
@@ -1373,6 +1393,7 @@ internal::CartesianProductHolder10<Generator1, Generator2, Generator3,
       Generator10>(
       g1, g2, g3, g4, g5, g6, g7, g8, g9, g10);
 }
+#  endif  // GTEST_HAS_VARIADIC_COMBINE_
 # endif  // GTEST_HAS_COMBINE
 
 
@@ -0,0 +1,162 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This header file defines RunStressTest(), which runs a piece of test
+// code on many threads at once to shake out races in the code under
+// test, and MeasureThreadScaling(), which measures how its throughput
+// scales with the number of threads.
+
+#ifndef GTEST_INCLUDE_GTEST_GTEST_STRESS_TEST_H_
+#define GTEST_INCLUDE_GTEST_GTEST_STRESS_TEST_H_
+
+#include <vector>
+#include "gtest/internal/gtest-port.h"
+
+namespace testing {
+
+#if GTEST_IS_THREADSAFE
+
+// The code run by RunStressTest().  To use it, subclass StressTestBody
+// and override Run():
+//
+//   class CounterStressTest : public StressTestBody {
+//    public:
+//     explicit CounterStressTest(Counter* counter) : counter_(counter) {}
+//     virtual void Run(int thread_index, int iteration) {
+//       EXPECT_LT(0, counter_->Increment());
+//     }
+//    private:
+//     Counter* const counter_;
+//   };
+//
+//   TEST(CounterTest, IsThreadSafe) {
+//     Counter counter;
+//     CounterStressTest body(&counter);
+//     RunStressTest(10, 1000, &body);
+//     EXPECT_EQ(10 * 1000, counter.value());
+//   }
+class GTEST_API_ StressTestBody {
+ public:
+  virtual ~StressTestBody() {}
+
+  // Runs the given iteration (0-based) on the given thread (0-based).
+  // It's called concurrently from all the threads, so it must be
+  // thread-safe.  Google Test assertions can be used in it; a fatal
+  // failure stops the thread that generated it.  So does an exception
+  // thrown by Run(), which is reported as a fatal failure unless
+  // --gtest_catch_exceptions=0.
+  virtual void Run(int thread_index, int iteration) = 0;
+};
+
+// What one thread did during RunStressTest().
+struct StressTestThreadResult {
+  // The number of iterations the thread completed.
+  int iteration_count;
+  // The number of failed assertions in the thread.
+  int failure_count;
+  // How long the thread ran, in nanoseconds of the monotonic clock.
+  internal::Int64 elapsed_time_nanos;
+};
+
+// Runs body->Run() for iteration_count iterations on each of
+// thread_count threads, and returns when all the threads are done.  The
+// threads are started first and then released at the same time, so
+// that they really run concurrently.
+//
+// A failure inside body->Run() is reported with a trace that names the
+// thread and iteration it happened in.  The failures are added to the
+// current test before RunStressTest() returns.
+//
+// Each thread's results are returned, indexed by thread, and are also
+// recorded as the stress_thread_<i> property of the current test, e.g.
+// "1000 iterations in 12.345678 ms, 0 failures".
+GTEST_API_ std::vector<StressTestThreadResult> RunStressTest(
+    int thread_count, int iteration_count, StressTestBody* body);
+
+// The throughput of a workload at one thread count.
+struct ThreadScalingPoint {
+  // The number of threads that ran the workload concurrently.
+  int thread_count;
+  // The number of iterations completed per second by all the threads.
+  double ops_per_second;
+  // ops_per_second divided by thread_count times the single-thread
+  // ops_per_second.  1.0 means perfect linear scaling.
+  double efficiency;
+};
+
+// The scaling curve measured by MeasureThreadScaling().
+class GTEST_API_ ThreadScalingResult {
+ public:
+  // Returns the number of thread counts measured.
+  int point_count() const { return static_cast<int>(points_.size()); }
+
+  // Returns the i-th point (0-based), in increasing thread count order.
+  const ThreadScalingPoint& GetPoint(int i) const;
+
+  // Returns the scaling efficiency measured at the given thread count,
+  // e.g.
+  //
+  //   EXPECT_GE(result.EfficiencyAt(8), 0.7);
+  //
+  // Aborts the program if the thread count wasn't measured.
+  double EfficiencyAt(int thread_count) const;
+
+  // Returns the throughput measured at the given thread count.  Aborts
+  // the program if the thread count wasn't measured.
+  double OpsPerSecondAt(int thread_count) const;
+
+ private:
+  friend GTEST_API_ ThreadScalingResult MeasureThreadScaling(
+      int max_thread_count, int iteration_count, StressTestBody* body);
+
+  // Returns the point for the given thread count, or aborts.
+  const ThreadScalingPoint& FindPoint(int thread_count) const;
+
+  std::vector<ThreadScalingPoint> points_;
+};
+
+// Runs the workload in body->Run() with 1, 2, 4, ... threads, up to and
+// including max_thread_count, each thread running iteration_count
+// iterations (see RunStressTest()).  Returns the throughput and scaling
+// efficiency at each thread count, and records them as the
+// thread_scaling_<n> properties of the current test, e.g.
+// "152000 ops/s, efficiency 0.93".
+//
+// The timer has millisecond resolution, so iteration_count should make
+// each run take at least tens of milliseconds.
+GTEST_API_ ThreadScalingResult MeasureThreadScaling(
+    int max_thread_count, int iteration_count, StressTestBody* body);
+
+#endif  // GTEST_IS_THREADSAFE
+
+}  // namespace testing
+
+#endif  // GTEST_INCLUDE_GTEST_GTEST_STRESS_TEST_H_
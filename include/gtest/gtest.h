@@ -57,9 +57,11 @@
 #include "gtest/internal/gtest-internal.h"
 #include "gtest/internal/gtest-string.h"
 #include "gtest/gtest-death-test.h"
+#include "gtest/gtest-latency.h"
 #include "gtest/gtest-message.h"
 #include "gtest/gtest-param-test.h"
 #include "gtest/gtest-printers.h"
+#include "gtest/gtest-stress-test.h"
 #include "gtest/gtest_prod.h"
 #include "gtest/gtest-test-part.h"
 #include "gtest/gtest-typed-test.h"
@@ -98,6 +100,12 @@ GTEST_DECLARE_bool_(catch_exceptions);
 // to let Google Test decide.
 GTEST_DECLARE_string_(color);
 
+// This flag makes a test fail when the heap grows by more than this many
+// bytes from the construction to the destruction of its fixture.  It only
+// has an effect when a heap profiler (e.g. the one in the gtest_allocations
+// library) is linked in.  A negative value disables the check.
+GTEST_DECLARE_int32_(fail_on_leak_bytes);
+
 // This flag sets up the filter to select by name using a glob pattern
 // the tests to run. If the filter is not given all tests are executed.
 GTEST_DECLARE_string_(filter);
@@ -106,6 +114,11 @@ GTEST_DECLARE_string_(filter);
 // are actually run if the flag is provided.
 GTEST_DECLARE_bool_(list_tests);
 
+// This flag limits how many test part results a test records.  Once a
+// test has that many, further failures identical (same source file,
+// line, and type) to a recorded one are only counted.  0 means no limit.
+GTEST_DECLARE_int32_(max_failures_per_test);
+
 // This flag controls whether Google Test emits a detailed XML report to a file
 // in addition to its normal textual output.
 GTEST_DECLARE_string_(output);
@@ -128,6 +141,11 @@ GTEST_DECLARE_bool_(show_internal_stack_frames);
 // When this flag is specified, tests' order is randomized on every iteration.
 GTEST_DECLARE_bool_(shuffle);
 
+// When this flag is specified, Google Test prints how much time (and how
+// many heap allocations, if a heap profiler is installed) each stage of
+// its startup took before running the tests.
+GTEST_DECLARE_bool_(startup_profile);
+
 // This flag specifies the maximum number of stack frames to be
 // printed in a failure message.
 GTEST_DECLARE_int32_(stack_trace_depth);
@@ -137,6 +155,11 @@ GTEST_DECLARE_int32_(stack_trace_depth);
 // non-zero code otherwise.
 GTEST_DECLARE_bool_(throw_on_failure);
 
+// When this flag is specified, {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE
+// rewrite the golden files with the actual data instead of comparing
+// against them.
+GTEST_DECLARE_bool_(update_golden_files);
+
 // When this flag is set with a "host:port" string, on supported
 // platforms test results are streamed to the specified port on
 // the specified host machine.
@@ -154,6 +177,7 @@ class NoExecDeathTest;
 class FinalSuccessChecker;
 class GTestFlagSaver;
 class TestResultAccessor;
+struct TestResultStorage;
 class TestEventListenersAccessor;
 class TestEventRepeater;
 class WindowsDeathTest;
@@ -324,12 +348,26 @@ class GTEST_API_ AssertionResult {
 GTEST_API_ AssertionResult AssertionSuccess();
 
 // Makes a failed assertion result.
-GTEST_API_ AssertionResult AssertionFailure();
+GTEST_API_ AssertionResult AssertionFailure() GTEST_ATTRIBUTE_COLD_;
 
 // Makes a failed assertion result with the given failure message.
 // Deprecated; use AssertionFailure() << msg.
 GTEST_API_ AssertionResult AssertionFailure(const Message& msg);
 
+namespace internal {
+
+// Makes a successful assertion result, like AssertionSuccess().  The
+// assertion helpers use it because it's inline: the compiler can see
+// that a successful result carries no message, and drop the code that
+// would free it from the assertions' success path.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+inline AssertionResult InlineAssertionSuccess() {
+  return AssertionResult(true);
+}
+
+}  // namespace internal
+
 // The abstract class that all tests inherit from.
 //
 // In Google Test, a unit test program contains one or many TestCases, and
@@ -507,6 +545,16 @@ class TestProperty {
 // TestResult is not copyable.
 class GTEST_API_ TestResult {
  public:
+  // The phases of running a test, which are timed separately.
+  enum Phase {
+    kConstructorPhase,  // Constructing the test fixture.
+    kSetUpPhase,        // Running SetUp().
+    kTestBodyPhase,     // Running the test body.
+    kTearDownPhase,     // Running TearDown().
+    kDestructorPhase,   // Destroying the test fixture.
+    kPhaseCount
+  };
+
   // Creates an empty TestResult.
   TestResult();
 
@@ -535,17 +583,55 @@ class GTEST_API_ TestResult {
   // Returns the elapsed time, in milliseconds.
   TimeInMillis elapsed_time() const { return elapsed_time_; }
 
+  // Returns the time spent in the given phase of the test, in
+  // nanoseconds.  A phase that didn't run (e.g. the test body after
+  // SetUp() failed fatally) took 0.
+  internal::Int64 phase_time_nanos(Phase phase) const {
+    return phase_time_nanos_[phase];
+  }
+
+  // Returns true iff the heap usage of the test was measured, which
+  // requires a heap profiler such as the one in gtest_allocations.
+  bool has_heap_usage() const { return has_heap_usage_; }
+
+  // Returns the most bytes the test had live on the heap at once, over
+  // what was live before its fixture was constructed.
+  internal::Int64 heap_peak_bytes() const { return heap_peak_bytes_; }
+
+  // Returns how many more bytes were live on the heap after the test's
+  // fixture was destroyed than before it was constructed.  A test that
+  // frees memory allocated earlier can have a negative growth.
+  internal::Int64 heap_growth_bytes() const { return heap_growth_bytes_; }
+
+  // Returns the number of heap allocations the test made.
+  internal::Int64 heap_allocation_count() const {
+    return heap_allocation_count_;
+  }
+
   // Returns the i-th test part result among all the results. i can range
   // from 0 to test_property_count() - 1. If i is not in that range, aborts
   // the program.
   const TestPartResult& GetTestPartResult(int i) const;
 
+  // Returns how many failures identical to the i-th test part result
+  // were counted instead of recorded because the test had reached the
+  // --gtest_max_failures_per_test limit.  i can range from 0 to
+  // total_part_count() - 1. If i is not in that range, aborts the
+  // program.
+  int GetTestPartRepeatCount(int i) const;
+
+  // Returns how many failures were neither recorded nor counted as a
+  // repeat of a recorded one because the test had reached the
+  // --gtest_max_failures_per_test limit.
+  int omitted_failure_count() const;
+
   // Returns the i-th test property. i can range from 0 to
   // test_property_count() - 1. If i is not in that range, aborts the
   // program.
   const TestProperty& GetTestProperty(int i) const;
 
  private:
+  friend class Test;
   friend class TestInfo;
   friend class UnitTest;
   friend class internal::DefaultGlobalTestPartResultReporter;
@@ -555,18 +641,33 @@ class GTEST_API_ TestResult {
   friend class internal::WindowsDeathTest;
 
   // Gets the vector of TestPartResults.
-  const std::vector<TestPartResult>& test_part_results() const {
-    return test_part_results_;
-  }
+  const std::vector<TestPartResult>& test_part_results() const;
 
   // Gets the vector of TestProperties.
-  const std::vector<TestProperty>& test_properties() const {
-    return test_properties_;
+  const std::vector<TestProperty>& test_properties() const;
+
+  // Returns the storage for the test part results and the test
+  // properties, allocating it the first time.
+  internal::TestResultStorage* MutableStorage();
+
+  // Returns the storage, or NULL if nothing has been recorded yet.
+  internal::TestResultStorage* storage() const {
+    return internal::AtomicLoadPointer(&storage_);
   }
 
   // Sets the elapsed time.
   void set_elapsed_time(TimeInMillis elapsed) { elapsed_time_ = elapsed; }
 
+  // Sets the time spent in the given phase, in nanoseconds.
+  void set_phase_time_nanos(Phase phase, internal::Int64 nanos) {
+    phase_time_nanos_[phase] = nanos;
+  }
+
+  // Sets the heap usage from the profiler's readings before the test's
+  // fixture was constructed and after it was destroyed.
+  void SetHeapUsage(const internal::HeapUsage& before,
+                    const internal::HeapUsage& after);
+
   // Adds a test property to the list. The property is validated and may add
   // a non-fatal failure if invalid (e.g., if it conflicts with reserved
   // key names). If a property is already recorded for the same key, the
@@ -579,8 +680,19 @@ class GTEST_API_ TestResult {
   // TODO(russr): Validate attribute names are legal and human readable.
   static bool ValidateTestProperty(const TestProperty& test_property);
 
-  // Adds a test part result to the list.
-  void AddTestPartResult(const TestPartResult& test_part_result);
+  // Adds a test part result to the list.  Once the test has recorded
+  // --gtest_max_failures_per_test test parts, a failure identical to a
+  // recorded one only increments the latter's repeat count, and any other
+  // failure is only counted as omitted.  Returns true iff the result was
+  // added.
+  bool AddTestPartResult(const TestPartResult& test_part_result);
+
+  // Adds count to the repeat count of the last recorded failure that is
+  // identical to the given one, or counts them as omitted if there is none.
+  void AddTestPartRepeats(const TestPartResult& test_part_result, int count);
+
+  // Counts count omitted failures of the given type.
+  void AddOmittedFailures(TestPartResult::Type type, int count);
 
   // Returns the death test count.
   int death_test_count() const { return death_test_count_; }
@@ -594,18 +706,22 @@ class GTEST_API_ TestResult {
   // Clears the object.
   void Clear();
 
-  // Protects mutable state of the property vector and of owned
-  // properties, whose values may be updated.
-  internal::Mutex test_properites_mutex_;
-
-  // The vector of TestPartResults
-  std::vector<TestPartResult> test_part_results_;
-  // The vector of TestProperties
-  std::vector<TestProperty> test_properties_;
+  // The test part results and the test properties, or NULL until one of
+  // them is recorded.  Most tests record none, and a program can register
+  // millions of them.  Threads recording the first result or property at
+  // once race to publish it with AtomicCompareAndSwapPointer().
+  internal::TestResultStorage* volatile storage_;
   // Running count of death tests.
   int death_test_count_;
   // The elapsed time, in milliseconds.
   TimeInMillis elapsed_time_;
+  // The time spent in each phase, in nanoseconds.
+  internal::Int64 phase_time_nanos_[kPhaseCount];
+  // The heap usage, if measured.
+  bool has_heap_usage_;
+  internal::Int64 heap_peak_bytes_;
+  internal::Int64 heap_growth_bytes_;
+  internal::Int64 heap_allocation_count_;
 
   // We disallow copying TestResult.
   GTEST_DISALLOW_COPY_AND_ASSIGN_(TestResult);
@@ -629,26 +745,18 @@ class GTEST_API_ TestInfo {
   ~TestInfo();
 
   // Returns the test case name.
-  const char* test_case_name() const { return test_case_name_.c_str(); }
+  const char* test_case_name() const { return test_case_name_; }
 
   // Returns the test name.
-  const char* name() const { return name_.c_str(); }
+  const char* name() const { return name_; }
 
   // Returns the name of the parameter type, or NULL if this is not a typed
   // or a type-parameterized test.
-  const char* type_param() const {
-    if (type_param_.get() != NULL)
-      return type_param_->c_str();
-    return NULL;
-  }
+  const char* type_param() const { return type_param_; }
 
   // Returns the text representation of the value parameter, or NULL if this
   // is not a value-parameterized test.
-  const char* value_param() const {
-    if (value_param_.get() != NULL)
-      return value_param_->c_str();
-    return NULL;
-  }
+  const char* value_param() const { return value_param_; }
 
   // Returns true if this test should run, that is if the test is not disabled
   // (or it is disabled but the also_run_disabled_tests flag has been specified)
@@ -710,15 +818,17 @@ class GTEST_API_ TestInfo {
     test_info->result_.Clear();
   }
 
-  // These fields are immutable properties of the test.
-  const std::string test_case_name_;     // Test case name
-  const std::string name_;               // Test name
+  // These fields are immutable properties of the test.  The strings
+  // are interned in a pool that outlives every TestInfo, so tests that
+  // share a name, a test case or a parameter share one copy of it.
+  const char* const test_case_name_;     // Test case name
+  const char* const name_;               // Test name
   // Name of the parameter type, or NULL if this is not a typed or a
   // type-parameterized test.
-  const internal::scoped_ptr<const ::std::string> type_param_;
+  const char* const type_param_;
   // Text representation of the value parameter, or NULL if this is not a
   // value-parameterized test.
-  const internal::scoped_ptr<const ::std::string> value_param_;
+  const char* const value_param_;
   const internal::TypeId fixture_class_id_;   // ID of the test fixture class
   bool should_run_;                 // True iff this test should run
   bool is_disabled_;                // True iff this test is disabled
@@ -759,15 +869,11 @@ class GTEST_API_ TestCase {
   virtual ~TestCase();
 
   // Gets the name of the TestCase.
-  const char* name() const { return name_.c_str(); }
+  const char* name() const { return name_; }
 
   // Returns the name of the parameter type, or NULL if this is not a
   // type-parameterized test case.
-  const char* type_param() const {
-    if (type_param_.get() != NULL)
-      return type_param_->c_str();
-    return NULL;
-  }
+  const char* type_param() const { return type_param_; }
 
   // Returns true if any test in this test case should run.
   bool should_run() const { return should_run_; }
@@ -793,9 +899,18 @@ class GTEST_API_ TestCase {
   // Returns true iff the test case failed.
   bool Failed() const { return failed_test_count() > 0; }
 
-  // Returns the elapsed time, in milliseconds.
+  // Returns the elapsed time, in milliseconds.  It doesn't include
+  // SetUpTestCase() and TearDownTestCase().
   TimeInMillis elapsed_time() const { return elapsed_time_; }
 
+  // Returns the time SetUpTestCase() took, in nanoseconds.
+  internal::Int64 set_up_time_nanos() const { return set_up_time_nanos_; }
+
+  // Returns the time TearDownTestCase() took, in nanoseconds.
+  internal::Int64 tear_down_time_nanos() const {
+    return tear_down_time_nanos_;
+  }
+
   // Returns the i-th test among all the tests. i can range from 0 to
   // total_test_count() - 1. If i is not in that range, returns NULL.
   const TestInfo* GetTestInfo(int i) const;
@@ -868,11 +983,12 @@ class GTEST_API_ TestCase {
   // Restores the test order to before the first shuffle.
   void UnshuffleTests();
 
-  // Name of the test case.
-  internal::String name_;
+  // Name of the test case, interned like the names in TestInfo.  Equal
+  // test case names are therefore equal pointers.
+  const char* const name_;
   // Name of the parameter type, or NULL if this is not a typed or a
   // type-parameterized test.
-  const internal::scoped_ptr<const ::std::string> type_param_;
+  const char* const type_param_;
   // The vector of TestInfos in their original order.  It owns the
   // elements in the vector.
   std::vector<TestInfo*> test_info_list_;
@@ -888,6 +1004,9 @@ class GTEST_API_ TestCase {
   bool should_run_;
   // Elapsed time, in milliseconds.
   TimeInMillis elapsed_time_;
+  // The time SetUpTestCase() and TearDownTestCase() took, in nanoseconds.
+  internal::Int64 set_up_time_nanos_;
+  internal::Int64 tear_down_time_nanos_;
 
   // We disallow copying TestCases.
   GTEST_DISALLOW_COPY_AND_ASSIGN_(TestCase);
@@ -1155,6 +1274,14 @@ class GTEST_API_ UnitTest {
   // Gets the elapsed time, in milliseconds.
   TimeInMillis elapsed_time() const;
 
+  // Gets the time the SetUp() methods of the global environments took in
+  // the last iteration, in nanoseconds.
+  internal::Int64 environments_set_up_time_nanos() const;
+
+  // Gets the time the TearDown() methods of the global environments took
+  // in the last iteration, in nanoseconds.
+  internal::Int64 environments_tear_down_time_nanos() const;
+
   // Returns true iff the unit test passed (i.e. all test cases passed).
   bool Passed() const;
 
@@ -1209,6 +1336,7 @@ class GTEST_API_ UnitTest {
   friend class Test;
   friend class internal::AssertHelper;
   friend class internal::ScopedTrace;
+  friend class internal::LazyScopedTrace;
   friend Environment* AddGlobalTestEnvironment(Environment* env);
   friend internal::UnitTestImpl* internal::GetUnitTestImpl();
   friend void internal::ReportFailureInUnknownLocation(
@@ -1301,6 +1429,147 @@ String FormatForComparisonFailureMessage(const T1& value,
   return ::testing::PrintToString(value);
 }
 
+// The number of unchanged elements shown around each change in the
+// diff of two containers.
+const size_t kDiffContext = 2;
+
+// The number of elements of each container that are printed to diff
+// two containers.
+const size_t kMaxElementsToDiff = 10000;
+
+// Prints the elements in [begin, end) to *lines, one element per line.
+// It stops after kMaxElementsToDiff + 1 elements, which is enough for
+// DiffPrintedElements() to tell that the rest was left out.
+template <typename Iter>
+void PrintElementsForDiff(Iter begin, Iter end,
+                          ::std::vector< ::std::string>* lines) {
+  for (; begin != end && lines->size() <= kMaxElementsToDiff; ++begin) {
+    ::std::stringstream ss;
+    UniversalPrint(*begin, &ss);
+    lines->push_back(ss.str());
+  }
+}
+
+// Returns a unified diff of the printed elements of two containers,
+// where the first element printed has the given 1-based position.  If
+// either has more than kMaxElementsToDiff elements, only that many
+// are compared and the diff says so.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ String DiffPrintedElements(
+    ::std::vector< ::std::string>* expected_lines,
+    ::std::vector< ::std::string>* actual_lines,
+    size_t first_position) GTEST_ATTRIBUTE_COLD_;
+
+// Returns a unified diff of the elements of two STL-style containers.
+template <typename Container>
+String DiffContainers(const Container& expected, const Container& actual,
+                      IsContainer /* dummy */) {
+  ::std::vector< ::std::string> expected_lines, actual_lines;
+  PrintElementsForDiff(expected.begin(), expected.end(), &expected_lines);
+  PrintElementsForDiff(actual.begin(), actual.end(), &actual_lines);
+  return DiffPrintedElements(&expected_lines, &actual_lines, 1);
+}
+
+template <typename T>
+String DiffContainers(const T& /* expected */, const T& /* actual */,
+                      IsNotContainer /* dummy */) {
+  return String("");
+}
+
+// Returns a unified diff of two vectors.  As the elements can be
+// compared with ==, only the part between the common prefix and the
+// common suffix is printed and diffed, so that one changed element of
+// a huge vector is cheap to report.
+template <typename T, typename Alloc>
+String DiffVectors(const ::std::vector<T, Alloc>& expected,
+                   const ::std::vector<T, Alloc>& actual) {
+  const size_t min_size = (::std::min)(expected.size(), actual.size());
+  size_t prefix = 0;
+  while (prefix != min_size && expected[prefix] == actual[prefix]) {
+    prefix++;
+  }
+  size_t suffix = 0;
+  while (suffix != min_size - prefix &&
+         expected[expected.size() - 1 - suffix] ==
+         actual[actual.size() - 1 - suffix]) {
+    suffix++;
+  }
+
+  const size_t begin = prefix - (::std::min)(prefix, kDiffContext);
+  const size_t context_after = (::std::min)(suffix, kDiffContext);
+  ::std::vector< ::std::string> expected_lines, actual_lines;
+  PrintElementsForDiff(expected.begin() + begin,
+                       expected.end() - suffix + context_after,
+                       &expected_lines);
+  PrintElementsForDiff(actual.begin() + begin,
+                       actual.end() - suffix + context_after,
+                       &actual_lines);
+  return DiffPrintedElements(&expected_lines, &actual_lines, begin + 1);
+}
+
+// Returns a unified diff of two values compared by {ASSERT|EXPECT}_EQ:
+// containers are diffed element by element, and strings line by line.
+// Returns an empty string for other values, and for single-line strings.
+template <typename T1, typename T2>
+String DiffForEqFailure(const T1& /* expected */, const T2& /* actual */) {
+  return String("");
+}
+template <typename T>
+String DiffForEqFailure(const T& expected, const T& actual) {
+  return DiffContainers(expected, actual, IsContainerTest<T>(0));
+}
+template <typename T, typename Alloc>
+String DiffForEqFailure(const ::std::vector<T, Alloc>& expected,
+                        const ::std::vector<T, Alloc>& actual) {
+  return DiffVectors(expected, actual);
+}
+inline String DiffForEqFailure(const ::std::string& expected,
+                               const ::std::string& actual) {
+  return DiffStrings(expected, actual);
+}
+#if GTEST_HAS_GLOBAL_STRING
+inline String DiffForEqFailure(const ::string& expected,
+                               const ::string& actual) {
+  return DiffStrings(::std::string(expected.data(), expected.size()),
+                     ::std::string(actual.data(), actual.size()));
+}
+#endif  // GTEST_HAS_GLOBAL_STRING
+#if GTEST_HAS_STD_WSTRING
+inline String DiffForEqFailure(const ::std::wstring& expected,
+                               const ::std::wstring& actual) {
+  return DiffStrings(expected, actual);
+}
+#endif  // GTEST_HAS_STD_WSTRING
+#if GTEST_HAS_GLOBAL_WSTRING
+inline String DiffForEqFailure(const ::wstring& expected,
+                               const ::wstring& actual) {
+  return DiffStrings(::std::wstring(expected.data(), expected.size()),
+                     ::std::wstring(actual.data(), actual.size()));
+}
+#endif  // GTEST_HAS_GLOBAL_WSTRING
+
+// Builds the failure message of {ASSERT|EXPECT}_EQ.  It is kept out
+// of line so that CmpHelperEQ() and the assertion that calls it stay a
+// compare and a branch when the values are equal.
+template <typename T1, typename T2>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult CmpHelperEQFailure(const char* expected_expression,
+                                   const char* actual_expression,
+                                   const T1& expected, const T2& actual) {
+  AssertionResult result =
+      EqFailure(expected_expression,
+                actual_expression,
+                FormatForComparisonFailureMessage(expected, actual),
+                FormatForComparisonFailureMessage(actual, expected),
+                false);
+  const String diff = DiffForEqFailure(expected, actual);
+  if (!diff.empty()) {
+    result << "\nWith diff:\n" << diff;
+  }
+  return result;
+}
+
 // The helper function for {ASSERT|EXPECT}_EQ.
 template <typename T1, typename T2>
 AssertionResult CmpHelperEQ(const char* expected_expression,
@@ -1314,18 +1583,15 @@ AssertionResult CmpHelperEQ(const char* expected_expression,
 #endif
 
   if (expected == actual) {
-    return AssertionSuccess();
+    return InlineAssertionSuccess();
   }
 
 #ifdef _MSC_VER
 # pragma warning(pop)          // Restores the warning state.
 #endif
 
-  return EqFailure(expected_expression,
-                   actual_expression,
-                   FormatForComparisonFailureMessage(expected, actual),
-                   FormatForComparisonFailureMessage(actual, expected),
-                   false);
+  return CmpHelperEQFailure(expected_expression, actual_expression,
+                            expected, actual);
 }
 
 // With this overloaded version, we allow anonymous enums to be used
@@ -1413,6 +1679,22 @@ class EqHelper<true> {
   }
 };
 
+// Builds the failure message of the binary comparison assertions other
+// than {ASSERT|EXPECT}_EQ.  Out of line for the same reason as
+// CmpHelperEQFailure().
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+template <typename T1, typename T2>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult CmpHelperOpFailure(const char* expr1, const char* expr2,
+                                   const T1& val1, const T2& val2,
+                                   const char* op) {
+  return AssertionFailure()
+      << "Expected: (" << expr1 << ") " << op << " (" << expr2
+      << "), actual: " << FormatForComparisonFailureMessage(val1, val2)
+      << " vs " << FormatForComparisonFailureMessage(val2, val1);
+}
+
 // A macro for implementing the helper functions needed to implement
 // ASSERT_?? and EXPECT_??.  It is here just to avoid copy-and-paste
 // of similar code.
@@ -1428,12 +1710,9 @@ template <typename T1, typename T2>\
 AssertionResult CmpHelper##op_name(const char* expr1, const char* expr2, \
                                    const T1& val1, const T2& val2) {\
   if (val1 op val2) {\
-    return AssertionSuccess();\
+    return InlineAssertionSuccess();\
   } else {\
-    return AssertionFailure() \
-        << "Expected: (" << expr1 << ") " #op " (" << expr2\
-        << "), actual: " << FormatForComparisonFailureMessage(val1, val2)\
-        << " vs " << FormatForComparisonFailureMessage(val2, val1);\
+    return CmpHelperOpFailure(expr1, expr2, val1, val2, #op);\
   }\
 }\
 GTEST_API_ AssertionResult CmpHelper##op_name(\
@@ -1503,6 +1782,150 @@ GTEST_API_ AssertionResult CmpHelperSTRNE(const char* s1_expression,
                                           const wchar_t* s1,
                                           const wchar_t* s2);
 
+// What BufferEqFailure() reports a difference in.
+enum BufferEqKind {
+  // Raw bytes, compared by {ASSERT|EXPECT}_BUFFER_EQ.  They are shown as
+  // a hex dump.
+  kBufferEqBytes,
+  // Elements compared by {ASSERT|EXPECT}_ARRAYS_EQ whose bytes are all
+  // there is to them.  The first differing elements are printed, and
+  // the bytes around them are shown as a hex dump.
+  kBufferEqPlainElements,
+  // Other elements compared by {ASSERT|EXPECT}_ARRAYS_EQ.  Only the
+  // printed elements are shown: their bytes may well be pointers to
+  // the data that actually differs.
+  kBufferEqElements
+};
+
+// Constructs the failure message for {ASSERT|EXPECT}_BUFFER_EQ and
+// {ASSERT|EXPECT}_ARRAYS_EQ.  expected and actual each hold count
+// elements of element_size bytes.  mismatches is the number of indices
+// where they differ, and first is the first such index.  expected_value
+// and actual_value are the printed values of the first differing
+// elements, and are ignored for kBufferEqBytes.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult BufferEqFailure(const char* expected_expression,
+                                           const char* actual_expression,
+                                           const char* count_expression,
+                                           BufferEqKind kind,
+                                           const void* expected,
+                                           const void* actual,
+                                           size_t count,
+                                           size_t element_size,
+                                           size_t mismatches,
+                                           size_t first,
+                                           const String& expected_value,
+                                           const String& actual_value)
+    GTEST_ATTRIBUTE_COLD_;
+
+// The helper function for {ASSERT|EXPECT}_BUFFER_EQ.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult CmpHelperBufferEQ(const char* expected_expression,
+                                             const char* actual_expression,
+                                             const char* size_expression,
+                                             const void* expected,
+                                             const void* actual,
+                                             size_t size);
+
+// The helper function for {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult CmpHelperGoldenFile(const char* path_expression,
+                                               const char* data_expression,
+                                               const ::std::string& path,
+                                               const ::std::string& data);
+
+// Returns the number of indices at which the two arrays differ.  The
+// loop deliberately has no early exit so that the compiler can
+// vectorize it.
+template <typename T>
+size_t CountArrayMismatches(const T* expected, const T* actual,
+                            size_t count) {
+  size_t mismatches = 0;
+  for (size_t i = 0; i != count; i++) {
+    mismatches += !(expected[i] == actual[i]);
+  }
+  return mismatches;
+}
+
+// IsPlainElement<T>::value is true iff T is an arithmetic type or a
+// pointer, whose bytes {ASSERT|EXPECT}_ARRAYS_EQ can show as a hex dump.
+template <typename T>
+struct IsPlainElement
+    : public bool_constant< ::std::numeric_limits<T>::is_specialized ||
+                            is_pointer<T>::value> {};
+
+// Appends the elements around index first of the arrays to a failure
+// of {ASSERT|EXPECT}_ARRAYS_EQ.  It's a no-op for plain elements, as
+// BufferEqFailure() shows their bytes instead.
+template <typename T>
+void AppendElementsAround(true_type /* is_plain */,
+                          const T* /* expected */, const T* /* actual */,
+                          size_t /* count */, size_t /* first */,
+                          AssertionResult* /* failure */) {}
+
+template <typename T>
+void AppendElementsAround(false_type /* is_plain */,
+                          const T* expected, const T* actual,
+                          size_t count, size_t first,
+                          AssertionResult* failure) {
+  const size_t kContext = 2;
+  const size_t begin = first < kContext ? 0 : first - kContext;
+  const size_t end = first + kContext + 1 < count ?
+      first + kContext + 1 : count;
+  ::std::stringstream expected_ss;
+  UniversalPrintArray(expected + begin, end - begin, &expected_ss);
+  ::std::stringstream actual_ss;
+  UniversalPrintArray(actual + begin, end - begin, &actual_ss);
+  *failure << "\nExpected elements at index " << begin << ": "
+           << StringStreamToString(&expected_ss)
+           << "\n  Actual elements at index " << begin << ": "
+           << StringStreamToString(&actual_ss);
+}
+
+// Locates the first difference and builds the failure message of
+// {ASSERT|EXPECT}_ARRAYS_EQ.
+template <typename T>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult CmpHelperArraysEQFailure(const char* expected_expression,
+                                         const char* actual_expression,
+                                         const char* count_expression,
+                                         const T* expected, const T* actual,
+                                         size_t count, size_t mismatches) {
+  size_t first = 0;
+  while (expected[first] == actual[first]) {
+    first++;
+  }
+  AssertionResult failure = BufferEqFailure(
+      expected_expression, actual_expression, count_expression,
+      IsPlainElement<T>::value ? kBufferEqPlainElements : kBufferEqElements,
+      expected, actual, count, sizeof(T), mismatches, first,
+      FormatForComparisonFailureMessage(expected[first], actual[first]),
+      FormatForComparisonFailureMessage(actual[first], expected[first]));
+  AppendElementsAround(typename IsPlainElement<T>::type(), expected, actual,
+                       count, first, &failure);
+  return failure;
+}
+
+// The helper function for {ASSERT|EXPECT}_ARRAYS_EQ.
+template <typename T>
+AssertionResult CmpHelperArraysEQ(const char* expected_expression,
+                                  const char* actual_expression,
+                                  const char* count_expression,
+                                  const T* expected, const T* actual,
+                                  size_t count) {
+  const size_t mismatches = CountArrayMismatches(expected, actual, count);
+  if (mismatches == 0) {
+    return InlineAssertionSuccess();
+  }
+
+  return CmpHelperArraysEQFailure(expected_expression, actual_expression,
+                                  count_expression, expected, actual, count,
+                                  mismatches);
+}
+
 }  // namespace internal
 
 // IsSubstring() and IsNotSubstring() are intended to be used as the
@@ -1543,6 +1966,30 @@ GTEST_API_ AssertionResult IsNotSubstring(
 
 namespace internal {
 
+// Builds the failure message of CmpHelperFloatingPointEQ().
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+template <typename RawType>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult CmpHelperFloatingPointEQFailure(const char* expected_expression,
+                                                const char* actual_expression,
+                                                RawType expected,
+                                                RawType actual) {
+  ::std::stringstream expected_ss;
+  expected_ss << std::setprecision(std::numeric_limits<RawType>::digits10 + 2)
+              << expected;
+
+  ::std::stringstream actual_ss;
+  actual_ss << std::setprecision(std::numeric_limits<RawType>::digits10 + 2)
+            << actual;
+
+  return EqFailure(expected_expression,
+                   actual_expression,
+                   StringStreamToString(&expected_ss),
+                   StringStreamToString(&actual_ss),
+                   false);
+}
+
 // Helper template function for comparing floating-points.
 //
 // Template parameter:
@@ -1558,22 +2005,11 @@ AssertionResult CmpHelperFloatingPointEQ(const char* expected_expression,
   const FloatingPoint<RawType> lhs(expected), rhs(actual);
 
   if (lhs.AlmostEquals(rhs)) {
-    return AssertionSuccess();
+    return InlineAssertionSuccess();
   }
 
-  ::std::stringstream expected_ss;
-  expected_ss << std::setprecision(std::numeric_limits<RawType>::digits10 + 2)
-              << expected;
-
-  ::std::stringstream actual_ss;
-  actual_ss << std::setprecision(std::numeric_limits<RawType>::digits10 + 2)
-            << actual;
-
-  return EqFailure(expected_expression,
-                   actual_expression,
-                   StringStreamToString(&expected_ss),
-                   StringStreamToString(&actual_ss),
-                   false);
+  return CmpHelperFloatingPointEQFailure(expected_expression,
+                                         actual_expression, expected, actual);
 }
 
 // Helper function for implementing ASSERT_NEAR.
@@ -1586,20 +2022,87 @@ GTEST_API_ AssertionResult DoubleNearPredFormat(const char* expr1,
                                                 double val2,
                                                 double abs_error);
 
+// Helper functions for implementing {ASSERT|EXPECT}_FLOAT_ARRAY_EQ and
+// {ASSERT|EXPECT}_DOUBLE_ARRAY_EQ.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult CmpHelperFloatArrayEQ(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const float* expected,
+    const float* actual,
+    size_t count);
+GTEST_API_ AssertionResult CmpHelperDoubleArrayEQ(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const double* expected,
+    const double* actual,
+    size_t count);
+
+// Helper functions for implementing {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR
+// and {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult FloatArrayNearPredFormat(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const char* abs_error_expression,
+    const float* expected,
+    const float* actual,
+    size_t count,
+    float abs_error);
+GTEST_API_ AssertionResult DoubleArrayNearPredFormat(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const char* abs_error_expression,
+    const double* expected,
+    const double* actual,
+    size_t count,
+    double abs_error);
+
+// Helper functions for implementing {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR_ULPS
+// and {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR_ULPS.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+GTEST_API_ AssertionResult FloatArrayNearUlpsPredFormat(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const char* max_ulps_expression,
+    const float* expected,
+    const float* actual,
+    size_t count,
+    size_t max_ulps);
+GTEST_API_ AssertionResult DoubleArrayNearUlpsPredFormat(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const char* max_ulps_expression,
+    const double* expected,
+    const double* actual,
+    size_t count,
+    size_t max_ulps);
+
 // INTERNAL IMPLEMENTATION - DO NOT USE IN USER CODE.
 // A class that enables one to stream messages to assertion macros
 class GTEST_API_ AssertHelper {
  public:
-  // Constructor.
+  // Constructor.  It's only called when an assertion fails (or for
+  // SUCCEED()), so it is marked cold to keep the assertions' success
+  // path tight.
   AssertHelper(TestPartResult::Type type,
                const char* file,
                int line,
-               const char* message);
+               const char* message) GTEST_ATTRIBUTE_COLD_;
   ~AssertHelper();
 
   // Message assignment is a semantic trick to enable assertion
   // streaming; see the GTEST_MESSAGE_ macro below.
-  void operator=(const Message& message) const;
+  void operator=(const Message& message) const GTEST_ATTRIBUTE_COLD_;
 
  private:
   // We put our data in a struct so that the size of the AssertHelper class can
@@ -1934,6 +2437,54 @@ class TestWithParam : public Test, public WithParamInterface<T> {
 #define ASSERT_STRCASENE(s1, s2)\
   ASSERT_PRED_FORMAT2(::testing::internal::CmpHelperSTRCASENE, s1, s2)
 
+// Bulk comparisons of buffers and arrays.
+//
+//    * {ASSERT|EXPECT}_BUFFER_EQ(expected, actual, size):
+//         Tests that the size bytes at expected and actual are equal.
+//    * {ASSERT|EXPECT}_ARRAYS_EQ(expected, actual, count):
+//         Tests that the count elements of the arrays expected and
+//         actual are equal according to ==.
+//
+// They are much faster than comparing two vectors with EXPECT_EQ, as
+// the comparison is a memcmp() or a vectorizable loop instead of an
+// element-by-element assertion.  On failure they report how many
+// bytes (elements) differ, the first difference, and a hex dump of
+// the bytes around it.  Elements that aren't arithmetic values or
+// pointers, e.g. strings, are printed instead of dumped.
+
+#define EXPECT_BUFFER_EQ(expected, actual, size)\
+  EXPECT_PRED_FORMAT3(::testing::internal::CmpHelperBufferEQ, \
+                      expected, actual, size)
+#define EXPECT_ARRAYS_EQ(expected, actual, count)\
+  EXPECT_PRED_FORMAT3(::testing::internal::CmpHelperArraysEQ, \
+                      expected, actual, count)
+
+#define ASSERT_BUFFER_EQ(expected, actual, size)\
+  ASSERT_PRED_FORMAT3(::testing::internal::CmpHelperBufferEQ, \
+                      expected, actual, size)
+#define ASSERT_ARRAYS_EQ(expected, actual, count)\
+  ASSERT_PRED_FORMAT3(::testing::internal::CmpHelperArraysEQ, \
+                      expected, actual, count)
+
+// Comparison against a golden file.
+//
+//    * {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE(path, data):
+//         Tests that the file at path holds exactly the bytes of the
+//         string data.
+//
+// The golden file is memory-mapped and compared a chunk at a time,
+// stopping at the first difference, so even a very large golden file is
+// never copied into a string.  On failure the assertion reports the
+// offset, line and column of the first difference and the bytes around
+// it.  When the --gtest_update_golden_files flag is specified, the
+// assertion instead replaces the golden file with data (writing it to a
+// temporary file and renaming that over the golden file) and succeeds.
+
+#define EXPECT_MATCHES_GOLDEN_FILE(path, data)\
+  EXPECT_PRED_FORMAT2(::testing::internal::CmpHelperGoldenFile, path, data)
+#define ASSERT_MATCHES_GOLDEN_FILE(path, data)\
+  ASSERT_PRED_FORMAT2(::testing::internal::CmpHelperGoldenFile, path, data)
+
 // Macros for comparing floating-point numbers.
 //
 //    * {ASSERT|EXPECT}_FLOAT_EQ(expected, actual):
@@ -1972,6 +2523,77 @@ class TestWithParam : public Test, public WithParamInterface<T> {
   ASSERT_PRED_FORMAT3(::testing::internal::DoubleNearPredFormat, \
                       val1, val2, abs_error)
 
+// Macros for comparing arrays of floating-point numbers.
+//
+//    * {ASSERT|EXPECT}_FLOAT_ARRAY_EQ(expected, actual, count):
+//    * {ASSERT|EXPECT}_DOUBLE_ARRAY_EQ(expected, actual, count):
+//         Tests that the count elements of two float (double) arrays
+//         are pairwise almost equal, as in {ASSERT|EXPECT}_FLOAT_EQ.
+//    * {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR(expected, actual, count, abs_error):
+//    * {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR(expected, actual, count, abs_error):
+//         Tests that the count elements of two float (double) arrays
+//         are pairwise within abs_error of each other.
+//    * {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR_ULPS(expected, actual, count,
+//                                            max_ulps):
+//    * {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, count,
+//                                             max_ulps):
+//         Tests that the count elements of two float (double) arrays
+//         are pairwise at most max_ulps ULP's apart.  The _ARRAY_EQ
+//         macros are these with max_ulps being 4.
+//
+// The whole array is checked by one vectorizable loop.  A failure is
+// reported once for the whole array: it gives the number of elements
+// that differ, the largest difference and where it is, and the first
+// few differing elements.
+
+#define EXPECT_FLOAT_ARRAY_EQ(expected, actual, count)\
+  EXPECT_PRED_FORMAT3(::testing::internal::CmpHelperFloatArrayEQ, \
+                      expected, actual, count)
+
+#define EXPECT_DOUBLE_ARRAY_EQ(expected, actual, count)\
+  EXPECT_PRED_FORMAT3(::testing::internal::CmpHelperDoubleArrayEQ, \
+                      expected, actual, count)
+
+#define ASSERT_FLOAT_ARRAY_EQ(expected, actual, count)\
+  ASSERT_PRED_FORMAT3(::testing::internal::CmpHelperFloatArrayEQ, \
+                      expected, actual, count)
+
+#define ASSERT_DOUBLE_ARRAY_EQ(expected, actual, count)\
+  ASSERT_PRED_FORMAT3(::testing::internal::CmpHelperDoubleArrayEQ, \
+                      expected, actual, count)
+
+#define EXPECT_FLOAT_ARRAY_NEAR(expected, actual, count, abs_error)\
+  EXPECT_PRED_FORMAT4(::testing::internal::FloatArrayNearPredFormat, \
+                      expected, actual, count, abs_error)
+
+#define EXPECT_DOUBLE_ARRAY_NEAR(expected, actual, count, abs_error)\
+  EXPECT_PRED_FORMAT4(::testing::internal::DoubleArrayNearPredFormat, \
+                      expected, actual, count, abs_error)
+
+#define ASSERT_FLOAT_ARRAY_NEAR(expected, actual, count, abs_error)\
+  ASSERT_PRED_FORMAT4(::testing::internal::FloatArrayNearPredFormat, \
+                      expected, actual, count, abs_error)
+
+#define ASSERT_DOUBLE_ARRAY_NEAR(expected, actual, count, abs_error)\
+  ASSERT_PRED_FORMAT4(::testing::internal::DoubleArrayNearPredFormat, \
+                      expected, actual, count, abs_error)
+
+#define EXPECT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, count, max_ulps)\
+  EXPECT_PRED_FORMAT4(::testing::internal::FloatArrayNearUlpsPredFormat, \
+                      expected, actual, count, max_ulps)
+
+#define EXPECT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, count, max_ulps)\
+  EXPECT_PRED_FORMAT4(::testing::internal::DoubleArrayNearUlpsPredFormat, \
+                      expected, actual, count, max_ulps)
+
+#define ASSERT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, count, max_ulps)\
+  ASSERT_PRED_FORMAT4(::testing::internal::FloatArrayNearUlpsPredFormat, \
+                      expected, actual, count, max_ulps)
+
+#define ASSERT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, count, max_ulps)\
+  ASSERT_PRED_FORMAT4(::testing::internal::DoubleArrayNearUlpsPredFormat, \
+                      expected, actual, count, max_ulps)
+
 // These predicate format functions work on floating-point values, and
 // can be used in {ASSERT|EXPECT}_PRED_FORMAT2*(), e.g.
 //
@@ -2040,6 +2662,23 @@ GTEST_API_ AssertionResult DoubleLE(const char* expr1, const char* expr2,
   ::testing::internal::ScopedTrace GTEST_CONCAT_TOKEN_(gtest_trace_, __LINE__)(\
     __FILE__, __LINE__, ::testing::Message() << (message))
 
+// Like SCOPED_TRACE(), but the value is streamed to the failure message
+// only when a failure actually happens in the current scope.  This
+// makes the trace nearly free when nothing fails, e.g. in a hot loop:
+//
+//   for (int i = 0; i < n; i++) {
+//     SCOPED_TRACE_LAZY(i);
+//     EXPECT_TRUE(IsValid(i));
+//   }
+//
+// The value is captured by reference, so it must be an lvalue that
+// outlives the scope, and a failure shows its value at the time of the
+// failure.  To trace a computed value, store it in a local variable or
+// use SCOPED_TRACE().
+#define SCOPED_TRACE_LAZY(value) \
+  ::testing::internal::LazyScopedTrace \
+      GTEST_CONCAT_TOKEN_(gtest_trace_, __LINE__)(__FILE__, __LINE__, value)
+
 // Compile-time assertion for type equality.
 // StaticAssertTypeEq<type1, type2>() compiles iff type1 and type2 are
 // the same type.  The value it returns is not interesting.
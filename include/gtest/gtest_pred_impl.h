@@ -80,6 +80,19 @@
     on_failure(gtest_ar.failure_message())
 
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED1.  It is kept out
+// of line so that AssertPred1Helper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <typename T1>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred1Failure(const char* pred_text,
+                                   const char* e1,
+                                   const T1& v1) {
+  return AssertionFailure() << pred_text << "("
+                            << e1 << ") evaluates to false, where"
+                            << "\n" << e1 << " evaluates to " << v1;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED1.  Don't use
 // this in your code.
 template <typename Pred,
@@ -88,11 +101,9 @@ AssertionResult AssertPred1Helper(const char* pred_text,
                                   const char* e1,
                                   Pred pred,
                                   const T1& v1) {
-  if (pred(v1)) return AssertionSuccess();
+  if (pred(v1)) return internal::InlineAssertionSuccess();
 
-  return AssertionFailure() << pred_text << "("
-                            << e1 << ") evaluates to false, where"
-                            << "\n" << e1 << " evaluates to " << v1;
+  return AssertPred1Failure(pred_text, e1, v1);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT1.
@@ -121,6 +132,24 @@ AssertionResult AssertPred1Helper(const char* pred_text,
 
 
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED2.  It is kept out
+// of line so that AssertPred2Helper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <typename T1,
+          typename T2>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred2Failure(const char* pred_text,
+                                   const char* e1,
+                                   const char* e2,
+                                   const T1& v1,
+                                   const T2& v2) {
+  return AssertionFailure() << pred_text << "("
+                            << e1 << ", "
+                            << e2 << ") evaluates to false, where"
+                            << "\n" << e1 << " evaluates to " << v1
+                            << "\n" << e2 << " evaluates to " << v2;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED2.  Don't use
 // this in your code.
 template <typename Pred,
@@ -132,13 +161,9 @@ AssertionResult AssertPred2Helper(const char* pred_text,
                                   Pred pred,
                                   const T1& v1,
                                   const T2& v2) {
-  if (pred(v1, v2)) return AssertionSuccess();
+  if (pred(v1, v2)) return internal::InlineAssertionSuccess();
 
-  return AssertionFailure() << pred_text << "("
-                            << e1 << ", "
-                            << e2 << ") evaluates to false, where"
-                            << "\n" << e1 << " evaluates to " << v1
-                            << "\n" << e2 << " evaluates to " << v2;
+  return AssertPred2Failure(pred_text, e1, e2, v1, v2);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT2.
@@ -169,6 +194,29 @@ AssertionResult AssertPred2Helper(const char* pred_text,
 
 
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED3.  It is kept out
+// of line so that AssertPred3Helper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <typename T1,
+          typename T2,
+          typename T3>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred3Failure(const char* pred_text,
+                                   const char* e1,
+                                   const char* e2,
+                                   const char* e3,
+                                   const T1& v1,
+                                   const T2& v2,
+                                   const T3& v3) {
+  return AssertionFailure() << pred_text << "("
+                            << e1 << ", "
+                            << e2 << ", "
+                            << e3 << ") evaluates to false, where"
+                            << "\n" << e1 << " evaluates to " << v1
+                            << "\n" << e2 << " evaluates to " << v2
+                            << "\n" << e3 << " evaluates to " << v3;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED3.  Don't use
 // this in your code.
 template <typename Pred,
@@ -183,15 +231,9 @@ AssertionResult AssertPred3Helper(const char* pred_text,
                                   const T1& v1,
                                   const T2& v2,
                                   const T3& v3) {
-  if (pred(v1, v2, v3)) return AssertionSuccess();
+  if (pred(v1, v2, v3)) return internal::InlineAssertionSuccess();
 
-  return AssertionFailure() << pred_text << "("
-                            << e1 << ", "
-                            << e2 << ", "
-                            << e3 << ") evaluates to false, where"
-                            << "\n" << e1 << " evaluates to " << v1
-                            << "\n" << e2 << " evaluates to " << v2
-                            << "\n" << e3 << " evaluates to " << v3;
+  return AssertPred3Failure(pred_text, e1, e2, e3, v1, v2, v3);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT3.
@@ -224,6 +266,34 @@ AssertionResult AssertPred3Helper(const char* pred_text,
 
 
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED4.  It is kept out
+// of line so that AssertPred4Helper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <typename T1,
+          typename T2,
+          typename T3,
+          typename T4>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred4Failure(const char* pred_text,
+                                   const char* e1,
+                                   const char* e2,
+                                   const char* e3,
+                                   const char* e4,
+                                   const T1& v1,
+                                   const T2& v2,
+                                   const T3& v3,
+                                   const T4& v4) {
+  return AssertionFailure() << pred_text << "("
+                            << e1 << ", "
+                            << e2 << ", "
+                            << e3 << ", "
+                            << e4 << ") evaluates to false, where"
+                            << "\n" << e1 << " evaluates to " << v1
+                            << "\n" << e2 << " evaluates to " << v2
+                            << "\n" << e3 << " evaluates to " << v3
+                            << "\n" << e4 << " evaluates to " << v4;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED4.  Don't use
 // this in your code.
 template <typename Pred,
@@ -241,17 +311,9 @@ AssertionResult AssertPred4Helper(const char* pred_text,
                                   const T2& v2,
                                   const T3& v3,
                                   const T4& v4) {
-  if (pred(v1, v2, v3, v4)) return AssertionSuccess();
+  if (pred(v1, v2, v3, v4)) return internal::InlineAssertionSuccess();
 
-  return AssertionFailure() << pred_text << "("
-                            << e1 << ", "
-                            << e2 << ", "
-                            << e3 << ", "
-                            << e4 << ") evaluates to false, where"
-                            << "\n" << e1 << " evaluates to " << v1
-                            << "\n" << e2 << " evaluates to " << v2
-                            << "\n" << e3 << " evaluates to " << v3
-                            << "\n" << e4 << " evaluates to " << v4;
+  return AssertPred4Failure(pred_text, e1, e2, e3, e4, v1, v2, v3, v4);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT4.
@@ -286,6 +348,39 @@ AssertionResult AssertPred4Helper(const char* pred_text,
 
 
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED5.  It is kept out
+// of line so that AssertPred5Helper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <typename T1,
+          typename T2,
+          typename T3,
+          typename T4,
+          typename T5>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred5Failure(const char* pred_text,
+                                   const char* e1,
+                                   const char* e2,
+                                   const char* e3,
+                                   const char* e4,
+                                   const char* e5,
+                                   const T1& v1,
+                                   const T2& v2,
+                                   const T3& v3,
+                                   const T4& v4,
+                                   const T5& v5) {
+  return AssertionFailure() << pred_text << "("
+                            << e1 << ", "
+                            << e2 << ", "
+                            << e3 << ", "
+                            << e4 << ", "
+                            << e5 << ") evaluates to false, where"
+                            << "\n" << e1 << " evaluates to " << v1
+                            << "\n" << e2 << " evaluates to " << v2
+                            << "\n" << e3 << " evaluates to " << v3
+                            << "\n" << e4 << " evaluates to " << v4
+                            << "\n" << e5 << " evaluates to " << v5;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED5.  Don't use
 // this in your code.
 template <typename Pred,
@@ -306,19 +401,9 @@ AssertionResult AssertPred5Helper(const char* pred_text,
                                   const T3& v3,
                                   const T4& v4,
                                   const T5& v5) {
-  if (pred(v1, v2, v3, v4, v5)) return AssertionSuccess();
+  if (pred(v1, v2, v3, v4, v5)) return internal::InlineAssertionSuccess();
 
-  return AssertionFailure() << pred_text << "("
-                            << e1 << ", "
-                            << e2 << ", "
-                            << e3 << ", "
-                            << e4 << ", "
-                            << e5 << ") evaluates to false, where"
-                            << "\n" << e1 << " evaluates to " << v1
-                            << "\n" << e2 << " evaluates to " << v2
-                            << "\n" << e3 << " evaluates to " << v3
-                            << "\n" << e4 << " evaluates to " << v4
-                            << "\n" << e5 << " evaluates to " << v5;
+  return AssertPred5Failure(pred_text, e1, e2, e3, e4, e5, v1, v2, v3, v4, v5);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT5.
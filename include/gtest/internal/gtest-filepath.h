@@ -58,21 +58,13 @@ namespace internal {
 
 class GTEST_API_ FilePath {
  public:
+  // FilePath relies on the implicitly declared copy (and, with a C++11
+  // compiler, move) operations.
   FilePath() : pathname_("") { }
-  FilePath(const FilePath& rhs) : pathname_(rhs.pathname_) { }
 
-  explicit FilePath(const char* pathname) : pathname_(pathname) {
-    Normalize();
-  }
-
-  explicit FilePath(const String& pathname) : pathname_(pathname) {
-    Normalize();
-  }
-
-  FilePath& operator=(const FilePath& rhs) {
-    Set(rhs);
-    return *this;
-  }
+  // Creates a FilePath from a C string, a String, an ::std::string, or
+  // a part of any of them.  A NULL C string results in "".
+  explicit FilePath(StringPiece pathname) { Normalize(pathname); }
 
   void Set(const FilePath& rhs) {
     pathname_ = rhs.pathname_;
@@ -173,10 +165,18 @@ class GTEST_API_ FilePath {
   // Returns true if pathname describes an absolute path.
   bool IsAbsolutePath() const;
 
+  // Replaces the contents of the file with the size bytes at data,
+  // creating the file if it doesn't exist.  The bytes are first written
+  // to a temporary file in the same directory, which is then renamed
+  // over the file, so a reader sees either the old or the new contents
+  // but never a partially written file.  Returns true if successful.
+  bool WriteFileAtomically(const void* data, size_t size) const;
+
  private:
-  // Replaces multiple consecutive separators with a single separator.
-  // For example, "bar///foo" becomes "bar/foo". Does not eliminate other
-  // redundancies that might be in a pathname involving "." or "..".
+  // Sets pathname_ to pathname, replacing multiple consecutive
+  // separators with a single separator.  For example, "bar///foo"
+  // becomes "bar/foo". Does not eliminate other redundancies that
+  // might be in a pathname involving "." or "..".
   //
   // A pathname with multiple consecutive separators may occur either through
   // user error or as a result of some scripts or APIs that generate a pathname
@@ -194,7 +194,7 @@ class GTEST_API_ FilePath {
   // the primary path separator '\\', so that for example "bar\\/\\foo" becomes
   // "bar\\foo".
 
-  void Normalize();
+  void Normalize(StringPiece pathname);
 
   // Returns a pointer to the last occurence of a valid path separator in
   // the FilePath. On Windows, for example, both '/' and '\' are valid path
@@ -204,6 +204,36 @@ class GTEST_API_ FilePath {
   String pathname_;
 };  // class FilePath
 
+// MappedFile - gives read-only access to the contents of a file without
+// copying them into a buffer first.  The file is memory-mapped where the
+// platform supports it (and read into memory elsewhere), so that comparing
+// a large file against some data only touches the pages that are compared.
+class GTEST_API_ MappedFile {
+ public:
+  MappedFile() : data_(NULL), size_(0), mapping_(NULL), buffer_(NULL) {}
+  ~MappedFile() { Unmap(); }
+
+  // Maps the given file, releasing the previously mapped one if any.
+  // Returns false if the file can't be opened or mapped.
+  bool Map(const FilePath& path);
+
+  // Releases the mapped file, if any.
+  void Unmap();
+
+  // Returns the contents of the mapped file, or NULL if no file is
+  // mapped.  An empty file has a non-NULL data() and a size() of 0.
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  const char* data_;
+  size_t size_;
+  void* mapping_;  // The address of the mapping, or NULL.
+  char* buffer_;   // The contents read into memory instead, or NULL.
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(MappedFile);
+};
+
 }  // namespace internal
 }  // namespace testing
 
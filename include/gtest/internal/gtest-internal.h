@@ -51,6 +51,7 @@
 #include <iomanip>
 #include <limits>
 #include <set>
+#include <vector>
 
 #include "gtest/internal/gtest-string.h"
 #include "gtest/internal/gtest-filepath.h"
@@ -118,6 +119,7 @@ namespace internal {
 
 struct TraceInfo;                      // Information about a trace point.
 class ScopedTrace;                     // Implements scoped trace.
+class LazyScopedTrace;                 // Implements lazy scoped trace.
 class TestInfoImpl;                    // Opaque implementation of TestInfo
 class UnitTestImpl;                    // Opaque implementation of UnitTest
 
@@ -185,6 +187,45 @@ class GTEST_API_ ScopedTrace {
                             // c'tor and d'tor.  Therefore it doesn't
                             // need to be used otherwise.
 
+// A helper class that implements SCOPED_TRACE_LAZY().  Unlike
+// ScopedTrace, it doesn't format the traced value when it's created.
+// Instead it remembers a reference to the value, and the value is
+// streamed to the failure message only when a failure actually occurs
+// in its scope.
+class GTEST_API_ LazyScopedTrace {
+ public:
+  // The c'tor pushes the given source file location and a reference to
+  // the given value onto a trace stack maintained by Google Test.  The
+  // value must outlive this object.  It's taken by non-const reference
+  // so that passing a temporary doesn't compile.
+  template <typename T>
+  LazyScopedTrace(const char* file, int line, T& value)
+      : value_(&value), append_value_(&AppendValue<T>) {
+    Push(file, line);
+  }
+
+  // The d'tor pops the info pushed by the c'tor.
+  ~LazyScopedTrace();
+
+  // Streams the current value of the traced object to the given message.
+  void AppendValueTo(Message* msg) const { append_value_(value_, msg); }
+
+ private:
+  // Streams *static_cast<const T*>(value) to msg.
+  template <typename T>
+  static void AppendValue(const void* value, Message* msg) {
+    *msg << *static_cast<const T*>(value);
+  }
+
+  // Pushes this trace onto the trace stack.
+  void Push(const char* file, int line);
+
+  const void* const value_;
+  void (* const append_value_)(const void* value, Message* msg);
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(LazyScopedTrace);
+} GTEST_ATTRIBUTE_UNUSED_;
+
 // Converts a streamable value to a String.  A NULL pointer is
 // converted to "(null)".  When the input value is a ::string,
 // ::std::string, ::wstring, or ::std::wstring object, each NUL
@@ -275,14 +316,57 @@ GTEST_API_ AssertionResult EqFailure(const char* expected_expression,
                                      const char* actual_expression,
                                      const String& expected_value,
                                      const String& actual_value,
-                                     bool ignoring_case);
+                                     bool ignoring_case) GTEST_ATTRIBUTE_COLD_;
+
+// Utilities for showing where two values differ in the failure
+// message of an equality assertion.
+namespace edit_distance {
+
+// The steps of an edit script that turns one sequence into another.
+enum EditType { kMatch, kAdd, kRemove };
+
+// The default number of steps CalculateOptimalEdits() may take, which
+// keeps it to a few milliseconds on any input.
+const size_t kDefaultMaxDiffWork = 1 << 20;
+
+// Returns a shortest edit script that turns 'left' into 'right',
+// computed with Myers' O(ND) algorithm in linear space.  If that takes
+// more than about max_work steps, the regions that are still unsolved
+// are reported as removed and re-added instead: the script is then
+// valid but no longer the shortest.
+GTEST_API_ ::std::vector<EditType> CalculateOptimalEdits(
+    const ::std::vector<size_t>& left,
+    const ::std::vector<size_t>& right,
+    size_t max_work = kDefaultMaxDiffWork);
+
+// Returns the differences between 'left' and 'right' in unified diff
+// format: hunks of changed lines, each with up to 'context' unchanged
+// lines around it.  The first lines of 'left' and 'right' are numbered
+// first_line.  Long diffs are cut short.
+GTEST_API_ String CreateUnifiedDiff(
+    const ::std::vector< ::std::string>& left,
+    const ::std::vector< ::std::string>& right,
+    size_t context = 2,
+    size_t first_line = 1);
+
+}  // namespace edit_distance
+
+// Returns a unified diff of the lines of two strings compared by an
+// equality assertion, or an empty string if neither has more than one
+// line.  Wide strings are diffed in UTF-8.
+GTEST_API_ String DiffStrings(const ::std::string& expected,
+                              const ::std::string& actual);
+#if GTEST_HAS_STD_WSTRING
+GTEST_API_ String DiffStrings(const ::std::wstring& expected,
+                              const ::std::wstring& actual);
+#endif  // GTEST_HAS_STD_WSTRING
 
 // Constructs a failure message for Boolean assertions such as EXPECT_TRUE.
 GTEST_API_ String GetBoolAssertionFailureMessage(
     const AssertionResult& assertion_result,
     const char* expression_text,
     const char* actual_predicate_value,
-    const char* expected_predicate_value);
+    const char* expected_predicate_value) GTEST_ATTRIBUTE_COLD_;
 
 // This template class represents an IEEE floating-point number
 // (either single-precision or double-precision, depending on the
@@ -416,6 +500,25 @@ class FloatingPoint {
         <= kMaxUlps;
   }
 
+  // Returns true iff the numbers whose bits are lhs and rhs are both
+  // not NAN and at most max_ulps ULP's apart.  It is AlmostEquals()
+  // without short-circuiting, so that a loop calling it on arrays
+  // can be vectorized.
+  static bool BitsAlmostEqual(const Bits lhs, const Bits rhs,
+                              const Bits max_ulps) {
+    const bool lhs_is_nan = (lhs & ~kSignBitMask) > kExponentBitMask;
+    const bool rhs_is_nan = (rhs & ~kSignBitMask) > kExponentBitMask;
+    const bool close =
+        DistanceBetweenSignAndMagnitudeNumbers(lhs, rhs) <= max_ulps;
+    return !lhs_is_nan & !rhs_is_nan & close;
+  }
+
+  // Returns the number of ULP's between the numbers whose bits are lhs
+  // and rhs.  The result is meaningless if either is NAN.
+  static Bits DistanceInUlps(const Bits lhs, const Bits rhs) {
+    return DistanceBetweenSignAndMagnitudeNumbers(lhs, rhs);
+  }
+
  private:
   // The data type used to store the actual floating-point number.
   union FloatingPointUnion {
@@ -521,6 +624,50 @@ class TestFactoryBase {
   GTEST_DISALLOW_COPY_AND_ASSIGN_(TestFactoryBase);
 };
 
+// The heap usage of the process at some point in time, as counted by
+// a HeapProfilerInterface.
+struct HeapUsage {
+  HeapUsage() : live_bytes(0), peak_live_bytes(0), allocation_count(0) {}
+
+  // The number of bytes allocated and not yet freed.
+  Int64 live_bytes;
+  // The largest live_bytes since the peak was last reset.
+  Int64 peak_live_bytes;
+  // The number of allocations made so far.
+  Int64 allocation_count;
+};
+
+// The role interface for measuring the heap usage of each test.  Google
+// Test has no way to count allocations by itself; a library that hooks
+// the allocator (such as gtest_allocations) installs an implementation
+// with SetHeapProfiler().  The methods may be called from any thread.
+class HeapProfilerInterface {
+ public:
+  virtual ~HeapProfilerInterface() {}
+
+  // Returns the current heap usage of the process.
+  virtual HeapUsage GetHeapUsage() = 0;
+
+  // Restarts tracking the peak from the current live bytes.
+  virtual void ResetPeakLiveBytes() = 0;
+
+  // Stops and restarts counting the allocations of the calling thread.
+  // Blocks allocated in between are left out of the heap usage, even
+  // when they are freed later.  Google Test stops counting while it
+  // records test results, so that its own bookkeeping doesn't count as
+  // the test's.  The calls nest.
+  virtual void SuspendCounting() = 0;
+  virtual void ResumeCounting() = 0;
+};
+
+// Installs the profiler used to measure the heap usage of each test.
+// Google Test doesn't take ownership of it.  NULL disables measuring.
+// It's safe to call this during static initialization.
+GTEST_API_ void SetHeapProfiler(HeapProfilerInterface* profiler);
+
+// Returns the installed heap profiler, or NULL if there is none.
+GTEST_API_ HeapProfilerInterface* GetHeapProfiler();
+
 // This class provides implementation of TeastFactoryBase interface.
 // It is used in TEST and TEST_F macros.
 template <class TestClass>
@@ -949,6 +1096,24 @@ IsNotContainer IsContainerTest(long /* dummy */) { return '\0'; }
 template<bool> struct EnableIf;
 template<> struct EnableIf<true> { typedef void type; };  // NOLINT
 
+#if GTEST_LANG_CXX11
+
+// MakeIndexSequence<N>::type is IndexSequence<0, 1, ..., N - 1>.  A
+// variadic template uses it to expand an expression once for each
+// element of a tuple.  It stands in for C++14's std::index_sequence.
+template <size_t... Is>
+struct IndexSequence {};
+
+template <size_t N, size_t... Is>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Is...> {};
+
+template <size_t... Is>
+struct MakeIndexSequence<0, Is...> {
+  typedef IndexSequence<Is...> type;
+};
+
+#endif  // GTEST_LANG_CXX11
+
 // Utilities for native arrays.
 
 // ArrayEq() compares two k-dimensional native arrays using the
@@ -36,9 +36,11 @@
 // Type and function utilities for implementing parameterized tests.
 // This file is generated by a SCRIPT.  DO NOT EDIT BY HAND!
 //
-// Currently Google Test supports at most 50 arguments in Values,
-// and at most 10 arguments in Combine. Please contact
-// googletestframework@googlegroups.com if you need more.
+// When the compiler supports C++11 variadic templates, Values() takes
+// any number of arguments, and so does Combine() unless Google Test
+// uses its own tr1::tuple.  Otherwise Google Test supports at most 50
+// arguments in Values, and at most 10 arguments in Combine. Please
+// contact googletestframework@googlegroups.com if you need more.
 // Please note that the number of arguments to Combine is limited
 // by the maximum arity of the implementation of tr1::tuple which is
 // currently set at 10.
@@ -52,6 +54,11 @@
 #include "gtest/internal/gtest-param-util.h"
 #include "gtest/internal/gtest-port.h"
 
+#if GTEST_LANG_CXX11
+# include <tuple>
+# include <type_traits>
+#endif  // GTEST_LANG_CXX11
+
 #if GTEST_HAS_PARAM_TEST
 
 namespace testing {
@@ -72,6 +79,37 @@ internal::ParamGenerator<typename Container::value_type> ValuesIn(
 
 namespace internal {
 
+# if GTEST_LANG_CXX11
+
+// Used in the Values() function to provide polymorphic capabilities.
+// It holds any number of values, and converts to a generator of any
+// type that all of them implicitly convert to.
+template <typename... Ts>
+class ValueArray {
+ public:
+  explicit ValueArray(Ts... v) : v_(v...) {}
+
+  template <typename T>
+  operator ParamGenerator<T>() const {
+    return MakeGenerator<T>(
+        typename MakeIndexSequence<sizeof...(Ts)>::type());
+  }
+
+ private:
+  template <typename T, size_t... Is>
+  ParamGenerator<T> MakeGenerator(IndexSequence<Is...>) const {
+    const T array[] = {ImplicitCast_<T>(::std::get<Is>(v_))...};
+    return ValuesIn(array);
+  }
+
+  // No implementation - assignment is unsupported.
+  void operator=(const ValueArray& other);
+
+  const ::std::tuple<Ts...> v_;
+};
+
+# else  // !GTEST_LANG_CXX11
+
 // Used in the Values() function to provide polymorphic capabilities.
 template <typename T1>
 class ValueArray1 {
@@ -2828,7 +2866,181 @@ class ValueArray50 {
   const T50 v50_;
 };
 
+# endif  // GTEST_LANG_CXX11
+
 # if GTEST_HAS_COMBINE
+#  if GTEST_HAS_VARIADIC_COMBINE_
+// INTERNAL IMPLEMENTATION - DO NOT USE IN USER CODE.
+//
+// Generates values from the Cartesian product of values produced
+// by the argument generators.
+//
+template <typename... Ts>
+class CartesianProductGenerator
+    : public ParamGeneratorInterface< ::std::tr1::tuple<Ts...> > {
+ public:
+  typedef ::std::tr1::tuple<Ts...> ParamType;
+  typedef ::std::tuple<ParamGenerator<Ts>...> GeneratorTuple;
+
+  explicit CartesianProductGenerator(const GeneratorTuple& generators)
+      : generators_(generators) {}
+  virtual ~CartesianProductGenerator() {}
+
+  virtual ParamIteratorInterface<ParamType>* Begin() const {
+    return new Iterator(this, generators_, false);
+  }
+  virtual ParamIteratorInterface<ParamType>* End() const {
+    return new Iterator(this, generators_, true);
+  }
+
+ private:
+  typedef typename MakeIndexSequence<sizeof...(Ts)>::type Indices;
+  typedef ::std::tuple<typename ParamGenerator<Ts>::iterator...>
+      IteratorTuple;
+
+  class Iterator : public ParamIteratorInterface<ParamType> {
+   public:
+    // Creates an iterator at the beginning of the product, or past its
+    // end if is_end is true.
+    Iterator(const ParamGeneratorInterface<ParamType>* base,
+             const GeneratorTuple& generators, bool is_end)
+        : base_(base),
+          begin_(Begins(generators, Indices())),
+          end_(Ends(generators, Indices())),
+          current_(is_end ? end_ : begin_) {
+      ComputeCurrentValue(Indices());
+    }
+    virtual ~Iterator() {}
+
+    virtual const ParamGeneratorInterface<ParamType>* BaseGenerator() const {
+      return base_;
+    }
+    // Advance should not be called on beyond-of-range iterators
+    // so no component iterators must be beyond end of range, either.
+    virtual void Advance() {
+      assert(!AtEnd());
+      ++::std::get<sizeof...(Ts) - 1>(current_);
+      Carry(::std::integral_constant<size_t, sizeof...(Ts) - 1>());
+      ComputeCurrentValue(Indices());
+    }
+    virtual ParamIteratorInterface<ParamType>* Clone() const {
+      return new Iterator(*this);
+    }
+    virtual const ParamType* Current() const { return &current_value_; }
+    virtual bool Equals(const ParamIteratorInterface<ParamType>& other) const {
+      // Having the same base generator guarantees that the other
+      // iterator is of the same type and we can downcast.
+      GTEST_CHECK_(BaseGenerator() == other.BaseGenerator())
+          << "The program attempted to compare iterators "
+          << "from different generators." << std::endl;
+      const Iterator* typed_other =
+          CheckedDowncastToActualType<const Iterator>(&other);
+      // We must report iterators equal if they both point beyond their
+      // respective ranges. That can happen in a variety of fashions,
+      // so we have to consult AtEnd().
+      return (AtEnd() && typed_other->AtEnd()) ||
+          current_ == typed_other->current_;
+    }
+
+   private:
+    template <size_t... Is>
+    static IteratorTuple Begins(const GeneratorTuple& generators,
+                                IndexSequence<Is...>) {
+      return IteratorTuple(::std::get<Is>(generators).begin()...);
+    }
+    template <size_t... Is>
+    static IteratorTuple Ends(const GeneratorTuple& generators,
+                              IndexSequence<Is...>) {
+      return IteratorTuple(::std::get<Is>(generators).end()...);
+    }
+
+    // If the I-th component iterator has reached the end of its range,
+    // rewinds it and advances the component before it.  Then does the
+    // same for that component, and so on down to the second one.
+    template <size_t I>
+    void Carry(::std::integral_constant<size_t, I>) {
+      if (::std::get<I>(current_) == ::std::get<I>(end_)) {
+        ::std::get<I>(current_) = ::std::get<I>(begin_);
+        ++::std::get<I - 1>(current_);
+      }
+      Carry(::std::integral_constant<size_t, I - 1>());
+    }
+    void Carry(::std::integral_constant<size_t, 0>) {}
+
+    template <size_t... Is>
+    void ComputeCurrentValue(IndexSequence<Is...>) {
+      if (!AtEnd())
+        current_value_ = ParamType(*::std::get<Is>(current_)...);
+    }
+    bool AtEnd() const {
+      // We must report iterator past the end of the range when either of the
+      // component iterators has reached the end of its range.
+      return AnyAtEnd(Indices());
+    }
+    template <size_t... Is>
+    bool AnyAtEnd(IndexSequence<Is...>) const {
+      const bool at_end[] = {
+        (::std::get<Is>(current_) == ::std::get<Is>(end_))...
+      };
+      for (size_t i = 0; i != sizeof...(Is); ++i) {
+        if (at_end[i])
+          return true;
+      }
+      return false;
+    }
+
+    // No implementation - assignment is unsupported.
+    void operator=(const Iterator& other);
+
+    const ParamGeneratorInterface<ParamType>* const base_;
+    // begin_ and end_ hold the ranges that Iterator traverses, one per
+    // generator.  current_ holds the actual traversing iterators.
+    const IteratorTuple begin_;
+    const IteratorTuple end_;
+    IteratorTuple current_;
+    ParamType current_value_;
+  };  // class CartesianProductGenerator::Iterator
+
+  // No implementation - assignment is unsupported.
+  void operator=(const CartesianProductGenerator& other);
+
+  const GeneratorTuple generators_;
+};  // class CartesianProductGenerator
+
+// INTERNAL IMPLEMENTATION - DO NOT USE IN USER CODE.
+//
+// Helper class providing Combine() with polymorphic features. It allows
+// casting CartesianProductGenerator<T...> to ParamGenerator<U...> if
+// each T is convertible to the matching U.
+//
+template <class... Generators>
+class CartesianProductHolder {
+ public:
+  explicit CartesianProductHolder(const Generators&... g)
+      : generators_(g...) {}
+
+  template <typename... Ts>
+  operator ParamGenerator< ::std::tr1::tuple<Ts...> >() const {
+    return ParamGenerator< ::std::tr1::tuple<Ts...> >(
+        new CartesianProductGenerator<Ts...>(ConvertGenerators<Ts...>(
+            typename MakeIndexSequence<sizeof...(Ts)>::type())));
+  }
+
+ private:
+  template <typename... Ts, size_t... Is>
+  ::std::tuple<ParamGenerator<Ts>...> ConvertGenerators(
+      IndexSequence<Is...>) const {
+    return ::std::tuple<ParamGenerator<Ts>...>(
+        static_cast<ParamGenerator<Ts> >(::std::get<Is>(generators_))...);
+  }
+
+  // No implementation - assignment is unsupported.
+  void operator=(const CartesianProductHolder& other);
+
+  const ::std::tuple<Generators...> generators_;
+};  // class CartesianProductHolder
+
+#  else  // !GTEST_HAS_VARIADIC_COMBINE_
 // INTERNAL IMPLEMENTATION - DO NOT USE IN USER CODE.
 //
 // Generates values from the Cartesian product of values produced
@@ -4812,6 +5024,7 @@ CartesianProductHolder10(const Generator1& g1, const Generator2& g2,
   const Generator10 g10_;
 };  // class CartesianProductHolder10
 
+#  endif  // GTEST_HAS_VARIADIC_COMBINE_
 # endif  // GTEST_HAS_COMBINE
 
 }  // namespace internal
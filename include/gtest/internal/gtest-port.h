@@ -42,6 +42,9 @@
 //
 //   GTEST_HAS_CLONE          - Define it to 1/0 to indicate that clone(2)
 //                              is/isn't available.
+//   GTEST_HAS_COMPILER_TLS   - Define it to 1/0 to indicate that the
+//                              compiler's __thread storage class can/can't
+//                              be used to speed up ThreadLocal.
 //   GTEST_HAS_EXCEPTIONS     - Define it to 1/0 to indicate that exceptions
 //                              are enabled.
 //   GTEST_HAS_GLOBAL_STRING  - Define it to 1/0 to indicate that ::string
@@ -59,6 +62,10 @@
 //   GTEST_HAS_STD_WSTRING    - Define it to 1/0 to indicate that
 //                              std::wstring does/doesn't work (Google Test can
 //                              be used where std::wstring is unavailable).
+//   GTEST_LANG_CXX11         - Define it to 1/0 to indicate that the compiler
+//                              does/doesn't support the C++11 language
+//                              features Google Test can take advantage of
+//                              (rvalue references, variadic templates).
 //   GTEST_HAS_TR1_TUPLE      - Define it to 1/0 to indicate tr1::tuple
 //                              is/isn't available.
 //   GTEST_HAS_SEH            - Define it to 1/0 to indicate whether the
@@ -127,6 +134,7 @@
 //
 // Macros for basic C++ coding:
 //   GTEST_AMBIGUOUS_ELSE_BLOCKER_ - for disabling a gcc warning.
+//   GTEST_ATTRIBUTE_COLD_    - declares that a function is rarely called.
 //   GTEST_ATTRIBUTE_UNUSED_  - declares that a class' instances or a
 //                              variable don't have to be used.
 //   GTEST_DISALLOW_ASSIGN_   - disables operator=.
@@ -213,6 +221,17 @@
     (__GNUC__*10000 + __GNUC_MINOR__*100 + __GNUC_PATCHLEVEL__)
 #endif  // __GNUC__
 
+// Determines whether the compiler supports C++11.  gcc and clang define
+// __GXX_EXPERIMENTAL_CXX0X__ when -std={c,gnu}++0x or ++11 is passed;
+// compilers implementing the C++11 standard set __cplusplus accordingly.
+#ifndef GTEST_LANG_CXX11
+# if __GXX_EXPERIMENTAL_CXX0X__ || __cplusplus >= 201103L
+#  define GTEST_LANG_CXX11 1
+# else
+#  define GTEST_LANG_CXX11 0
+# endif
+#endif  // GTEST_LANG_CXX11
+
 // Determines the platform on which Google Test is compiled.
 #ifdef __CYGWIN__
 # define GTEST_OS_CYGWIN 1
@@ -436,6 +455,18 @@
 # include <time.h>  // NOLINT
 #endif
 
+// Determines whether ThreadLocal can cache its per-thread values in
+// compiler-provided thread-local storage (the __thread storage class).
+#ifndef GTEST_HAS_COMPILER_TLS
+// gcc and clang support __thread on Linux.  We don't enable it elsewhere
+// as some toolchains (e.g. older Xcode) reject or emulate it.
+# if GTEST_HAS_PTHREAD && GTEST_OS_LINUX && defined(__GNUC__)
+#  define GTEST_HAS_COMPILER_TLS 1
+# else
+#  define GTEST_HAS_COMPILER_TLS 0
+# endif
+#endif  // GTEST_HAS_COMPILER_TLS
+
 // Determines whether Google Test can use tr1/tuple.  You can define
 // this macro to 0 to prevent Google Test from using tuple (any
 // feature depending on tuple with be disabled in this mode).
@@ -577,6 +608,13 @@
 # define GTEST_HAS_COMBINE 1
 #endif
 
+// Determines whether Combine() is implemented with variadic templates,
+// which lifts its limit on the number of generators.  That needs a
+// tr1::tuple that is variadic itself, which Google Test's own isn't.
+#if GTEST_HAS_COMBINE && GTEST_LANG_CXX11 && !GTEST_USE_OWN_TR1_TUPLE
+# define GTEST_HAS_VARIADIC_COMBINE_ 1
+#endif
+
 // Determines whether the system compiler uses UTF-16 for encoding wide strings.
 #define GTEST_WIDE_STRING_USES_UTF16_ \
     (GTEST_OS_WINDOWS || GTEST_OS_CYGWIN || GTEST_OS_SYMBIAN || GTEST_OS_AIX)
@@ -678,6 +716,18 @@
 # define GTEST_NO_INLINE_
 #endif
 
+// Tells the compiler that a function is rarely called, e.g. because
+// it only runs when an assertion fails.  The compiler then optimizes
+// the function for size and moves the branches that call it out of
+// the way of the code around them.
+#if defined(__clang__) || \
+    (defined(__GNUC__) && (__GNUC__ > 4 || \
+                           (__GNUC__ == 4 && __GNUC_MINOR__ >= 3)))
+# define GTEST_ATTRIBUTE_COLD_ __attribute__((cold))
+#else
+# define GTEST_ATTRIBUTE_COLD_
+#endif
+
 namespace testing {
 
 class Message;
@@ -1089,30 +1139,104 @@ inline void SleepMilliseconds(int n) {
 // threads until notified.  Instances of this class must be created
 // and destroyed in the controller thread.
 //
+// Waiting threads block on a condition variable, so they all wake up
+// as soon as Notify() is called.
+//
 // This class is only for testing Google Test's own constructs. Do not
 // use it in user tests, either directly or indirectly.
 class Notification {
  public:
-  Notification() : notified_(false) {}
+  Notification() : notified_(false) {
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_init(&mutex_, NULL));
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_init(&cond_, NULL));
+  }
+  ~Notification() {
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_destroy(&cond_));
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_destroy(&mutex_));
+  }
 
   // Notifies all threads created with this notification to start. Must
   // be called from the controller thread.
-  void Notify() { notified_ = true; }
+  void Notify() {
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_lock(&mutex_));
+    notified_ = true;
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_broadcast(&cond_));
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_unlock(&mutex_));
+  }
 
   // Blocks until the controller thread notifies. Must be called from a test
   // thread.
   void WaitForNotification() {
-    while(!notified_) {
-      SleepMilliseconds(10);
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_lock(&mutex_));
+    while (!notified_) {
+      GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_wait(&cond_, &mutex_));
     }
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_unlock(&mutex_));
   }
 
  private:
-  volatile bool notified_;
+  pthread_mutex_t mutex_;  // Protects notified_.
+  pthread_cond_t cond_;  // Signaled when notified_ becomes true.
+  bool notified_;
 
   GTEST_DISALLOW_COPY_AND_ASSIGN_(Notification);
 };
 
+// Blocks each of a fixed number of threads until all of them have
+// called Wait(), then releases them together.  A Barrier can be reused:
+// once a group of threads has been released, the next group starts
+// waiting.
+//
+// This class is only for testing Google Test's own constructs. Do not
+// use it in user tests, either directly or indirectly.
+class Barrier {
+ public:
+  // Creates a barrier for the given number of threads (which must be
+  // positive).
+  explicit Barrier(int thread_count)
+      : thread_count_(thread_count), waiting_count_(0), generation_(0) {
+    GTEST_CHECK_(thread_count > 0)
+        << "A Barrier needs at least one thread, " << thread_count
+        << " given.";
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_init(&mutex_, NULL));
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_init(&cond_, NULL));
+  }
+  ~Barrier() {
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_destroy(&cond_));
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_destroy(&mutex_));
+  }
+
+  // Blocks until thread_count threads (including this one) are waiting,
+  // then releases them all.
+  void Wait() {
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_lock(&mutex_));
+    const unsigned int generation = generation_;
+    if (++waiting_count_ == thread_count_) {
+      // This is the last thread to arrive: starts a new generation and
+      // wakes up the others.
+      waiting_count_ = 0;
+      ++generation_;
+      GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_broadcast(&cond_));
+    } else {
+      // Waits for the generation to change, which guards against
+      // spurious wake-ups.
+      while (generation == generation_) {
+        GTEST_CHECK_POSIX_SUCCESS_(pthread_cond_wait(&cond_, &mutex_));
+      }
+    }
+    GTEST_CHECK_POSIX_SUCCESS_(pthread_mutex_unlock(&mutex_));
+  }
+
+ private:
+  const int thread_count_;
+  pthread_mutex_t mutex_;  // Protects the fields below.
+  pthread_cond_t cond_;  // Signaled when a generation is released.
+  int waiting_count_;  // The number of threads waiting in this generation.
+  unsigned int generation_;  // Incremented each time threads are released.
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(Barrier);
+};
+
 // As a C-function, ThreadFuncWithCLinkage cannot be templated itself.
 // Consequently, it cannot select a correct instantiation of ThreadWithParam
 // in order to call its Run(). Introducing ThreadWithParamBase as a
@@ -1297,6 +1421,41 @@ class ThreadLocalValueHolderBase {
   virtual ~ThreadLocalValueHolderBase() {}
 };
 
+#if GTEST_HAS_COMPILER_TLS
+
+// The number of ThreadLocal objects that can have their per-thread
+// values cached in compiler-provided TLS.  Google Test itself uses only
+// a few ThreadLocal objects; any beyond this limit fall back to
+// pthread_getspecific().
+const int kThreadLocalCacheSize = 32;
+
+// A thread's value holder for one ThreadLocal object.
+struct ThreadLocalCacheEntry {
+  ThreadLocalValueHolderBase* holder;
+  // The ID of the ThreadLocal that stored holder, or 0 if the entry is
+  // empty.
+  unsigned int owner_id;
+};
+
+// The calling thread's value holders, indexed by the cache index of the
+// ThreadLocal that owns them.  An entry is empty until the thread first
+// accesses that ThreadLocal, and is reset when the holder is deleted.
+extern __thread ThreadLocalCacheEntry
+    g_thread_local_cache[kThreadLocalCacheSize];
+
+// Returns a cache index for a new ThreadLocal object, reusing one
+// released by a dead ThreadLocal if possible, and sets *owner_id to a
+// new non-zero ID for the object.  A thread that outlives a ThreadLocal
+// may still hold an entry stored by it, so an entry is only used when
+// its owner ID matches.  An index >= kThreadLocalCacheSize means the
+// ThreadLocal isn't cached.
+GTEST_API_ int NewThreadLocalCacheIndex(unsigned int* owner_id);
+
+// Makes the given cache index available to new ThreadLocal objects.
+GTEST_API_ void ReleaseThreadLocalCacheIndex(int index);
+
+#endif  // GTEST_HAS_COMPILER_TLS
+
 // Called by pthread to delete thread-local data stored by
 // pthread_setspecific().
 extern "C" inline void DeleteThreadLocalValue(void* value_holder) {
@@ -1332,13 +1491,22 @@ extern "C" inline void DeleteThreadLocalValue(void* value_holder) {
 // will die after main() has returned.  Therefore, no per-thread
 // object managed by Google Test will be leaked as long as all threads
 // using Google Test have exited when main() returns.
+//
+// When GTEST_HAS_COMPILER_TLS is 1, each thread also keeps a pointer to
+// its value in compiler-provided TLS, so that get() and pointer() don't
+// need to call pthread_getspecific().  The pthread key still owns the
+// values, so the rules above are unchanged.
 template <typename T>
 class ThreadLocal {
  public:
   ThreadLocal() : key_(CreateKey()),
-                  default_() {}
+                  default_() {
+    InitCacheIndex();
+  }
   explicit ThreadLocal(const T& value) : key_(CreateKey()),
-                                         default_(value) {}
+                                         default_(value) {
+    InitCacheIndex();
+  }
 
   ~ThreadLocal() {
     // Destroys the managed object for the current thread, if any.
@@ -1347,6 +1515,7 @@ class ThreadLocal {
     // Releases resources associated with the key.  This will *not*
     // delete managed objects for other threads.
     GTEST_CHECK_POSIX_SUCCESS_(pthread_key_delete(key_));
+    ReleaseCacheIndex();
   }
 
   T* pointer() { return GetOrCreateValue(); }
@@ -1358,12 +1527,27 @@ class ThreadLocal {
   // Holds a value of type T.
   class ValueHolder : public ThreadLocalValueHolderBase {
    public:
-    explicit ValueHolder(const T& value) : value_(value) {}
+    ValueHolder(const T& value, int cache_index)
+        : value_(value), cache_index_(cache_index) {}
+
+#if GTEST_HAS_COMPILER_TLS
+    // A holder is always deleted by the thread that owns it, either when
+    // the thread exits or when the ThreadLocal dies, so it can reset
+    // that thread's cache entry here.
+    virtual ~ValueHolder() {
+      if (cache_index_ < kThreadLocalCacheSize &&
+          g_thread_local_cache[cache_index_].holder == this) {
+        g_thread_local_cache[cache_index_].holder = NULL;
+        g_thread_local_cache[cache_index_].owner_id = 0;
+      }
+    }
+#endif  // GTEST_HAS_COMPILER_TLS
 
     T* pointer() { return &value_; }
 
    private:
     T value_;
+    const int cache_index_;
     GTEST_DISALLOW_COPY_AND_ASSIGN_(ValueHolder);
   };
 
@@ -1376,22 +1560,61 @@ class ThreadLocal {
     return key;
   }
 
+#if GTEST_HAS_COMPILER_TLS
+  void InitCacheIndex() { cache_index_ = NewThreadLocalCacheIndex(&id_); }
+  void ReleaseCacheIndex() { ReleaseThreadLocalCacheIndex(cache_index_); }
+
+  // Remembers the given holder as the calling thread's value.
+  void CacheValueHolder(ValueHolder* holder) const {
+    if (cache_index_ < kThreadLocalCacheSize) {
+      g_thread_local_cache[cache_index_].holder = holder;
+      g_thread_local_cache[cache_index_].owner_id = id_;
+    }
+  }
+
   T* GetOrCreateValue() const {
+    // Only this object stores holders under its ID, so the entry can be
+    // downcast without checking.
+    if (cache_index_ < kThreadLocalCacheSize &&
+        g_thread_local_cache[cache_index_].owner_id == id_) {
+      return static_cast<ValueHolder*>(
+          g_thread_local_cache[cache_index_].holder)->pointer();
+    }
+    return GetOrCreateValueSlow();
+  }
+#else
+  void InitCacheIndex() { cache_index_ = 0; id_ = 0; }
+  void ReleaseCacheIndex() {}
+  void CacheValueHolder(ValueHolder* /* holder */) const {}
+  T* GetOrCreateValue() const { return GetOrCreateValueSlow(); }
+#endif  // GTEST_HAS_COMPILER_TLS
+
+  // Looks up the calling thread's value with pthread_getspecific(),
+  // creating it if needed.
+  T* GetOrCreateValueSlow() const {
     ThreadLocalValueHolderBase* const holder =
         static_cast<ThreadLocalValueHolderBase*>(pthread_getspecific(key_));
     if (holder != NULL) {
-      return CheckedDowncastToActualType<ValueHolder>(holder)->pointer();
+      ValueHolder* const value_holder =
+          CheckedDowncastToActualType<ValueHolder>(holder);
+      CacheValueHolder(value_holder);
+      return value_holder->pointer();
     }
 
-    ValueHolder* const new_holder = new ValueHolder(default_);
+    ValueHolder* const new_holder = new ValueHolder(default_, cache_index_);
     ThreadLocalValueHolderBase* const holder_base = new_holder;
     GTEST_CHECK_POSIX_SUCCESS_(pthread_setspecific(key_, holder_base));
+    CacheValueHolder(new_holder);
     return new_holder->pointer();
   }
 
   // A key pthreads uses for looking up per-thread values.
   const pthread_key_t key_;
   const T default_;  // The default value for each thread.
+  // This object's index in g_thread_local_cache, and the ID that marks
+  // the entries it stores there.  Set once by the c'tor.
+  int cache_index_;
+  unsigned int id_;
 
   GTEST_DISALLOW_COPY_AND_ASSIGN_(ThreadLocal);
 };
@@ -1446,6 +1669,189 @@ class ThreadLocal {
 // we cannot detect it.
 GTEST_API_ size_t GetThreadCount();
 
+// AtomicIncrement() and AtomicDecrement() add one to and subtract one
+// from a counter that several threads may update at once, and return its
+// new value.  AtomicLoadCounter() reads such a counter.
+// AtomicLoadPointer() reads a pointer that another thread may publish
+// with AtomicCompareAndSwapPointer(), which sets *pointer to new_value
+// iff it equals old_value, and returns the value it had.  They are full
+// memory barriers.
+#if defined(__GNUC__)
+
+inline long AtomicIncrement(volatile long* counter) {
+  return __sync_add_and_fetch(counter, 1);
+}
+
+inline long AtomicDecrement(volatile long* counter) {
+  return __sync_sub_and_fetch(counter, 1);
+}
+
+inline long AtomicLoadCounter(const volatile long* counter) {
+  const long value = *counter;
+  __sync_synchronize();
+  return value;
+}
+
+template <typename T>
+inline T* AtomicLoadPointer(T* const volatile* pointer) {
+  T* const value = *pointer;
+  __sync_synchronize();
+  return value;
+}
+
+template <typename T>
+inline T* AtomicCompareAndSwapPointer(T* volatile* pointer, T* old_value,
+                                      T* new_value) {
+  return __sync_val_compare_and_swap(pointer, old_value, new_value);
+}
+
+#elif GTEST_OS_WINDOWS
+
+// These use the Interlocked functions.  They are defined in gtest-port.cc
+// so that this header doesn't need <windows.h>.
+GTEST_API_ long AtomicIncrement(volatile long* counter);
+GTEST_API_ long AtomicDecrement(volatile long* counter);
+GTEST_API_ long AtomicLoadCounter(const volatile long* counter);
+GTEST_API_ void* AtomicLoadVoidPointer(void* const volatile* pointer);
+GTEST_API_ void* AtomicCompareAndSwapVoidPointer(void* volatile* pointer,
+                                                 void* old_value,
+                                                 void* new_value);
+
+template <typename T>
+inline T* AtomicLoadPointer(T* const volatile* pointer) {
+  return static_cast<T*>(AtomicLoadVoidPointer(
+      reinterpret_cast<void* const volatile*>(pointer)));
+}
+
+template <typename T>
+inline T* AtomicCompareAndSwapPointer(T* volatile* pointer, T* old_value,
+                                      T* new_value) {
+  return static_cast<T*>(AtomicCompareAndSwapVoidPointer(
+      reinterpret_cast<void* volatile*>(pointer), old_value, new_value));
+}
+
+#else
+
+// Without atomic builtins, the counters and the pointers are accessed
+// under a mutex.
+GTEST_API_ GTEST_DECLARE_STATIC_MUTEX_(g_atomic_counter_mutex);
+
+inline long AtomicIncrement(volatile long* counter) {
+  MutexLock lock(&g_atomic_counter_mutex);
+  return ++*counter;
+}
+
+inline long AtomicDecrement(volatile long* counter) {
+  MutexLock lock(&g_atomic_counter_mutex);
+  return --*counter;
+}
+
+inline long AtomicLoadCounter(const volatile long* counter) {
+  MutexLock lock(&g_atomic_counter_mutex);
+  return *counter;
+}
+
+template <typename T>
+inline T* AtomicLoadPointer(T* const volatile* pointer) {
+  MutexLock lock(&g_atomic_counter_mutex);
+  return *pointer;
+}
+
+template <typename T>
+inline T* AtomicCompareAndSwapPointer(T* volatile* pointer, T* old_value,
+                                      T* new_value) {
+  MutexLock lock(&g_atomic_counter_mutex);
+  T* const value = *pointer;
+  if (value == old_value)
+    *pointer = new_value;
+  return value;
+}
+
+#endif  // defined(__GNUC__)
+
+// Defines refcounted_ptr.
+
+// A smart pointer that shares the ownership of an object among its
+// copies and deletes the object with the last of them.  Unlike
+// linked_ptr, which links the copies into a list under a single global
+// mutex, it keeps a reference count that it updates with
+// AtomicIncrement() and AtomicDecrement().  Threads copying pointers
+// therefore don't contend for a lock.  The count lives in an allocation
+// of its own.
+//
+// This implementation is PARTIAL - it only contains enough stuff to
+// satisfy Google Test's need.
+template <typename T>
+class refcounted_ptr {
+ public:
+  typedef T element_type;
+
+  explicit refcounted_ptr(T* ptr = NULL) : ptr_(ptr), count_(NewCount(ptr)) {}
+  refcounted_ptr(const refcounted_ptr& other)
+      : ptr_(other.ptr_), count_(other.count_) {
+    if (count_ != NULL)
+      AtomicIncrement(count_);
+  }
+  ~refcounted_ptr() { Release(); }
+
+  refcounted_ptr& operator=(const refcounted_ptr& other) {
+    // Taking the new reference first makes self-assignment safe.
+    if (other.count_ != NULL)
+      AtomicIncrement(other.count_);
+    Release();
+    ptr_ = other.ptr_;
+    count_ = other.count_;
+    return *this;
+  }
+
+  T& operator*() const { return *ptr_; }
+  T* operator->() const { return ptr_; }
+  T* get() const { return ptr_; }
+
+  void reset(T* ptr = NULL) { *this = refcounted_ptr(ptr); }
+
+  // Returns the number of refcounted_ptrs sharing the object, or 0 if
+  // this one is NULL.  Other threads may change it at any time.
+  long use_count() const {
+    return count_ == NULL ? 0 : AtomicLoadCounter(count_);
+  }
+
+ private:
+  // Allocates the reference count of the given object, or returns NULL
+  // if it is NULL.  If the allocation throws, the object is deleted, as
+  // the caller has already handed over its ownership.
+  static volatile long* NewCount(T* ptr) {
+    if (ptr == NULL)
+      return NULL;
+#if GTEST_HAS_EXCEPTIONS
+    try {
+      return new long(1);
+    } catch (...) {
+      if (IsTrue(sizeof(T) > 0)) {  // Makes sure T is a complete type.
+        delete ptr;
+      }
+      throw;
+    }
+#else
+    return new long(1);
+#endif  // GTEST_HAS_EXCEPTIONS
+  }
+
+  // Drops this pointer's reference, deleting the object if it was the
+  // last one.
+  void Release() {
+    if (count_ != NULL && AtomicDecrement(count_) == 0) {
+      delete count_;
+      if (IsTrue(sizeof(T) > 0)) {  // Makes sure T is a complete type.
+        delete ptr_;
+      }
+    }
+  }
+
+  T* ptr_;
+  volatile long* count_;
+};
+
 // Passing non-POD classes through ellipsis (...) crashes the ARM
 // compiler and generates a warning in Sun Studio.  The Nokia Symbian
 // and the IBM XL C/C++ compiler try to instantiate a copy constructor
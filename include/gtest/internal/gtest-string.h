@@ -76,6 +76,13 @@ namespace internal {
 // constructor and assignment operators such that we don't need
 // conditional compilation in a lot of places.
 //
+// Strings of up to kInlineCapacity chars are stored in the String
+// object itself, in the bytes that hold the length of a longer string,
+// so creating and copying them doesn't allocate.
+// Longer strings live on the heap; with a C++11 compiler, moving such
+// a String takes over its buffer instead of copying it.  Note that
+// either way, c_str() may change when a String is copied or moved.
+//
 // In order to make the representation efficient, the d'tor of String
 // is not virtual.  Therefore DO NOT INHERIT FROM String.
 class GTEST_API_ String {
@@ -181,21 +188,28 @@ class GTEST_API_ String {
   // We do not use the StringPrintf class as it is not universally
   // available.
   //
-  // The result is limited to 4096 characters (including the tailing
-  // 0).  If 4096 characters are not enough to format the input,
-  // "<buffer exceeded>" is returned.
+  // The result can be of any length: it's measured first and then
+  // allocated exactly once.  If the format spec is invalid,
+  // "<formatting error>" is returned.
   static String Format(const char* format, ...);
 
+  // Formats a list of arguments like Format() does, but appends the
+  // result to *output instead of creating a new String.  A caller
+  // that reuses the same ::std::string therefore stops allocating
+  // once it has grown large enough.  Returns false and leaves *output
+  // unchanged if the format spec is invalid.
+  static bool AppendFormat(::std::string* output, const char* format, ...);
+
   // C'tors
 
   // The default c'tor constructs a NULL string.
-  String() : c_str_(NULL), length_(0) {}
+  String() : c_str_(NULL), heap_length_(0) {}
 
   // Constructs a String by cloning a 0-terminated C string.
   String(const char* a_c_str) {  // NOLINT
     if (a_c_str == NULL) {
       c_str_ = NULL;
-      length_ = 0;
+      heap_length_ = 0;
     } else {
       ConstructNonNull(a_c_str, strlen(a_c_str));
     }
@@ -211,11 +225,19 @@ class GTEST_API_ String {
 
   // The copy c'tor creates a new copy of the string.  The two
   // String objects do not share content.
-  String(const String& str) : c_str_(NULL), length_(0) { *this = str; }
+  String(const String& str) : c_str_(NULL), heap_length_(0) { *this = str; }
+
+#if GTEST_LANG_CXX11
+  // The move c'tor takes over the content of str, leaving str NULL.
+  String(String&& str) noexcept  // NOLINT
+      : c_str_(NULL), heap_length_(0) {
+    MoveFrom(&str);
+  }
+#endif  // GTEST_LANG_CXX11
 
   // D'tor.  String is intended to be a final class, so the d'tor
   // doesn't need to be virtual.
-  ~String() { delete[] c_str_; }
+  ~String() { Deallocate(); }
 
   // Allows a String to be implicitly converted to an ::std::string or
   // ::string, and vice versa.  Converting a String containing a NULL
@@ -267,7 +289,11 @@ class GTEST_API_ String {
 
   // Returns the length of the encapsulated string, or 0 if the
   // string is NULL.
-  size_t length() const { return length_; }
+  size_t length() const {
+    return c_str_ == inline_buffer_ ?
+        static_cast<size_t>(kInlineCapacity - inline_buffer_[kInlineCapacity]) :
+        heap_length_;
+  }
 
   // Gets the 0-terminated C string this String object represents.
   // The String object still owns the string.  Therefore the caller
@@ -279,13 +305,24 @@ class GTEST_API_ String {
     return *this = String(a_c_str);
   }
 
+#if GTEST_LANG_CXX11
+  // Moves a String object into this object, leaving rhs NULL.
+  const String& operator=(String&& rhs) noexcept {  // NOLINT
+    if (this != &rhs) {
+      Deallocate();
+      MoveFrom(&rhs);
+    }
+    return *this;
+  }
+#endif  // GTEST_LANG_CXX11
+
   // Assigns a String object to this object.  Self-assignment works.
   const String& operator=(const String& rhs) {
     if (this != &rhs) {
-      delete[] c_str_;
+      Deallocate();
       if (rhs.c_str() == NULL) {
         c_str_ = NULL;
-        length_ = 0;
+        heap_length_ = 0;
       } else {
         ConstructNonNull(rhs.c_str(), rhs.length());
       }
@@ -295,22 +332,146 @@ class GTEST_API_ String {
   }
 
  private:
+  // The longest string that is stored in inline_buffer_ rather than
+  // on the heap.  It's enough for most test and test case names.
+  enum { kInlineCapacity = 15 };
+
+  // Makes this a non-NULL String of a_length chars with an
+  // uninitialized content, and returns the buffer to write the chars
+  // to.  The terminating NUL is already in place.  This function can
+  // only be called when c_str_ has not been allocated.
+  char* Allocate(size_t a_length) {
+    char* str;
+    if (a_length <= kInlineCapacity) {
+      str = inline_buffer_;
+      inline_buffer_[kInlineCapacity] =
+          static_cast<char>(kInlineCapacity - a_length);
+    } else {
+      str = new char[a_length + 1];
+      heap_length_ = a_length;
+    }
+    str[a_length] = '\0';
+    c_str_ = str;
+    return str;
+  }
+
+  // Frees the heap buffer, if there's one.  Leaves c_str_ dangling.
+  void Deallocate() {
+    if (c_str_ != inline_buffer_)
+      delete[] c_str_;
+  }
+
   // Constructs a non-NULL String from the given content.  This
   // function can only be called when c_str_ has not been allocated.
   // ConstructNonNull(NULL, 0) results in an empty string ("").
   // ConstructNonNull(NULL, non_zero) is undefined behavior.
   void ConstructNonNull(const char* buffer, size_t a_length) {
-    char* const str = new char[a_length + 1];
-    memcpy(str, buffer, a_length);
-    str[a_length] = '\0';
-    c_str_ = str;
-    length_ = a_length;
+    memcpy(Allocate(a_length), buffer, a_length);
+  }
+
+#if GTEST_LANG_CXX11
+  // Takes over the content of str, leaving str NULL.  Only a heap
+  // buffer can be taken over; an inline string is copied.  This
+  // function can only be called when c_str_ has not been allocated.
+  void MoveFrom(String* str) noexcept {
+    if (str->c_str_ == str->inline_buffer_) {
+      ConstructNonNull(str->c_str_, str->length());
+    } else {
+      c_str_ = str->c_str_;
+      heap_length_ = str->heap_length_;
+    }
+    str->c_str_ = NULL;
+    str->heap_length_ = 0;
   }
+#endif  // GTEST_LANG_CXX11
 
   const char* c_str_;
-  size_t length_;
+  union {
+    // The length of a NULL String (0), or of a String on the heap.
+    size_t heap_length_;
+    // The chars of an inline String.  Its last byte holds
+    // kInlineCapacity - length(), so that it doubles as the terminating
+    // NUL of a String of kInlineCapacity chars.
+    char inline_buffer_[kInlineCapacity + 1];
+  };
 };  // class String
 
+// A read-only view of a sequence of chars owned by someone else, such
+// as a C string, a String, or a part of either.  It's cheap to copy
+// and is meant to be passed by value to functions that only read a
+// string, so that their callers don't have to create a String for
+// the purpose.  The chars are NOT necessarily followed by a NUL.
+//
+// A StringPiece must not outlive the chars it refers to.
+//
+// INTERNAL IMPLEMENTATION - DO NOT USE IN A USER PROGRAM.
+class StringPiece {
+ public:
+  // Creates an empty view.
+  StringPiece() : data_(""), length_(0) {}
+
+  // Creates a view of a 0-terminated C string.  NULL is viewed as the
+  // empty string.
+  StringPiece(const char* c_str)  // NOLINT
+      : data_(c_str == NULL ? "" : c_str),
+        length_(c_str == NULL ? 0 : strlen(c_str)) {}
+
+  // Creates a view of a_length chars starting at data.
+  StringPiece(const char* data, size_t a_length)
+      : data_(data), length_(a_length) {}
+
+  // Creates a view of the content of a String.  A NULL String is
+  // viewed as the empty string.
+  StringPiece(const String& str)  // NOLINT
+      : data_(str.c_str() == NULL ? "" : str.c_str()),
+        length_(str.length()) {}
+
+  // Creates a view of the content of an ::std::string.
+  StringPiece(const ::std::string& str)  // NOLINT
+      : data_(str.data()), length_(str.length()) {}
+
+#if GTEST_HAS_GLOBAL_STRING
+  // Creates a view of the content of a ::string.
+  StringPiece(const ::string& str)  // NOLINT
+      : data_(str.data()), length_(str.length()) {}
+#endif  // GTEST_HAS_GLOBAL_STRING
+
+  const char* data() const { return data_; }
+  size_t length() const { return length_; }
+  bool empty() const { return length_ == 0; }
+
+  char operator[](size_t i) const { return data_[i]; }
+
+  // Returns a view of the chars after the first n ones.  n must not
+  // exceed length().
+  StringPiece RemovePrefix(size_t n) const {
+    return StringPiece(data_ + n, length_ - n);
+  }
+
+  // Returns a view of the first n chars.  n must not exceed length().
+  StringPiece Prefix(size_t n) const { return StringPiece(data_, n); }
+
+  // Returns true iff this view starts with the given prefix.
+  bool StartsWith(StringPiece prefix) const {
+    return length_ >= prefix.length_ &&
+        memcmp(data_, prefix.data_, prefix.length_) == 0;
+  }
+
+  // Returns true iff this view ends with the given suffix.
+  bool EndsWith(StringPiece suffix) const {
+    return length_ >= suffix.length_ &&
+        memcmp(data_ + length_ - suffix.length_, suffix.data_,
+               suffix.length_) == 0;
+  }
+
+  // Copies the viewed chars into a String.
+  String ToString() const { return String(data_, length_); }
+
+ private:
+  const char* data_;
+  size_t length_;
+};
+
 // Streams a String to an ostream.  Each '\0' character in the String
 // is replaced with "\\0".
 inline ::std::ostream& operator<<(::std::ostream& os, const String& str) {
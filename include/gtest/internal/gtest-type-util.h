@@ -36,10 +36,11 @@
 // Type utilities needed for implementing typed and type-parameterized
 // tests.  This file is generated by a SCRIPT.  DO NOT EDIT BY HAND!
 //
-// Currently we support at most 50 types in a list, and at most 50
-// type-parameterized tests in one type-parameterized test case.
-// Please contact googletestframework@googlegroups.com if you need
-// more.
+// There is no limit on the number of types in a list, or on the
+// number of type-parameterized tests in a type-parameterized test
+// case, when the compiler supports C++11 variadic templates.
+// Otherwise we support at most 50 of each.  Please contact
+// googletestframework@googlegroups.com if you need more.
 
 #ifndef GTEST_INCLUDE_GTEST_INTERNAL_GTEST_TYPE_UTIL_H_
 #define GTEST_INCLUDE_GTEST_INTERNAL_GTEST_TYPE_UTIL_H_
@@ -108,6 +109,108 @@ struct AssertTypeEq<T, T> {
 // support directly.
 struct None {};
 
+# define GTEST_TEMPLATE_ template <typename T> class
+
+// The template "selector" struct TemplateSel<Tmpl> is used to
+// represent Tmpl, which must be a class template with one type
+// parameter, as a type.  TemplateSel<Tmpl>::Bind<T>::type is defined
+// as the type Tmpl<T>.  This allows us to actually instantiate the
+// template "selected" by TemplateSel<Tmpl>.
+//
+// This trick is necessary for simulating typedef for class templates,
+// which C++ doesn't support directly.
+template <GTEST_TEMPLATE_ Tmpl>
+struct TemplateSel {
+  template <typename T>
+  struct Bind {
+    typedef Tmpl<T> type;
+  };
+};
+
+# define GTEST_BIND_(TmplSel, T) \
+  TmplSel::template Bind<T>::type
+
+// A unique struct template used as the default value for the
+// arguments of class template Templates.  This allows us to simulate
+// variadic templates (e.g. Templates<int>, Templates<int, double>,
+// and etc), which C++ doesn't support directly.
+template <typename T>
+struct NoneT {};
+
+// The empty type list.
+struct Types0 {};
+
+// The empty template list.
+struct Templates0 {};
+
+# if GTEST_LANG_CXX11
+
+// With variadic templates, a type list is TypeSequence<T1, T2, ..., TN>
+// (N >= 1), or Types0 when it's empty.  Like the TypesN family used
+// without them, TypeSequence has two member types: Head for the first
+// type in the list, and Tail for the rest of the list.  There is no
+// limit on the length of the list.
+template <typename T1, typename... Ts>
+struct TypeSequence;
+
+}  // namespace internal
+
+// Users write a type list as Types<T1, ..., TN>.  Its 'type' member is
+// the list's internal representation.
+template <typename... Ts>
+struct Types {
+  typedef internal::TypeSequence<Ts...> type;
+};
+
+template <>
+struct Types<> {
+  typedef internal::Types0 type;
+};
+
+namespace internal {
+
+template <typename T1, typename... Ts>
+struct TypeSequence {
+  typedef T1 Head;
+  typedef typename Types<Ts...>::type Tail;
+};
+
+// Template lists work the same way: TemplateSequence<T1, ..., TN>
+// (N >= 1) has the selector of T1 as its Head, and the list of the
+// rest of the templates as its Tail.
+template <GTEST_TEMPLATE_ T1, GTEST_TEMPLATE_... Ts>
+struct TemplateSequence;
+
+template <GTEST_TEMPLATE_... Ts>
+struct Templates {
+  typedef TemplateSequence<Ts...> type;
+};
+
+template <>
+struct Templates<> {
+  typedef Templates0 type;
+};
+
+template <GTEST_TEMPLATE_ T1, GTEST_TEMPLATE_... Ts>
+struct TemplateSequence {
+  typedef TemplateSel<T1> Head;
+  typedef typename Templates<Ts...>::type Tail;
+};
+
+// The TypeList template makes it possible to use either a single type
+// or a Types<...> list in TYPED_TEST_CASE() and
+// INSTANTIATE_TYPED_TEST_CASE_P().
+
+template <typename T>
+struct TypeList { typedef TypeSequence<T> type; };
+
+template <typename... Ts>
+struct TypeList<Types<Ts...> > {
+  typedef typename Types<Ts...>::type type;
+};
+
+# else  // !GTEST_LANG_CXX11
+
 // The following family of struct and struct templates are used to
 // represent type lists.  In particular, TypesN<T1, T2, ..., TN>
 // represents a type list with N types (T1, T2, ..., and TN) in it.
@@ -115,9 +218,6 @@ struct None {};
 // Head for the first type in the list, and Tail for the rest of the
 // list.
 
-// The empty type list.
-struct Types0 {};
-
 // Type lists of length 1, 2, 3, and so on.
 
 template <typename T1>
@@ -1620,34 +1720,6 @@ struct Types<T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13, T14, T15,
 
 namespace internal {
 
-# define GTEST_TEMPLATE_ template <typename T> class
-
-// The template "selector" struct TemplateSel<Tmpl> is used to
-// represent Tmpl, which must be a class template with one type
-// parameter, as a type.  TemplateSel<Tmpl>::Bind<T>::type is defined
-// as the type Tmpl<T>.  This allows us to actually instantiate the
-// template "selected" by TemplateSel<Tmpl>.
-//
-// This trick is necessary for simulating typedef for class templates,
-// which C++ doesn't support directly.
-template <GTEST_TEMPLATE_ Tmpl>
-struct TemplateSel {
-  template <typename T>
-  struct Bind {
-    typedef Tmpl<T> type;
-  };
-};
-
-# define GTEST_BIND_(TmplSel, T) \
-  TmplSel::template Bind<T>::type
-
-// A unique struct template used as the default value for the
-// arguments of class template Templates.  This allows us to simulate
-// variadic templates (e.g. Templates<int>, Templates<int, double>,
-// and etc), which C++ doesn't support directly.
-template <typename T>
-struct NoneT {};
-
 // The following family of struct and struct templates are used to
 // represent template lists.  In particular, TemplatesN<T1, T2, ...,
 // TN> represents a list of N templates (T1, T2, ..., and TN).  Except
@@ -1655,9 +1727,6 @@ struct NoneT {};
 // Head for the selector of the first template in the list, and Tail
 // for the rest of the list.
 
-// The empty template list.
-struct Templates0 {};
-
 // Template lists of length 1, 2, 3, and so on.
 
 template <GTEST_TEMPLATE_ T1>
@@ -3322,6 +3391,8 @@ struct TypeList<Types<T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13,
       T41, T42, T43, T44, T45, T46, T47, T48, T49, T50>::type type;
 };
 
+# endif  // GTEST_LANG_CXX11
+
 #endif  // GTEST_HAS_TYPED_TEST || GTEST_HAS_TYPED_TEST_P
 
 }  // namespace internal
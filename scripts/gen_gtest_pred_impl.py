@@ -216,6 +216,40 @@ def ImplementationForArity(n):
 
   impl = """
 
+// Builds the failure message of {EXPECT|ASSERT}_PRED%(n)s.  It is kept out
+// of line so that AssertPred%(n)sHelper() is just a call to the predicate
+// and a branch.  Don't use this in your code.
+template <""" % DEFS
+
+  impl += Iter(n, """typename T%s""", sep=""",
+          """)
+
+  impl += """>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult AssertPred%(n)sFailure(const char* pred_text""" % DEFS
+
+  impl += Iter(n, """,
+                                   const char* e%s""")
+
+  impl += Iter(n, """,
+                                   const T%s& v%s""")
+
+  impl += """) {
+"""
+
+  impl += '  return AssertionFailure() << pred_text << "("'
+
+  impl += Iter(n, """
+                            << e%s""", sep=' << ", "')
+
+  impl += ' << ") evaluates to false, where"'
+
+  impl += Iter(n, """
+                            << "\\n" << e%s << " evaluates to " << v%s""")
+
+  impl += """;
+}
+
 // Helper function for implementing {EXPECT|ASSERT}_PRED%(n)s.  Don't use
 // this in your code.
 template <typename Pred""" % DEFS
@@ -236,21 +270,17 @@ AssertionResult AssertPred%(n)sHelper(const char* pred_text""" % DEFS
                                   const T%s& v%s""")
 
   impl += """) {
-  if (pred(%(vs)s)) return AssertionSuccess();
-
-""" % DEFS
+  if (pred(%(vs)s)) return internal::InlineAssertionSuccess();
 
-  impl += '  return AssertionFailure() << pred_text << "("'
+  return AssertPred%(n)sFailure(pred_text, """ % DEFS
 
-  impl += Iter(n, """
-                            << e%s""", sep=' << ", "')
+  impl += Iter(n, 'e%s', sep=', ')
 
-  impl += ' << ") evaluates to false, where"'
+  impl += ', '
 
-  impl += Iter(n, """
-                            << "\\n" << e%s << " evaluates to " << v%s""")
+  impl += Iter(n, 'v%s', sep=', ')
 
-  impl += """;
+  impl += """);
 }
 
 // Internal macro for implementing {EXPECT|ASSERT}_PRED_FORMAT%(n)s.
@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+#
+# Copyright 2013, Google Inc.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     * Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#     * Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following disclaimer
+# in the documentation and/or other materials provided with the
+# distribution.
+#     * Neither the name of Google Inc. nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""measure_assertion_cost.py v0.1
+
+Measures how much Google Test's assertions cost to compile.
+
+Usage:
+
+  measure_assertion_cost.py [--cxx=COMPILER] [--flags=FLAGS]
+                            [--runs=N] [SOURCE_FILE]...
+
+For each source file (test/gtest_pred_impl_unittest.cc by default) the
+script compiles the file to an object file the given number of times
+(3 by default) and prints one comma-separated line with the fastest
+compile time in seconds, the object file size, and the size of its
+code, as reported by 'size'.  Run it before and after changing the
+assertion macros to see what the change costs or saves.
+"""
+
+import getopt
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Where this script is.
+SCRIPT_DIR = os.path.dirname(os.path.abspath(sys.argv[0]))
+
+# The root of the Google Test source tree.
+GTEST_ROOT = os.path.join(SCRIPT_DIR, '..')
+
+DEFAULT_SOURCES = [os.path.join(GTEST_ROOT, 'test',
+                                'gtest_pred_impl_unittest.cc')]
+
+
+def CompileOnce(cxx, flags, source, object_file):
+  """Compiles source into object_file and returns the elapsed seconds."""
+
+  command = ([cxx] + flags.split() +
+             ['-I' + os.path.join(GTEST_ROOT, 'include'), '-I' + GTEST_ROOT,
+              '-c', source, '-o', object_file])
+  start = time.time()
+  subprocess.check_call(command)
+  return time.time() - start
+
+
+def TextSize(object_file):
+  """Returns the size of the code in object_file, or -1 if unknown."""
+
+  try:
+    output = subprocess.Popen(['size', object_file],
+                              stdout=subprocess.PIPE).communicate()[0]
+    return int(output.decode().splitlines()[1].split()[0])
+  except (OSError, IndexError, ValueError):
+    return -1
+
+
+def main():
+  cxx = os.environ.get('CXX', 'c++')
+  flags = '-O2'
+  runs = 3
+  opts, sources = getopt.getopt(sys.argv[1:], '', ['cxx=', 'flags=', 'runs='])
+  for (opt, value) in opts:
+    if opt == '--cxx':
+      cxx = value
+    elif opt == '--flags':
+      flags = value
+    elif opt == '--runs':
+      runs = int(value)
+
+  object_file = os.path.join(tempfile.mkdtemp(), 'measured.o')
+  print('source,flags,compile_seconds,object_bytes,text_bytes')
+  for source in sources or DEFAULT_SOURCES:
+    seconds = min([CompileOnce(cxx, flags, source, object_file)
+                   for _ in range(runs)])
+    print('%s,%s,%.2f,%d,%d' % (os.path.basename(source), flags, seconds,
+                                os.path.getsize(object_file),
+                                TextSize(object_file)))
+    os.remove(object_file)
+  os.rmdir(os.path.dirname(object_file))
+
+
+if __name__ == '__main__':
+  main()
@@ -42,7 +42,9 @@
 #include "src/gtest.cc"
 #include "src/gtest-death-test.cc"
 #include "src/gtest-filepath.cc"
+#include "src/gtest-latency.cc"
 #include "src/gtest-port.cc"
 #include "src/gtest-printers.cc"
+#include "src/gtest-stress-test.cc"
 #include "src/gtest-test-part.cc"
 #include "src/gtest-typed-test.cc"
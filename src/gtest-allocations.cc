@@ -0,0 +1,539 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This file replaces the global operator new and operator delete with
+// versions that count, per thread, how many times operator new is
+// called, and implements the EXPECT_NO_HEAP_ALLOCATIONS() and
+// EXPECT_ALLOCATIONS_LE() assertions on top of that.  The replacement
+// also tracks the live bytes of the process, and installs a heap
+// profiler that lets Google Test report the heap usage of each test.
+// It is built into its own library, gtest_allocations, so that only the
+// tests that link with it pay for the replacement.
+
+#include "gtest/gtest-allocations.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "gtest/gtest.h"
+
+#if GTEST_OS_WINDOWS
+# include <windows.h>  // NOLINT
+#endif  // GTEST_OS_WINDOWS
+
+// backtrace() is available in glibc and on Mac OS X.
+#if (GTEST_OS_LINUX && defined(__GLIBC__)) || GTEST_OS_MAC
+# define GTEST_HAS_EXECINFO_ 1
+# include <cxxabi.h>
+# include <execinfo.h>
+#else
+# define GTEST_HAS_EXECINFO_ 0
+#endif  // (GTEST_OS_LINUX && defined(__GLIBC__)) || GTEST_OS_MAC
+
+#if GTEST_LANG_CXX11
+# define GTEST_THROWS_BAD_ALLOC_
+# define GTEST_THROWS_NOTHING_ noexcept
+#else
+# define GTEST_THROWS_BAD_ALLOC_ throw(std::bad_alloc)
+# define GTEST_THROWS_NOTHING_ throw()
+#endif  // GTEST_LANG_CXX11
+
+namespace testing {
+namespace internal {
+
+namespace {
+
+// How many allocations per counting scope have their call sites
+// remembered, and how many stack frames are kept for each.
+const int kMaxCallSites = 4;
+const int kMaxCallSiteFrames = 8;
+
+// The number of stack frames that belong to the replacement operator new
+// itself: AllocateAndCount() and operator new.
+const int kAllocatorFrames = 2;
+
+// True iff each thread has its own ThreadAllocationState.  Otherwise all
+// threads share one, whose counts are updated atomically, and which
+// doesn't record call sites.
+const bool kHasThreadAllocationState = GTEST_HAS_COMPILER_TLS != 0;
+
+struct AllocationCallSite {
+  Int64 serial;  // The allocation count of the thread before this one.
+  size_t size;
+  int frame_count;
+  void* frames[kMaxCallSiteFrames];
+};
+
+// The allocation state of a thread.  It's a POD so that it can live in
+// compiler-provided thread-local storage, which operator new can use
+// before and after the pthread key machinery is up.
+struct ThreadAllocationState {
+  volatile Int64 count;
+  int counting_depth;  // The number of active counting scopes.
+  // The number of SuspendCounting() calls not yet matched by a
+  // ResumeCounting().  While it's positive, the blocks the thread
+  // allocates are left out of the process-wide heap usage.
+  volatile Int64 suspension_depth;
+  bool in_hook;  // True while a call site is being recorded.
+  int call_site_count;
+  AllocationCallSite call_sites[kMaxCallSites];
+};
+
+// Each block starts with a header that holds its size, so that operator
+// delete knows how many bytes it frees, and whether it was counted in
+// the process-wide heap usage.  16 bytes keep the alignment that malloc()
+// guarantees on common platforms.  A block allocated with a larger
+// alignment also keeps, kBlockHeaderSize bytes before its header, the
+// address that malloc() returned.
+struct BlockHeader {
+  size_t size;
+  bool counted;
+};
+const size_t kBlockHeaderSize = 16;
+GTEST_COMPILE_ASSERT_(sizeof(BlockHeader) <= kBlockHeaderSize,
+                      block_header_must_fit_in_kBlockHeaderSize);
+
+// The heap usage of the whole process.
+volatile Int64 g_live_bytes = 0;
+volatile Int64 g_peak_live_bytes = 0;
+volatile Int64 g_allocation_count = 0;
+
+#if defined(__GNUC__)
+
+// Atomically adds delta to *value, and returns the new value.
+inline Int64 AtomicAdd(volatile Int64* value, Int64 delta) {
+  return __sync_add_and_fetch(value, delta);
+}
+
+// Atomically raises *value to candidate if it is lower.
+inline void AtomicRaiseTo(volatile Int64* value, Int64 candidate) {
+  Int64 current = *value;
+  while (candidate > current &&
+         !__sync_bool_compare_and_swap(value, current, candidate)) {
+    current = *value;
+  }
+}
+
+#elif GTEST_OS_WINDOWS
+
+inline Int64 AtomicAdd(volatile Int64* value, Int64 delta) {
+  return InterlockedExchangeAdd64(value, delta) + delta;
+}
+
+inline void AtomicRaiseTo(volatile Int64* value, Int64 candidate) {
+  Int64 current = *value;
+  while (candidate > current) {
+    const Int64 previous =
+        InterlockedCompareExchange64(value, candidate, current);
+    if (previous == current)
+      break;
+    current = previous;
+  }
+}
+
+#else
+
+// Without atomic builtins, the process-wide counts may be off when
+// several threads allocate at once.
+inline Int64 AtomicAdd(volatile Int64* value, Int64 delta) {
+  return *value += delta;
+}
+
+inline void AtomicRaiseTo(volatile Int64* value, Int64 candidate) {
+  if (candidate > *value)
+    *value = candidate;
+}
+
+#endif  // defined(__GNUC__)
+
+#if GTEST_HAS_COMPILER_TLS
+__thread ThreadAllocationState g_allocation_state;
+#else
+// Without compiler-provided TLS, all threads share one state.
+ThreadAllocationState g_allocation_state;
+#endif  // GTEST_HAS_COMPILER_TLS
+
+// Adds delta to a count of g_allocation_state, atomically if the state is
+// shared by all threads.
+inline void AddToAllocationState(volatile Int64* value, Int64 delta) {
+  if (kHasThreadAllocationState) {
+    *value += delta;
+  } else {
+    AtomicAdd(value, delta);
+  }
+}
+
+// Counts an allocation of the given size by the calling thread and, if
+// the thread is inside a counting scope, records where it comes from.
+// The block is aligned on the given alignment, or as malloc() aligns it
+// when alignment is 0.  Must not be inlined, as the call site is found
+// by skipping a fixed number of frames.
+#if GTEST_HAS_EXECINFO_
+__attribute__((noinline))
+#endif  // GTEST_HAS_EXECINFO_
+void* AllocateAndCount(size_t size, size_t alignment) {
+  ThreadAllocationState& state = g_allocation_state;
+  if (kHasThreadAllocationState && state.counting_depth > 0 &&
+      !state.in_hook && state.call_site_count < kMaxCallSites) {
+    // backtrace() may allocate the first time it's called.
+    state.in_hook = true;
+    AllocationCallSite& site = state.call_sites[state.call_site_count++];
+    site.serial = state.count;
+    site.size = size;
+#if GTEST_HAS_EXECINFO_
+    site.frame_count = backtrace(site.frames, kMaxCallSiteFrames);
+#else
+    site.frame_count = 0;
+#endif  // GTEST_HAS_EXECINFO_
+    state.in_hook = false;
+  }
+  AddToAllocationState(&state.count, 1);
+
+  const size_t overhead = alignment == 0 ? kBlockHeaderSize :
+      2 * kBlockHeaderSize + alignment;
+  if (size > static_cast<size_t>(-1) - overhead)
+    return NULL;
+  char* const block = static_cast<char*>(malloc(overhead + size));
+  if (block == NULL)
+    return NULL;
+  char* p = block + kBlockHeaderSize;
+  if (alignment != 0) {
+    const size_t address = reinterpret_cast<size_t>(block) +
+        2 * kBlockHeaderSize;
+    p = block + (address + alignment - 1) / alignment * alignment -
+        reinterpret_cast<size_t>(block);
+    *reinterpret_cast<char**>(p - 2 * kBlockHeaderSize) = block;
+  }
+  BlockHeader* const header =
+      reinterpret_cast<BlockHeader*>(p - kBlockHeaderSize);
+  header->size = size;
+  header->counted = state.suspension_depth == 0;
+  if (header->counted) {
+    AtomicAdd(&g_allocation_count, 1);
+    AtomicRaiseTo(&g_peak_live_bytes,
+                  AtomicAdd(&g_live_bytes, static_cast<Int64>(size)));
+  }
+  return p;
+}
+
+// Frees a block returned by AllocateAndCount(), which was allocated with
+// a specific alignment iff aligned is true.
+void FreeAndCount(void* p, bool aligned) {
+  if (p == NULL)
+    return;
+  char* const header_address = static_cast<char*>(p) - kBlockHeaderSize;
+  const BlockHeader* const header =
+      reinterpret_cast<BlockHeader*>(header_address);
+  if (header->counted)
+    AtomicAdd(&g_live_bytes, -static_cast<Int64>(header->size));
+  free(aligned ?
+       *reinterpret_cast<char**>(header_address - kBlockHeaderSize) :
+       header_address);
+}
+
+// Reports the heap usage tracked by the replacement operator new and
+// operator delete to Google Test.
+class AllocationHookHeapProfiler : public HeapProfilerInterface {
+ public:
+  virtual HeapUsage GetHeapUsage() {
+    HeapUsage usage;
+    usage.live_bytes = g_live_bytes;
+    usage.peak_live_bytes = g_peak_live_bytes;
+    usage.allocation_count = g_allocation_count;
+    return usage;
+  }
+
+  virtual void ResetPeakLiveBytes() {
+    g_peak_live_bytes = g_live_bytes;
+  }
+
+  virtual void SuspendCounting() {
+    AddToAllocationState(&g_allocation_state.suspension_depth, 1);
+  }
+
+  virtual void ResumeCounting() {
+    AddToAllocationState(&g_allocation_state.suspension_depth, -1);
+  }
+};
+
+AllocationHookHeapProfiler g_heap_profiler;
+
+// Installs g_heap_profiler when the program starts.  This happens as
+// long as this file is linked in, which replacing operator new ensures.
+class HeapProfilerInstaller {
+ public:
+  HeapProfilerInstaller() { SetHeapProfiler(&g_heap_profiler); }
+};
+
+HeapProfilerInstaller g_heap_profiler_installer;
+
+// Reports that memory is exhausted, the way the throwing forms of
+// operator new must.
+void ReportOutOfMemory() {
+#if GTEST_HAS_EXCEPTIONS
+  throw std::bad_alloc();
+#else
+  posix::Abort();
+#endif  // GTEST_HAS_EXCEPTIONS
+}
+
+#if GTEST_HAS_EXECINFO_
+
+// Given a line of backtrace_symbols() output, returns it with the
+// mangled function name in it demangled, when there is one.
+String DemangleSymbolLine(const char* line) {
+  const String symbol_line(line);
+  // glibc formats frames as "binary(_ZN3fooEv+0x1a) [0x4005d4]", Mac OS X
+  // as "3   binary   0x4005d4 _ZN3fooEv + 26".
+  const char* begin = strchr(line, '(');
+  const char* end = NULL;
+  if (begin != NULL) {
+    begin++;
+    end = strchr(begin, '+');
+  } else {
+    begin = strstr(line, " _Z");
+    if (begin == NULL)
+      return symbol_line;
+    begin++;
+    end = strchr(begin, ' ');
+  }
+  if (end == NULL || end == begin)
+    return symbol_line;
+
+  const String mangled(begin, end - begin);
+  int status = 0;
+  char* const demangled =
+      abi::__cxa_demangle(mangled.c_str(), NULL, NULL, &status);
+  if (status != 0 || demangled == NULL)
+    return symbol_line;
+
+  Message msg;
+  msg << String(line, begin - line) << demangled << end;
+  free(demangled);
+  return msg.GetString();
+}
+
+#endif  // GTEST_HAS_EXECINFO_
+
+}  // namespace
+
+// Returns the number of times the calling thread has called the global
+// operator new (in any of its forms) so far.  Where the compiler doesn't
+// provide thread-local storage, the count is shared by all threads.
+Int64 GetHeapAllocationCount() {
+  return g_allocation_state.count;
+}
+
+// Starts counting allocations on the calling thread, and remembers
+// where they come from.
+void HeapAllocationCheck::BeginCounting() {
+  ThreadAllocationState& state = g_allocation_state;
+  if (kHasThreadAllocationState) {
+    if (state.counting_depth == 0)
+      state.call_site_count = 0;
+    state.counting_depth++;
+  }
+  start_count_ = state.count;
+}
+
+// Stops counting allocations.
+void HeapAllocationCheck::EndCounting() {
+  ThreadAllocationState& state = g_allocation_state;
+  end_count_ = state.count;
+  if (kHasThreadAllocationState)
+    state.counting_depth--;
+}
+
+// Returns the failure message for the given statement, which lists the
+// call sites of the first allocations.
+String HeapAllocationCheck::FailureMessage(const char* statement) const {
+  const Int64 actual_count = end_count_ - start_count_;
+  Message msg;
+  msg << "Expected: " << statement;
+  if (max_count_ == 0) {
+    msg << " doesn't allocate on the heap.\n";
+  } else {
+    msg << " makes at most " << max_count_ << " heap allocation"
+        << (max_count_ == 1 ? "" : "s") << ".\n";
+  }
+  msg << "  Actual: it makes " << actual_count << ".";
+
+  const ThreadAllocationState& state = g_allocation_state;
+  int shown_count = 0;
+  for (int i = 0; i < state.call_site_count; i++) {
+    const AllocationCallSite& site = state.call_sites[i];
+    if (site.serial < start_count_ || site.serial >= end_count_)
+      continue;
+
+    shown_count++;
+    msg << "\nAllocation #" << (site.serial - start_count_ + 1) << " ("
+        << static_cast<Int64>(site.size) << " bytes)";
+#if GTEST_HAS_EXECINFO_
+    if (site.frame_count > kAllocatorFrames) {
+      msg << " at:";
+      char** const symbols = backtrace_symbols(
+          site.frames + kAllocatorFrames, site.frame_count - kAllocatorFrames);
+      for (int j = 0; symbols != NULL &&
+               j < site.frame_count - kAllocatorFrames; j++) {
+        msg << "\n  " << DemangleSymbolLine(symbols[j]);
+      }
+      free(symbols);
+      continue;
+    }
+#endif  // GTEST_HAS_EXECINFO_
+    msg << " (call site unavailable on this platform)";
+  }
+  if (actual_count > shown_count && shown_count > 0) {
+    msg << "\n(" << (actual_count - shown_count)
+        << " more allocation(s) not shown)";
+  }
+  return msg.GetString();
+}
+
+}  // namespace internal
+}  // namespace testing
+
+// The replacement global allocation functions.
+
+void* operator new(size_t size) GTEST_THROWS_BAD_ALLOC_ {
+  void* const p = testing::internal::AllocateAndCount(size, 0);
+  if (p == NULL)
+    testing::internal::ReportOutOfMemory();
+  return p;
+}
+
+void* operator new[](size_t size) GTEST_THROWS_BAD_ALLOC_ {
+  void* const p = testing::internal::AllocateAndCount(size, 0);
+  if (p == NULL)
+    testing::internal::ReportOutOfMemory();
+  return p;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  return testing::internal::AllocateAndCount(size, 0);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&)
+    GTEST_THROWS_NOTHING_ {
+  return testing::internal::AllocateAndCount(size, 0);
+}
+
+void operator delete(void* p) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+void operator delete[](void* p) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+void operator delete(void* p, const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+#ifdef __cpp_sized_deallocation
+
+void operator delete(void* p, size_t /* size */) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+void operator delete[](void* p, size_t /* size */) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, false);
+}
+
+#endif  // __cpp_sized_deallocation
+
+#ifdef __cpp_aligned_new
+
+// The forms that C++17 uses for types aligned beyond what malloc()
+// guarantees.
+
+void* operator new(size_t size, std::align_val_t alignment) {
+  void* const p = testing::internal::AllocateAndCount(
+      size, static_cast<size_t>(alignment));
+  if (p == NULL)
+    testing::internal::ReportOutOfMemory();
+  return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+  void* const p = testing::internal::AllocateAndCount(
+      size, static_cast<size_t>(alignment));
+  if (p == NULL)
+    testing::internal::ReportOutOfMemory();
+  return p;
+}
+
+void* operator new(size_t size, std::align_val_t alignment,
+                   const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  return testing::internal::AllocateAndCount(
+      size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  return testing::internal::AllocateAndCount(
+      size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* p, std::align_val_t) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+void operator delete[](void* p, std::align_val_t) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+void operator delete(void* p, std::align_val_t,
+                     const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+void operator delete[](void* p, std::align_val_t,
+                       const std::nothrow_t&) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+void operator delete(void* p, size_t /* size */,
+                     std::align_val_t) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+void operator delete[](void* p, size_t /* size */,
+                       std::align_val_t) GTEST_THROWS_NOTHING_ {
+  testing::internal::FreeAndCount(p, true);
+}
+
+#endif  // __cpp_aligned_new
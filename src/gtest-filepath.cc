@@ -32,6 +32,7 @@
 #include "gtest/internal/gtest-filepath.h"
 #include "gtest/internal/gtest-port.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #if GTEST_OS_WINDOWS_MOBILE
@@ -39,6 +40,7 @@
 #elif GTEST_OS_WINDOWS
 # include <direct.h>
 # include <io.h>
+# include <windows.h>  // For MapViewOfFile() and MoveFileEx().
 #elif GTEST_OS_SYMBIAN || GTEST_OS_NACL
 // Symbian OpenC and NaCl have PATH_MAX in sys/syslimits.h
 # include <sys/syslimits.h>
@@ -47,6 +49,11 @@
 # include <climits>  // Some Linux distributions define PATH_MAX here.
 #endif  // GTEST_OS_WINDOWS_MOBILE
 
+#if !GTEST_OS_WINDOWS
+# include <fcntl.h>
+# include <sys/mman.h>
+#endif  // !GTEST_OS_WINDOWS
+
 #if GTEST_OS_WINDOWS
 # define GTEST_PATH_MAX_ _MAX_PATH
 #elif defined(PATH_MAX)
@@ -116,9 +123,13 @@ FilePath FilePath::GetCurrentDir() {
 // FilePath("dir/file"). If a case-insensitive extension is not
 // found, returns a copy of the original FilePath.
 FilePath FilePath::RemoveExtension(const char* extension) const {
-  String dot_extension(String::Format(".%s", extension));
-  if (pathname_.EndsWithCaseInsensitive(dot_extension.c_str())) {
-    return FilePath(String(pathname_.c_str(), pathname_.length() - 4));
+  const size_t dot_extension_length = strlen(extension) + 1;
+  const size_t length = pathname_.length();
+  if (length >= dot_extension_length &&
+      pathname_.c_str()[length - dot_extension_length] == '.' &&
+      pathname_.EndsWithCaseInsensitive(extension)) {
+    return FilePath(StringPiece(pathname_).Prefix(
+        length - dot_extension_length));
   }
   return *this;
 }
@@ -147,7 +158,7 @@ const char* FilePath::FindLastPathSeparator() const {
 // On Windows platform, '\' is the path separator, otherwise it is '/'.
 FilePath FilePath::RemoveDirectoryName() const {
   const char* const last_sep = FindLastPathSeparator();
-  return last_sep ? FilePath(String(last_sep + 1)) : *this;
+  return last_sep ? FilePath(last_sep + 1) : *this;
 }
 
 // RemoveFileName returns the directory path with the filename removed.
@@ -158,13 +169,11 @@ FilePath FilePath::RemoveDirectoryName() const {
 // On Windows platform, '\' is the path separator, otherwise it is '/'.
 FilePath FilePath::RemoveFileName() const {
   const char* const last_sep = FindLastPathSeparator();
-  String dir;
   if (last_sep) {
-    dir = String(c_str(), last_sep + 1 - c_str());
+    return FilePath(StringPiece(c_str(), last_sep + 1 - c_str()));
   } else {
-    dir = kCurrentDirectoryString;
+    return FilePath(kCurrentDirectoryString);
   }
-  return FilePath(dir);
 }
 
 // Helper functions for naming files in a directory for xml output.
@@ -338,25 +347,81 @@ bool FilePath::CreateFolder() const {
 // On Windows platform, uses \ as the separator, other platforms use /.
 FilePath FilePath::RemoveTrailingPathSeparator() const {
   return IsDirectory()
-      ? FilePath(String(pathname_.c_str(), pathname_.length() - 1))
+      ? FilePath(StringPiece(pathname_).Prefix(pathname_.length() - 1))
       : *this;
 }
 
+// Replaces the contents of the file with the size bytes at data, via a
+// temporary file in the same directory that is renamed over the file.
+// Returns true if successful.
+bool FilePath::WriteFileAtomically(const void* data, size_t size) const {
+  const FilePath temp_path(GenerateUniqueFileName(
+      RemoveFileName(), RemoveDirectoryName(), "tmp"));
+  FILE* const file = posix::FOpen(temp_path.c_str(), "wb");
+  if (file == NULL) {
+    return false;
+  }
+  const bool written = size == 0 || fwrite(data, 1, size, file) == size;
+  if (posix::FClose(file) != 0 || !written) {
+    remove(temp_path.c_str());
+    return false;
+  }
+
+#if GTEST_OS_WINDOWS_MOBILE
+  // Windows CE can't replace a file in one step.
+  LPCWSTR temp_unicode = String::AnsiToUtf16(temp_path.c_str());
+  LPCWSTR unicode = String::AnsiToUtf16(pathname_.c_str());
+  DeleteFile(unicode);
+  const bool renamed = MoveFile(temp_unicode, unicode) != 0;
+  delete [] temp_unicode;
+  delete [] unicode;
+#elif GTEST_OS_WINDOWS
+  // Unlike POSIX rename(), Windows' rename() fails if the file exists.
+  const bool renamed = ::MoveFileExA(temp_path.c_str(), pathname_.c_str(),
+                                     MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  const bool renamed = rename(temp_path.c_str(), pathname_.c_str()) == 0;
+#endif  // GTEST_OS_WINDOWS_MOBILE
+
+  if (!renamed) {
+    remove(temp_path.c_str());
+  }
+  return renamed;
+}
+
 // Removes any redundant separators that might be in the pathname.
 // For example, "bar///foo" becomes "bar/foo". Does not eliminate other
 // redundancies that might be in a pathname involving "." or "..".
 // TODO(wan@google.com): handle Windows network shares (e.g. \\server\share).
-void FilePath::Normalize() {
-  if (pathname_.c_str() == NULL) {
-    pathname_ = "";
+void FilePath::Normalize(StringPiece pathname) {
+  // Like a C string, the pathname ends at the first NUL, if any.
+  const char* const begin = pathname.data();
+  const char* const nul =
+      static_cast<const char*>(memchr(begin, '\0', pathname.length()));
+  const size_t length = nul == NULL ? pathname.length() : nul - begin;
+
+  // Most pathnames are already normal, and are copied as they are.
+  bool is_normal = true;
+  for (size_t i = 0; is_normal && i < length; i++) {
+#if GTEST_HAS_ALT_PATH_SEP_
+    if (begin[i] == kAlternatePathSeparator)
+      is_normal = false;
+#endif
+    if (i > 0 && IsPathSeparator(begin[i]) && IsPathSeparator(begin[i - 1]))
+      is_normal = false;
+  }
+  if (is_normal) {
+    pathname_ = String(begin, length);
     return;
   }
-  const char* src = pathname_.c_str();
-  char* const dest = new char[pathname_.length() + 1];
+
+  const char* src = begin;
+  const char* const end = begin + length;
+  char* const dest = new char[length + 1];
   char* dest_ptr = dest;
-  memset(dest_ptr, 0, pathname_.length() + 1);
+  memset(dest_ptr, 0, length + 1);
 
-  while (*src != '\0') {
+  while (src != end) {
     *dest_ptr = *src;
     if (!IsPathSeparator(*src)) {
       src++;
@@ -366,15 +431,134 @@ void FilePath::Normalize() {
         *dest_ptr = kPathSeparator;
       }
 #endif
-      while (IsPathSeparator(*src))
+      while (src != end && IsPathSeparator(*src))
         src++;
     }
     dest_ptr++;
   }
   *dest_ptr = '\0';
-  pathname_ = dest;
+  pathname_ = String(dest, dest_ptr - dest);
   delete[] dest;
 }
 
+// Maps the given file, releasing the previously mapped one if any.
+// Returns false if the file can't be opened or mapped.
+bool MappedFile::Map(const FilePath& path) {
+  Unmap();
+
+#if GTEST_OS_WINDOWS_MOBILE
+  // Windows CE has no file mapping we can rely on; reads the file instead.
+  FILE* const file = posix::FOpen(path.c_str(), "rb");
+  if (file == NULL) {
+    return false;
+  }
+  long file_size = -1;  // NOLINT
+  if (fseek(file, 0, SEEK_END) == 0) {
+    file_size = ftell(file);
+  }
+  if (file_size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+    posix::FClose(file);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(file_size);
+  buffer_ = new char[size + 1];
+  const bool read_all = fread(buffer_, 1, size, file) == size;
+  posix::FClose(file);
+  if (!read_all) {
+    Unmap();
+    return false;
+  }
+  data_ = buffer_;
+  size_ = size;
+  return true;
+#else
+# if GTEST_OS_WINDOWS
+  const HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ,
+                                    FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                    FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER file_size;
+  if (!::GetFileSizeEx(file, &file_size) ||
+      static_cast<BiggestInt>(file_size.QuadPart) >
+      static_cast<BiggestInt>(static_cast<size_t>(-1) >> 1)) {
+    ::CloseHandle(file);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(file_size.QuadPart);
+  void* mapping = NULL;
+  if (size != 0) {
+    // The view keeps the file open after both handles are closed.
+    const HANDLE file_mapping =
+        ::CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (file_mapping != NULL) {
+      mapping = ::MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+      ::CloseHandle(file_mapping);
+    }
+  }
+  ::CloseHandle(file);
+# else
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  posix::StatStruct file_stat;
+  if (fstat(fd, &file_stat) != 0 || posix::IsDir(file_stat) ||
+      static_cast<BiggestInt>(file_stat.st_size) >
+      static_cast<BiggestInt>(static_cast<size_t>(-1) >> 1)) {
+    posix::Close(fd);
+    return false;
+  }
+  const size_t size = static_cast<size_t>(file_stat.st_size);
+  void* mapping = NULL;
+  if (size != 0) {
+    mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      mapping = NULL;
+    }
+#  ifdef MADV_SEQUENTIAL
+    if (mapping != NULL) {
+      // The file will be read front to back, so the kernel can read ahead
+      // aggressively and drop pages behind the reader.
+      madvise(static_cast<char*>(mapping), size, MADV_SEQUENTIAL);
+    }
+#  endif  // MADV_SEQUENTIAL
+  }
+  posix::Close(fd);
+# endif  // GTEST_OS_WINDOWS
+
+  if (size == 0) {
+    // Neither mmap() nor MapViewOfFile() can map an empty file.
+    buffer_ = new char[1];
+    data_ = buffer_;
+    return true;
+  }
+  if (mapping == NULL) {
+    return false;
+  }
+  mapping_ = mapping;
+  data_ = static_cast<const char*>(mapping);
+  size_ = size;
+  return true;
+#endif  // GTEST_OS_WINDOWS_MOBILE
+}
+
+// Releases the mapped file, if any.
+void MappedFile::Unmap() {
+  if (mapping_ != NULL) {
+#if GTEST_OS_WINDOWS
+    ::UnmapViewOfFile(mapping_);
+#else
+    munmap(static_cast<char*>(mapping_), size_);
+#endif  // GTEST_OS_WINDOWS
+  }
+  delete [] buffer_;
+  data_ = NULL;
+  size_ = 0;
+  mapping_ = NULL;
+  buffer_ = NULL;
+}
+
 }  // namespace internal
 }  // namespace testing
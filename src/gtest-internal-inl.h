@@ -85,16 +85,20 @@ const char kAlsoRunDisabledTestsFlag[] = "also_run_disabled_tests";
 const char kBreakOnFailureFlag[] = "break_on_failure";
 const char kCatchExceptionsFlag[] = "catch_exceptions";
 const char kColorFlag[] = "color";
+const char kFailOnLeakBytesFlag[] = "fail_on_leak_bytes";
 const char kFilterFlag[] = "filter";
 const char kListTestsFlag[] = "list_tests";
+const char kMaxFailuresPerTestFlag[] = "max_failures_per_test";
 const char kOutputFlag[] = "output";
 const char kPrintTimeFlag[] = "print_time";
 const char kRandomSeedFlag[] = "random_seed";
 const char kRepeatFlag[] = "repeat";
 const char kShuffleFlag[] = "shuffle";
+const char kStartupProfileFlag[] = "startup_profile";
 const char kStackTraceDepthFlag[] = "stack_trace_depth";
 const char kStreamResultToFlag[] = "stream_result_to";
 const char kThrowOnFailureFlag[] = "throw_on_failure";
+const char kUpdateGoldenFilesFlag[] = "update_golden_files";
 
 // A valid random seed must be in [1, kMaxRandomSeed].
 const int kMaxRandomSeed = 99999;
@@ -106,12 +110,37 @@ GTEST_API_ extern bool g_help_flag;
 // Returns the current time in milliseconds.
 GTEST_API_ TimeInMillis GetTimeInMillis();
 
+// Returns the current time of a monotonic clock, in nanoseconds since an
+// arbitrary point.  It times the phases of a test, for which
+// GetTimeInMillis() is too coarse.
+GTEST_API_ Int64 GetMonotonicTimeInNanos();
+
 // Returns true iff Google Test should use colors in the output.
 GTEST_API_ bool ShouldUseColor(bool stdout_is_tty);
 
+// Returns the note reported after a failure that was repeated count more
+// times, e.g. "... and 9,999,990 more identical failures".
+GTEST_API_ String FormatRepeatedFailureNote(int count);
+
+// Returns the note reported after a test that omitted count failures,
+// e.g. "... and 1,000 more failures".
+GTEST_API_ String FormatOmittedFailureNote(int count);
+
+// Converts length characters starting at start to a String, converting
+// NUL bytes to "\\0" along the way.
+GTEST_API_ String CharsToStringEscapingNuls(const char* start, size_t length);
+
 // Formats the given time in milliseconds as seconds.
 GTEST_API_ std::string FormatTimeInMillisAsSeconds(TimeInMillis ms);
 
+// Formats the given time in nanoseconds as seconds, with microsecond
+// precision, e.g. "0.000125".
+GTEST_API_ std::string FormatNanosAsSeconds(Int64 nanos);
+
+// Returns the name of the given test phase as used in reports, e.g.
+// "set_up" for TestResult::kSetUpPhase.
+GTEST_API_ const char* TestPhaseName(TestResult::Phase phase);
+
 // Parses a string for an Int32 flag, in the form of "--flag=value".
 //
 // On success, stores the value of the flag in *value, and returns
@@ -157,17 +186,21 @@ class GTestFlagSaver {
     color_ = GTEST_FLAG(color);
     death_test_style_ = GTEST_FLAG(death_test_style);
     death_test_use_fork_ = GTEST_FLAG(death_test_use_fork);
+    fail_on_leak_bytes_ = GTEST_FLAG(fail_on_leak_bytes);
     filter_ = GTEST_FLAG(filter);
     internal_run_death_test_ = GTEST_FLAG(internal_run_death_test);
     list_tests_ = GTEST_FLAG(list_tests);
+    max_failures_per_test_ = GTEST_FLAG(max_failures_per_test);
     output_ = GTEST_FLAG(output);
     print_time_ = GTEST_FLAG(print_time);
     random_seed_ = GTEST_FLAG(random_seed);
     repeat_ = GTEST_FLAG(repeat);
     shuffle_ = GTEST_FLAG(shuffle);
+    startup_profile_ = GTEST_FLAG(startup_profile);
     stack_trace_depth_ = GTEST_FLAG(stack_trace_depth);
     stream_result_to_ = GTEST_FLAG(stream_result_to);
     throw_on_failure_ = GTEST_FLAG(throw_on_failure);
+    update_golden_files_ = GTEST_FLAG(update_golden_files);
   }
 
   // The d'tor is not virtual.  DO NOT INHERIT FROM THIS CLASS.
@@ -178,17 +211,21 @@ class GTestFlagSaver {
     GTEST_FLAG(color) = color_;
     GTEST_FLAG(death_test_style) = death_test_style_;
     GTEST_FLAG(death_test_use_fork) = death_test_use_fork_;
+    GTEST_FLAG(fail_on_leak_bytes) = fail_on_leak_bytes_;
     GTEST_FLAG(filter) = filter_;
     GTEST_FLAG(internal_run_death_test) = internal_run_death_test_;
     GTEST_FLAG(list_tests) = list_tests_;
+    GTEST_FLAG(max_failures_per_test) = max_failures_per_test_;
     GTEST_FLAG(output) = output_;
     GTEST_FLAG(print_time) = print_time_;
     GTEST_FLAG(random_seed) = random_seed_;
     GTEST_FLAG(repeat) = repeat_;
     GTEST_FLAG(shuffle) = shuffle_;
+    GTEST_FLAG(startup_profile) = startup_profile_;
     GTEST_FLAG(stack_trace_depth) = stack_trace_depth_;
     GTEST_FLAG(stream_result_to) = stream_result_to_;
     GTEST_FLAG(throw_on_failure) = throw_on_failure_;
+    GTEST_FLAG(update_golden_files) = update_golden_files_;
   }
  private:
   // Fields for saving the original values of flags.
@@ -198,18 +235,22 @@ class GTestFlagSaver {
   String color_;
   String death_test_style_;
   bool death_test_use_fork_;
+  internal::Int32 fail_on_leak_bytes_;
   String filter_;
   String internal_run_death_test_;
   bool list_tests_;
+  internal::Int32 max_failures_per_test_;
   String output_;
   bool print_time_;
   bool pretty_;
   internal::Int32 random_seed_;
   internal::Int32 repeat_;
   bool shuffle_;
+  bool startup_profile_;
   internal::Int32 stack_trace_depth_;
   String stream_result_to_;
   bool throw_on_failure_;
+  bool update_golden_files_;
 } GTEST_ATTRIBUTE_UNUSED_;
 
 // Converts a Unicode code point to a narrow string in UTF-8 encoding.
@@ -237,6 +278,18 @@ GTEST_API_ char* CodePointToUtf8(UInt32 code_point, char* str);
 // will be encoded as individual Unicode characters from Basic Normal Plane.
 GTEST_API_ String WideStringToUtf8(const wchar_t* str, int num_chars);
 
+// Returns the number of bytes WideCharsToUtf8() writes for the num_chars
+// wide characters at str.
+GTEST_API_ size_t Utf8LengthOfWideChars(const wchar_t* str, size_t num_chars);
+
+// Writes the UTF-8 encoding of the num_chars wide characters at str to
+// out, which must have room for Utf8LengthOfWideChars(str, num_chars)
+// bytes, and returns the end of what was written.  Unlike
+// WideStringToUtf8(), it doesn't stop at L'\0' and doesn't write a
+// terminating nul.  The encoding is the same as WideStringToUtf8()'s.
+GTEST_API_ char* WideCharsToUtf8(const wchar_t* str, size_t num_chars,
+                                 char* out);
+
 // Reads the GTEST_SHARD_STATUS_FILE environment variable, and creates the file
 // if the variable is present. If a file already exists at this location, this
 // function will write over it. If the variable is present, but the file cannot
@@ -331,6 +384,13 @@ static void Delete(T* x) {
   delete x;
 }
 
+// A function for destroying an object whose memory belongs to an Arena,
+// without freeing the memory.  Handy for being used as a functor.
+template <typename T>
+static void Destroy(T* x) {
+  x->~T();
+}
+
 // A predicate that checks the key of a TestProperty against a known key.
 //
 // TestPropertyKeyIs is copyable.
@@ -380,13 +440,26 @@ class GTEST_API_ UnitTestOptions {
   //
   // This recursive algorithm isn't very efficient, but is clear and
   // works well enough for matching test names, which are short.
-  static bool PatternMatchesString(const char *pattern, const char *str);
+  static bool PatternMatchesString(const char *pattern, StringPiece str);
 
   // Returns true iff the user-specified filter matches the test case
   // name and the test name.
   static bool FilterMatchesTest(const String &test_case_name,
                                 const String &test_name);
 
+  // Splits a --gtest_filter value at its first '-' into the positive
+  // and the negative patterns.  An empty positive part (as in
+  // "-FooTest.*") means all tests.  *negative points into filter.
+  static void SplitFilter(const char* filter, String* positive,
+                          const char** negative);
+
+  // Returns true iff full_name ("TestCaseName.TestName") matches one
+  // of the positive patterns and none of the negative patterns that
+  // SplitFilter() returned.
+  static bool FullNameMatchesFilter(StringPiece full_name,
+                                    const char* positive,
+                                    const char* negative);
+
 #if GTEST_OS_WINDOWS
   // Function for supporting the gtest_catch_exception flag.
 
@@ -398,7 +471,7 @@ class GTEST_API_ UnitTestOptions {
 
   // Returns true if "name" matches the ':' separated list of glob-style
   // filters in "filter".
-  static bool MatchesFilter(const String& name, const char* filter);
+  static bool MatchesFilter(StringPiece name, const char* filter);
 };
 
 // Returns the current application's name, removing directory path if that
@@ -456,6 +529,97 @@ struct TraceInfo {
   const char* file;
   int line;
   String message;
+  // For a trace created by SCOPED_TRACE_LAZY(), the object that renders
+  // the message on failure; NULL otherwise.
+  const LazyScopedTrace* lazy_trace;
+};
+
+// Records test part results, folding a flood of failures.  Once it holds
+// --gtest_max_failures_per_test results, a failure identical (same source
+// file, line, and type) to a recorded one only increments the latter's
+// repeat count, and any other failure is only counted as omitted.  It
+// isn't thread-safe; its owner guards it with a mutex.
+class GTEST_API_ TestPartResultRecorder {
+ public:
+  TestPartResultRecorder();
+
+  // Records the result, or counts it as a repeat or as omitted.  Returns
+  // true iff it was recorded.
+  bool Add(const TestPartResult& result);
+
+  // Adds count to the repeat count of the last recorded failure identical
+  // to the given one, or counts them as omitted if there is none.
+  void AddRepeats(const TestPartResult& failure, int count);
+
+  // Counts count omitted failures of the given type.
+  void AddOmitted(TestPartResult::Type type, int count);
+
+  // Forgets all results and counts.
+  void Clear();
+
+  // Exchanges the contents with other's.
+  void Swap(TestPartResultRecorder* other);
+
+  const std::vector<TestPartResult>& results() const { return results_; }
+
+  // Returns the repeat count of the i-th recorded result.
+  int repeat_count(int i) const { return GetElementOr(repeat_counts_, i, 0); }
+
+  int omitted_fatal_failure_count() const {
+    return omitted_fatal_failure_count_;
+  }
+  int omitted_nonfatal_failure_count() const {
+    return omitted_nonfatal_failure_count_;
+  }
+
+ private:
+  // Returns the index of the last recorded failure identical to the given
+  // one, or -1 if there is none.
+  int FindIdenticalFailure(const TestPartResult& failure);
+
+  // Returns the slot of failure_slots_ that holds the failures identical
+  // to the given one, or the empty slot where they belong.
+  size_t FindSlot(const TestPartResult& failure) const;
+
+  // Adds the failures recorded since the last call to failure_slots_,
+  // growing it as needed.
+  void IndexNewFailures();
+
+  std::vector<TestPartResult> results_;
+  // It's only as long as the index of the last result with a non-zero
+  // repeat count requires.
+  std::vector<int> repeat_counts_;
+  // An open-addressing hash table keyed on (file, line, type).  A slot
+  // holds 1 + the index in results_ of the last failure with that key, or
+  // 0 if it's empty.  It's built the first time a lookup needs it, so a
+  // test below the limit never pays for it.
+  std::vector<int> failure_slots_;
+  int used_slot_count_;
+  // The number of results_ elements already added to failure_slots_.
+  int indexed_result_count_;
+  int omitted_fatal_failure_count_;
+  int omitted_nonfatal_failure_count_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(TestPartResultRecorder);
+};
+
+// Buffers the test part results reported on a thread other than the
+// one running the tests.  Each such thread appends to its own buffer,
+// so assertions in different threads don't contend for a shared lock;
+// the thread running the tests merges the buffers into the current
+// TestResult when a test (or the ad hoc test) ends.
+struct ThreadTestPartResults {
+  ThreadTestPartResults()
+      : has_fatal_failure(false), has_nonfatal_failure(false) {}
+
+  // Protects the members below.  It is only ever contended by the merge
+  // and by Test::HasFatalFailure() and Test::HasNonfatalFailure().
+  Mutex mutex;
+  TestPartResultRecorder results;
+  // True iff a failure of that kind has been buffered since the last
+  // merge, so that the current test sees it before the merge.
+  bool has_fatal_failure;
+  bool has_nonfatal_failure;
 };
 
 // This is the default global test part result reporter used in UnitTestImpl.
@@ -490,6 +654,149 @@ class DefaultPerThreadTestPartResultReporter
   GTEST_DISALLOW_COPY_AND_ASSIGN_(DefaultPerThreadTestPartResultReporter);
 };
 
+// The stages of Google Test's startup that --gtest_startup_profile
+// reports separately.
+enum StartupStage {
+  kStaticRegistrationStage,  // MakeAndRegisterTestInfo() before main().
+  kFlagParsingStage,         // Parsing the command line flags.
+  kPostFlagParsingInitStage,  // The rest of PostFlagParsingInit().
+  kParameterizedTestRegistrationStage,  // RegisterParameterizedTests().
+  kListenerSetUpStage,       // Creating the XML and streaming listeners.
+  kTestFilteringStage,       // FilterTests().
+  kStartupStageCount
+};
+
+// Accumulates the time and the heap allocations (when a heap profiler is
+// installed) spent in each startup stage.  Stages can nest; the time
+// spent in a nested stage only counts toward that stage.
+class GTEST_API_ StartupProfile {
+ public:
+  StartupProfile();
+
+  // Returns true iff some stage is being timed.
+  bool in_stage() const { return current_stage_ != kStartupStageCount; }
+
+  // Starts timing the given stage, pausing the current one if any.
+  // Returns the paused stage, which must be passed to EndStage().
+  StartupStage BeginStage(StartupStage stage);
+
+  // Stops timing the current stage and resumes the given paused one.
+  void EndStage(StartupStage paused_stage);
+
+  // Returns the time spent in the given stage, in nanoseconds.
+  Int64 nanos(StartupStage stage) const { return nanos_[stage]; }
+
+  // Returns how many times the given stage was entered.
+  int call_count(StartupStage stage) const { return call_counts_[stage]; }
+
+  // Returns the number of heap allocations made in the given stage, or -1
+  // if there was no heap profiler to count them.
+  Int64 allocation_count(StartupStage stage) const {
+    return allocation_counts_[stage];
+  }
+
+  // Returns a table of the stages, for printing.
+  String Format() const;
+
+ private:
+  // Charges the time and allocations since the last call to the current
+  // stage.
+  void ChargeCurrentStage();
+
+  StartupStage current_stage_;
+  Int64 last_nanos_;
+  Int64 last_allocation_count_;
+  Int64 nanos_[kStartupStageCount];
+  int call_counts_[kStartupStageCount];
+  Int64 allocation_counts_[kStartupStageCount];
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(StartupProfile);
+};
+
+// Times a startup stage from construction to destruction.
+class StartupStageTimer {
+ public:
+  StartupStageTimer(StartupProfile* profile, StartupStage stage)
+      : profile_(profile),
+        paused_stage_(profile->BeginStage(stage)) {}
+  ~StartupStageTimer() { profile_->EndStage(paused_stage_); }
+
+ private:
+  StartupProfile* const profile_;
+  const StartupStage paused_stage_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(StartupStageTimer);
+};
+
+// AlignmentOf<T>::value is the alignment of T.  T's alignment is the
+// padding the compiler inserts before a T that follows a char.
+template <typename T>
+struct AlignmentOf {
+  struct CharThenT {
+    char c;
+    T t;
+  };
+  static const size_t value = sizeof(CharThenT) - sizeof(T);
+};
+
+// Hands out memory that lives as long as the arena, carving it out of
+// large chunks that are all freed when the arena is destroyed.  Memory is
+// handed out in order, so objects allocated one after another are usually
+// next to each other.  The arena isn't thread-safe.  Objects constructed
+// in it with placement new must be destroyed with Destroy().
+class GTEST_API_ Arena {
+ public:
+  explicit Arena(size_t chunk_size);
+  ~Arena();
+
+  // Returns size bytes aligned to the given power of two, which must not
+  // exceed the alignment of the memory operator new[] returns.
+  void* Allocate(size_t size, size_t alignment);
+
+ private:
+  const size_t chunk_size_;
+  // The chunks and the blocks too big to share a chunk.  The arena owns
+  // them.
+  std::vector<char*> chunks_;
+  // The chunk being handed out, or NULL, and the bytes used from it.
+  char* current_chunk_;
+  size_t current_chunk_used_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(Arena);
+};
+
+// Keeps a single copy of each distinct string it is given, so that the
+// many tests sharing a test case name, a test name or a parameter share
+// its storage, and equal interned strings have equal addresses.  The
+// copies are packed into large chunks and live until the pool is
+// destroyed.  The pool is thread-safe.
+class GTEST_API_ StringPool {
+ public:
+  StringPool();
+
+  // Returns the pool's copy of str, making one if the pool doesn't have
+  // it yet.  Returns NULL if str is NULL.
+  const char* Intern(const char* str);
+
+  // Returns the number of distinct strings in the pool.
+  size_t size() const;
+
+ private:
+  // Doubles the number of hash table slots and rehashes the strings.
+  void Grow();
+
+  // An open-addressing hash table of the interned strings, whose size is
+  // a power of two.  Empty slots are NULL.
+  std::vector<const char*> slots_;
+  // Holds the interned strings.
+  Arena arena_;
+  size_t size_;
+  // Protects all the fields above.
+  mutable Mutex mutex_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(StringPool);
+};
+
 // The private implementation of the UnitTest class.  We don't protect
 // the methods under a mutex, as this class is not accessible by a
 // user and the UnitTest class that delegates work to this class does
@@ -551,6 +858,15 @@ class GTEST_API_ UnitTestImpl {
   // Gets the elapsed time, in milliseconds.
   TimeInMillis elapsed_time() const { return elapsed_time_; }
 
+  // Gets the time the SetUp() and TearDown() methods of the global
+  // environments took in the last iteration, in nanoseconds.
+  Int64 environments_set_up_time_nanos() const {
+    return environments_set_up_time_nanos_;
+  }
+  Int64 environments_tear_down_time_nanos() const {
+    return environments_tear_down_time_nanos_;
+  }
+
   // Returns true iff the unit test passed (i.e. all test cases passed).
   bool Passed() const { return !Failed(); }
 
@@ -577,10 +893,28 @@ class GTEST_API_ UnitTestImpl {
   // Provides access to the event listener list.
   TestEventListeners* listeners() { return &listeners_; }
 
+  // Returns the profile of Google Test's startup.
+  StartupProfile* startup_profile() { return &startup_profile_; }
+
   // Returns the TestResult for the test that's currently running, or
   // the TestResult for the ad hoc test if no test is running.
   TestResult* current_test_result();
 
+  // Records a test part result reported by the calling thread.  If it
+  // is the thread running the tests, the result is added to the current
+  // TestResult and the listeners are notified right away; otherwise it
+  // is buffered until MergeTestPartResultsFromOtherThreads() is called.
+  void RecordTestPartResult(const TestPartResult& result);
+
+  // Adds the test part results buffered by other threads to the current
+  // TestResult and notifies the listeners of them.  Must be called by the
+  // thread running the tests.
+  void MergeTestPartResultsFromOtherThreads();
+
+  // Returns true iff another thread has buffered a failure of the given
+  // type that hasn't been merged yet.
+  bool HasUnmergedFailure(TestPartResult::Type type);
+
   // Returns the TestResult for the ad hoc test.
   const TestResult* ad_hoc_test_result() const { return &ad_hoc_test_result_; }
 
@@ -608,6 +942,19 @@ class GTEST_API_ UnitTestImpl {
   // trace but Bar() and CurrentOsStackTraceExceptTop() won't.
   String CurrentOsStackTraceExceptTop(int skip_count);
 
+  // Returns the pool that interns the names and the parameters of the
+  // tests and the test cases.
+  StringPool* name_pool() { return &name_pool_; }
+
+  // Returns memory for a T, such as a TestInfo or a TestCase, in the arena
+  // that holds the tests and the test cases.  The T must be constructed
+  // in it with placement new, and destroyed with Destroy().  It's
+  // thread-safe.
+  template <typename T>
+  void* AllocateRegistrationObject() {
+    return AllocateRegistrationObject(sizeof(T), AlignmentOf<T>::value);
+  }
+
   // Finds and returns a TestCase with the given name.  If one doesn't
   // exist, creates one and returns it.
   //
@@ -791,6 +1138,10 @@ class GTEST_API_ UnitTestImpl {
   // GTEST_FLAG(catch_exceptions) at the moment it starts.
   void set_catch_exceptions(bool value) { catch_exceptions_ = value; }
 
+  // Allocates size bytes with the given alignment in the registration
+  // arena.
+  void* AllocateRegistrationObject(size_t size, size_t alignment);
+
   // The UnitTest object that owns this implementation object.
   UnitTest* const parent_;
 
@@ -804,19 +1155,49 @@ class GTEST_API_ UnitTestImpl {
       default_per_thread_test_part_result_reporter_;
 
   // Points to (but doesn't own) the global test part result reporter.
-  TestPartResultReporterInterface* global_test_part_result_repoter_;
+  // Every assertion reads it, so it is read without a lock.
+  TestPartResultReporterInterface* volatile global_test_part_result_repoter_;
 
-  // Protects read and write access to global_test_part_result_reporter_.
+  // Serializes the writes to global_test_part_result_reporter_.
   internal::Mutex global_test_part_result_reporter_mutex_;
 
   // Points to (but doesn't own) the per-thread test part result reporter.
   internal::ThreadLocal<TestPartResultReporterInterface*>
       per_thread_test_part_result_reporter_;
 
+  // True on the thread running the tests.  Test part results reported
+  // on any other thread are buffered in its ThreadTestPartResults.
+  internal::ThreadLocal<bool> is_test_thread_;
+
+  // Points to (but doesn't own) the calling thread's result buffer, or
+  // NULL if the thread hasn't reported any test part result yet.
+  internal::ThreadLocal<ThreadTestPartResults*> thread_test_part_results_;
+
+  // The result buffers of all threads that have reported a test part
+  // result.  It owns the elements in the vector.
+  std::vector<ThreadTestPartResults*> all_thread_test_part_results_;
+
+  // Protects all_thread_test_part_results_.  A thread takes it only once,
+  // when it registers its buffer.
+  internal::Mutex all_thread_test_part_results_mutex_;
+
   // The vector of environments that need to be set-up/torn-down
   // before/after the tests are run.
   std::vector<Environment*> environments_;
 
+  // Holds the objects allocated by AllocateRegistrationObject(): the
+  // TestInfos and the TestCases, in the order they were registered.  It's
+  // declared before the fields that own such objects, so that it outlives
+  // them.
+  Arena registration_arena_;
+
+  // Protects registration_arena_.
+  internal::Mutex registration_arena_mutex_;
+
+  // Interns the names and the parameters of the tests and the test
+  // cases.  It's declared before test_cases_ so that it outlives them.
+  StringPool name_pool_;
+
   // The vector of TestCases in their original order.  It owns the
   // elements in the vector.
   std::vector<TestCase*> test_cases_;
@@ -865,6 +1246,9 @@ class GTEST_API_ UnitTestImpl {
   // Google Test.
   TestEventListeners listeners_;
 
+  // The time and allocations spent in each stage of the startup.
+  StartupProfile startup_profile_;
+
   // The OS stack trace getter.  Will be deleted when the UnitTest
   // object is destructed.  By default, an OsStackTraceGetter is used,
   // but the user can set this field to use a custom getter if that is
@@ -883,6 +1267,11 @@ class GTEST_API_ UnitTestImpl {
   // How long the test took to run, in milliseconds.
   TimeInMillis elapsed_time_;
 
+  // How long the environments took to set up and tear down in the last
+  // iteration, in nanoseconds.
+  Int64 environments_set_up_time_nanos_;
+  Int64 environments_tear_down_time_nanos_;
+
 #if GTEST_HAS_DEATH_TEST
   // The decomposed components of the gtest_internal_run_death_test flag,
   // parsed when RUN_ALL_TESTS is called.
@@ -906,6 +1295,26 @@ inline UnitTestImpl* GetUnitTestImpl() {
   return UnitTest::GetInstance()->impl();
 }
 
+// Suspends counting the calling thread's allocations in the installed
+// heap profiler, if any, for as long as the object lives.
+class ScopedHeapCountingSuspension {
+ public:
+  ScopedHeapCountingSuspension() : profiler_(GetHeapProfiler()) {
+    if (profiler_ != NULL)
+      profiler_->SuspendCounting();
+  }
+
+  ~ScopedHeapCountingSuspension() {
+    if (profiler_ != NULL)
+      profiler_->ResumeCounting();
+  }
+
+ private:
+  HeapProfilerInterface* const profiler_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(ScopedHeapCountingSuspension);
+};
+
 #if GTEST_USES_SIMPLE_RE
 
 // Internal helper functions for implementing the simple regular
@@ -931,6 +1340,15 @@ GTEST_API_ bool MatchRegexAnywhere(const char* regex, const char* str);
 GTEST_API_ void ParseGoogleTestFlagsOnly(int* argc, char** argv);
 GTEST_API_ void ParseGoogleTestFlagsOnly(int* argc, wchar_t** argv);
 
+#if GTEST_CAN_STREAM_RESULTS_
+
+// Creates the listener --gtest_stream_result_to=host:port installs, which
+// connects to the given host and port.  The caller owns the listener.
+GTEST_API_ TestEventListener* NewStreamingListener(const string& host,
+                                                   const string& port);
+
+#endif  // GTEST_CAN_STREAM_RESULTS_
+
 #if GTEST_HAS_DEATH_TEST
 
 // Returns the message describing the last system error, regardless of the
@@ -1026,12 +1444,27 @@ class TestResultAccessor {
     test_result->ClearTestPartResults();
   }
 
+  static bool AddTestPartResult(TestResult* test_result,
+                                const TestPartResult& test_part_result) {
+    return test_result->AddTestPartResult(test_part_result);
+  }
+
   static const std::vector<testing::TestPartResult>& test_part_results(
       const TestResult& test_result) {
     return test_result.test_part_results();
   }
 };
 
+#if GTEST_IS_THREADSAFE
+
+// Runs body->Run(thread_index, iteration) for RunStressTest(), and
+// reports a C++ exception or SEH exception it throws as a fatal failure,
+// just like one thrown in a test body.
+GTEST_API_ void RunStressTestIteration(
+    StressTestBody* body, int thread_index, int iteration);
+
+#endif  // GTEST_IS_THREADSAFE
+
 }  // namespace internal
 }  // namespace testing
 
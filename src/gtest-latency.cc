@@ -0,0 +1,258 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This file implements LatencyRecorder and the EXPECT_PERCENTILE_LT()
+// assertions.
+
+#include "gtest/gtest-latency.h"
+
+#include <math.h>
+
+#include "gtest/gtest.h"
+
+// Indicates that this translation unit is part of Google Test's
+// implementation.  It must come before gtest-internal-inl.h is
+// included, or there will be a compiler error.  This trick is to
+// prevent a user from accidentally including gtest-internal-inl.h in
+// his code.
+#define GTEST_IMPLEMENTATION_ 1
+#include "src/gtest-internal-inl.h"
+#undef GTEST_IMPLEMENTATION_
+
+namespace testing {
+
+using internal::GetMonotonicTimeInNanos;
+using internal::Int64;
+using internal::String;
+using internal::UInt64;
+
+namespace {
+
+// Each power-of-two range of latencies [2^k, 2^(k+1)), k > kSubBucketBits,
+// is split into kSubBucketCount linear buckets.  Latencies below
+// 2 * kSubBucketCount nanoseconds get a bucket each.
+const int kSubBucketBits = 5;
+const int kSubBucketCount = 1 << kSubBucketBits;
+
+// Returns the index of the most significant bit set in n, which must
+// not be 0.
+int MostSignificantBit(UInt64 n) {
+  int bit = 0;
+  while (n >>= 1)
+    bit++;
+  return bit;
+}
+
+// Formats the given number of nanoseconds as microseconds, e.g. "12.3us".
+String FormatNanosAsMicros(Int64 nanos) {
+  return String::Format("%.1fus", static_cast<double>(nanos) / 1000.0);
+}
+
+}  // namespace
+
+// Returns the current time of a monotonic clock, in nanoseconds.  It's
+// the clock Google Test times the phases of a test with.
+Int64 LatencyRecorder::NowNanos() {
+  return GetMonotonicTimeInNanos();
+}
+
+LatencyRecorder::LatencyRecorder()
+    : count_(0), min_nanos_(0), max_nanos_(0), total_nanos_(0) {}
+
+// Returns the index of the bucket holding the given latency.
+int LatencyRecorder::BucketIndex(UInt64 nanos) {
+  if (nanos < 2 * kSubBucketCount)
+    return static_cast<int>(nanos);
+
+  // Keeps the kSubBucketBits bits after the most significant one.
+  const int shift = MostSignificantBit(nanos) - kSubBucketBits;
+  return shift * kSubBucketCount + static_cast<int>(nanos >> shift);
+}
+
+// Returns the lowest latency held by the given bucket.
+UInt64 LatencyRecorder::BucketLowestNanos(int index) {
+  if (index < 2 * kSubBucketCount)
+    return static_cast<UInt64>(index);
+
+  const int shift = index / kSubBucketCount - 1;
+  return static_cast<UInt64>(index - shift * kSubBucketCount) << shift;
+}
+
+// Returns the highest latency held by the given bucket.
+UInt64 LatencyRecorder::BucketHighestNanos(int index) {
+  if (index < 2 * kSubBucketCount)
+    return static_cast<UInt64>(index);
+
+  const int shift = index / kSubBucketCount - 1;
+  return BucketLowestNanos(index) + (static_cast<UInt64>(1) << shift) - 1;
+}
+
+// Records one latency, in nanoseconds.
+void LatencyRecorder::RecordNanos(Int64 nanos) {
+  if (nanos < 0)
+    nanos = 0;
+
+  const int index = BucketIndex(static_cast<UInt64>(nanos));
+  if (index >= static_cast<int>(counts_.size()))
+    counts_.resize(index + 1, 0);
+  counts_[index]++;
+
+  if (count_ == 0 || nanos < min_nanos_)
+    min_nanos_ = nanos;
+  if (nanos > max_nanos_)
+    max_nanos_ = nanos;
+  count_++;
+  total_nanos_ += static_cast<double>(nanos);
+}
+
+// Adds all the latencies recorded by other to this recorder.
+void LatencyRecorder::Merge(const LatencyRecorder& other) {
+  if (other.count_ == 0)
+    return;
+
+  if (other.counts_.size() > counts_.size())
+    counts_.resize(other.counts_.size(), 0);
+  for (size_t i = 0; i < other.counts_.size(); i++)
+    counts_[i] += other.counts_[i];
+
+  if (count_ == 0 || other.min_nanos_ < min_nanos_)
+    min_nanos_ = other.min_nanos_;
+  if (other.max_nanos_ > max_nanos_)
+    max_nanos_ = other.max_nanos_;
+  count_ += other.count_;
+  total_nanos_ += other.total_nanos_;
+}
+
+// Returns the mean latency in nanoseconds.
+double LatencyRecorder::mean_nanos() const {
+  return count_ == 0 ? 0.0 : total_nanos_ / static_cast<double>(count_);
+}
+
+// Returns the latency at the given percentile.  This is the highest
+// latency of the bucket holding it, but no more than the largest
+// latency recorded, so it never understates the percentile.
+Int64 LatencyRecorder::PercentileNanos(double percentile) const {
+  if (count_ == 0)
+    return 0;
+
+  if (percentile < 0)
+    percentile = 0;
+  if (percentile > 100)
+    percentile = 100;
+
+  // The 1-based rank of the latency at the percentile.
+  Int64 rank = static_cast<Int64>(
+      ceil(percentile / 100.0 * static_cast<double>(count_)));
+  if (rank < 1)
+    rank = 1;
+
+  Int64 seen = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      const Int64 highest =
+          static_cast<Int64>(BucketHighestNanos(static_cast<int>(i)));
+      return highest < max_nanos_ ? highest : max_nanos_;
+    }
+  }
+  return max_nanos_;
+}
+
+// Returns a one-line summary of the distribution.
+String LatencyRecorder::Summary() const {
+  Message summary;
+  summary << "count=" << count_
+          << " min=" << FormatNanosAsMicros(min_nanos())
+          << " p50=" << FormatNanosAsMicros(PercentileNanos(50))
+          << " p90=" << FormatNanosAsMicros(PercentileNanos(90))
+          << " p99=" << FormatNanosAsMicros(PercentileNanos(99))
+          << " p99.9=" << FormatNanosAsMicros(PercentileNanos(99.9))
+          << " max=" << FormatNanosAsMicros(max_nanos());
+  return summary.GetString();
+}
+
+// Returns the non-empty buckets as "<lowest ns>:<count>" pairs.
+String LatencyRecorder::SerializeHistogram() const {
+  Message histogram;
+  bool is_first = true;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    if (counts_[i] == 0)
+      continue;
+
+    if (!is_first)
+      histogram << " ";
+    is_first = false;
+    histogram << BucketLowestNanos(static_cast<int>(i)) << ":" << counts_[i];
+  }
+  return histogram.GetString();
+}
+
+// Records the summary and the histogram as properties of the current
+// test.
+void LatencyRecorder::RecordAsProperties(const char* name) const {
+  Test::RecordProperty(
+      String::Format("%s_latency_summary", name).c_str(),
+      Summary().c_str());
+  Test::RecordProperty(
+      String::Format("%s_latency_histogram", name).c_str(),
+      SerializeHistogram().c_str());
+}
+
+namespace internal {
+
+// The helper function for {EXPECT|ASSERT}_PERCENTILE_LT.
+AssertionResult CmpHelperPercentileLT(
+    const char* recorder_expr, const char* percentile_expr,
+    const char* micros_expr, const LatencyRecorder& recorder,
+    double percentile, double micros) {
+  if (recorder.count() == 0) {
+    return AssertionFailure()
+        << "Expected: the " << percentile_expr << "th percentile of the "
+        << "latencies in " << recorder_expr << " is less than "
+        << micros_expr << "us\n"
+        << "  Actual: no latency has been recorded";
+  }
+
+  const Int64 nanos = recorder.PercentileNanos(percentile);
+  if (static_cast<double>(nanos) < micros * 1000.0)
+    return AssertionSuccess();
+
+  return AssertionFailure()
+      << "Expected: the " << percentile_expr << "th percentile of the "
+      << "latencies in " << recorder_expr << " is less than "
+      << micros_expr << "us\n"
+      << "  Actual: " << FormatNanosAsMicros(nanos) << "\n"
+      << "Latencies: " << recorder.Summary();
+}
+
+}  // namespace internal
+
+}  // namespace testing
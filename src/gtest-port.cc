@@ -39,6 +39,7 @@
 #if GTEST_OS_WINDOWS_MOBILE
 # include <windows.h>  // For TerminateProcess()
 #elif GTEST_OS_WINDOWS
+# include <windows.h>  // For the Interlocked functions.
 # include <io.h>
 # include <sys/stat.h>
 #else
@@ -133,6 +134,91 @@ size_t GetThreadCount() {
 
 #endif  // GTEST_OS_MAC
 
+#if defined(__GNUC__)
+// The atomic operations are inline in gtest-port.h.
+#elif GTEST_OS_WINDOWS
+
+long AtomicIncrement(volatile long* counter) {
+  return InterlockedIncrement(counter);
+}
+
+long AtomicDecrement(volatile long* counter) {
+  return InterlockedDecrement(counter);
+}
+
+// A compare-and-swap that never changes the value is a read with a full
+// barrier.
+long AtomicLoadCounter(const volatile long* counter) {
+  return InterlockedCompareExchange(const_cast<volatile long*>(counter),
+                                    0, 0);
+}
+
+void* AtomicLoadVoidPointer(void* const volatile* pointer) {
+  return InterlockedCompareExchangePointer(
+      const_cast<void* volatile*>(pointer), NULL, NULL);
+}
+
+void* AtomicCompareAndSwapVoidPointer(void* volatile* pointer,
+                                      void* old_value,
+                                      void* new_value) {
+  return InterlockedCompareExchangePointer(pointer, new_value, old_value);
+}
+
+#else
+
+// Serializes the atomic operations where there are no atomic builtins.
+GTEST_API_ GTEST_DEFINE_STATIC_MUTEX_(g_atomic_counter_mutex);
+
+#endif  // defined(__GNUC__)
+
+#if GTEST_HAS_COMPILER_TLS
+
+__thread ThreadLocalCacheEntry g_thread_local_cache[kThreadLocalCacheSize];
+
+// Protects the cache index and ID bookkeeping below.  ThreadLocal objects
+// may be created and destroyed concurrently.
+static GTEST_DEFINE_STATIC_MUTEX_(g_thread_local_cache_mutex);
+
+// The next cache index that has never been handed out.
+static int g_next_thread_local_cache_index = 0;
+
+// The indices released by dead ThreadLocal objects.
+static int g_free_thread_local_cache_indices[kThreadLocalCacheSize];
+static int g_free_thread_local_cache_index_count = 0;
+
+// The last ID given to a ThreadLocal object.
+static unsigned int g_last_thread_local_id = 0;
+
+// Returns a cache index and an ID for a new ThreadLocal object.
+int NewThreadLocalCacheIndex(unsigned int* owner_id) {
+  MutexLock lock(&g_thread_local_cache_mutex);
+  // 0 marks an empty entry.  IDs wrap around after 2^32 ThreadLocal
+  // objects, far more than a test program creates.
+  if (++g_last_thread_local_id == 0)
+    ++g_last_thread_local_id;
+  *owner_id = g_last_thread_local_id;
+
+  if (g_free_thread_local_cache_index_count > 0) {
+    return g_free_thread_local_cache_indices[
+        --g_free_thread_local_cache_index_count];
+  }
+  if (g_next_thread_local_cache_index < kThreadLocalCacheSize)
+    return g_next_thread_local_cache_index++;
+  return kThreadLocalCacheSize;
+}
+
+// Puts the given cache index on the free list.
+void ReleaseThreadLocalCacheIndex(int index) {
+  if (index >= kThreadLocalCacheSize)
+    return;
+
+  MutexLock lock(&g_thread_local_cache_mutex);
+  g_free_thread_local_cache_indices[
+      g_free_thread_local_cache_index_count++] = index;
+}
+
+#endif  // GTEST_HAS_COMPILER_TLS
+
 #if GTEST_USES_POSIX_RE
 
 // Implements RE.  Currently only needed for death tests.
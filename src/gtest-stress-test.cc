@@ -0,0 +1,277 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// This file implements RunStressTest() and MeasureThreadScaling().
+
+#include "gtest/gtest-stress-test.h"
+
+#include <ostream>
+
+#include "gtest/gtest.h"
+
+// Indicates that this translation unit is part of Google Test's
+// implementation.  It must come before gtest-internal-inl.h is
+// included, or there will be a compiler error.  This trick is to
+// prevent a user from accidentally including gtest-internal-inl.h in
+// his code.
+#define GTEST_IMPLEMENTATION_ 1
+#include "src/gtest-internal-inl.h"
+#undef GTEST_IMPLEMENTATION_
+
+namespace testing {
+
+#if GTEST_IS_THREADSAFE
+
+namespace internal {
+
+// The thread and iteration a stress test thread is running.  It's traced
+// lazily, so it's only formatted when an assertion fails.
+struct StressTestPosition {
+  int thread_index;
+  int iteration;
+};
+
+// Prints the position in failure messages.
+inline std::ostream& operator<<(std::ostream& os,
+                                const StressTestPosition& position) {
+  return os << "stress test thread #" << position.thread_index
+            << ", iteration #" << position.iteration;
+}
+
+// Counts the failures reported on a stress test thread while it's in
+// scope, and forwards them to the thread's original reporter.
+class StressTestFailureCounter : public TestPartResultReporterInterface {
+ public:
+  StressTestFailureCounter()
+      : failure_count_(0),
+        has_fatal_failure_(false),
+        original_reporter_(GetUnitTestImpl()->
+                           GetTestPartResultReporterForCurrentThread()) {
+    GetUnitTestImpl()->SetTestPartResultReporterForCurrentThread(this);
+  }
+
+  virtual ~StressTestFailureCounter() {
+    GetUnitTestImpl()->SetTestPartResultReporterForCurrentThread(
+        original_reporter_);
+  }
+
+  virtual void ReportTestPartResult(const TestPartResult& result) {
+    if (result.failed())
+      failure_count_++;
+    if (result.fatally_failed())
+      has_fatal_failure_ = true;
+    original_reporter_->ReportTestPartResult(result);
+  }
+
+  int failure_count() const { return failure_count_; }
+  bool has_fatal_failure() const { return has_fatal_failure_; }
+
+ private:
+  int failure_count_;
+  bool has_fatal_failure_;
+  TestPartResultReporterInterface* const original_reporter_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(StressTestFailureCounter);
+};
+
+// The state of one stress test thread.
+struct StressTestThread {
+  int thread_index;
+  int iteration_count;
+  StressTestBody* body;
+  // Released once all the threads have started.
+  Barrier* start_barrier;
+  StressTestThreadResult result;
+};
+
+// The thread function of a stress test thread.
+void RunStressTestThread(StressTestThread* thread) {
+  StressTestFailureCounter failure_counter;
+  StressTestPosition position = { thread->thread_index, 0 };
+  SCOPED_TRACE_LAZY(position);
+
+  thread->start_barrier->Wait();
+  const Int64 start = GetMonotonicTimeInNanos();
+  int iteration = 0;
+  for (; iteration < thread->iteration_count; iteration++) {
+    position.iteration = iteration;
+    RunStressTestIteration(thread->body, thread->thread_index, iteration);
+    if (failure_counter.has_fatal_failure()) {
+      // The failed iteration doesn't count as completed.
+      break;
+    }
+  }
+
+  thread->result.iteration_count = iteration;
+  thread->result.failure_count = failure_counter.failure_count();
+  thread->result.elapsed_time_nanos = GetMonotonicTimeInNanos() - start;
+}
+
+// Runs body->Run() on thread_count threads for iteration_count
+// iterations each, and returns the results of the threads.  Unlike
+// RunStressTest(), records no properties.
+static std::vector<StressTestThreadResult> RunStressTestThreads(
+    int thread_count, int iteration_count, StressTestBody* body) {
+  GTEST_CHECK_(thread_count > 0)
+      << "A stress test needs at least one thread, " << thread_count
+      << " given.";
+
+  std::vector<StressTestThread> threads(thread_count);
+  Barrier start_barrier(thread_count);
+  {
+    std::vector<ThreadWithParam<StressTestThread*>*> running_threads;
+    for (int i = 0; i < thread_count; i++) {
+      threads[i].thread_index = i;
+      threads[i].iteration_count = iteration_count;
+      threads[i].body = body;
+      threads[i].start_barrier = &start_barrier;
+      running_threads.push_back(new ThreadWithParam<StressTestThread*>(
+          &RunStressTestThread, &threads[i], NULL));
+    }
+
+    // Blocks until all the threads are done.
+    for (int i = 0; i < thread_count; i++)
+      delete running_threads[i];
+  }
+
+  // Makes the failures visible in the current test right away.
+  GetUnitTestImpl()->MergeTestPartResultsFromOtherThreads();
+
+  std::vector<StressTestThreadResult> results;
+  for (int i = 0; i < thread_count; i++)
+    results.push_back(threads[i].result);
+  return results;
+}
+
+}  // namespace internal
+
+// Runs body->Run() on thread_count threads for iteration_count
+// iterations each.
+std::vector<StressTestThreadResult> RunStressTest(
+    int thread_count, int iteration_count, StressTestBody* body) {
+  const std::vector<StressTestThreadResult> results =
+      internal::RunStressTestThreads(thread_count, iteration_count, body);
+  for (int i = 0; i < thread_count; i++) {
+    const StressTestThreadResult& result = results[i];
+    Message key;
+    key << "stress_thread_" << i;
+    Test::RecordProperty(
+        key.GetString().c_str(),
+        internal::String::Format(
+            "%d iterations in %.6f ms, %d %s", result.iteration_count,
+            static_cast<double>(result.elapsed_time_nanos) / 1e6,
+            result.failure_count,
+            result.failure_count == 1 ? "failure" : "failures").c_str());
+  }
+  return results;
+}
+
+// Returns the i-th point (0-based).
+const ThreadScalingPoint& ThreadScalingResult::GetPoint(int i) const {
+  GTEST_CHECK_(0 <= i && i < point_count())
+      << "Invalid index (" << i << ") into ThreadScalingResult.";
+  return points_[i];
+}
+
+// Returns the point for the given thread count, or aborts.
+const ThreadScalingPoint& ThreadScalingResult::FindPoint(
+    int thread_count) const {
+  for (size_t i = 0; i < points_.size(); i++) {
+    if (points_[i].thread_count == thread_count)
+      return points_[i];
+  }
+  GTEST_LOG_(FATAL) << "Throughput at " << thread_count
+                    << " threads wasn't measured.";
+  return points_[0];  // Not reached.
+}
+
+// Returns the scaling efficiency at the given thread count.
+double ThreadScalingResult::EfficiencyAt(int thread_count) const {
+  return FindPoint(thread_count).efficiency;
+}
+
+// Returns the throughput at the given thread count.
+double ThreadScalingResult::OpsPerSecondAt(int thread_count) const {
+  return FindPoint(thread_count).ops_per_second;
+}
+
+// Runs the workload with 1, 2, 4, ... max_thread_count threads and
+// computes the throughput and scaling efficiency at each.
+ThreadScalingResult MeasureThreadScaling(
+    int max_thread_count, int iteration_count, StressTestBody* body) {
+  GTEST_CHECK_(max_thread_count > 0)
+      << "MeasureThreadScaling() needs at least one thread, "
+      << max_thread_count << " given.";
+
+  ThreadScalingResult result;
+  for (int thread_count = 1; ; ) {
+    const std::vector<StressTestThreadResult> thread_results =
+        internal::RunStressTestThreads(thread_count, iteration_count, body);
+
+    // The threads start together, so the slowest one gives the wall time
+    // of the run.
+    internal::Int64 elapsed_time_nanos = 0;
+    internal::Int64 total_iteration_count = 0;
+    for (int i = 0; i < thread_count; i++) {
+      if (thread_results[i].elapsed_time_nanos > elapsed_time_nanos)
+        elapsed_time_nanos = thread_results[i].elapsed_time_nanos;
+      total_iteration_count += thread_results[i].iteration_count;
+    }
+
+    ThreadScalingPoint point;
+    point.thread_count = thread_count;
+    point.ops_per_second = elapsed_time_nanos > 0 ?
+        1e9 * static_cast<double>(total_iteration_count) /
+        static_cast<double>(elapsed_time_nanos) : 0.0;
+    const double single_thread_ops_per_second = result.points_.empty() ?
+        point.ops_per_second : result.points_[0].ops_per_second;
+    point.efficiency = single_thread_ops_per_second > 0 ?
+        point.ops_per_second / (thread_count * single_thread_ops_per_second) :
+        0.0;
+    result.points_.push_back(point);
+
+    Test::RecordProperty(
+        internal::String::Format("thread_scaling_%d", thread_count).c_str(),
+        internal::String::Format("%.0f ops/s, efficiency %.2f",
+                                 point.ops_per_second,
+                                 point.efficiency).c_str());
+
+    if (thread_count == max_thread_count)
+      break;
+    thread_count = thread_count * 2 < max_thread_count ?
+        thread_count * 2 : max_thread_count;
+  }
+  return result;
+}
+
+#endif  // GTEST_IS_THREADSAFE
+
+}  // namespace testing
@@ -43,6 +43,8 @@
 #include <wctype.h>
 
 #include <algorithm>
+#include <map>
+#include <new>
 #include <ostream>  // NOLINT
 #include <sstream>
 #include <vector>
@@ -60,6 +62,7 @@
 # include <strings.h>  // NOLINT
 # include <sys/mman.h>  // NOLINT
 # include <sys/time.h>  // NOLINT
+# include <time.h>  // NOLINT
 # include <unistd.h>  // NOLINT
 # include <string>
 
@@ -141,6 +144,7 @@ namespace testing {
 using internal::CountIf;
 using internal::ForEach;
 using internal::GetElementOr;
+using internal::GetMonotonicTimeInNanos;
 using internal::Shuffle;
 
 // Constants.
@@ -203,6 +207,14 @@ GTEST_DEFINE_string_(
     "being sent to a terminal and the TERM environment variable "
     "is set to xterm, xterm-color, xterm-256color, linux or cygwin.");
 
+GTEST_DEFINE_int32_(
+    fail_on_leak_bytes,
+    internal::Int32FromGTestEnv("fail_on_leak_bytes", -1),
+    "Fail a test when the heap grows by more than this many bytes from "
+    "the construction to the destruction of its fixture.  Requires a "
+    "heap profiler such as the gtest_allocations library.  A negative "
+    "value disables the check.");
+
 GTEST_DEFINE_string_(
     filter,
     internal::StringFromGTestEnv("filter", kUniversalFilter),
@@ -215,6 +227,14 @@ GTEST_DEFINE_string_(
 GTEST_DEFINE_bool_(list_tests, false,
                    "List all tests without running them.");
 
+GTEST_DEFINE_int32_(
+    max_failures_per_test,
+    internal::Int32FromGTestEnv("max_failures_per_test", 100),
+    "The maximum number of test part results a test records.  Further "
+    "failures identical (same file, line, and type) to a recorded one "
+    "are counted as its repeats, and other failures are only counted.  "
+    "0 means no limit.");
+
 GTEST_DEFINE_string_(
     output,
     internal::StringFromGTestEnv("output", ""),
@@ -256,6 +276,12 @@ GTEST_DEFINE_bool_(
     "True iff " GTEST_NAME_
     " should randomize tests' order on every run.");
 
+GTEST_DEFINE_bool_(
+    startup_profile,
+    internal::BoolFromGTestEnv("startup_profile", false),
+    "True iff " GTEST_NAME_ " should print the time and heap allocations "
+    "spent in each stage of its startup before running the tests.");
+
 GTEST_DEFINE_int32_(
     stack_trace_depth,
     internal::Int32FromGTestEnv("stack_trace_depth", kMaxStackTraceDepth),
@@ -276,6 +302,12 @@ GTEST_DEFINE_bool_(
     "if exceptions are enabled or exit the program with a non-zero code "
     "otherwise.");
 
+GTEST_DEFINE_bool_(
+    update_golden_files,
+    internal::BoolFromGTestEnv("update_golden_files", false),
+    "True iff {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE should replace the "
+    "golden files with the actual data instead of comparing against them.");
+
 namespace internal {
 
 // Generates a random number from [0, range), using a Linear
@@ -431,26 +463,28 @@ String UnitTestOptions::GetAbsolutePathToOutputFile() {
 // This recursive algorithm isn't very efficient, but is clear and
 // works well enough for matching test names, which are short.
 bool UnitTestOptions::PatternMatchesString(const char *pattern,
-                                           const char *str) {
+                                           StringPiece str) {
   switch (*pattern) {
     case '\0':
     case ':':  // Either ':' or '\0' marks the end of the pattern.
-      return *str == '\0';
+      return str.empty();
     case '?':  // Matches any single character.
-      return *str != '\0' && PatternMatchesString(pattern + 1, str + 1);
+      return !str.empty() &&
+          PatternMatchesString(pattern + 1, str.RemovePrefix(1));
     case '*':  // Matches any string (possibly empty) of characters.
-      return (*str != '\0' && PatternMatchesString(pattern, str + 1)) ||
+      return (!str.empty() &&
+              PatternMatchesString(pattern, str.RemovePrefix(1))) ||
           PatternMatchesString(pattern + 1, str);
     default:  // Non-special character.  Matches itself.
-      return *pattern == *str &&
-          PatternMatchesString(pattern + 1, str + 1);
+      return !str.empty() && *pattern == str[0] &&
+          PatternMatchesString(pattern + 1, str.RemovePrefix(1));
   }
 }
 
-bool UnitTestOptions::MatchesFilter(const String& name, const char* filter) {
+bool UnitTestOptions::MatchesFilter(StringPiece name, const char* filter) {
   const char *cur_pattern = filter;
   for (;;) {
-    if (PatternMatchesString(cur_pattern, name.c_str())) {
+    if (PatternMatchesString(cur_pattern, name)) {
       return true;
     }
 
@@ -473,32 +507,42 @@ bool UnitTestOptions::MatchesFilter(const String& name, const char* filter) {
 // name and the test name.
 bool UnitTestOptions::FilterMatchesTest(const String &test_case_name,
                                         const String &test_name) {
-  const String& full_name = String::Format("%s.%s",
-                                           test_case_name.c_str(),
-                                           test_name.c_str());
-
-  // Split --gtest_filter at '-', if there is one, to separate into
-  // positive filter and negative filter portions
-  const char* const p = GTEST_FLAG(filter).c_str();
-  const char* const dash = strchr(p, '-');
+  ::std::string full_name(test_case_name.c_str(), test_case_name.length());
+  full_name.append(1, '.').append(test_name.c_str(), test_name.length());
+
   String positive;
-  String negative;
+  const char* negative;
+  SplitFilter(GTEST_FLAG(filter).c_str(), &positive, &negative);
+  return FullNameMatchesFilter(full_name, positive.c_str(), negative);
+}
+
+// Splits a --gtest_filter value at its first '-' into the positive
+// and the negative patterns.
+void UnitTestOptions::SplitFilter(const char* filter, String* positive,
+                                  const char** negative) {
+  const char* const dash = strchr(filter, '-');
   if (dash == NULL) {
-    positive = GTEST_FLAG(filter).c_str();  // Whole string is a positive filter
-    negative = String("");
+    *positive = filter;  // Whole string is a positive filter
+    *negative = "";
   } else {
-    positive = String(p, dash - p);  // Everything up to the dash
-    negative = String(dash+1);       // Everything after the dash
-    if (positive.empty()) {
+    *positive = String(filter, dash - filter);  // Everything up to the dash
+    *negative = dash + 1;                       // Everything after the dash
+    if (positive->empty()) {
       // Treat '-test1' as the same as '*-test1'
-      positive = kUniversalFilter;
+      *positive = kUniversalFilter;
     }
   }
+}
 
+// Returns true iff full_name matches the positive patterns and none
+// of the negative patterns.
+bool UnitTestOptions::FullNameMatchesFilter(StringPiece full_name,
+                                            const char* positive,
+                                            const char* negative) {
   // A filter is a colon-separated list of patterns.  It matches a
   // test if any pattern in it matches the test.
-  return (MatchesFilter(full_name, positive.c_str()) &&
-          !MatchesFilter(full_name, negative.c_str()));
+  return (MatchesFilter(full_name, positive) &&
+          !MatchesFilter(full_name, negative));
 }
 
 #if GTEST_HAS_SEH
@@ -599,6 +643,21 @@ TypeId GetTestTypeId() {
 // library.  This is solely for testing GetTestTypeId().
 extern const TypeId kTestTypeIdInGoogleTest = GetTestTypeId();
 
+// The installed heap profiler.  It's a plain pointer, constant-initialized
+// to NULL, so that a profiler can be installed during static
+// initialization regardless of the order.
+static HeapProfilerInterface* g_heap_profiler = NULL;
+
+// Installs the profiler used to measure the heap usage of each test.
+void SetHeapProfiler(HeapProfilerInterface* profiler) {
+  g_heap_profiler = profiler;
+}
+
+// Returns the installed heap profiler, or NULL if there is none.
+HeapProfilerInterface* GetHeapProfiler() {
+  return g_heap_profiler;
+}
+
 // This predicate-formatter checks that 'results' contains a test part
 // failure of the given type and that the failure message contains the
 // given substring.
@@ -657,13 +716,172 @@ SingleFailureChecker::~SingleFailureChecker() {
   EXPECT_PRED_FORMAT3(HasOneFailure, *results_, type_, substr_);
 }
 
+// Formats count with thousands separators, e.g. "9,999,990".
+static std::string FormatCountWithThousandsSeparators(int count) {
+  const std::string digits = StreamableToString(count).c_str();
+  std::string grouped;
+  for (size_t i = 0; i < digits.length(); i++) {
+    if (i > 0 && (digits.length() - i) % 3 == 0)
+      grouped += ',';
+    grouped += digits[i];
+  }
+  return grouped;
+}
+
+// Returns the note reported after a failure that was repeated count more
+// times.  The count is printed with thousands separators.
+String FormatRepeatedFailureNote(int count) {
+  return String::Format("... and %s more identical %s",
+                        FormatCountWithThousandsSeparators(count).c_str(),
+                        count == 1 ? "failure" : "failures");
+}
+
+// Returns the note reported after a test that omitted count failures.
+String FormatOmittedFailureNote(int count) {
+  return String::Format("... and %s more %s",
+                        FormatCountWithThousandsSeparators(count).c_str(),
+                        count == 1 ? "failure" : "failures");
+}
+
+// Returns true iff the two failures have the same source file, line, and
+// type.
+static bool AreIdenticalFailures(const TestPartResult& lhs,
+                                 const TestPartResult& rhs) {
+  return lhs.type() == rhs.type() && lhs.line_number() == rhs.line_number() &&
+      String::CStringEquals(lhs.file_name(), rhs.file_name());
+}
+
+// Hashes the (file, line, type) key of a failure, with FNV-1a.
+static size_t HashFailure(const TestPartResult& failure) {
+  size_t hash = 2166136261U;
+  const char* const file_name = failure.file_name();
+  if (file_name != NULL) {
+    for (const char* p = file_name; *p != '\0'; ++p)
+      hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619U;
+  }
+  hash = (hash ^ static_cast<size_t>(failure.line_number())) * 16777619U;
+  return (hash ^ static_cast<size_t>(failure.type())) * 16777619U;
+}
+
+TestPartResultRecorder::TestPartResultRecorder()
+    : used_slot_count_(0),
+      indexed_result_count_(0),
+      omitted_fatal_failure_count_(0),
+      omitted_nonfatal_failure_count_(0) {}
+
+// Records the result unless the limit has been reached and it's a failure,
+// in which case it's counted as a repeat or as omitted.
+bool TestPartResultRecorder::Add(const TestPartResult& result) {
+  const int max_parts = GTEST_FLAG(max_failures_per_test);
+  if (max_parts > 0 && result.failed() &&
+      results_.size() >= static_cast<size_t>(max_parts)) {
+    AddRepeats(result, 1);
+    return false;
+  }
+  results_.push_back(result);
+  return true;
+}
+
+// Adds count to the repeat count of the last recorded failure identical to
+// the given one, or counts them as omitted if there is none.
+void TestPartResultRecorder::AddRepeats(const TestPartResult& failure,
+                                        int count) {
+  const int index = FindIdenticalFailure(failure);
+  if (index < 0) {
+    AddOmitted(failure.type(), count);
+    return;
+  }
+  if (repeat_counts_.size() <= static_cast<size_t>(index))
+    repeat_counts_.resize(index + 1);
+  repeat_counts_[index] += count;
+}
+
+// Counts count omitted failures of the given type.
+void TestPartResultRecorder::AddOmitted(TestPartResult::Type type,
+                                        int count) {
+  if (type == TestPartResult::kFatalFailure)
+    omitted_fatal_failure_count_ += count;
+  else if (type == TestPartResult::kNonFatalFailure)
+    omitted_nonfatal_failure_count_ += count;
+}
+
+// Forgets all results and counts.
+void TestPartResultRecorder::Clear() {
+  results_.clear();
+  repeat_counts_.clear();
+  failure_slots_.clear();
+  used_slot_count_ = 0;
+  indexed_result_count_ = 0;
+  omitted_fatal_failure_count_ = 0;
+  omitted_nonfatal_failure_count_ = 0;
+}
+
+// Exchanges the contents with other's.
+void TestPartResultRecorder::Swap(TestPartResultRecorder* other) {
+  results_.swap(other->results_);
+  repeat_counts_.swap(other->repeat_counts_);
+  failure_slots_.swap(other->failure_slots_);
+  std::swap(used_slot_count_, other->used_slot_count_);
+  std::swap(indexed_result_count_, other->indexed_result_count_);
+  std::swap(omitted_fatal_failure_count_,
+            other->omitted_fatal_failure_count_);
+  std::swap(omitted_nonfatal_failure_count_,
+            other->omitted_nonfatal_failure_count_);
+}
+
+// Returns the index of the last recorded failure identical to the given
+// one, or -1 if there is none.
+int TestPartResultRecorder::FindIdenticalFailure(
+    const TestPartResult& failure) {
+  IndexNewFailures();
+  if (failure_slots_.empty())
+    return -1;
+  return failure_slots_[FindSlot(failure)] - 1;
+}
+
+// Returns the slot that holds the failures identical to the given one, or
+// the empty slot where they belong.  The table is never full.
+size_t TestPartResultRecorder::FindSlot(const TestPartResult& failure) const {
+  const size_t mask = failure_slots_.size() - 1;
+  for (size_t slot = HashFailure(failure) & mask; ;
+       slot = (slot + 1) & mask) {
+    const int entry = failure_slots_[slot];
+    if (entry == 0 || AreIdenticalFailures(results_[entry - 1], failure))
+      return slot;
+  }
+}
+
+// Adds the failures recorded since the last call to the hash table,
+// doubling it whenever it would become more than half full.
+void TestPartResultRecorder::IndexNewFailures() {
+  const int result_count = static_cast<int>(results_.size());
+  for (; indexed_result_count_ < result_count; ++indexed_result_count_) {
+    if (!results_[indexed_result_count_].failed())
+      continue;
+
+    if (2 * (used_slot_count_ + 1) > static_cast<int>(failure_slots_.size())) {
+      std::vector<int> old_slots;
+      old_slots.swap(failure_slots_);
+      failure_slots_.assign(old_slots.empty() ? 16 : 2 * old_slots.size(), 0);
+      for (size_t i = 0; i < old_slots.size(); ++i) {
+        if (old_slots[i] != 0)
+          failure_slots_[FindSlot(results_[old_slots[i] - 1])] = old_slots[i];
+      }
+    }
+
+    const size_t slot = FindSlot(results_[indexed_result_count_]);
+    if (failure_slots_[slot] == 0)
+      ++used_slot_count_;
+    failure_slots_[slot] = indexed_result_count_ + 1;
+  }
+}
+
 DefaultGlobalTestPartResultReporter::DefaultGlobalTestPartResultReporter(
     UnitTestImpl* unit_test) : unit_test_(unit_test) {}
 
 void DefaultGlobalTestPartResultReporter::ReportTestPartResult(
     const TestPartResult& result) {
-  unit_test_->current_test_result()->AddTestPartResult(result);
-  unit_test_->listeners()->repeater()->OnTestPartResult(result);
+  unit_test_->RecordTestPartResult(result);
 }
 
 DefaultPerThreadTestPartResultReporter::DefaultPerThreadTestPartResultReporter(
@@ -674,18 +892,98 @@ void DefaultPerThreadTestPartResultReporter::ReportTestPartResult(
   unit_test_->GetGlobalTestPartResultReporter()->ReportTestPartResult(result);
 }
 
-// Returns the global test part result reporter.
+// Records a test part result reported by the calling thread.  Other
+// threads than the one running the tests only append to their own
+// buffer, which doesn't contend with any other thread's assertions.
+void UnitTestImpl::RecordTestPartResult(const TestPartResult& result) {
+  if (is_test_thread_.get()) {
+    if (current_test_result()->AddTestPartResult(result))
+      listeners()->repeater()->OnTestPartResult(result);
+    return;
+  }
+
+  ThreadTestPartResults* buffer = thread_test_part_results_.get();
+  if (buffer == NULL) {
+    buffer = new ThreadTestPartResults;
+    {
+      MutexLock lock(&all_thread_test_part_results_mutex_);
+      all_thread_test_part_results_.push_back(buffer);
+    }
+    thread_test_part_results_.set(buffer);
+  }
+
+  MutexLock lock(&buffer->mutex);
+  if (result.fatally_failed())
+    buffer->has_fatal_failure = true;
+  else if (result.nonfatally_failed())
+    buffer->has_nonfatal_failure = true;
+
+  buffer->results.Add(result);
+}
+
+// Adds the test part results buffered by other threads to the current
+// TestResult, in the order in which the threads first reported.
+void UnitTestImpl::MergeTestPartResultsFromOtherThreads() {
+  std::vector<ThreadTestPartResults*> buffers;
+  {
+    MutexLock lock(&all_thread_test_part_results_mutex_);
+    buffers = all_thread_test_part_results_;
+  }
+
+  TestEventListener* const repeater = listeners()->repeater();
+  TestResult* const test_result = current_test_result();
+  for (size_t i = 0; i < buffers.size(); i++) {
+    TestPartResultRecorder recorder;
+    {
+      MutexLock lock(&buffers[i]->mutex);
+      recorder.Swap(&buffers[i]->results);
+      buffers[i]->has_fatal_failure = false;
+      buffers[i]->has_nonfatal_failure = false;
+    }
+    const std::vector<TestPartResult>& results = recorder.results();
+    for (size_t j = 0; j < results.size(); j++) {
+      if (test_result->AddTestPartResult(results[j]))
+        repeater->OnTestPartResult(results[j]);
+      const int repeat_count = recorder.repeat_count(static_cast<int>(j));
+      if (repeat_count > 0)
+        test_result->AddTestPartRepeats(results[j], repeat_count);
+    }
+    test_result->AddOmittedFailures(TestPartResult::kFatalFailure,
+                                    recorder.omitted_fatal_failure_count());
+    test_result->AddOmittedFailures(
+        TestPartResult::kNonFatalFailure,
+        recorder.omitted_nonfatal_failure_count());
+  }
+}
+
+// Returns true iff another thread has buffered a failure of the given
+// type since the last merge.
+bool UnitTestImpl::HasUnmergedFailure(TestPartResult::Type type) {
+  MutexLock lock(&all_thread_test_part_results_mutex_);
+  for (size_t i = 0; i < all_thread_test_part_results_.size(); i++) {
+    ThreadTestPartResults* const buffer = all_thread_test_part_results_[i];
+    MutexLock buffer_lock(&buffer->mutex);
+    if (type == TestPartResult::kFatalFailure ? buffer->has_fatal_failure :
+        buffer->has_nonfatal_failure)
+      return true;
+  }
+  return false;
+}
+
+// Returns the global test part result reporter.  It is called for every
+// assertion on every thread, so it doesn't take a lock.
 TestPartResultReporterInterface*
 UnitTestImpl::GetGlobalTestPartResultReporter() {
-  internal::MutexLock lock(&global_test_part_result_reporter_mutex_);
-  return global_test_part_result_repoter_;
+  return AtomicLoadPointer(&global_test_part_result_repoter_);
 }
 
-// Sets the global test part result reporter.
+// Sets the global test part result reporter.  The writers are serialized,
+// so the swap always succeeds; it publishes the reporter to the readers.
 void UnitTestImpl::SetGlobalTestPartResultReporter(
     TestPartResultReporterInterface* reporter) {
   internal::MutexLock lock(&global_test_part_result_reporter_mutex_);
-  global_test_part_result_repoter_ = reporter;
+  AtomicCompareAndSwapPointer(&global_test_part_result_repoter_,
+                              global_test_part_result_repoter_, reporter);
 }
 
 // Returns the test part result reporter for the current thread.
@@ -813,6 +1111,32 @@ TimeInMillis GetTimeInMillis() {
 #endif
 }
 
+// Returns the current time of a monotonic clock, in nanoseconds since an
+// arbitrary point.  Where the platform has no monotonic clock, the wall
+// clock is used.
+Int64 GetMonotonicTimeInNanos() {
+#if GTEST_OS_WINDOWS
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  // Splits the conversion so that it doesn't overflow.
+  const Int64 seconds = counter.QuadPart / frequency.QuadPart;
+  const Int64 remainder = counter.QuadPart % frequency.QuadPart;
+  return seconds * 1000000000 + remainder * 1000000000 / frequency.QuadPart;
+#elif GTEST_OS_LINUX
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<Int64>(now.tv_sec) * 1000000000 + now.tv_nsec;
+#else
+  // gettimeofday() isn't monotonic, but is available everywhere else.
+  timeval now;
+  gettimeofday(&now, NULL);
+  return static_cast<Int64>(now.tv_sec) * 1000000000 +
+      static_cast<Int64>(now.tv_usec) * 1000;
+#endif  // GTEST_OS_WINDOWS
+}
+
 // Utilities
 
 // class String
@@ -927,6 +1251,56 @@ static void StreamWideCharsToMessage(const wchar_t* wstr, size_t length,
 
 }  // namespace internal
 
+// class Message
+
+// Copies the text of msg, to the buffer if it fits.
+Message::Message(const Message& msg) {  // NOLINT
+  set_buffer_length(0);
+  if (!msg.has_stream()) {
+    Append(msg.buffer_, msg.buffer_length());
+  } else {
+    const ::std::string str = msg.ss_->str();
+    Append(str.data(), str.length());
+  }
+}
+
+#if GTEST_LANG_CXX11
+// Takes over the text or the stringstream of msg, leaving it empty.
+Message::Message(Message&& msg) {  // NOLINT
+  memcpy(buffer_, msg.buffer_, kStorageSize);
+  msg.set_buffer_length(0);
+}
+#endif  // GTEST_LANG_CXX11
+
+// Deletes the stringstream, if there's one.
+Message::~Message() {
+  if (has_stream())
+    delete ss_;
+}
+
+// Creates the stringstream on first use.  Kept out of line, as most
+// messages never need one.
+::std::stringstream* Message::GetStream() {
+  if (!has_stream()) {
+    ::std::stringstream* const ss = new ::std::stringstream;
+    // By default, we want there to be enough precision when printing
+    // a double to a Message.
+    *ss << std::setprecision(std::numeric_limits<double>::digits10 + 2);
+    ss->write(buffer_, static_cast< ::std::streamsize>(buffer_length()));
+    // The pointer takes the place of the text.
+    ss_ = ss;
+    buffer_[kBufferCapacity] = kHasStream;
+  }
+  return ss_;
+}
+
+// Gets the text streamed to this object so far as a String.
+internal::String Message::GetString() const {
+  if (has_stream())
+    return internal::StringStreamToString(ss_);
+  return internal::CharsToStringEscapingNuls(buffer_, buffer_length());
+}
+
 #if GTEST_HAS_STD_WSTRING
 // Converts the given wide string to a narrow string using the UTF-8
 // encoding, and streams the result to this Message object.
@@ -980,6 +1354,371 @@ AssertionResult AssertionFailure(const Message& message) {
 
 namespace internal {
 
+namespace edit_distance {
+
+namespace {
+
+// Finds shortest edit scripts with the linear-space variant of Myers'
+// algorithm ("An O(ND) Difference Algorithm and Its Variations",
+// 1986): it looks for the middle snake of a shortest path from both
+// ends at once, and recurses on the parts before and after it.
+class MyersDiff {
+ public:
+  MyersDiff(const std::vector<size_t>& left,
+            const std::vector<size_t>& right,
+            size_t max_work)
+      : left_(left), right_(right), max_work_(max_work), work_(0) {}
+
+  std::vector<EditType> Run() {
+    Diff(0, left_.size(), 0, right_.size());
+    return edits_;
+  }
+
+ private:
+  // A snake of a path: the diagonal run of matches from (x, y) to
+  // (u, v), where x and u index left_ and y and v index right_.
+  struct Snake {
+    size_t x, y, u, v;
+  };
+
+  // Appends to edits_ the edits that turn left_[left_begin, left_end)
+  // into right_[right_begin, right_end).
+  void Diff(size_t left_begin, size_t left_end,
+            size_t right_begin, size_t right_end) {
+    while (left_begin != left_end && right_begin != right_end &&
+           left_[left_begin] == right_[right_begin]) {
+      edits_.push_back(kMatch);
+      left_begin++;
+      right_begin++;
+    }
+    size_t common_suffix = 0;
+    while (left_begin != left_end && right_begin != right_end &&
+           left_[left_end - 1] == right_[right_end - 1]) {
+      left_end--;
+      right_end--;
+      common_suffix++;
+    }
+
+    // After the common prefix and suffix are gone, a non-empty region
+    // is at least two edits long, and each half around its middle
+    // snake is strictly shorter, so the recursion terminates.
+    Snake snake;
+    if (left_begin == left_end || right_begin == right_end ||
+        !FindMiddleSnake(left_begin, left_end, right_begin, right_end,
+                         &snake)) {
+      edits_.insert(edits_.end(), left_end - left_begin, kRemove);
+      edits_.insert(edits_.end(), right_end - right_begin, kAdd);
+    } else {
+      Diff(left_begin, left_begin + snake.x,
+           right_begin, right_begin + snake.y);
+      edits_.insert(edits_.end(), snake.u - snake.x, kMatch);
+      Diff(left_begin + snake.u, left_end, right_begin + snake.v, right_end);
+    }
+    edits_.insert(edits_.end(), common_suffix, kMatch);
+  }
+
+  // Finds the middle snake of a shortest edit script for the given
+  // regions, in coordinates relative to their beginnings.  Returns
+  // false if the work budget runs out first.
+  bool FindMiddleSnake(size_t left_begin, size_t left_end,
+                       size_t right_begin, size_t right_end,
+                       Snake* snake) {
+    const long n = static_cast<long>(left_end - left_begin);
+    const long m = static_cast<long>(right_end - right_begin);
+    const long delta = n - m;
+    const bool odd = (delta % 2) != 0;
+    const long max_d = (n + m + 1) / 2;
+
+    // forward_[k + offset] is the furthest x reached on diagonal
+    // k = x - y from the beginning; backward_ is the same from the end
+    // of the regions, going backwards.
+    const long offset = max_d + 1;
+    forward_.assign(2*max_d + 3, 0);
+    backward_.assign(2*max_d + 3, 0);
+    long* const forward = &forward_[offset];
+    long* const backward = &backward_[offset];
+
+    for (long d = 0; d <= max_d; d++) {
+      if (work_ > max_work_)
+        return false;
+
+      for (long k = -d; k <= d; k += 2) {
+        long x = (k == -d || (k != d && forward[k - 1] < forward[k + 1])) ?
+            forward[k + 1] : forward[k - 1] + 1;
+        long y = x - k;
+        const long x0 = x, y0 = y;
+        while (x < n && y < m &&
+               left_[left_begin + x] == right_[right_begin + y]) {
+          x++;
+          y++;
+        }
+        forward[k] = x;
+        work_ += x - x0 + 1;
+
+        const long c = delta - k;  // The same diagonal seen from the end.
+        if (odd && c >= -(d - 1) && c <= d - 1 && x + backward[c] >= n) {
+          snake->x = x0;
+          snake->y = y0;
+          snake->u = x;
+          snake->v = y;
+          return true;
+        }
+      }
+
+      for (long k = -d; k <= d; k += 2) {
+        long x = (k == -d || (k != d && backward[k - 1] < backward[k + 1])) ?
+            backward[k + 1] : backward[k - 1] + 1;
+        long y = x - k;
+        const long x0 = x, y0 = y;
+        while (x < n && y < m &&
+               left_[left_end - 1 - x] == right_[right_end - 1 - y]) {
+          x++;
+          y++;
+        }
+        backward[k] = x;
+        work_ += x - x0 + 1;
+
+        const long c = delta - k;
+        if (!odd && c >= -d && c <= d && x + forward[c] >= n) {
+          snake->x = n - x;
+          snake->y = m - y;
+          snake->u = n - x0;
+          snake->v = m - y0;
+          return true;
+        }
+      }
+    }
+    return false;  // Not reached for valid input.
+  }
+
+  const std::vector<size_t>& left_;
+  const std::vector<size_t>& right_;
+  const size_t max_work_;
+  size_t work_;
+  std::vector<long> forward_;
+  std::vector<long> backward_;
+  std::vector<EditType> edits_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(MyersDiff);
+};
+
+// The most lines CreateUnifiedDiff() prints.
+const size_t kMaxDiffLines = 200;
+
+// Prints the lines of a unified diff, dropping the ones over
+// kMaxDiffLines.
+class UnifiedDiffPrinter {
+ public:
+  UnifiedDiffPrinter() : printed_(0), omitted_(0) {}
+
+  void AddHunkHeader(size_t left_start, size_t left_count,
+                     size_t right_start, size_t right_count) {
+    if (Full())
+      return;
+    ss_ << "@@ -" << left_start << "," << left_count
+        << " +" << right_start << "," << right_count << " @@\n";
+    printed_++;
+  }
+
+  void AddLine(char prefix, const std::string& line) {
+    if (Full()) {
+      omitted_++;
+      return;
+    }
+    ss_ << prefix << line << "\n";
+    printed_++;
+  }
+
+  String GetString() {
+    if (omitted_ > 0)
+      ss_ << "(" << omitted_ << " more lines of diff not shown)\n";
+    return StringStreamToString(&ss_);
+  }
+
+ private:
+  bool Full() const { return printed_ >= kMaxDiffLines; }
+
+  ::std::stringstream ss_;
+  size_t printed_;
+  size_t omitted_;
+};
+
+}  // namespace
+
+std::vector<EditType> CalculateOptimalEdits(const std::vector<size_t>& left,
+                                            const std::vector<size_t>& right,
+                                            size_t max_work) {
+  return MyersDiff(left, right, max_work).Run();
+}
+
+String CreateUnifiedDiff(const std::vector<std::string>& left,
+                         const std::vector<std::string>& right,
+                         size_t context,
+                         size_t first_line) {
+  // Diffs the lines as ids, so that comparing two lines is cheap.
+  std::map<std::string, size_t> ids;
+  std::vector<size_t> left_ids, right_ids;
+  for (size_t i = 0; i != left.size(); i++) {
+    left_ids.push_back(
+        ids.insert(std::make_pair(left[i], ids.size())).first->second);
+  }
+  for (size_t i = 0; i != right.size(); i++) {
+    right_ids.push_back(
+        ids.insert(std::make_pair(right[i], ids.size())).first->second);
+  }
+  const std::vector<EditType> edits =
+      CalculateOptimalEdits(left_ids, right_ids);
+
+  UnifiedDiffPrinter printer;
+  size_t left_pos = 0, right_pos = 0;  // The lines edits[edit] acts on.
+  size_t edit = 0;
+  while (edit != edits.size()) {
+    size_t change = edit;
+    while (change != edits.size() && edits[change] == kMatch)
+      change++;
+    if (change == edits.size())
+      break;
+
+    // A hunk starts 'context' matches before its first change, and ends
+    // 'context' matches after a change that is followed by more than
+    // 2*context matches.
+    const size_t hunk_begin = change - (std::min)(context, change - edit);
+    size_t last_change = change;
+    for (size_t i = change; i != edits.size(); i++) {
+      if (edits[i] != kMatch) {
+        last_change = i;
+      } else if (i - last_change > 2*context) {
+        break;
+      }
+    }
+    const size_t hunk_end =
+        (std::min)(edits.size(), last_change + 1 + context);
+
+    left_pos += hunk_begin - edit;
+    right_pos += hunk_begin - edit;
+    size_t left_count = 0, right_count = 0;
+    for (size_t i = hunk_begin; i != hunk_end; i++) {
+      left_count += edits[i] != kAdd;
+      right_count += edits[i] != kRemove;
+    }
+    // Like diff -u, an empty side is numbered after the line before it.
+    printer.AddHunkHeader(first_line + left_pos - (left_count == 0),
+                          left_count,
+                          first_line + right_pos - (right_count == 0),
+                          right_count);
+
+    // Prints each run of changes as its removed lines followed by its
+    // added lines, which reads better than interleaving them.
+    for (size_t i = hunk_begin; i != hunk_end;) {
+      if (edits[i] == kMatch) {
+        printer.AddLine(' ', left[left_pos]);
+        left_pos++;
+        right_pos++;
+        i++;
+        continue;
+      }
+      size_t run_end = i;
+      while (run_end != hunk_end && edits[run_end] != kMatch)
+        run_end++;
+      for (size_t j = i; j != run_end; j++) {
+        if (edits[j] == kRemove)
+          printer.AddLine('-', left[left_pos++]);
+      }
+      for (size_t j = i; j != run_end; j++) {
+        if (edits[j] == kAdd)
+          printer.AddLine('+', right[right_pos++]);
+      }
+      i = run_end;
+    }
+    edit = hunk_end;
+  }
+  return printer.GetString();
+}
+
+}  // namespace edit_distance
+
+namespace {
+
+// Splits the length characters at str into lines.
+std::vector<std::string> SplitIntoLines(const char* str, size_t length) {
+  std::vector<std::string> lines;
+  size_t begin = 0;
+  for (size_t i = 0; i != length; i++) {
+    if (str[i] == '\n') {
+      lines.push_back(std::string(str + begin, i - begin));
+      begin = i + 1;
+    }
+  }
+  lines.push_back(std::string(str + begin, length - begin));
+  return lines;
+}
+
+// Returns a unified diff of the lines of two strings, or an empty string
+// if neither has more than one line.
+String DiffLines(const char* expected, size_t expected_length,
+                 const char* actual, size_t actual_length) {
+  const std::vector<std::string> expected_lines =
+      SplitIntoLines(expected, expected_length);
+  const std::vector<std::string> actual_lines =
+      SplitIntoLines(actual, actual_length);
+  if (expected_lines.size() == 1 && actual_lines.size() == 1)
+    return String("");
+  return edit_distance::CreateUnifiedDiff(expected_lines, actual_lines);
+}
+
+// Returns the UTF-8 encoding of the length wide characters at str.
+std::string WideCharsToUtf8String(const wchar_t* str, size_t length) {
+  std::string utf8(Utf8LengthOfWideChars(str, length), '\0');
+  if (!utf8.empty())
+    WideCharsToUtf8(str, length, &utf8[0]);
+  return utf8;
+}
+
+// Adds the diff of the two strings compared by a failed string equality
+// assertion to its failure message, if there is one.
+AssertionResult AppendStringDiff(AssertionResult result, const String& diff) {
+  if (!diff.empty())
+    result << "\nWith diff:\n" << diff;
+  return result;
+}
+
+}  // namespace
+
+// Returns a unified diff of the lines of two strings, or an empty
+// string if neither has more than one line.
+String DiffStrings(const ::std::string& expected,
+                   const ::std::string& actual) {
+  return DiffLines(expected.c_str(), expected.length(),
+                   actual.c_str(), actual.length());
+}
+
+#if GTEST_HAS_STD_WSTRING
+String DiffStrings(const ::std::wstring& expected,
+                   const ::std::wstring& actual) {
+  return DiffStrings(WideCharsToUtf8String(expected.c_str(), expected.length()),
+                     WideCharsToUtf8String(actual.c_str(), actual.length()));
+}
+#endif  // GTEST_HAS_STD_WSTRING
+
+// Returns a unified diff of the printed elements of two containers.
+String DiffPrintedElements(std::vector<std::string>* expected_lines,
+                           std::vector<std::string>* actual_lines,
+                           size_t first_position) {
+  const bool truncated = expected_lines->size() > kMaxElementsToDiff ||
+      actual_lines->size() > kMaxElementsToDiff;
+  expected_lines->resize(
+      (std::min)(expected_lines->size(), kMaxElementsToDiff));
+  actual_lines->resize((std::min)(actual_lines->size(), kMaxElementsToDiff));
+
+  Message msg;
+  msg << edit_distance::CreateUnifiedDiff(*expected_lines, *actual_lines,
+                                          kDiffContext, first_position);
+  if (truncated) {
+    msg << "(only " << kMaxElementsToDiff << " elements were compared)\n";
+  }
+  return msg.GetString();
+}
+
 // Constructs and returns the message for an equality assertion
 // (e.g. ASSERT_EQ, EXPECT_STREQ, etc) failure.
 //
@@ -1088,6 +1827,290 @@ AssertionResult FloatingPointLE(const char* expr1,
       << StringStreamToString(&val2_ss);
 }
 
+// The maximum number of differing elements that the floating-point
+// array assertions list in their failure message.
+const size_t kMaxArrayMismatchesToPrint = 10;
+
+// Prints a floating-point number with enough digits to tell it apart
+// from its neighbours.
+template <typename RawType>
+String FloatingPointToString(RawType value) {
+  ::std::stringstream ss;
+  ss << std::setprecision(std::numeric_limits<RawType>::digits10 + 2)
+     << value;
+  return StringStreamToString(&ss);
+}
+
+// Returns the number of elements of the two arrays that are NAN or
+// more than max_ulps ULP's apart.  The loop has no early exit and
+// BitsAlmostEqual() has no branches, so the compiler can vectorize it.
+template <typename RawType>
+size_t CountUlpMismatches(const RawType* expected, const RawType* actual,
+                          size_t count,
+                          typename FloatingPoint<RawType>::Bits max_ulps) {
+  typedef typename FloatingPoint<RawType>::Bits Bits;
+  size_t mismatches = 0;
+  for (size_t i = 0; i != count; i++) {
+    Bits expected_bits, actual_bits;
+    memcpy(&expected_bits, expected + i, sizeof(expected_bits));
+    memcpy(&actual_bits, actual + i, sizeof(actual_bits));
+    mismatches += !FloatingPoint<RawType>::BitsAlmostEqual(
+        expected_bits, actual_bits, max_ulps);
+  }
+  return mismatches;
+}
+
+// Returns the number of elements of the two arrays that are NAN or
+// more than abs_error apart.  Like CountUlpMismatches(), it is written
+// so that the compiler can vectorize it.
+template <typename RawType>
+size_t CountAbsErrorMismatches(const RawType* expected,
+                               const RawType* actual,
+                               size_t count,
+                               RawType abs_error) {
+  size_t mismatches = 0;
+  for (size_t i = 0; i != count; i++) {
+    const RawType diff = expected[i] - actual[i];
+    // Written so that a NAN difference counts as a mismatch.
+    mismatches += !((diff < 0 ? -diff : diff) <= abs_error);
+  }
+  return mismatches;
+}
+
+// Builds the failure message of the floating-point array assertions.
+// When abs_error_expression is NULL the elements were compared in
+// ULP's, with max_ulps as the tolerance (max_ulps_expression is NULL
+// for the default kMaxUlps); otherwise they were compared with
+// abs_error.  The message
+// states how many elements differ, the largest difference and lists
+// the first kMaxArrayMismatchesToPrint differing elements.  A
+// difference involving a NAN is larger than any other.
+template <typename RawType>
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult FloatingPointArrayFailure(const char* expected_expression,
+                                          const char* actual_expression,
+                                          const char* count_expression,
+                                          const char* abs_error_expression,
+                                          const char* max_ulps_expression,
+                                          const RawType* expected,
+                                          const RawType* actual,
+                                          size_t count,
+                                          size_t mismatches,
+                                          RawType abs_error,
+                                          size_t max_ulps) {
+  typedef FloatingPoint<RawType> FP;
+  typedef typename FP::Bits Bits;
+  const bool use_ulps = abs_error_expression == NULL;
+
+  Message listing;
+  size_t listed = 0;
+  size_t worst_index = 0;
+  double worst_error = 0;
+  for (size_t i = 0; i != count; i++) {
+    const FP lhs(expected[i]), rhs(actual[i]);
+    const bool is_nan = lhs.is_nan() || rhs.is_nan();
+    const RawType diff = expected[i] - actual[i];
+    bool differs;
+    double error;
+    if (use_ulps) {
+      differs = !FP::BitsAlmostEqual(lhs.bits(), rhs.bits(),
+                                     static_cast<Bits>(max_ulps));
+      error = static_cast<double>(FP::DistanceInUlps(lhs.bits(), rhs.bits()));
+    } else {
+      error = diff < 0 ? -diff : diff;
+      differs = !(error <= abs_error);
+    }
+    if (!differs)
+      continue;
+    if (is_nan)
+      error = std::numeric_limits<double>::quiet_NaN();
+
+    if (listed == 0 || (worst_error == worst_error &&
+                        (error != error || error > worst_error))) {
+      worst_index = i;
+      worst_error = error;
+    }
+    if (listed < kMaxArrayMismatchesToPrint) {
+      listing << "\n  index " << i
+              << ": expected " << FloatingPointToString(expected[i])
+              << ", actual " << FloatingPointToString(actual[i]);
+      listed++;
+    }
+  }
+
+  const String count_value = StreamableToString(count);
+  Message msg;
+  msg << "Value of: " << actual_expression
+      << "\nExpected: " << expected_expression
+      << "\n" << mismatches << " of " << count_expression;
+  if (count_value != count_expression) {
+    msg << " (" << count_value << ")";
+  }
+  msg << " elements differ by more than ";
+  if (use_ulps) {
+    const String max_ulps_value = StreamableToString(max_ulps);
+    if (max_ulps_expression == NULL) {
+      msg << max_ulps_value;
+    } else {
+      msg << max_ulps_expression;
+      if (max_ulps_value != max_ulps_expression) {
+        msg << " (" << max_ulps_value << ")";
+      }
+    }
+    msg << " ULP's";
+  } else {
+    msg << abs_error_expression;
+    const String abs_error_value = FloatingPointToString(abs_error);
+    if (abs_error_value != abs_error_expression) {
+      msg << " (" << abs_error_value << ")";
+    }
+  }
+
+  msg << "\nThe largest difference is ";
+  if (worst_error != worst_error) {
+    msg << "NaN";
+  } else if (use_ulps) {
+    msg << FloatingPointToString(worst_error) << " ULP's";
+  } else {
+    msg << FloatingPointToString(worst_error);
+  }
+  msg << " at index " << worst_index << ": expected "
+      << FloatingPointToString(expected[worst_index]) << ", actual "
+      << FloatingPointToString(actual[worst_index]);
+
+  msg << "\n" << (listed == mismatches ? "The differing elements are:" :
+                  "The first differing elements are:")
+      << listing.GetString();
+  return AssertionFailure() << msg;
+}
+
+// The implementation of {ASSERT|EXPECT}_{FLOAT|DOUBLE}_ARRAY_EQ and
+// {ASSERT|EXPECT}_{FLOAT|DOUBLE}_ARRAY_NEAR_ULPS.  max_ulps_expression
+// is NULL for the former, which use kMaxUlps.
+template <typename RawType>
+AssertionResult CmpHelperFloatingPointArrayEQ(const char* expected_expression,
+                                              const char* actual_expression,
+                                              const char* count_expression,
+                                              const char* max_ulps_expression,
+                                              const RawType* expected,
+                                              const RawType* actual,
+                                              size_t count,
+                                              size_t max_ulps) {
+  typedef typename FloatingPoint<RawType>::Bits Bits;
+  const size_t mismatches = CountUlpMismatches(
+      expected, actual, count, static_cast<Bits>(max_ulps));
+  if (mismatches == 0) {
+    return AssertionSuccess();
+  }
+
+  return FloatingPointArrayFailure<RawType>(
+      expected_expression, actual_expression, count_expression, NULL,
+      max_ulps_expression, expected, actual, count, mismatches, 0, max_ulps);
+}
+
+// The implementation of {ASSERT|EXPECT}_{FLOAT|DOUBLE}_ARRAY_NEAR.
+template <typename RawType>
+AssertionResult FloatingPointArrayNearPredFormat(
+    const char* expected_expression,
+    const char* actual_expression,
+    const char* count_expression,
+    const char* abs_error_expression,
+    const RawType* expected,
+    const RawType* actual,
+    size_t count,
+    RawType abs_error) {
+  const size_t mismatches =
+      CountAbsErrorMismatches(expected, actual, count, abs_error);
+  if (mismatches == 0) {
+    return AssertionSuccess();
+  }
+
+  return FloatingPointArrayFailure<RawType>(
+      expected_expression, actual_expression, count_expression,
+      abs_error_expression, NULL, expected, actual, count, mismatches,
+      abs_error, 0);
+}
+
+// Helper function for {ASSERT|EXPECT}_FLOAT_ARRAY_EQ.
+AssertionResult CmpHelperFloatArrayEQ(const char* expected_expression,
+                                      const char* actual_expression,
+                                      const char* count_expression,
+                                      const float* expected,
+                                      const float* actual,
+                                      size_t count) {
+  return CmpHelperFloatingPointArrayEQ<float>(
+      expected_expression, actual_expression, count_expression, NULL,
+      expected, actual, count, FloatingPoint<float>::kMaxUlps);
+}
+
+// Helper function for {ASSERT|EXPECT}_DOUBLE_ARRAY_EQ.
+AssertionResult CmpHelperDoubleArrayEQ(const char* expected_expression,
+                                       const char* actual_expression,
+                                       const char* count_expression,
+                                       const double* expected,
+                                       const double* actual,
+                                       size_t count) {
+  return CmpHelperFloatingPointArrayEQ<double>(
+      expected_expression, actual_expression, count_expression, NULL,
+      expected, actual, count, FloatingPoint<double>::kMaxUlps);
+}
+
+// Helper function for {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR_ULPS.
+AssertionResult FloatArrayNearUlpsPredFormat(const char* expected_expression,
+                                             const char* actual_expression,
+                                             const char* count_expression,
+                                             const char* max_ulps_expression,
+                                             const float* expected,
+                                             const float* actual,
+                                             size_t count,
+                                             size_t max_ulps) {
+  return CmpHelperFloatingPointArrayEQ<float>(
+      expected_expression, actual_expression, count_expression,
+      max_ulps_expression, expected, actual, count, max_ulps);
+}
+
+// Helper function for {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR_ULPS.
+AssertionResult DoubleArrayNearUlpsPredFormat(const char* expected_expression,
+                                              const char* actual_expression,
+                                              const char* count_expression,
+                                              const char* max_ulps_expression,
+                                              const double* expected,
+                                              const double* actual,
+                                              size_t count,
+                                              size_t max_ulps) {
+  return CmpHelperFloatingPointArrayEQ<double>(
+      expected_expression, actual_expression, count_expression,
+      max_ulps_expression, expected, actual, count, max_ulps);
+}
+
+// Helper function for {ASSERT|EXPECT}_FLOAT_ARRAY_NEAR.
+AssertionResult FloatArrayNearPredFormat(const char* expected_expression,
+                                         const char* actual_expression,
+                                         const char* count_expression,
+                                         const char* abs_error_expression,
+                                         const float* expected,
+                                         const float* actual,
+                                         size_t count,
+                                         float abs_error) {
+  return FloatingPointArrayNearPredFormat<float>(
+      expected_expression, actual_expression, count_expression,
+      abs_error_expression, expected, actual, count, abs_error);
+}
+
+// Helper function for {ASSERT|EXPECT}_DOUBLE_ARRAY_NEAR.
+AssertionResult DoubleArrayNearPredFormat(const char* expected_expression,
+                                          const char* actual_expression,
+                                          const char* count_expression,
+                                          const char* abs_error_expression,
+                                          const double* expected,
+                                          const double* actual,
+                                          size_t count,
+                                          double abs_error) {
+  return FloatingPointArrayNearPredFormat<double>(
+      expected_expression, actual_expression, count_expression,
+      abs_error_expression, expected, actual, count, abs_error);
+}
+
 }  // namespace internal
 
 // Asserts that val1 is less than, or almost equal to, val2.  Fails
@@ -1166,11 +2189,16 @@ AssertionResult CmpHelperSTREQ(const char* expected_expression,
     return AssertionSuccess();
   }
 
-  return EqFailure(expected_expression,
-                   actual_expression,
-                   String::ShowCStringQuoted(expected),
-                   String::ShowCStringQuoted(actual),
-                   false);
+  // Shows where multi-line strings differ, as they are hard to compare
+  // by eye.
+  return AppendStringDiff(
+      EqFailure(expected_expression,
+                actual_expression,
+                String::ShowCStringQuoted(expected),
+                String::ShowCStringQuoted(actual),
+                false),
+      expected == NULL || actual == NULL ? String("") :
+      DiffLines(expected, strlen(expected), actual, strlen(actual)));
 }
 
 // The helper function for {ASSERT|EXPECT}_STRCASEEQ.
@@ -1218,6 +2246,214 @@ AssertionResult CmpHelperSTRCASENE(const char* s1_expression,
   }
 }
 
+// Constructs the failure message for {ASSERT|EXPECT}_BUFFER_EQ and
+// {ASSERT|EXPECT}_ARRAYS_EQ.
+AssertionResult BufferEqFailure(const char* expected_expression,
+                                const char* actual_expression,
+                                const char* count_expression,
+                                BufferEqKind kind,
+                                const void* expected,
+                                const void* actual,
+                                size_t count,
+                                size_t element_size,
+                                size_t mismatches,
+                                size_t first,
+                                const String& expected_value,
+                                const String& actual_value) {
+  const bool is_buffer = kind == kBufferEqBytes;
+  const String count_value = StreamableToString(count);
+
+  Message msg;
+  msg << "Value of: " << actual_expression
+      << "\nExpected: " << expected_expression
+      << "\n" << mismatches << " of " << count_expression;
+  if (count_value != count_expression) {
+    msg << " (" << count_value << ")";
+  }
+  msg << (is_buffer ? " bytes differ, the first at offset " :
+          " elements differ, the first at index ") << first;
+  if (!is_buffer) {
+    msg << "\n  Actual: " << actual_value
+        << "\nExpected: " << expected_value;
+  }
+  if (kind == kBufferEqElements) {
+    // The caller prints the elements around the first difference.
+    return AssertionFailure() << msg;
+  }
+
+  // Dumps the 16-byte row holding the first difference, the row before
+  // it and the row after it.  This keeps the message short no matter
+  // how large the buffers are.
+  const size_t kRowSize = 16;
+  const size_t size = count*element_size;
+  const size_t row = first*element_size/kRowSize*kRowSize;
+  const size_t begin = row < kRowSize ? 0 : row - kRowSize;
+  const size_t end = std::min(size, row + 2*kRowSize);
+  ::std::stringstream expected_bytes;
+  internal2::PrintBytesInObjectTo(
+      static_cast<const unsigned char*>(expected) + begin, end - begin,
+      &expected_bytes);
+  ::std::stringstream actual_bytes;
+  internal2::PrintBytesInObjectTo(
+      static_cast<const unsigned char*>(actual) + begin, end - begin,
+      &actual_bytes);
+  msg << "\nExpected bytes at offset " << begin << ": "
+      << StringStreamToString(&expected_bytes)
+      << "\n  Actual bytes at offset " << begin << ": "
+      << StringStreamToString(&actual_bytes);
+
+  return AssertionFailure() << msg;
+}
+
+// The helper function for {ASSERT|EXPECT}_BUFFER_EQ.
+AssertionResult CmpHelperBufferEQ(const char* expected_expression,
+                                  const char* actual_expression,
+                                  const char* size_expression,
+                                  const void* expected,
+                                  const void* actual,
+                                  size_t size) {
+  // memcmp() is typically vectorized by the C library, which makes the
+  // common case much cheaper than comparing element by element.
+  if (size == 0 || memcmp(expected, actual, size) == 0) {
+    return AssertionSuccess();
+  }
+
+  const unsigned char* const expected_bytes =
+      static_cast<const unsigned char*>(expected);
+  const unsigned char* const actual_bytes =
+      static_cast<const unsigned char*>(actual);
+  const size_t mismatches =
+      CountArrayMismatches(expected_bytes, actual_bytes, size);
+  size_t first = 0;
+  while (expected_bytes[first] == actual_bytes[first]) {
+    first++;
+  }
+  return BufferEqFailure(expected_expression, actual_expression,
+                         size_expression, kBufferEqBytes, expected, actual,
+                         size, 1, mismatches, first, String(""), String(""));
+}
+
+namespace {
+
+// The number of bytes compared by each memcmp() call when looking for
+// the first difference from a golden file.  It's large enough to make
+// the per-call overhead negligible and small enough that a difference
+// near the start of a large file is found without reading the rest.
+const size_t kGoldenFileChunkSize = 64 * 1024;
+
+// The number of bytes shown before and after the first difference from
+// a golden file.
+const size_t kGoldenFileContext = 32;
+
+// Returns the offset of the first byte at which expected and actual
+// differ, or size if their first size bytes are equal.
+size_t FindFirstDifference(const char* expected, const char* actual,
+                           size_t size) {
+  for (size_t offset = 0; offset != size; ) {
+    const size_t chunk = std::min(kGoldenFileChunkSize, size - offset);
+    if (memcmp(expected + offset, actual + offset, chunk) != 0) {
+      while (expected[offset] == actual[offset]) {
+        offset++;
+      }
+      return offset;
+    }
+    offset += chunk;
+  }
+  return size;
+}
+
+// Returns the bytes of data (which holds size bytes) from offset begin up
+// to, but excluding, offset end, printed as an escaped string literal.
+String FormatGoldenFileExcerpt(const char* data, size_t size,
+                               size_t begin, size_t end) {
+  end = std::min(end, size);
+  return String(PrintToString(
+      ::std::string(data + begin, begin < end ? end - begin : 0)).c_str());
+}
+
+// Constructs the failure message for a golden file that differs from
+// the actual data.
+GTEST_NO_INLINE_ GTEST_ATTRIBUTE_COLD_
+AssertionResult GoldenFileFailure(const char* data_expression,
+                                  const FilePath& golden,
+                                  const MappedFile& file,
+                                  const ::std::string& data,
+                                  size_t first) {
+  const char* const actual = data.data();
+  const size_t line = 1 + std::count(actual, actual + first, '\n');
+  size_t line_start = first;
+  while (line_start != 0 && actual[line_start - 1] != '\n') {
+    line_start--;
+  }
+  const size_t begin = first < kGoldenFileContext ?
+      0 : first - kGoldenFileContext;
+  const size_t end = first + kGoldenFileContext;
+
+  return AssertionFailure()
+      << "Value of: " << data_expression
+      << "\n  Actual: " << data.size() << " bytes"
+      << "\nExpected: the contents of golden file " << golden.c_str()
+      << " (" << file.size() << " bytes)"
+      << "\nThe first difference is at offset " << first
+      << " (line " << line << ", column " << first - line_start + 1 << ")"
+      << "\nExpected bytes at offset " << begin << ": "
+      << FormatGoldenFileExcerpt(file.data(), file.size(), begin, end)
+      << "\n  Actual bytes at offset " << begin << ": "
+      << FormatGoldenFileExcerpt(actual, data.size(), begin, end)
+      << "\nRun with --" GTEST_FLAG_PREFIX_ << kUpdateGoldenFilesFlag
+      << " to replace the golden file with the actual data.";
+}
+
+// Replaces the golden file with data unless it already matches, which
+// keeps unchanged golden files from being touched.
+AssertionResult UpdateGoldenFile(const FilePath& golden,
+                                 const ::std::string& data) {
+  MappedFile file;
+  if (file.Map(golden) && file.size() == data.size() &&
+      FindFirstDifference(file.data(), data.data(), data.size()) ==
+      data.size()) {
+    return AssertionSuccess();
+  }
+  file.Unmap();  // Windows can't replace a file that is mapped.
+
+  if (!golden.RemoveFileName().CreateDirectoriesRecursively() ||
+      !golden.WriteFileAtomically(data.data(), data.size())) {
+    return AssertionFailure() << "Failed to update golden file "
+                              << golden.c_str() << ".";
+  }
+  return AssertionSuccess();
+}
+
+}  // namespace
+
+// The helper function for {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE.
+AssertionResult CmpHelperGoldenFile(const char* /* path_expression */,
+                                    const char* data_expression,
+                                    const ::std::string& path,
+                                    const ::std::string& data) {
+  const FilePath golden(path.c_str());
+  if (GTEST_FLAG(update_golden_files)) {
+    return UpdateGoldenFile(golden, data);
+  }
+
+  MappedFile file;
+  if (!file.Map(golden)) {
+    return AssertionFailure()
+        << "Failed to read golden file " << golden.c_str()
+        << (golden.FileOrDirectoryExists() ? "." : ": it does not exist.")
+        << "\nRun with --" GTEST_FLAG_PREFIX_ << kUpdateGoldenFilesFlag
+        << " to create it from the actual data.";
+  }
+
+  const size_t common_size = std::min(file.size(), data.size());
+  const size_t first =
+      FindFirstDifference(file.data(), data.data(), common_size);
+  if (first == common_size && file.size() == data.size()) {
+    return AssertionSuccess();
+  }
+  return GoldenFileFailure(data_expression, golden, file, data, first);
+}
+
 }  // namespace internal
 
 namespace {
@@ -1349,7 +2585,7 @@ AssertionResult HRESULTFailureHelper(const char* expr,
   // want inserts expanded.
   const DWORD kFlags = FORMAT_MESSAGE_FROM_SYSTEM |
                        FORMAT_MESSAGE_IGNORE_INSERTS;
-  const DWORD kBufSize = 4096;  // String::Format can't exceed this length.
+  const DWORD kBufSize = 4096;
   // Gets the system's human readable message string for this HRESULT.
   char error_text[kBufSize] = { '\0' };
   DWORD message_length = ::FormatMessageA(kFlags,
@@ -1424,69 +2660,198 @@ inline UInt32 ChopLowBits(UInt32* bits, int n) {
   return low_bits;
 }
 
-// Converts a Unicode code point to a narrow string in UTF-8 encoding.
-// code_point parameter is of type UInt32 because wchar_t may not be
-// wide enough to contain a code point.
-// The output buffer str must containt at least 32 characters.
-// The function returns the address of the output buffer.
-// If the code_point is not a valid Unicode code point
-// (i.e. outside of Unicode range U+0 to U+10FFFF) it will be output
-// as '(Invalid Unicode 0xXXXXXXXX)'.
-char* CodePointToUtf8(UInt32 code_point, char* str) {
+// What an invalid code point is encoded as: the prefix, the code point
+// in upper-case hex, then the suffix, e.g. "(Invalid Unicode 0x200000)".
+const char kInvalidCodePointPrefix[] = "(Invalid Unicode 0x";
+const char kInvalidCodePointSuffix[] = ")";
+
+// Returns the number of hex digits needed to print n.
+inline size_t HexDigitCount(UInt32 n) {
+  size_t count = 1;
+  while ((n >>= 4) != 0) {
+    count++;
+  }
+  return count;
+}
+
+// Returns the number of bytes EncodeCodePointAsUtf8() writes for the
+// given code point.
+inline size_t Utf8LengthOfCodePoint(UInt32 code_point) {
+  if (code_point <= kMaxCodePoint1) {
+    return 1;
+  } else if (code_point <= kMaxCodePoint2) {
+    return 2;
+  } else if (code_point <= kMaxCodePoint3) {
+    return 3;
+  } else if (code_point <= kMaxCodePoint4) {
+    return 4;
+  }
+  return sizeof(kInvalidCodePointPrefix) - 1 + HexDigitCount(code_point) +
+      sizeof(kInvalidCodePointSuffix) - 1;
+}
+
+// Writes the UTF-8 encoding of the given code point to str, without a
+// terminating nul, and returns the end of what was written.  A code
+// point outside of the range UTF-8 can encode is written as
+// '(Invalid Unicode 0xXXXXXXXX)', which takes at most 28 characters.
+char* EncodeCodePointAsUtf8(UInt32 code_point, char* str) {
   if (code_point <= kMaxCodePoint1) {
-    str[1] = '\0';
     str[0] = static_cast<char>(code_point);                          // 0xxxxxxx
+    return str + 1;
   } else if (code_point <= kMaxCodePoint2) {
-    str[2] = '\0';
     str[1] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[0] = static_cast<char>(0xC0 | code_point);                   // 110xxxxx
+    return str + 2;
   } else if (code_point <= kMaxCodePoint3) {
-    str[3] = '\0';
     str[2] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[1] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[0] = static_cast<char>(0xE0 | code_point);                   // 1110xxxx
+    return str + 3;
   } else if (code_point <= kMaxCodePoint4) {
-    str[4] = '\0';
     str[3] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[2] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[1] = static_cast<char>(0x80 | ChopLowBits(&code_point, 6));  // 10xxxxxx
     str[0] = static_cast<char>(0xF0 | code_point);                   // 11110xxx
-  } else {
-    // The longest string String::Format can produce when invoked
-    // with these parameters is 28 character long (not including
-    // the terminating nul character). We are asking for 32 character
-    // buffer just in case. This is also enough for strncpy to
-    // null-terminate the destination string.
-    posix::StrNCpy(
-        str, String::Format("(Invalid Unicode 0x%X)", code_point).c_str(), 32);
-    str[31] = '\0';  // Makes sure no change in the format to strncpy leaves
-                     // the result unterminated.
+    return str + 4;
+  }
+
+  memcpy(str, kInvalidCodePointPrefix, sizeof(kInvalidCodePointPrefix) - 1);
+  str += sizeof(kInvalidCodePointPrefix) - 1;
+  for (size_t i = HexDigitCount(code_point); i != 0; i--) {
+    *str++ = "0123456789ABCDEF"[(code_point >> (4*(i - 1))) & 0xF];
+  }
+  memcpy(str, kInvalidCodePointSuffix, sizeof(kInvalidCodePointSuffix) - 1);
+  return str + sizeof(kInvalidCodePointSuffix) - 1;
+}
+
+// Converts a Unicode code point to a narrow string in UTF-8 encoding.
+// code_point parameter is of type UInt32 because wchar_t may not be
+// wide enough to contain a code point.
+// The output buffer str must containt at least 32 characters.
+// The function returns the address of the output buffer.
+// If the code_point is not a valid Unicode code point
+// (i.e. outside of Unicode range U+0 to U+10FFFF) it will be output
+// as '(Invalid Unicode 0xXXXXXXXX)'.
+char* CodePointToUtf8(UInt32 code_point, char* str) {
+  *EncodeCodePointAsUtf8(code_point, str) = '\0';
+  return str;
+}
+
+// The following two functions only make sense if the the system
+// uses UTF-16 for wide string encoding. All supported systems
+// with 16 bit wchar_t (Windows, Cygwin, Symbian OS) do use UTF-16.
+
+// Determines if the arguments constitute UTF-16 surrogate pair
+// and thus should be combined into a single Unicode code point
+// using CreateCodePointFromUtf16SurrogatePair.
+inline bool IsUtf16SurrogatePair(wchar_t first, wchar_t second) {
+  return sizeof(wchar_t) == 2 &&
+      (first & 0xFC00) == 0xD800 && (second & 0xFC00) == 0xDC00;
+}
+
+// Creates a Unicode code point from UTF16 surrogate pair.
+inline UInt32 CreateCodePointFromUtf16SurrogatePair(wchar_t first,
+                                                    wchar_t second) {
+  const UInt32 mask = (1 << 10) - 1;
+  return (sizeof(wchar_t) == 2) ?
+      (((first & mask) << 10) | (second & mask)) + 0x10000 :
+      // This function should not be called when the condition is
+      // false, but we provide a sensible default in case it is.
+      static_cast<UInt32>(first);
+}
+
+// Returns the code point starting at str[*i], where str holds num_chars
+// wide characters, and advances *i past it.
+inline UInt32 NextCodePoint(const wchar_t* str, size_t num_chars, size_t* i) {
+  const size_t j = *i;
+  if (j + 1 < num_chars && IsUtf16SurrogatePair(str[j], str[j + 1])) {
+    *i = j + 2;
+    return CreateCodePointFromUtf16SurrogatePair(str[j], str[j + 1]);
+  }
+  *i = j + 1;
+  return static_cast<UInt32>(str[j]);
+}
+
+// The number of wide characters the ASCII fast path below looks at at a
+// time.
+const size_t kAsciiBlockSize = 16;
+
+// Returns true iff the kAsciiBlockSize wide characters at str are all
+// ASCII.  The loop deliberately has no early exit so that the compiler
+// can vectorize it.
+inline bool IsAsciiBlock(const wchar_t* str) {
+  UInt32 bits = 0;
+  for (size_t i = 0; i != kAsciiBlockSize; i++) {
+    bits |= static_cast<UInt32>(str[i]);
+  }
+  return bits <= kMaxCodePoint1;
+}
+
+// Returns the number of bytes WideCharsToUtf8() writes for the num_chars
+// wide characters at str.
+size_t Utf8LengthOfWideChars(const wchar_t* str, size_t num_chars) {
+  size_t length = 0;
+  for (size_t i = 0; i != num_chars; ) {
+    const size_t block_size = std::min(kAsciiBlockSize, num_chars - i);
+    if (block_size == kAsciiBlockSize && IsAsciiBlock(str + i)) {
+      length += kAsciiBlockSize;
+      i += kAsciiBlockSize;
+      continue;
+    }
+
+    // The block holds a non-ASCII character somewhere; converts it one
+    // code point at a time.  A surrogate pair may extend past the block.
+    for (const size_t block_end = i + block_size; i < block_end; ) {
+      length += Utf8LengthOfCodePoint(NextCodePoint(str, num_chars, &i));
+    }
+  }
+  return length;
+}
+
+// Writes the UTF-8 encoding of the num_chars wide characters at str to
+// out, which must have room for Utf8LengthOfWideChars(str, num_chars)
+// bytes, and returns the end of what was written.  No terminating nul is
+// written.  Runs of ASCII characters are copied a block at a time, which
+// is much faster than encoding them one by one.
+char* WideCharsToUtf8(const wchar_t* str, size_t num_chars, char* out) {
+  for (size_t i = 0; i != num_chars; ) {
+    const size_t block_size = std::min(kAsciiBlockSize, num_chars - i);
+    if (block_size == kAsciiBlockSize && IsAsciiBlock(str + i)) {
+      for (size_t j = 0; j != kAsciiBlockSize; j++) {
+        out[j] = static_cast<char>(str[i + j]);
+      }
+      out += kAsciiBlockSize;
+      i += kAsciiBlockSize;
+      continue;
+    }
+
+    for (const size_t block_end = i + block_size; i < block_end; ) {
+      out = EncodeCodePointAsUtf8(NextCodePoint(str, num_chars, &i), out);
+    }
   }
-  return str;
+  return out;
 }
 
-// The following two functions only make sense if the the system
-// uses UTF-16 for wide string encoding. All supported systems
-// with 16 bit wchar_t (Windows, Cygwin, Symbian OS) do use UTF-16.
+namespace {
 
-// Determines if the arguments constitute UTF-16 surrogate pair
-// and thus should be combined into a single Unicode code point
-// using CreateCodePointFromUtf16SurrogatePair.
-inline bool IsUtf16SurrogatePair(wchar_t first, wchar_t second) {
-  return sizeof(wchar_t) == 2 &&
-      (first & 0xFC00) == 0xD800 && (second & 0xFC00) == 0xDC00;
+// Returns the UTF-8 encoding of the num_chars wide characters at str,
+// which must not contain L'\0', between prefix and suffix.
+String WideCharsToUtf8String(const wchar_t* str, size_t num_chars,
+                             const char* prefix, const char* suffix) {
+  const size_t prefix_length = strlen(prefix);
+  const size_t suffix_length = strlen(suffix);
+  const size_t length = prefix_length +
+      Utf8LengthOfWideChars(str, num_chars) + suffix_length;
+  char* const buffer = new char[length];
+  memcpy(buffer, prefix, prefix_length);
+  char* const end = WideCharsToUtf8(str, num_chars, buffer + prefix_length);
+  memcpy(end, suffix, suffix_length);
+  const String result(buffer, length);
+  delete [] buffer;
+  return result;
 }
 
-// Creates a Unicode code point from UTF16 surrogate pair.
-inline UInt32 CreateCodePointFromUtf16SurrogatePair(wchar_t first,
-                                                    wchar_t second) {
-  const UInt32 mask = (1 << 10) - 1;
-  return (sizeof(wchar_t) == 2) ?
-      (((first & mask) << 10) | (second & mask)) + 0x10000 :
-      // This function should not be called when the condition is
-      // false, but we provide a sensible default in case it is.
-      static_cast<UInt32>(first);
-}
+}  // namespace
 
 // Converts a wide string to a narrow string in UTF-8 encoding.
 // The wide string is assumed to have the following encoding:
@@ -1502,27 +2867,15 @@ inline UInt32 CreateCodePointFromUtf16SurrogatePair(wchar_t first,
 // and contains invalid UTF-16 surrogate pairs, values in those pairs
 // will be encoded as individual Unicode characters from Basic Normal Plane.
 String WideStringToUtf8(const wchar_t* str, int num_chars) {
-  if (num_chars == -1)
-    num_chars = static_cast<int>(wcslen(str));
-
-  ::std::stringstream stream;
-  for (int i = 0; i < num_chars; ++i) {
-    UInt32 unicode_code_point;
-
-    if (str[i] == L'\0') {
-      break;
-    } else if (i + 1 < num_chars && IsUtf16SurrogatePair(str[i], str[i + 1])) {
-      unicode_code_point = CreateCodePointFromUtf16SurrogatePair(str[i],
-                                                                 str[i + 1]);
-      i++;
-    } else {
-      unicode_code_point = static_cast<UInt32>(str[i]);
+  size_t length = 0;
+  if (num_chars == -1) {
+    length = wcslen(str);
+  } else {
+    while (static_cast<int>(length) < num_chars && str[length] != L'\0') {
+      length++;
     }
-
-    char buffer[32];  // CodePointToUtf8 requires a buffer this big.
-    stream << CodePointToUtf8(unicode_code_point, buffer);
   }
-  return StringStreamToString(&stream);
+  return WideCharsToUtf8String(str, length, "", "");
 }
 
 // Converts a wide C string to a String using the UTF-8 encoding.
@@ -1530,7 +2883,8 @@ String WideStringToUtf8(const wchar_t* str, int num_chars) {
 String String::ShowWideCString(const wchar_t * wide_c_str) {
   if (wide_c_str == NULL) return String("(null)");
 
-  return String(internal::WideStringToUtf8(wide_c_str, -1).c_str());
+  return internal::WideCharsToUtf8String(wide_c_str, wcslen(wide_c_str),
+                                         "", "");
 }
 
 // Similar to ShowWideCString(), except that this function encloses
@@ -1538,8 +2892,8 @@ String String::ShowWideCString(const wchar_t * wide_c_str) {
 String String::ShowWideCStringQuoted(const wchar_t* wide_c_str) {
   if (wide_c_str == NULL) return String("(null)");
 
-  return String::Format("L\"%s\"",
-                        String::ShowWideCString(wide_c_str).c_str());
+  return internal::WideCharsToUtf8String(wide_c_str, wcslen(wide_c_str),
+                                         "L\"", "\"");
 }
 
 // Compares two wide C strings.  Returns true iff they have the same
@@ -1565,11 +2919,22 @@ AssertionResult CmpHelperSTREQ(const char* expected_expression,
     return AssertionSuccess();
   }
 
-  return EqFailure(expected_expression,
-                   actual_expression,
-                   String::ShowWideCStringQuoted(expected),
-                   String::ShowWideCStringQuoted(actual),
-                   false);
+  // The diff shows the lines of the strings without the quoting.
+  String diff;
+  if (expected != NULL && actual != NULL) {
+    const std::string expected_utf8 =
+        WideCharsToUtf8String(expected, wcslen(expected));
+    const std::string actual_utf8 =
+        WideCharsToUtf8String(actual, wcslen(actual));
+    diff = DiffLines(expected_utf8.c_str(), expected_utf8.length(),
+                     actual_utf8.c_str(), actual_utf8.length());
+  }
+  return AppendStringDiff(EqFailure(expected_expression,
+                                    actual_expression,
+                                    String::ShowWideCStringQuoted(expected),
+                                    String::ShowWideCStringQuoted(actual),
+                                    false),
+                          diff);
 }
 
 // Helper function for *_STRNE on wide strings.
@@ -1687,68 +3052,146 @@ bool String::EndsWithCaseInsensitive(const char* suffix) const {
          CaseInsensitiveCStringEquals(c_str() + this_len - suffix_len, suffix);
 }
 
+namespace {
+
+// Most formatted strings (test names, event lines) fit in this many
+// characters, so Format() and AppendFormat() first try to format into
+// a stack buffer of this size and only run vsnprintf() a second time
+// when the output is longer.
+const int kFormatStackBufferSize = 256;
+
+// Formats args according to format into the size-character buffer.
+// Returns the length of the complete output, even if it didn't fit,
+// or a negative value if the format spec is invalid.
+int FormatIntoBuffer(char* buffer, size_t size, const char* format,
+                     va_list args) {
+  // MSVC 8 deprecates vsnprintf(), so we want to suppress warning
+  // 4996 (deprecated function) there.
+#ifdef _MSC_VER  // We are using MSVC.
+# pragma warning(push)          // Saves the current warning state.
+# pragma warning(disable:4996)  // Temporarily disables warning 4996.
+
+  return vsnprintf(buffer, size, format, args);
+
+# pragma warning(pop)           // Restores the warning state.
+#else  // We are not using MSVC.
+  return vsnprintf(buffer, size, format, args);
+#endif  // _MSC_VER
+}
+
+// Returns the length of the output format produces for args, or a
+// negative value if the format spec is invalid.  Only called after
+// FormatIntoBuffer() returned a negative value, which MSVC's
+// vsnprintf() also does when the buffer is too small.
+int MeasureFormat(const char* format, va_list args) {
+#ifdef _MSC_VER
+  return _vscprintf(format, args);
+#else
+  return vsnprintf(NULL, 0, format, args);
+#endif  // _MSC_VER
+}
+
+}  // namespace
+
 // Formats a list of arguments to a String, using the same format
 // spec string as for printf.
 //
 // We do not use the StringPrintf class as it is not universally
 // available.
 //
-// The result is limited to 4096 characters (including the tailing 0).
-// If 4096 characters are not enough to format the input, or if
-// there's an error, "<formatting error or buffer exceeded>" is
-// returned.
+// The output is formatted into a stack buffer first; when it doesn't
+// fit there, its exact length is known (or measured) and it's
+// formatted again straight into the String's own storage.  Either way
+// the result is allocated exactly once.  If the format spec is
+// invalid, "<formatting error>" is returned.
 String String::Format(const char * format, ...) {
+  char buffer[kFormatStackBufferSize];
+
   va_list args;
   va_start(args, format);
+  int size = FormatIntoBuffer(buffer, sizeof(buffer), format, args);
+  va_end(args);
 
-  char buffer[4096];
-  const int kBufferSize = sizeof(buffer)/sizeof(buffer[0]);
+  if (size < 0) {
+    va_start(args, format);
+    size = MeasureFormat(format, args);
+    va_end(args);
+    if (size < 0)
+      return String("<formatting error>");
+  }
 
-  // MSVC 8 deprecates vsnprintf(), so we want to suppress warning
-  // 4996 (deprecated function) there.
-#ifdef _MSC_VER  // We are using MSVC.
-# pragma warning(push)          // Saves the current warning state.
-# pragma warning(disable:4996)  // Temporarily disables warning 4996.
+  const size_t length = static_cast<size_t>(size);
+  String result;
+  char* const str = result.Allocate(length);
+  if (length < sizeof(buffer)) {
+    memcpy(str, buffer, length);
+  } else {
+    va_start(args, format);
+    FormatIntoBuffer(str, length + 1, format, args);
+    va_end(args);
+  }
+  return result;
+}
 
-  const int size = vsnprintf(buffer, kBufferSize, format, args);
+// Formats a list of arguments like Format() does and appends the
+// result to *output.  Returns false and leaves *output unchanged if
+// the format spec is invalid.
+bool String::AppendFormat(::std::string* output, const char* format, ...) {
+  char buffer[kFormatStackBufferSize];
 
-# pragma warning(pop)           // Restores the warning state.
-#else  // We are not using MSVC.
-  const int size = vsnprintf(buffer, kBufferSize, format, args);
-#endif  // _MSC_VER
+  va_list args;
+  va_start(args, format);
+  int size = FormatIntoBuffer(buffer, sizeof(buffer), format, args);
   va_end(args);
 
-  // vsnprintf()'s behavior is not portable.  When the buffer is not
-  // big enough, it returns a negative value in MSVC, and returns the
-  // needed buffer size on Linux.  When there is an output error, it
-  // always returns a negative value.  For simplicity, we lump the two
-  // error cases together.
-  if (size < 0 || size >= kBufferSize) {
-    return String("<formatting error or buffer exceeded>");
+  if (size < 0) {
+    va_start(args, format);
+    size = MeasureFormat(format, args);
+    va_end(args);
+    if (size < 0)
+      return false;
+  }
+
+  const size_t length = static_cast<size_t>(size);
+  if (length < sizeof(buffer)) {
+    output->append(buffer, length);
   } else {
-    return String(buffer, size);
+    // vsnprintf() always writes a terminating NUL, so we make room
+    // for it and drop it again afterwards.
+    const size_t old_length = output->length();
+    output->resize(old_length + length + 1);
+    va_start(args, format);
+    FormatIntoBuffer(&(*output)[old_length], length + 1, format, args);
+    va_end(args);
+    output->resize(old_length + length);
   }
+  return true;
 }
 
-// Converts the buffer in a stringstream to a String, converting NUL
-// bytes to "\\0" along the way.
-String StringStreamToString(::std::stringstream* ss) {
-  const ::std::string& str = ss->str();
-  const char* const start = str.c_str();
-  const char* const end = start + str.length();
+// Converts length characters starting at start to a String, converting
+// NUL bytes to "\\0" along the way.
+String CharsToStringEscapingNuls(const char* start, size_t length) {
+  // Most text has no NUL in it, and can be copied as is.
+  if (memchr(start, '\0', length) == NULL)
+    return String(start, length);
 
-  // We need to use a helper stringstream to do this transformation
-  // because String doesn't support push_back().
-  ::std::stringstream helper;
-  for (const char* ch = start; ch != end; ++ch) {
+  ::std::string escaped;
+  escaped.reserve(length + 1);
+  for (const char* ch = start; ch != start + length; ++ch) {
     if (*ch == '\0') {
-      helper << "\\0";  // Replaces NUL with "\\0";
+      escaped += "\\0";  // Replaces NUL with "\\0";
     } else {
-      helper.put(*ch);
+      escaped += *ch;
     }
   }
+  return String(escaped.c_str(), escaped.length());
+}
 
-  return String(helper.str().c_str());
+// Converts the buffer in a stringstream to a String, converting NUL
+// bytes to "\\0" along the way.
+String StringStreamToString(::std::stringstream* ss) {
+  const ::std::string& str = ss->str();
+  return CharsToStringEscapingNuls(str.c_str(), str.length());
 }
 
 // Appends the user-supplied message to the Google-Test-generated message.
@@ -1766,18 +3209,75 @@ String AppendUserMessage(const String& gtest_msg,
   return msg.GetString();
 }
 
+// The parts of a TestResult that most tests never record.  TestResult
+// allocates them the first time it needs them.
+struct TestResultStorage {
+  // Protects the fields below, which several threads may record to at
+  // once.
+  Mutex mutex;
+  TestPartResultRecorder test_part_results;
+  std::vector<TestProperty> test_properties;
+};
+
+// What TestResult returns for the results and properties it hasn't
+// allocated storage for.
+static const std::vector<TestPartResult> g_no_test_part_results;
+static const std::vector<TestProperty> g_no_test_properties;
+
 }  // namespace internal
 
 // class TestResult
 
 // Creates an empty TestResult.
 TestResult::TestResult()
-    : death_test_count_(0),
-      elapsed_time_(0) {
+    : storage_(NULL),
+      death_test_count_(0),
+      elapsed_time_(0),
+      has_heap_usage_(false),
+      heap_peak_bytes_(0),
+      heap_growth_bytes_(0),
+      heap_allocation_count_(0) {
+  std::fill(phase_time_nanos_, phase_time_nanos_ + kPhaseCount, 0);
 }
 
 // D'tor.
 TestResult::~TestResult() {
+  delete storage();
+}
+
+// Returns the storage for the test part results and the test properties,
+// allocating it the first time.  When several threads allocate it at
+// once, the first one to publish its storage wins, and the others delete
+// theirs.
+internal::TestResultStorage* TestResult::MutableStorage() {
+  internal::TestResultStorage* const storage = this->storage();
+  if (storage != NULL)
+    return storage;
+
+  internal::TestResultStorage* const new_storage =
+      new internal::TestResultStorage;
+  internal::TestResultStorage* const published_storage =
+      internal::AtomicCompareAndSwapPointer(
+          &storage_, static_cast<internal::TestResultStorage*>(NULL),
+          new_storage);
+  if (published_storage == NULL)
+    return new_storage;
+  delete new_storage;
+  return published_storage;
+}
+
+// Gets the vector of TestPartResults.
+const std::vector<TestPartResult>& TestResult::test_part_results() const {
+  const internal::TestResultStorage* const storage = this->storage();
+  return storage == NULL ? internal::g_no_test_part_results :
+      storage->test_part_results.results();
+}
+
+// Gets the vector of TestProperties.
+const std::vector<TestProperty>& TestResult::test_properties() const {
+  const internal::TestResultStorage* const storage = this->storage();
+  return storage == NULL ? internal::g_no_test_properties :
+      storage->test_properties;
 }
 
 // Returns the i-th test part result among all the results. i can
@@ -1786,7 +3286,27 @@ TestResult::~TestResult() {
 const TestPartResult& TestResult::GetTestPartResult(int i) const {
   if (i < 0 || i >= total_part_count())
     internal::posix::Abort();
-  return test_part_results_.at(i);
+  return storage()->test_part_results.results().at(i);
+}
+
+// Returns how many failures identical to the i-th test part result were
+// counted instead of recorded. i can range from 0 to total_part_count() - 1.
+// If i is not in that range, aborts the program.
+int TestResult::GetTestPartRepeatCount(int i) const {
+  if (i < 0 || i >= total_part_count())
+    internal::posix::Abort();
+  return storage()->test_part_results.repeat_count(i);
+}
+
+// Returns how many failures were neither recorded nor counted as repeats
+// because the test had reached the --gtest_max_failures_per_test limit.
+int TestResult::omitted_failure_count() const {
+  internal::TestResultStorage* const storage = this->storage();
+  if (storage == NULL)
+    return 0;
+  internal::MutexLock lock(&storage->mutex);
+  return storage->test_part_results.omitted_fatal_failure_count() +
+      storage->test_part_results.omitted_nonfatal_failure_count();
 }
 
 // Returns the i-th test property. i can range from 0 to
@@ -1795,17 +3315,42 @@ const TestPartResult& TestResult::GetTestPartResult(int i) const {
 const TestProperty& TestResult::GetTestProperty(int i) const {
   if (i < 0 || i >= test_property_count())
     internal::posix::Abort();
-  return test_properties_.at(i);
+  return storage()->test_properties.at(i);
 }
 
 // Clears the test part results.
 void TestResult::ClearTestPartResults() {
-  test_part_results_.clear();
+  internal::TestResultStorage* const storage = this->storage();
+  if (storage != NULL) {
+    internal::MutexLock lock(&storage->mutex);
+    storage->test_part_results.Clear();
+  }
+}
+
+// Adds a test part result to the list, or counts it once the list has
+// reached the limit.
+bool TestResult::AddTestPartResult(const TestPartResult& test_part_result) {
+  internal::TestResultStorage* const storage = MutableStorage();
+  internal::MutexLock lock(&storage->mutex);
+  return storage->test_part_results.Add(test_part_result);
+}
+
+// Adds count to the repeat count of the last recorded failure that is
+// identical to the given one, or counts them as omitted.
+void TestResult::AddTestPartRepeats(const TestPartResult& test_part_result,
+                                    int count) {
+  internal::TestResultStorage* const storage = MutableStorage();
+  internal::MutexLock lock(&storage->mutex);
+  storage->test_part_results.AddRepeats(test_part_result, count);
 }
 
-// Adds a test part result to the list.
-void TestResult::AddTestPartResult(const TestPartResult& test_part_result) {
-  test_part_results_.push_back(test_part_result);
+// Counts count omitted failures of the given type.
+void TestResult::AddOmittedFailures(TestPartResult::Type type, int count) {
+  if (count == 0)
+    return;
+  internal::TestResultStorage* const storage = MutableStorage();
+  internal::MutexLock lock(&storage->mutex);
+  storage->test_part_results.AddOmitted(type, count);
 }
 
 // Adds a test property to the list. If a property with the same key as the
@@ -1815,26 +3360,48 @@ void TestResult::RecordProperty(const TestProperty& test_property) {
   if (!ValidateTestProperty(test_property)) {
     return;
   }
-  internal::MutexLock lock(&test_properites_mutex_);
+  // The storage of the property isn't part of the test's heap usage.
+  const internal::ScopedHeapCountingSuspension suspension;
+  internal::TestResultStorage* const storage = MutableStorage();
+  internal::MutexLock lock(&storage->mutex);
+  std::vector<TestProperty>& properties = storage->test_properties;
   const std::vector<TestProperty>::iterator property_with_matching_key =
-      std::find_if(test_properties_.begin(), test_properties_.end(),
+      std::find_if(properties.begin(), properties.end(),
                    internal::TestPropertyKeyIs(test_property.key()));
-  if (property_with_matching_key == test_properties_.end()) {
-    test_properties_.push_back(test_property);
+  if (property_with_matching_key == properties.end()) {
+    properties.push_back(test_property);
     return;
   }
   property_with_matching_key->SetValue(test_property.value());
 }
 
+// The attributes Google Test writes in testcase tags.  They can't be
+// used as keys in RecordProperty(), as the properties are written as
+// attributes of the same tag.
+static const char* const kReservedTestCaseAttributes[] = {
+  "name", "status", "time", "classname", "constructor_time", "set_up_time",
+  "test_body_time", "tear_down_time", "destructor_time", "heap_peak_bytes",
+  "heap_growth_bytes", "heap_allocations"
+};
+
 // Adds a failure if the key is a reserved attribute of Google Test
 // testcase tags.  Returns true if the property is valid.
 bool TestResult::ValidateTestProperty(const TestProperty& test_property) {
-  internal::String key(test_property.key());
-  if (key == "name" || key == "status" || key == "time" || key == "classname") {
+  const size_t count = sizeof(kReservedTestCaseAttributes) /
+      sizeof(kReservedTestCaseAttributes[0]);
+  for (size_t i = 0; i != count; i++) {
+    if (strcmp(test_property.key(), kReservedTestCaseAttributes[i]) != 0)
+      continue;
+
+    Message reserved_keys;
+    for (size_t j = 0; j != count; j++) {
+      reserved_keys << (j == 0 ? "" : j + 1 == count ? ", and " : ", ")
+                    << "'" << kReservedTestCaseAttributes[j] << "'";
+    }
     ADD_FAILURE()
         << "Reserved key used in RecordProperty(): "
-        << key
-        << " ('name', 'status', 'time', and 'classname' are reserved by "
+        << test_property.key()
+        << " (" << reserved_keys.GetString() << " are reserved by "
         << GTEST_NAME_ << ")";
     return false;
   }
@@ -1843,10 +3410,25 @@ bool TestResult::ValidateTestProperty(const TestProperty& test_property) {
 
 // Clears the object.
 void TestResult::Clear() {
-  test_part_results_.clear();
-  test_properties_.clear();
+  delete storage();
+  storage_ = NULL;
   death_test_count_ = 0;
   elapsed_time_ = 0;
+  std::fill(phase_time_nanos_, phase_time_nanos_ + kPhaseCount, 0);
+  has_heap_usage_ = false;
+  heap_peak_bytes_ = 0;
+  heap_growth_bytes_ = 0;
+  heap_allocation_count_ = 0;
+}
+
+// Sets the heap usage from the profiler's readings before the test's
+// fixture was constructed and after it was destroyed.
+void TestResult::SetHeapUsage(const internal::HeapUsage& before,
+                              const internal::HeapUsage& after) {
+  has_heap_usage_ = true;
+  heap_peak_bytes_ = after.peak_live_bytes - before.live_bytes;
+  heap_growth_bytes_ = after.live_bytes - before.live_bytes;
+  heap_allocation_count_ = after.allocation_count - before.allocation_count;
 }
 
 // Returns true iff the test failed.
@@ -1855,7 +3437,7 @@ bool TestResult::Failed() const {
     if (GetTestPartResult(i).failed())
       return true;
   }
-  return false;
+  return omitted_failure_count() > 0;
 }
 
 // Returns true iff the test part fatally failed.
@@ -1865,7 +3447,10 @@ static bool TestPartFatallyFailed(const TestPartResult& result) {
 
 // Returns true iff the test fatally failed.
 bool TestResult::HasFatalFailure() const {
-  return CountIf(test_part_results_, TestPartFatallyFailed) > 0;
+  internal::TestResultStorage* const storage = this->storage();
+  return CountIf(test_part_results(), TestPartFatallyFailed) > 0 ||
+      (storage != NULL &&
+       storage->test_part_results.omitted_fatal_failure_count() > 0);
 }
 
 // Returns true iff the test part non-fatally failed.
@@ -1875,18 +3460,29 @@ static bool TestPartNonfatallyFailed(const TestPartResult& result) {
 
 // Returns true iff the test has a non-fatal failure.
 bool TestResult::HasNonfatalFailure() const {
-  return CountIf(test_part_results_, TestPartNonfatallyFailed) > 0;
+  internal::TestResultStorage* const storage = this->storage();
+  return CountIf(test_part_results(), TestPartNonfatallyFailed) > 0 ||
+      (storage != NULL &&
+       storage->test_part_results.omitted_nonfatal_failure_count() > 0);
 }
 
 // Gets the number of all test parts.  This is the sum of the number
 // of successful test parts and the number of failed test parts.
 int TestResult::total_part_count() const {
-  return static_cast<int>(test_part_results_.size());
+  internal::TestResultStorage* const storage = this->storage();
+  if (storage == NULL)
+    return 0;
+  internal::MutexLock lock(&storage->mutex);
+  return static_cast<int>(storage->test_part_results.results().size());
 }
 
 // Returns the number of the test properties.
 int TestResult::test_property_count() const {
-  return static_cast<int>(test_properties_.size());
+  internal::TestResultStorage* const storage = this->storage();
+  if (storage == NULL)
+    return 0;
+  internal::MutexLock lock(&storage->mutex);
+  return static_cast<int>(storage->test_properties.size());
 }
 
 // class Test
@@ -2146,6 +3742,38 @@ Result HandleExceptionsInMethodIfSupported(
   }
 }
 
+#if GTEST_IS_THREADSAFE
+
+// One iteration of a stress test thread, in the form that
+// HandleExceptionsInMethodIfSupported() calls.
+class StressTestIteration {
+ public:
+  StressTestIteration(StressTestBody* body, int thread_index, int iteration)
+      : body_(body), thread_index_(thread_index), iteration_(iteration) {}
+
+  void Run() { body_->Run(thread_index_, iteration_); }
+
+ private:
+  StressTestBody* const body_;
+  const int thread_index_;
+  const int iteration_;
+
+  GTEST_DISALLOW_COPY_AND_ASSIGN_(StressTestIteration);
+};
+
+// Runs one iteration of a stress test body.  The stress test threads
+// aren't run by a Test, so an exception escaping the body would
+// otherwise call std::terminate().
+void RunStressTestIteration(
+    StressTestBody* body, int thread_index, int iteration) {
+  StressTestIteration stress_test_iteration(body, thread_index, iteration);
+  HandleExceptionsInMethodIfSupported(
+      &stress_test_iteration, &StressTestIteration::Run,
+      "the stress test body");
+}
+
+#endif  // GTEST_IS_THREADSAFE
+
 }  // namespace internal
 
 // Runs the test and updates the test result.
@@ -2153,32 +3781,47 @@ void Test::Run() {
   if (!HasSameFixtureClass()) return;
 
   internal::UnitTestImpl* const impl = internal::GetUnitTestImpl();
+  TestResult* const result = impl->current_test_result();
   impl->os_stack_trace_getter()->UponLeavingGTest();
+  internal::Int64 phase_start = GetMonotonicTimeInNanos();
   internal::HandleExceptionsInMethodIfSupported(this, &Test::SetUp, "SetUp()");
+  result->set_phase_time_nanos(TestResult::kSetUpPhase,
+                               GetMonotonicTimeInNanos() - phase_start);
   // We will run the test only if SetUp() was successful.
   if (!HasFatalFailure()) {
     impl->os_stack_trace_getter()->UponLeavingGTest();
+    phase_start = GetMonotonicTimeInNanos();
     internal::HandleExceptionsInMethodIfSupported(
         this, &Test::TestBody, "the test body");
+    result->set_phase_time_nanos(TestResult::kTestBodyPhase,
+                                 GetMonotonicTimeInNanos() - phase_start);
   }
 
   // However, we want to clean up as much as possible.  Hence we will
   // always call TearDown(), even if SetUp() or the test body has
   // failed.
   impl->os_stack_trace_getter()->UponLeavingGTest();
+  phase_start = GetMonotonicTimeInNanos();
   internal::HandleExceptionsInMethodIfSupported(
       this, &Test::TearDown, "TearDown()");
+  result->set_phase_time_nanos(TestResult::kTearDownPhase,
+                               GetMonotonicTimeInNanos() - phase_start);
 }
 
-// Returns true iff the current test has a fatal failure.
+// Returns true iff the current test has a fatal failure, including one
+// another thread has reported but that hasn't been merged yet.
 bool Test::HasFatalFailure() {
-  return internal::GetUnitTestImpl()->current_test_result()->HasFatalFailure();
+  internal::UnitTestImpl* const impl = internal::GetUnitTestImpl();
+  return impl->current_test_result()->HasFatalFailure() ||
+      impl->HasUnmergedFailure(TestPartResult::kFatalFailure);
 }
 
-// Returns true iff the current test has a non-fatal failure.
+// Returns true iff the current test has a non-fatal failure, including
+// one another thread has reported but that hasn't been merged yet.
 bool Test::HasNonfatalFailure() {
-  return internal::GetUnitTestImpl()->current_test_result()->
-      HasNonfatalFailure();
+  internal::UnitTestImpl* const impl = internal::GetUnitTestImpl();
+  return impl->current_test_result()->HasNonfatalFailure() ||
+      impl->HasUnmergedFailure(TestPartResult::kNonFatalFailure);
 }
 
 // class TestInfo
@@ -2193,10 +3836,13 @@ TestInfo::TestInfo(const char* a_test_case_name,
                    const char* a_value_param,
                    internal::TypeId fixture_class_id,
                    internal::TestFactoryBase* factory)
-    : test_case_name_(a_test_case_name),
-      name_(a_name),
-      type_param_(a_type_param ? new std::string(a_type_param) : NULL),
-      value_param_(a_value_param ? new std::string(a_value_param) : NULL),
+    : test_case_name_(
+          internal::GetUnitTestImpl()->name_pool()->Intern(a_test_case_name)),
+      name_(internal::GetUnitTestImpl()->name_pool()->Intern(a_name)),
+      type_param_(internal::GetUnitTestImpl()->name_pool()->Intern(
+          a_type_param)),
+      value_param_(internal::GetUnitTestImpl()->name_pool()->Intern(
+          a_value_param)),
       fixture_class_id_(fixture_class_id),
       should_run_(false),
       is_disabled_(false),
@@ -2209,6 +3855,15 @@ TestInfo::~TestInfo() { delete factory_; }
 
 namespace internal {
 
+// Returns true iff static test registration is timed for
+// --gtest_startup_profile.  It happens before main() parses the flags,
+// so only the GTEST_STARTUP_PROFILE environment variable can turn it on,
+// and it's read once rather than for every test.
+static bool ProfilesStaticRegistration() {
+  static const bool profiles = BoolFromGTestEnv("startup_profile", false);
+  return profiles;
+}
+
 // Creates a new TestInfo object and registers it with Google Test;
 // returns the created object.
 //
@@ -2234,10 +3889,26 @@ TestInfo* MakeAndRegisterTestInfo(
     SetUpTestCaseFunc set_up_tc,
     TearDownTestCaseFunc tear_down_tc,
     TestFactoryBase* factory) {
+  UnitTestImpl* const impl = GetUnitTestImpl();
+
+  // A test registered while another startup stage is timed (e.g. a
+  // parameterized test) counts toward that stage.
+  StartupProfile* const profile = impl->startup_profile();
+  const bool is_static_registration =
+      ProfilesStaticRegistration() && !profile->in_stage();
+  const StartupStage paused_stage = is_static_registration ?
+      profile->BeginStage(kStaticRegistrationStage) : kStartupStageCount;
+
+  // The TestInfo lives in the registration arena, next to the ones
+  // registered before it.
   TestInfo* const test_info =
-      new TestInfo(test_case_name, name, type_param, value_param,
-                   fixture_class_id, factory);
-  GetUnitTestImpl()->AddTestInfo(set_up_tc, tear_down_tc, test_info);
+      new(impl->AllocateRegistrationObject<TestInfo>())
+      TestInfo(test_case_name, name, type_param, value_param,
+               fixture_class_id, factory);
+  impl->AddTestInfo(set_up_tc, tear_down_tc, test_info);
+
+  if (is_static_registration)
+    profile->EndStage(paused_stage);
   return test_info;
 }
 
@@ -2323,12 +3994,25 @@ void TestInfo::Run() {
 
   const TimeInMillis start = internal::GetTimeInMillis();
 
+  // Measures the heap usage from before the fixture is constructed, if a
+  // heap profiler is installed.
+  internal::HeapProfilerInterface* const heap_profiler =
+      internal::GetHeapProfiler();
+  internal::HeapUsage heap_usage_before;
+  if (heap_profiler != NULL) {
+    heap_profiler->ResetPeakLiveBytes();
+    heap_usage_before = heap_profiler->GetHeapUsage();
+  }
+
   impl->os_stack_trace_getter()->UponLeavingGTest();
 
   // Creates the test object.
+  internal::Int64 phase_start = GetMonotonicTimeInNanos();
   Test* const test = internal::HandleExceptionsInMethodIfSupported(
       factory_, &internal::TestFactoryBase::CreateTest,
       "the test fixture's constructor");
+  result_.set_phase_time_nanos(TestResult::kConstructorPhase,
+                               GetMonotonicTimeInNanos() - phase_start);
 
   // Runs the test only if the test object was created and its
   // constructor didn't generate a fatal failure.
@@ -2340,8 +4024,27 @@ void TestInfo::Run() {
 
   // Deletes the test object.
   impl->os_stack_trace_getter()->UponLeavingGTest();
+  phase_start = GetMonotonicTimeInNanos();
   internal::HandleExceptionsInMethodIfSupported(
       test, &Test::DeleteSelf_, "the test fixture's destructor");
+  result_.set_phase_time_nanos(TestResult::kDestructorPhase,
+                               GetMonotonicTimeInNanos() - phase_start);
+
+  if (heap_profiler != NULL) {
+    result_.SetHeapUsage(heap_usage_before, heap_profiler->GetHeapUsage());
+    const internal::Int32 max_growth = GTEST_FLAG(fail_on_leak_bytes);
+    if (max_growth >= 0 && result_.heap_growth_bytes() > max_growth) {
+      internal::ReportFailureInUnknownLocation(
+          TestPartResult::kNonFatalFailure,
+          (Message() << "The heap grew by " << result_.heap_growth_bytes()
+           << " bytes during the test, which is more than the "
+           << max_growth << " bytes --" GTEST_FLAG_PREFIX_
+           << "fail_on_leak_bytes allows.").GetString());
+    }
+  }
+
+  // Collects the failures other threads have reported during the test.
+  impl->MergeTestPartResultsFromOtherThreads();
 
   result_.set_elapsed_time(internal::GetTimeInMillis() - start);
 
@@ -2391,18 +4094,22 @@ int TestCase::total_test_count() const {
 TestCase::TestCase(const char* a_name, const char* a_type_param,
                    Test::SetUpTestCaseFunc set_up_tc,
                    Test::TearDownTestCaseFunc tear_down_tc)
-    : name_(a_name),
-      type_param_(a_type_param ? new std::string(a_type_param) : NULL),
+    : name_(internal::GetUnitTestImpl()->name_pool()->Intern(a_name)),
+      type_param_(internal::GetUnitTestImpl()->name_pool()->Intern(
+          a_type_param)),
       set_up_tc_(set_up_tc),
       tear_down_tc_(tear_down_tc),
       should_run_(false),
-      elapsed_time_(0) {
+      elapsed_time_(0),
+      set_up_time_nanos_(0),
+      tear_down_time_nanos_(0) {
 }
 
 // Destructor of TestCase.
 TestCase::~TestCase() {
-  // Deletes every Test in the collection.
-  ForEach(test_info_list_, internal::Delete<TestInfo>);
+  // Destroys every Test in the collection.  Their memory belongs to the
+  // registration arena.
+  ForEach(test_info_list_, internal::Destroy<TestInfo>);
 }
 
 // Returns the i-th test among all the tests. i can range from 0 to
@@ -2437,8 +4144,10 @@ void TestCase::Run() {
 
   repeater->OnTestCaseStart(*this);
   impl->os_stack_trace_getter()->UponLeavingGTest();
+  const internal::Int64 set_up_start = GetMonotonicTimeInNanos();
   internal::HandleExceptionsInMethodIfSupported(
       this, &TestCase::RunSetUpTestCase, "SetUpTestCase()");
+  set_up_time_nanos_ = GetMonotonicTimeInNanos() - set_up_start;
 
   const internal::TimeInMillis start = internal::GetTimeInMillis();
   for (int i = 0; i < total_test_count(); i++) {
@@ -2447,8 +4156,11 @@ void TestCase::Run() {
   elapsed_time_ = internal::GetTimeInMillis() - start;
 
   impl->os_stack_trace_getter()->UponLeavingGTest();
+  const internal::Int64 tear_down_start = GetMonotonicTimeInNanos();
   internal::HandleExceptionsInMethodIfSupported(
       this, &TestCase::RunTearDownTestCase, "TearDownTestCase()");
+  tear_down_time_nanos_ = GetMonotonicTimeInNanos() - tear_down_start;
+  impl->MergeTestPartResultsFromOtherThreads();
 
   repeater->OnTestCaseEnd(*this);
   impl->set_current_test_case(NULL);
@@ -2543,6 +4255,28 @@ static void PrintTestPartResult(const TestPartResult& test_part_result) {
 #endif
 }
 
+// Prints a note for each failure of the test that was repeated after the
+// test had reached the --gtest_max_failures_per_test limit, and one for
+// the failures it omitted.
+static void PrintRepeatedFailureNotes(const TestResult& result) {
+  for (int i = 0; i < result.total_part_count(); ++i) {
+    const int repeat_count = result.GetTestPartRepeatCount(i);
+    if (repeat_count > 0) {
+      const TestPartResult& part = result.GetTestPartResult(i);
+      printf("%s %s\n",
+             internal::FormatFileLocation(part.file_name(),
+                                          part.line_number()).c_str(),
+             internal::FormatRepeatedFailureNote(repeat_count).c_str());
+    }
+  }
+  const int omitted_count = result.omitted_failure_count();
+  if (omitted_count > 0) {
+    printf("%s\n",
+           internal::FormatOmittedFailureNote(omitted_count).c_str());
+  }
+  fflush(stdout);
+}
+
 // class PrettyUnitTestResultPrinter
 
 namespace internal {
@@ -2788,6 +4522,8 @@ void PrettyUnitTestResultPrinter::OnTestPartResult(
 }
 
 void PrettyUnitTestResultPrinter::OnTestEnd(const TestInfo& test_info) {
+  PrintRepeatedFailureNotes(*test_info.result());
+
   if (test_info.result()->Passed()) {
     ColoredPrintf(COLOR_GREEN, "[       OK ] ");
   } else {
@@ -3199,6 +4935,211 @@ std::string FormatTimeInMillisAsSeconds(TimeInMillis ms) {
   return ss.str();
 }
 
+// Formats the given time in nanoseconds as seconds, with microsecond
+// precision.
+std::string FormatNanosAsSeconds(Int64 nanos) {
+  return String::Format("%.6f", static_cast<double>(nanos) / 1e9).c_str();
+}
+
+// Returns the name of the given test phase as used in reports.
+const char* TestPhaseName(TestResult::Phase phase) {
+  switch (phase) {
+    case TestResult::kConstructorPhase: return "constructor";
+    case TestResult::kSetUpPhase: return "set_up";
+    case TestResult::kTestBodyPhase: return "test_body";
+    case TestResult::kTearDownPhase: return "tear_down";
+    case TestResult::kDestructorPhase: return "destructor";
+    default: return "unknown";
+  }
+}
+
+// class StartupProfile
+
+StartupProfile::StartupProfile()
+    : current_stage_(kStartupStageCount),
+      last_nanos_(0),
+      last_allocation_count_(-1) {
+  std::fill(nanos_, nanos_ + kStartupStageCount, 0);
+  std::fill(call_counts_, call_counts_ + kStartupStageCount, 0);
+  std::fill(allocation_counts_, allocation_counts_ + kStartupStageCount, -1);
+}
+
+// Starts timing the given stage, pausing the current one if any.
+StartupStage StartupProfile::BeginStage(StartupStage stage) {
+  ChargeCurrentStage();
+  const StartupStage paused_stage = current_stage_;
+  current_stage_ = stage;
+  call_counts_[stage]++;
+  return paused_stage;
+}
+
+// Stops timing the current stage and resumes the given paused one.
+void StartupProfile::EndStage(StartupStage paused_stage) {
+  ChargeCurrentStage();
+  current_stage_ = paused_stage;
+}
+
+// Charges the time and allocations since the last call to the current
+// stage.  Allocations are only counted while a heap profiler is
+// installed.
+void StartupProfile::ChargeCurrentStage() {
+  const Int64 now = GetMonotonicTimeInNanos();
+  HeapProfilerInterface* const heap_profiler = GetHeapProfiler();
+  const Int64 allocation_count = heap_profiler == NULL ? -1 :
+      heap_profiler->GetHeapUsage().allocation_count;
+  if (in_stage()) {
+    nanos_[current_stage_] += now - last_nanos_;
+    if (allocation_count >= 0 && last_allocation_count_ >= 0) {
+      Int64& stage_count = allocation_counts_[current_stage_];
+      stage_count = (stage_count < 0 ? 0 : stage_count) +
+          allocation_count - last_allocation_count_;
+    }
+  }
+  last_nanos_ = now;
+  last_allocation_count_ = allocation_count;
+}
+
+// Returns a table of the stages, for printing.
+String StartupProfile::Format() const {
+  static const char* const kStageNames[kStartupStageCount] = {
+    "static test registration",
+    "flag parsing",
+    "other post-flag-parsing init",
+    "parameterized test registration",
+    "listener set-up",
+    "test filtering"
+  };
+
+  Message msg;
+  msg << "Startup profile:\n";
+  Int64 total_nanos = 0;
+  for (int i = 0; i < kStartupStageCount; i++) {
+    const StartupStage stage = static_cast<StartupStage>(i);
+    total_nanos += nanos(stage);
+    msg << String::Format("  %-32s %10.3f ms %8d calls", kStageNames[i],
+                          static_cast<double>(nanos(stage)) / 1e6,
+                          call_count(stage));
+    if (allocation_count(stage) >= 0)
+      msg << "  " << allocation_count(stage) << " allocations";
+    msg << "\n";
+  }
+  msg << String::Format("  %-32s %10.3f ms\n", "total",
+                        static_cast<double>(total_nanos) / 1e6);
+  return msg.GetString();
+}
+
+// class Arena
+
+Arena::Arena(size_t chunk_size)
+    : chunk_size_(chunk_size),
+      current_chunk_(NULL),
+      current_chunk_used_(0) {
+}
+
+Arena::~Arena() {
+  for (size_t i = 0; i < chunks_.size(); i++)
+    delete[] chunks_[i];
+}
+
+// Returns size bytes aligned to the given power of two.
+void* Arena::Allocate(size_t size, size_t alignment) {
+  const size_t offset =
+      (current_chunk_used_ + alignment - 1) & ~(alignment - 1);
+  if (current_chunk_ != NULL && offset <= chunk_size_ &&
+      size <= chunk_size_ - offset) {
+    current_chunk_used_ = offset + size;
+    return current_chunk_ + offset;
+  }
+
+  // A block bigger than a quarter of a chunk gets a chunk of its own, so
+  // that it doesn't waste the rest of the current one.
+  const bool is_big = size > chunk_size_ / 4;
+  char* const chunk = new char[is_big ? size : chunk_size_];
+  chunks_.push_back(chunk);
+  if (!is_big) {
+    current_chunk_ = chunk;
+    current_chunk_used_ = size;
+  }
+  return chunk;
+}
+
+// class StringPool
+
+namespace {
+
+// The size of the chunks the pool copies strings into.
+const size_t kStringPoolChunkSize = 16 * 1024;
+
+// The number of hash table slots of an empty pool.
+const size_t kStringPoolInitialSlotCount = 256;
+
+// Hashes a NUL-terminated string with FNV-1a, setting *length to its
+// length.
+size_t HashString(const char* str, size_t* length) {
+  UInt32 hash = 2166136261U;
+  const char* p = str;
+  for (; *p != '\0'; ++p) {
+    hash = (hash ^ static_cast<unsigned char>(*p)) * 16777619U;
+  }
+  *length = static_cast<size_t>(p - str);
+  return hash;
+}
+
+}  // namespace
+
+StringPool::StringPool()
+    : slots_(kStringPoolInitialSlotCount),
+      arena_(kStringPoolChunkSize),
+      size_(0) {
+}
+
+// Returns the pool's copy of str, making one if the pool doesn't have it
+// yet.  Returns NULL if str is NULL.
+const char* StringPool::Intern(const char* str) {
+  if (str == NULL)
+    return NULL;
+
+  size_t length;
+  const size_t hash = HashString(str, &length);
+  MutexLock lock(&mutex_);
+  const size_t mask = slots_.size() - 1;
+  size_t i = hash & mask;
+  for (; slots_[i] != NULL; i = (i + 1) & mask) {
+    if (strcmp(slots_[i], str) == 0)
+      return slots_[i];
+  }
+
+  char* const copy = static_cast<char*>(arena_.Allocate(length + 1, 1));
+  memcpy(copy, str, length + 1);
+  slots_[i] = copy;
+  // Keeps the table at most half full, so that probe sequences are short.
+  if (++size_ * 2 > slots_.size())
+    Grow();
+  return copy;
+}
+
+// Returns the number of distinct strings in the pool.
+size_t StringPool::size() const {
+  MutexLock lock(&mutex_);
+  return size_;
+}
+
+// Doubles the number of hash table slots and rehashes the strings.
+void StringPool::Grow() {
+  std::vector<const char*> old_slots(slots_.size() * 2);
+  old_slots.swap(slots_);
+  const size_t mask = slots_.size() - 1;
+  for (size_t j = 0; j < old_slots.size(); j++) {
+    if (old_slots[j] == NULL)
+      continue;
+    size_t length;
+    size_t i = HashString(old_slots[j], &length) & mask;
+    while (slots_[i] != NULL)
+      i = (i + 1) & mask;
+    slots_[i] = old_slots[j];
+  }
+}
+
 // Streams an XML CDATA section, escaping invalid CDATA sequences as needed.
 void XmlUnitTestResultPrinter::OutputXmlCDataSection(::std::ostream* stream,
                                                      const char* data) {
@@ -3240,9 +5181,21 @@ void XmlUnitTestResultPrinter::OutputXmlTestInfo(::std::ostream* stream,
   *stream << " status=\""
           << (test_info.should_run() ? "run" : "notrun")
           << "\" time=\""
-          << FormatTimeInMillisAsSeconds(result.elapsed_time())
-          << "\" classname=\"" << EscapeXmlAttribute(test_case_name).c_str()
-          << "\"" << TestPropertiesAsXmlAttributes(result).c_str();
+          << FormatTimeInMillisAsSeconds(result.elapsed_time()) << "\"";
+  for (int i = 0; i < TestResult::kPhaseCount; ++i) {
+    const TestResult::Phase phase = static_cast<TestResult::Phase>(i);
+    *stream << " " << TestPhaseName(phase) << "_time=\""
+            << FormatNanosAsSeconds(result.phase_time_nanos(phase)) << "\"";
+  }
+  *stream << " classname=\"" << EscapeXmlAttribute(test_case_name).c_str()
+          << "\"";
+  if (result.has_heap_usage()) {
+    *stream << " heap_peak_bytes=\"" << result.heap_peak_bytes()
+            << "\" heap_growth_bytes=\"" << result.heap_growth_bytes()
+            << "\" heap_allocations=\"" << result.heap_allocation_count()
+            << "\"";
+  }
+  *stream << TestPropertiesAsXmlAttributes(result).c_str();
 
   int failures = 0;
   for (int i = 0; i < result.total_part_count(); ++i) {
@@ -3255,13 +5208,29 @@ void XmlUnitTestResultPrinter::OutputXmlTestInfo(::std::ostream* stream,
               << "\" type=\"\">";
       const string location = internal::FormatCompilerIndependentFileLocation(
           part.file_name(), part.line_number());
-      const string message = location + "\n" + part.message();
+      string message = location + "\n" + part.message();
+      const int repeat_count = result.GetTestPartRepeatCount(i);
+      if (repeat_count > 0) {
+        message = message + "\n" +
+            FormatRepeatedFailureNote(repeat_count).c_str();
+      }
       OutputXmlCDataSection(stream,
                             RemoveInvalidXmlCharacters(message).c_str());
       *stream << "</failure>\n";
     }
   }
 
+  const int omitted_count = result.omitted_failure_count();
+  if (omitted_count > 0) {
+    if (++failures == 1)
+      *stream << ">\n";
+    const String note = FormatOmittedFailureNote(omitted_count);
+    *stream << "      <failure message=\"" << EscapeXmlAttribute(note.c_str()).c_str()
+            << "\" type=\"\">";
+    OutputXmlCDataSection(stream, note.c_str());
+    *stream << "</failure>\n";
+  }
+
   if (failures == 0)
     *stream << " />\n";
   else
@@ -3279,8 +5248,11 @@ void XmlUnitTestResultPrinter::PrintXmlTestCase(FILE* out,
           test_case.failed_test_count(),
           test_case.disabled_test_count());
   fprintf(out,
-          "errors=\"0\" time=\"%s\">\n",
-          FormatTimeInMillisAsSeconds(test_case.elapsed_time()).c_str());
+          "errors=\"0\" time=\"%s\" set_up_time=\"%s\" "
+          "tear_down_time=\"%s\">\n",
+          FormatTimeInMillisAsSeconds(test_case.elapsed_time()).c_str(),
+          FormatNanosAsSeconds(test_case.set_up_time_nanos()).c_str(),
+          FormatNanosAsSeconds(test_case.tear_down_time_nanos()).c_str());
   for (int i = 0; i < test_case.total_test_count(); ++i) {
     ::std::stringstream stream;
     OutputXmlTestInfo(&stream, test_case.name(), *test_case.GetTestInfo(i));
@@ -3295,11 +5267,16 @@ void XmlUnitTestResultPrinter::PrintXmlUnitTest(FILE* out,
   fprintf(out, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
   fprintf(out,
           "<testsuites tests=\"%d\" failures=\"%d\" disabled=\"%d\" "
-          "errors=\"0\" time=\"%s\" ",
+          "errors=\"0\" time=\"%s\" set_up_time=\"%s\" "
+          "tear_down_time=\"%s\" ",
           unit_test.total_test_count(),
           unit_test.failed_test_count(),
           unit_test.disabled_test_count(),
-          FormatTimeInMillisAsSeconds(unit_test.elapsed_time()).c_str());
+          FormatTimeInMillisAsSeconds(unit_test.elapsed_time()).c_str(),
+          FormatNanosAsSeconds(
+              unit_test.environments_set_up_time_nanos()).c_str(),
+          FormatNanosAsSeconds(
+              unit_test.environments_tear_down_time_nanos()).c_str());
   if (GTEST_FLAG(shuffle)) {
     fprintf(out, "random_seed=\"%d\" ", unit_test.random_seed());
   }
@@ -3329,8 +5306,9 @@ String XmlUnitTestResultPrinter::TestPropertiesAsXmlAttributes(
 // Streams test results to the given port on the given host machine.
 class StreamingListener : public EmptyTestEventListener {
  public:
-  // Escapes '=', '&', '%', and '\n' characters in str as "%xx".
-  static string UrlEncode(const char* str);
+  // Escapes '=', '&', '%', and '\n' characters in str as "%xx" and
+  // appends the result to *output.
+  static void UrlEncode(const char* str, string* output);
 
   StreamingListener(const string& host, const string& port)
       : sockfd_(-1), host_name_(host), port_num_(port) {
@@ -3350,53 +5328,110 @@ class StreamingListener : public EmptyTestEventListener {
   void OnTestProgramEnd(const UnitTest& unit_test) {
     // Note that Google Test current only report elapsed time for each
     // test iteration, not for the entire test program.
-    Send(String::Format("event=TestProgramEnd&passed=%d\n",
-                        unit_test.Passed()));
+    line_.clear();
+    String::AppendFormat(&line_, "event=TestProgramEnd&passed=%d\n",
+                         unit_test.Passed());
+    Send(line_);
 
     // Notify the streaming server to stop.
     CloseConnection();
   }
 
   void OnTestIterationStart(const UnitTest& /* unit_test */, int iteration) {
-    Send(String::Format("event=TestIterationStart&iteration=%d\n",
-                        iteration));
+    line_.clear();
+    String::AppendFormat(&line_, "event=TestIterationStart&iteration=%d\n",
+                         iteration);
+    Send(line_);
   }
 
   void OnTestIterationEnd(const UnitTest& unit_test, int /* iteration */) {
-    Send(String::Format("event=TestIterationEnd&passed=%d&elapsed_time=%sms\n",
-                        unit_test.Passed(),
-                        StreamableToString(unit_test.elapsed_time()).c_str()));
+    line_.clear();
+    String::AppendFormat(&line_, "event=TestIterationEnd&passed=%d",
+                         unit_test.Passed());
+    AppendField("&elapsed_time=", unit_test.elapsed_time(), "ms\n");
+    Send(line_);
   }
 
   void OnTestCaseStart(const TestCase& test_case) {
-    Send(String::Format("event=TestCaseStart&name=%s\n", test_case.name()));
+    line_.assign("event=TestCaseStart&name=").append(test_case.name());
+    line_.append(1, '\n');
+    Send(line_);
   }
 
   void OnTestCaseEnd(const TestCase& test_case) {
-    Send(String::Format("event=TestCaseEnd&passed=%d&elapsed_time=%sms\n",
-                        test_case.Passed(),
-                        StreamableToString(test_case.elapsed_time()).c_str()));
+    line_.clear();
+    String::AppendFormat(&line_, "event=TestCaseEnd&passed=%d",
+                         test_case.Passed());
+    AppendField("&elapsed_time=", test_case.elapsed_time(), "ms");
+    AppendField("&set_up_time=", test_case.set_up_time_nanos(), "ns");
+    AppendField("&tear_down_time=", test_case.tear_down_time_nanos(), "ns\n");
+    Send(line_);
   }
 
   void OnTestStart(const TestInfo& test_info) {
-    Send(String::Format("event=TestStart&name=%s\n", test_info.name()));
+    line_.assign("event=TestStart&name=").append(test_info.name());
+    line_.append(1, '\n');
+    Send(line_);
   }
 
   void OnTestEnd(const TestInfo& test_info) {
-    Send(String::Format(
-        "event=TestEnd&passed=%d&elapsed_time=%sms\n",
-        (test_info.result())->Passed(),
-        StreamableToString((test_info.result())->elapsed_time()).c_str()));
+    const TestResult& result = *test_info.result();
+    for (int i = 0; i < result.total_part_count(); ++i) {
+      const int repeat_count = result.GetTestPartRepeatCount(i);
+      if (repeat_count > 0) {
+        const TestPartResult& part = result.GetTestPartResult(i);
+        const char* file_name = part.file_name();
+        if (file_name == NULL)
+          file_name = "";
+        line_.assign("event=TestPartResultRepeated&file=");
+        UrlEncode(file_name, &line_);
+        String::AppendFormat(&line_, "&line=%d&count=%d&message=",
+                             part.line_number(), repeat_count);
+        UrlEncode(FormatRepeatedFailureNote(repeat_count).c_str(), &line_);
+        line_.append(1, '\n');
+        Send(line_);
+      }
+    }
+    const int omitted_count = result.omitted_failure_count();
+    if (omitted_count > 0) {
+      line_.assign("event=TestPartResultsOmitted");
+      String::AppendFormat(&line_, "&count=%d&message=", omitted_count);
+      UrlEncode(FormatOmittedFailureNote(omitted_count).c_str(), &line_);
+      line_.append(1, '\n');
+      Send(line_);
+    }
+    for (int i = 0; i < result.test_property_count(); ++i) {
+      const TestProperty& property = result.GetTestProperty(i);
+      line_.assign("event=TestProperty&key=");
+      UrlEncode(property.key(), &line_);
+      line_.append("&value=");
+      UrlEncode(property.value(), &line_);
+      line_.append(1, '\n');
+      Send(line_);
+    }
+    line_.clear();
+    String::AppendFormat(&line_, "event=TestEnd&passed=%d", result.Passed());
+    AppendField("&elapsed_time=", result.elapsed_time(), "ms");
+    for (int i = 0; i < TestResult::kPhaseCount; ++i) {
+      const TestResult::Phase phase = static_cast<TestResult::Phase>(i);
+      line_.append(1, '&').append(TestPhaseName(phase));
+      AppendField("_time=", result.phase_time_nanos(phase), "ns");
+    }
+    line_.append(1, '\n');
+    Send(line_);
   }
 
   void OnTestPartResult(const TestPartResult& test_part_result) {
     const char* file_name = test_part_result.file_name();
     if (file_name == NULL)
       file_name = "";
-    Send(String::Format("event=TestPartResult&file=%s&line=%d&message=",
-                        UrlEncode(file_name).c_str(),
-                        test_part_result.line_number()));
-    Send(UrlEncode(test_part_result.message()) + "\n");
+    line_.assign("event=TestPartResult&file=");
+    UrlEncode(file_name, &line_);
+    String::AppendFormat(&line_, "&line=%d&message=",
+                         test_part_result.line_number());
+    UrlEncode(test_part_result.message(), &line_);
+    line_.append(1, '\n');
+    Send(line_);
   }
 
  private:
@@ -3412,6 +5447,9 @@ class StreamingListener : public EmptyTestEventListener {
     sockfd_ = -1;
   }
 
+  // Appends prefix, the decimal value, and suffix to line_.
+  void AppendField(const char* prefix, Int64 value, const char* suffix);
+
   // Sends a string to the socket.
   void Send(const string& message) {
     GTEST_CHECK_(sockfd_ != -1)
@@ -3429,31 +5467,57 @@ class StreamingListener : public EmptyTestEventListener {
   const string host_name_;
   const string port_num_;
 
+  // The event line being built.  It's reused across events so that
+  // streaming a test doesn't allocate once the buffer has grown to
+  // the longest line seen so far.
+  string line_;
+
   GTEST_DISALLOW_COPY_AND_ASSIGN_(StreamingListener);
 };  // class StreamingListener
 
 // Checks if str contains '=', '&', '%' or '\n' characters. If yes,
 // replaces them by "%xx" where xx is their hexadecimal value. For
-// example, replaces "=" with "%3D".  This algorithm is O(strlen(str))
+// example, replaces "=" with "%3d".  This algorithm is O(strlen(str))
 // in both time and space -- important as the input str may contain an
 // arbitrarily long test failure message and stack trace.
-string StreamingListener::UrlEncode(const char* str) {
-  string result;
-  result.reserve(strlen(str) + 1);
+void StreamingListener::UrlEncode(const char* str, string* output) {
+  static const char kHexDigits[] = "0123456789abcdef";
   for (char ch = *str; ch != '\0'; ch = *++str) {
     switch (ch) {
       case '%':
       case '=':
       case '&':
-      case '\n':
-        result.append(String::Format("%%%02x", static_cast<unsigned char>(ch)));
+      case '\n': {
+        const unsigned char byte = static_cast<unsigned char>(ch);
+        output->append(1, '%');
+        output->append(1, kHexDigits[byte >> 4]);
+        output->append(1, kHexDigits[byte & 0xf]);
         break;
+      }
       default:
-        result.push_back(ch);
+        output->push_back(ch);
         break;
     }
   }
-  return result;
+}
+
+// Appends the decimal value without going through a stringstream, as
+// StreamableToString() would.
+void StreamingListener::AppendField(const char* prefix, Int64 value,
+                                    const char* suffix) {
+  char digits[24];
+  char* const end = digits + sizeof(digits);
+  char* p = end;
+  UInt64 magnitude = value < 0 ? 0 - static_cast<UInt64>(value) :
+      static_cast<UInt64>(value);
+  do {
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (value < 0)
+    *--p = '-';
+
+  line_.append(prefix).append(p, end - p).append(suffix);
 }
 
 void StreamingListener::MakeConnection() {
@@ -3498,28 +5562,52 @@ void StreamingListener::MakeConnection() {
 }
 
 // End of class Streaming Listener
+
+// Creates the listener --gtest_stream_result_to=host:port installs.
+TestEventListener* NewStreamingListener(const string& host,
+                                        const string& port) {
+  return new StreamingListener(host, port);
+}
 #endif  // GTEST_CAN_STREAM_RESULTS__
 
 // Class ScopedTrace
 
 // Pushes the given source file location and message onto a per-thread
 // trace stack maintained by Google Test.
-// L < UnitTest::mutex_
 ScopedTrace::ScopedTrace(const char* file, int line, const Message& message) {
   TraceInfo trace;
   trace.file = file;
   trace.line = line;
   trace.message = message.GetString();
+  trace.lazy_trace = NULL;
 
   UnitTest::GetInstance()->PushGTestTrace(trace);
 }
 
 // Pops the info pushed by the c'tor.
-// L < UnitTest::mutex_
 ScopedTrace::~ScopedTrace() {
   UnitTest::GetInstance()->PopGTestTrace();
 }
 
+// Class LazyScopedTrace
+
+// Pushes the given source file location and this object onto the
+// per-thread trace stack.  No message is formatted here; the traced
+// value is streamed only if a failure is reported in this scope.
+void LazyScopedTrace::Push(const char* file, int line) {
+  TraceInfo trace;
+  trace.file = file;
+  trace.line = line;
+  trace.lazy_trace = this;
+
+  UnitTest::GetInstance()->PushGTestTrace(trace);
+}
+
+// Pops the info pushed by the c'tor.
+LazyScopedTrace::~LazyScopedTrace() {
+  UnitTest::GetInstance()->PopGTestTrace();
+}
+
 
 // class OsStackTraceGetter
 
@@ -3696,6 +5784,18 @@ internal::TimeInMillis UnitTest::elapsed_time() const {
   return impl()->elapsed_time();
 }
 
+// Gets the time the SetUp() methods of the global environments took in
+// the last iteration, in nanoseconds.
+internal::Int64 UnitTest::environments_set_up_time_nanos() const {
+  return impl()->environments_set_up_time_nanos();
+}
+
+// Gets the time the TearDown() methods of the global environments took in
+// the last iteration, in nanoseconds.
+internal::Int64 UnitTest::environments_tear_down_time_nanos() const {
+  return impl()->environments_tear_down_time_nanos();
+}
+
 // Returns true iff the unit test passed (i.e. all test cases passed).
 bool UnitTest::Passed() const { return impl()->Passed(); }
 
@@ -3744,16 +5844,20 @@ Environment* UnitTest::AddEnvironment(Environment* env) {
 // assertion macros (e.g. ASSERT_TRUE, EXPECT_EQ, etc) eventually call
 // this to report their results.  The user code should use the
 // assertion macros instead of calling this directly.
-// L < mutex_
 void UnitTest::AddTestPartResult(TestPartResult::Type result_type,
                                  const char* file_name,
                                  int line_number,
                                  const internal::String& message,
                                  const internal::String& os_stack_trace) {
+  // Neither the message nor the recorded result is part of the test's
+  // heap usage.
+  const internal::ScopedHeapCountingSuspension suspension;
+
   Message msg;
   msg << message;
 
-  internal::MutexLock lock(&mutex_);
+  // No lock is needed here: the trace stack is per-thread, and the
+  // default reporters buffer the results of other threads per thread.
   if (impl_->gtest_trace_stack().size() > 0) {
     msg << "\n" << GTEST_NAME_ << " trace:";
 
@@ -3761,7 +5865,12 @@ void UnitTest::AddTestPartResult(TestPartResult::Type result_type,
          i > 0; --i) {
       const internal::TraceInfo& trace = impl_->gtest_trace_stack()[i - 1];
       msg << "\n" << internal::FormatFileLocation(trace.file, trace.line)
-          << " " << trace.message;
+          << " ";
+      if (trace.lazy_trace != NULL) {
+        trace.lazy_trace->AppendValueTo(&msg);
+      } else {
+        msg << trace.message;
+      }
     }
   }
 
@@ -3920,22 +6029,26 @@ UnitTest::~UnitTest() {
 }
 
 // Pushes a trace defined by SCOPED_TRACE() on to the per-thread
-// Google Test trace stack.
-// L < mutex_
+// Google Test trace stack.  As the stack is per-thread, no lock is
+// needed.
 void UnitTest::PushGTestTrace(const internal::TraceInfo& trace) {
-  internal::MutexLock lock(&mutex_);
   impl_->gtest_trace_stack().push_back(trace);
 }
 
 // Pops a trace from the per-thread Google Test trace stack.
-// L < mutex_
 void UnitTest::PopGTestTrace() {
-  internal::MutexLock lock(&mutex_);
   impl_->gtest_trace_stack().pop_back();
 }
 
 namespace internal {
 
+namespace {
+
+// The size of the chunks of the registration arena.
+const size_t kRegistrationArenaChunkSize = 64 * 1024;
+
+}  // namespace
+
 UnitTestImpl::UnitTestImpl(UnitTest* parent)
     : parent_(parent),
 #ifdef _MSC_VER
@@ -3953,6 +6066,7 @@ UnitTestImpl::UnitTestImpl(UnitTest* parent)
           &default_global_test_part_result_reporter_),
       per_thread_test_part_result_reporter_(
           &default_per_thread_test_part_result_reporter_),
+      registration_arena_(kRegistrationArenaChunkSize),
 #if GTEST_HAS_PARAM_TEST
       parameterized_test_registry_(),
       parameterized_tests_registered_(false),
@@ -3966,18 +6080,26 @@ UnitTestImpl::UnitTestImpl(UnitTest* parent)
       random_seed_(0),  // Will be overridden by the flag before first use.
       random_(0),  // Will be reseeded before first use.
       elapsed_time_(0),
+      environments_set_up_time_nanos_(0),
+      environments_tear_down_time_nanos_(0),
 #if GTEST_HAS_DEATH_TEST
       internal_run_death_test_flag_(NULL),
       death_test_factory_(new DefaultDeathTestFactory),
 #endif
       // Will be overridden by the flag before first use.
       catch_exceptions_(false) {
+  is_test_thread_.set(true);
   listeners()->SetDefaultResultPrinter(new PrettyUnitTestResultPrinter);
 }
 
 UnitTestImpl::~UnitTestImpl() {
-  // Deletes every TestCase.
-  ForEach(test_cases_, internal::Delete<TestCase>);
+  // Deletes the result buffers of the threads that reported results.
+  ForEach(all_thread_test_part_results_,
+          internal::Delete<ThreadTestPartResults>);
+
+  // Destroys every TestCase.  Their memory belongs to the registration
+  // arena.
+  ForEach(test_cases_, internal::Destroy<TestCase>);
 
   // Deletes every Environment.
   ForEach(environments_, internal::Delete<Environment>);
@@ -3985,6 +6107,14 @@ UnitTestImpl::~UnitTestImpl() {
   delete os_stack_trace_getter_;
 }
 
+// Allocates size bytes with the given alignment in the registration
+// arena.
+void* UnitTestImpl::AllocateRegistrationObject(size_t size,
+                                               size_t alignment) {
+  MutexLock lock(&registration_arena_mutex_);
+  return registration_arena_.Allocate(size, alignment);
+}
+
 #if GTEST_HAS_DEATH_TEST
 // Disables event forwarding if the control is currently in a death test
 // subprocess. Must not be called before InitGoogleTest.
@@ -4036,6 +6166,8 @@ void UnitTestImpl::PostFlagParsingInit() {
   // Ensures that this function does not execute more than once.
   if (!post_flag_parse_init_performed_) {
     post_flag_parse_init_performed_ = true;
+    const StartupStageTimer timer(&startup_profile_,
+                                  kPostFlagParsingInitStage);
 
 #if GTEST_HAS_DEATH_TEST
     InitDeathTestSubprocessControlInfo();
@@ -4045,7 +6177,14 @@ void UnitTestImpl::PostFlagParsingInit() {
     // Registers parameterized tests. This makes parameterized tests
     // available to the UnitTest reflection API without running
     // RUN_ALL_TESTS.
-    RegisterParameterizedTests();
+    {
+      const StartupStageTimer registration_timer(
+          &startup_profile_, kParameterizedTestRegistrationStage);
+      RegisterParameterizedTests();
+    }
+
+    const StartupStageTimer listener_timer(&startup_profile_,
+                                           kListenerSetUpStage);
 
     // Configures listeners for XML output. This makes it possible for users
     // to shut down the default XML output before invoking RUN_ALL_TESTS.
@@ -4068,17 +6207,18 @@ void UnitTestImpl::PostFlagParsingInit() {
 // TestCaseNameIs is copyable.
 class TestCaseNameIs {
  public:
-  // Constructor.
-  explicit TestCaseNameIs(const String& name)
+  // Constructor.  name must be interned in the name pool, like the names
+  // of the test cases.
+  explicit TestCaseNameIs(const char* name)
       : name_(name) {}
 
   // Returns true iff the name of test_case matches name_.
   bool operator()(const TestCase* test_case) const {
-    return test_case != NULL && strcmp(test_case->name(), name_.c_str()) == 0;
+    return test_case != NULL && test_case->name() == name_;
   }
 
  private:
-  String name_;
+  const char* name_;
 };
 
 // Finds and returns a TestCase with the given name.  If one doesn't
@@ -4097,6 +6237,9 @@ TestCase* UnitTestImpl::GetTestCase(const char* test_case_name,
                                     const char* type_param,
                                     Test::SetUpTestCaseFunc set_up_tc,
                                     Test::TearDownTestCaseFunc tear_down_tc) {
+  // Interned test case names can be compared by address.
+  test_case_name = name_pool_.Intern(test_case_name);
+
   // Can we find a TestCase with the given name?
   const std::vector<TestCase*>::const_iterator test_case =
       std::find_if(test_cases_.begin(), test_cases_.end(),
@@ -4107,10 +6250,11 @@ TestCase* UnitTestImpl::GetTestCase(const char* test_case_name,
 
   // No.  Let's create one.
   TestCase* const new_test_case =
-      new TestCase(test_case_name, type_param, set_up_tc, tear_down_tc);
+      new(AllocateRegistrationObject<TestCase>())
+      TestCase(test_case_name, type_param, set_up_tc, tear_down_tc);
 
   // Is this a death test case?
-  if (internal::UnitTestOptions::MatchesFilter(String(test_case_name),
+  if (internal::UnitTestOptions::MatchesFilter(test_case_name,
                                                kDeathTestCaseFilter)) {
     // Yes.  Inserts the test case after the last death test case
     // defined so far.  This only works when the test cases haven't
@@ -4177,9 +6321,18 @@ bool UnitTestImpl::RunAllTests() {
 
   // Compares the full test names with the filter to decide which
   // tests to run.
-  const bool has_tests_to_run = FilterTests(should_shard
-                                              ? HONOR_SHARDING_PROTOCOL
-                                              : IGNORE_SHARDING_PROTOCOL) > 0;
+  bool has_tests_to_run = false;
+  {
+    const StartupStageTimer timer(&startup_profile_, kTestFilteringStage);
+    has_tests_to_run = FilterTests(should_shard
+                                     ? HONOR_SHARDING_PROTOCOL
+                                     : IGNORE_SHARDING_PROTOCOL) > 0;
+  }
+
+  if (GTEST_FLAG(startup_profile) && !in_subprocess_for_death_test) {
+    printf("%s", startup_profile_.Format().c_str());
+    fflush(stdout);
+  }
 
   // Lists the tests and exits if the --gtest_list_tests flag was specified.
   if (GTEST_FLAG(list_tests)) {
@@ -4194,6 +6347,11 @@ bool UnitTestImpl::RunAllTests() {
   // True iff at least one test has failed.
   bool failed = false;
 
+  // Failures in other threads are merged by the thread running the
+  // tests.  Those reported before RUN_ALL_TESTS() go to the ad hoc test.
+  is_test_thread_.set(true);
+  MergeTestPartResultsFromOtherThreads();
+
   TestEventListener* repeater = listeners()->repeater();
 
   repeater->OnTestProgramStart(*parent_);
@@ -4226,7 +6384,10 @@ bool UnitTestImpl::RunAllTests() {
     if (has_tests_to_run) {
       // Sets up all environments beforehand.
       repeater->OnEnvironmentsSetUpStart(*parent_);
+      const Int64 set_up_start = GetMonotonicTimeInNanos();
       ForEach(environments_, SetUpEnvironment);
+      environments_set_up_time_nanos_ =
+          GetMonotonicTimeInNanos() - set_up_start;
       repeater->OnEnvironmentsSetUpEnd(*parent_);
 
       // Runs the tests only if there was no fatal failure during global
@@ -4240,8 +6401,12 @@ bool UnitTestImpl::RunAllTests() {
 
       // Tears down all environments in reverse order afterwards.
       repeater->OnEnvironmentsTearDownStart(*parent_);
+      const Int64 tear_down_start = GetMonotonicTimeInNanos();
       std::for_each(environments_.rbegin(), environments_.rend(),
                     TearDownEnvironment);
+      environments_tear_down_time_nanos_ =
+          GetMonotonicTimeInNanos() - tear_down_start;
+      MergeTestPartResultsFromOtherThreads();
       repeater->OnEnvironmentsTearDownEnd(*parent_);
     }
 
@@ -4386,14 +6551,23 @@ int UnitTestImpl::FilterTests(ReactionToSharding shard_tests) {
   // this shard.
   int num_runnable_tests = 0;
   int num_selected_tests = 0;
+
+  // The filter is split once, and the full name of each test is built
+  // in the same buffer, so that filtering doesn't allocate per test.
+  String positive_filter;
+  const char* negative_filter;
+  internal::UnitTestOptions::SplitFilter(GTEST_FLAG(filter).c_str(),
+                                         &positive_filter, &negative_filter);
+  ::std::string full_name;
+
   for (size_t i = 0; i < test_cases_.size(); i++) {
     TestCase* const test_case = test_cases_[i];
-    const String &test_case_name = test_case->name();
+    const char* const test_case_name = test_case->name();
     test_case->set_should_run(false);
 
     for (size_t j = 0; j < test_case->test_info_list().size(); j++) {
       TestInfo* const test_info = test_case->test_info_list()[j];
-      const String test_name(test_info->name());
+      const char* const test_name = test_info->name();
       // A test is disabled if test case name or test name matches
       // kDisableTestFilter.
       const bool is_disabled =
@@ -4403,9 +6577,10 @@ int UnitTestImpl::FilterTests(ReactionToSharding shard_tests) {
                                                    kDisableTestFilter);
       test_info->is_disabled_ = is_disabled;
 
+      full_name.assign(test_case_name).append(1, '.').append(test_name);
       const bool matches_filter =
-          internal::UnitTestOptions::FilterMatchesTest(test_case_name,
-                                                       test_name);
+          internal::UnitTestOptions::FullNameMatchesFilter(
+              full_name, positive_filter.c_str(), negative_filter);
       test_info->matches_filter_ = matches_filter;
 
       const bool is_runnable =
@@ -4731,6 +6906,10 @@ static const char kColorEncodedHelpMessage[] =
 "      Enable/disable colored output. The default is @Gauto@D.\n"
 "  -@G-" GTEST_FLAG_PREFIX_ "print_time=0@D\n"
 "      Don't print the elapsed time of each test.\n"
+"  @G--" GTEST_FLAG_PREFIX_ "startup_profile@D\n"
+"      Print the time spent in each stage of " GTEST_NAME_ "'s startup.\n"
+"      Static test registration is only timed with @G" GTEST_FLAG_PREFIX_UPPER_
+    "STARTUP_PROFILE=1@D.\n"
 "  @G--" GTEST_FLAG_PREFIX_ "output=xml@Y[@G:@YDIRECTORY_PATH@G"
     GTEST_PATH_SEP_ "@Y|@G:@YFILE_PATH]@D\n"
 "      Generate an XML report in the given directory or with the given file\n"
@@ -4752,6 +6931,16 @@ static const char kColorEncodedHelpMessage[] =
 "  @G--" GTEST_FLAG_PREFIX_ "catch_exceptions=0@D\n"
 "      Do not report exceptions as test failures. Instead, allow them\n"
 "      to crash the program or throw a pop-up (on Windows).\n"
+"  @G--" GTEST_FLAG_PREFIX_ "max_failures_per_test=@Y[COUNT]@D\n"
+"      Once a test has recorded @YCOUNT@D results (100 by default), only count\n"
+"      further failures, as repeats of an earlier one with the same file,\n"
+"      line, and type or as omitted.  0 means no limit.\n"
+"  @G--" GTEST_FLAG_PREFIX_ "fail_on_leak_bytes=@Y[BYTES]@D\n"
+"      Fail a test whose heap grows by more than @YBYTES@D. Requires a heap\n"
+"      profiler, e.g. linking with the gtest_allocations library.\n"
+"  @G--" GTEST_FLAG_PREFIX_ "update_golden_files@D\n"
+"      Rewrite the golden files of MATCHES_GOLDEN_FILE assertions with the\n"
+"      actual data instead of comparing against them.\n"
 "\n"
 "Except for @G--" GTEST_FLAG_PREFIX_ "list_tests@D, you can alternatively set "
     "the corresponding\n"
@@ -4790,21 +6979,29 @@ void ParseGoogleTestFlagsOnlyImpl(int* argc, CharType** argv) {
                         &GTEST_FLAG(death_test_style)) ||
         ParseBoolFlag(arg, kDeathTestUseFork,
                       &GTEST_FLAG(death_test_use_fork)) ||
+        ParseInt32Flag(arg, kFailOnLeakBytesFlag,
+                       &GTEST_FLAG(fail_on_leak_bytes)) ||
         ParseStringFlag(arg, kFilterFlag, &GTEST_FLAG(filter)) ||
         ParseStringFlag(arg, kInternalRunDeathTestFlag,
                         &GTEST_FLAG(internal_run_death_test)) ||
         ParseBoolFlag(arg, kListTestsFlag, &GTEST_FLAG(list_tests)) ||
+        ParseInt32Flag(arg, kMaxFailuresPerTestFlag,
+                       &GTEST_FLAG(max_failures_per_test)) ||
         ParseStringFlag(arg, kOutputFlag, &GTEST_FLAG(output)) ||
         ParseBoolFlag(arg, kPrintTimeFlag, &GTEST_FLAG(print_time)) ||
         ParseInt32Flag(arg, kRandomSeedFlag, &GTEST_FLAG(random_seed)) ||
         ParseInt32Flag(arg, kRepeatFlag, &GTEST_FLAG(repeat)) ||
         ParseBoolFlag(arg, kShuffleFlag, &GTEST_FLAG(shuffle)) ||
+        ParseBoolFlag(arg, kStartupProfileFlag,
+                      &GTEST_FLAG(startup_profile)) ||
         ParseInt32Flag(arg, kStackTraceDepthFlag,
                        &GTEST_FLAG(stack_trace_depth)) ||
         ParseStringFlag(arg, kStreamResultToFlag,
                         &GTEST_FLAG(stream_result_to)) ||
         ParseBoolFlag(arg, kThrowOnFailureFlag,
-                      &GTEST_FLAG(throw_on_failure))
+                      &GTEST_FLAG(throw_on_failure)) ||
+        ParseBoolFlag(arg, kUpdateGoldenFilesFlag,
+                      &GTEST_FLAG(update_golden_files))
         ) {
       // Yes.  Shift the remainder of the argv list left by one.  Note
       // that argv has (*argc + 1) elements, the last one always being
@@ -4870,7 +7067,11 @@ void InitGoogleTestImpl(int* argc, CharType** argv) {
 
 #endif  // GTEST_HAS_DEATH_TEST
 
-  ParseGoogleTestFlagsOnly(argc, argv);
+  {
+    const StartupStageTimer timer(GetUnitTestImpl()->startup_profile(),
+                                  kFlagParsingStage);
+    ParseGoogleTestFlagsOnly(argc, argv);
+  }
   GetUnitTestImpl()->PostFlagParsingInit();
 }
 
@@ -0,0 +1,185 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Tests for EXPECT_NO_HEAP_ALLOCATIONS() and EXPECT_ALLOCATIONS_LE().
+
+#include "gtest/gtest-allocations.h"
+
+#include "gtest/gtest.h"
+#include "gtest/gtest-spi.h"
+
+namespace {
+
+using testing::TestResult;
+using testing::UnitTest;
+using testing::internal::GetHeapAllocationCount;
+using testing::internal::GetHeapProfiler;
+using testing::internal::HeapProfilerInterface;
+using testing::internal::HeapUsage;
+using testing::internal::Int64;
+
+// Makes the given number of heap allocations.
+void Allocate(int count) {
+  for (int i = 0; i < count; i++)
+    delete[] new char[10];
+}
+
+TEST(GetHeapAllocationCountTest, CountsCallsToOperatorNew) {
+  const Int64 start = GetHeapAllocationCount();
+  delete new int(1);
+  delete[] new char[3];
+  delete new(std::nothrow) int(2);
+  EXPECT_EQ(3, GetHeapAllocationCount() - start);
+}
+
+TEST(NoHeapAllocationsTest, SucceedsWhenStatementDoesNotAllocate) {
+  int n = 0;
+  EXPECT_NO_HEAP_ALLOCATIONS(n++);
+  ASSERT_NO_HEAP_ALLOCATIONS(n++);
+  EXPECT_EQ(2, n);
+}
+
+TEST(NoHeapAllocationsTest, FailsWhenStatementAllocates) {
+  EXPECT_NONFATAL_FAILURE(EXPECT_NO_HEAP_ALLOCATIONS(Allocate(1)),
+                          "Expected: Allocate(1) doesn't allocate on the heap.\n"
+                          "  Actual: it makes 1.");
+  EXPECT_FATAL_FAILURE(ASSERT_NO_HEAP_ALLOCATIONS(Allocate(1)),
+                       "Actual: it makes 1.");
+}
+
+#ifdef __cpp_aligned_new
+
+struct OverAlignedType {
+  alignas(64) char bytes[64];
+};
+
+TEST(GetHeapAllocationCountTest, CountsCallsToAlignedOperatorNew) {
+  const Int64 start = GetHeapAllocationCount();
+  OverAlignedType* const p = new OverAlignedType;
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(p) % 64);
+  delete p;
+  delete[] new OverAlignedType[3];
+  delete new(std::nothrow) OverAlignedType;
+  EXPECT_EQ(3, GetHeapAllocationCount() - start);
+}
+
+#endif  // __cpp_aligned_new
+
+TEST(AllocationsLeTest, SucceedsWithinTheLimit) {
+  EXPECT_ALLOCATIONS_LE(2, Allocate(2));
+  ASSERT_ALLOCATIONS_LE(2, Allocate(1));
+}
+
+TEST(AllocationsLeTest, FailsOverTheLimit) {
+  EXPECT_NONFATAL_FAILURE(EXPECT_ALLOCATIONS_LE(1, Allocate(2)),
+                          "Expected: Allocate(2) makes at most 1 heap "
+                          "allocation.\n  Actual: it makes 2.");
+  EXPECT_FATAL_FAILURE(ASSERT_ALLOCATIONS_LE(2, Allocate(3)),
+                       "makes at most 2 heap allocations.");
+}
+
+// Call sites are only recorded where each thread has its own count.
+#if GTEST_HAS_COMPILER_TLS
+
+TEST(AllocationsLeTest, ListsTheFirstFewCallSites) {
+  EXPECT_NONFATAL_FAILURE(EXPECT_NO_HEAP_ALLOCATIONS(Allocate(1)),
+                          "Actual: it makes 1.\nAllocation #1 (10 bytes)");
+  EXPECT_NONFATAL_FAILURE(EXPECT_NO_HEAP_ALLOCATIONS(Allocate(10)),
+                          "Allocation #4 (10 bytes)");
+  EXPECT_NONFATAL_FAILURE(EXPECT_NO_HEAP_ALLOCATIONS(Allocate(10)),
+                          "(6 more allocation(s) not shown)");
+}
+
+#endif  // GTEST_HAS_COMPILER_TLS
+
+TEST(AllocationsLeTest, WorksWhenNested) {
+  int n = 0;
+  EXPECT_ALLOCATIONS_LE(1, {
+    EXPECT_NO_HEAP_ALLOCATIONS(n++);
+    Allocate(1);
+  });
+  EXPECT_EQ(1, n);
+
+  EXPECT_NONFATAL_FAILURE(EXPECT_ALLOCATIONS_LE(1, {
+    EXPECT_ALLOCATIONS_LE(2, Allocate(2));
+    Allocate(1);
+  }), "Actual: it makes 3.");
+}
+
+#if GTEST_HAS_PTHREAD && GTEST_HAS_COMPILER_TLS
+
+TEST(AllocationsLeTest, DoesNotCountAllocationsOnOtherThreads) {
+  testing::internal::Notification can_start;
+  testing::internal::ThreadWithParam<int> thread(&Allocate, 5, &can_start);
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    can_start.Notify();
+    thread.Join();
+  });
+}
+
+#endif  // GTEST_HAS_PTHREAD && GTEST_HAS_COMPILER_TLS
+
+TEST(HeapProfilerTest, IsInstalledByLinkingWithGtestAllocations) {
+  HeapProfilerInterface* const profiler = GetHeapProfiler();
+  ASSERT_TRUE(profiler != NULL);
+
+  const HeapUsage before = profiler->GetHeapUsage();
+  char* const block = new char[500];
+  const HeapUsage during = profiler->GetHeapUsage();
+  delete[] block;
+  const HeapUsage after = profiler->GetHeapUsage();
+
+  EXPECT_EQ(500, during.live_bytes - before.live_bytes);
+  EXPECT_EQ(1, during.allocation_count - before.allocation_count);
+  EXPECT_EQ(before.live_bytes, after.live_bytes);
+  EXPECT_LE(during.live_bytes, after.peak_live_bytes);
+}
+
+// The heap usage of a test is only known once it has finished, so the
+// following tests check the result of the test that runs before them.
+
+char* g_block_kept_for_next_test = NULL;
+
+TEST(HeapUsageTest, KeepsABlockForTheNextTest) {
+  g_block_kept_for_next_test = new char[1000];
+  delete[] new char[100000];
+}
+
+TEST(HeapUsageTest, IsRecordedInTheResultOfThePreviousTest) {
+  delete[] g_block_kept_for_next_test;
+  const TestResult& previous =
+      *UnitTest::GetInstance()->current_test_case()->GetTestInfo(0)->result();
+
+  ASSERT_TRUE(previous.has_heap_usage());
+  EXPECT_EQ(1000, previous.heap_growth_bytes());
+  EXPECT_LE(101000, previous.heap_peak_bytes());
+  EXPECT_LE(2, previous.heap_allocation_count());
+}
+
+}  // namespace
@@ -467,6 +467,17 @@ TEST(NormalizeTest, MultipleConsecutiveSepaparatorsAtStringEnd) {
     FilePath("foo" GTEST_PATH_SEP_ GTEST_PATH_SEP_ GTEST_PATH_SEP_).c_str());
 }
 
+// Tests that a FilePath made from a part of a string doesn't look
+// past the end of that part.
+TEST(NormalizeTest, StopsAtTheEndOfAPartOfAString) {
+  const char path[] = "foo" GTEST_PATH_SEP_ GTEST_PATH_SEP_ GTEST_PATH_SEP_
+      GTEST_PATH_SEP_ "bar";
+  EXPECT_STREQ("foo" GTEST_PATH_SEP_, FilePath(StringPiece(path, 5)).c_str());
+  EXPECT_STREQ("fo", FilePath(StringPiece(path, 2)).c_str());
+  EXPECT_STREQ("foo" GTEST_PATH_SEP_ "bar",
+               FilePath(::std::string(path)).c_str());
+}
+
 #if GTEST_HAS_ALT_PATH_SEP_
 
 // Tests that separators at the end of the string are normalized
@@ -603,6 +614,46 @@ TEST_F(DirectoryCreationTest, CreateDirectoriesFail) {
   EXPECT_FALSE(testdata_file_.CreateDirectoriesRecursively());
 }
 
+TEST_F(DirectoryCreationTest, WriteFileAtomicallyCreatesAndReplacesFile) {
+  testdata_path_.CreateDirectoriesRecursively();
+  ASSERT_TRUE(unique_file0_.WriteFileAtomically("text\n", 5));
+  MappedFile file;
+  ASSERT_TRUE(file.Map(unique_file0_));
+  EXPECT_EQ(::std::string("text\n"), ::std::string(file.data(), file.size()));
+  file.Unmap();
+
+  const char kBinary[] = "a\0b\r\n";
+  ASSERT_TRUE(unique_file0_.WriteFileAtomically(kBinary, sizeof(kBinary)));
+  ASSERT_TRUE(file.Map(unique_file0_));
+  EXPECT_EQ(::std::string(kBinary, sizeof(kBinary)),
+            ::std::string(file.data(), file.size()));
+  file.Unmap();
+
+  ASSERT_TRUE(unique_file0_.WriteFileAtomically("", 0));
+  ASSERT_TRUE(file.Map(unique_file0_));
+  EXPECT_TRUE(file.data() != NULL);
+  EXPECT_EQ(0u, file.size());
+
+  // The temporary file is gone.
+  EXPECT_FALSE(FilePath::MakeFileName(testdata_path_, FilePath("unique.txt"),
+                                      0, "tmp").FileOrDirectoryExists());
+}
+
+TEST_F(DirectoryCreationTest, WriteFileAtomicallyFailsWithoutDirectory) {
+  EXPECT_FALSE(unique_file0_.WriteFileAtomically("text\n", 5));
+  EXPECT_FALSE(unique_file0_.FileOrDirectoryExists());
+}
+
+TEST_F(DirectoryCreationTest, MappedFileFailsForMissingFileOrDirectory) {
+  MappedFile file;
+  EXPECT_FALSE(file.Map(unique_file0_));
+  EXPECT_TRUE(file.data() == NULL);
+
+  testdata_path_.CreateDirectoriesRecursively();
+  EXPECT_FALSE(file.Map(testdata_file_));
+  EXPECT_TRUE(file.data() == NULL);
+}
+
 TEST(NoDirectoryCreationTest, CreateNoDirectoriesForDefaultXmlFile) {
   const FilePath test_detail_xml("test_detail.xml");
   EXPECT_FALSE(test_detail_xml.CreateDirectoriesRecursively());
@@ -643,6 +694,13 @@ TEST(FilePathTest, ToString) {
 TEST(FilePathTest, RemoveExtension) {
   EXPECT_STREQ("app", FilePath("app.exe").RemoveExtension("exe").c_str());
   EXPECT_STREQ("APP", FilePath("APP.EXE").RemoveExtension("exe").c_str());
+  EXPECT_STREQ("out", FilePath("out.golden").RemoveExtension("golden").c_str());
+  EXPECT_STREQ("a.b", FilePath("a.b.c").RemoveExtension("C").c_str());
+}
+
+TEST(FilePathTest, RemoveExtensionRequiresTheDot) {
+  EXPECT_STREQ("appexe", FilePath("appexe").RemoveExtension("exe").c_str());
+  EXPECT_STREQ("exe", FilePath("exe").RemoveExtension("exe").c_str());
 }
 
 TEST(FilePathTest, RemoveExtensionWhenThereIsNoExtension) {
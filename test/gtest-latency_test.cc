@@ -0,0 +1,200 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Tests for LatencyRecorder and EXPECT_PERCENTILE_LT().
+
+#include "gtest/gtest-latency.h"
+
+#include "gtest/gtest.h"
+#include "gtest/gtest-spi.h"
+
+namespace {
+
+using testing::LatencyRecorder;
+using testing::LatencyTimer;
+using testing::TestProperty;
+using testing::TestResult;
+using testing::UnitTest;
+
+TEST(LatencyRecorderTest, IsEmptyInitially) {
+  const LatencyRecorder recorder;
+  EXPECT_EQ(0, recorder.count());
+  EXPECT_EQ(0, recorder.min_nanos());
+  EXPECT_EQ(0, recorder.max_nanos());
+  EXPECT_EQ(0.0, recorder.mean_nanos());
+  EXPECT_EQ(0, recorder.PercentileNanos(50));
+  EXPECT_STREQ("", recorder.SerializeHistogram().c_str());
+}
+
+TEST(LatencyRecorderTest, TracksCountMinMaxAndMean) {
+  LatencyRecorder recorder;
+  recorder.RecordNanos(30);
+  recorder.RecordNanos(10);
+  recorder.RecordNanos(20);
+  EXPECT_EQ(3, recorder.count());
+  EXPECT_EQ(10, recorder.min_nanos());
+  EXPECT_EQ(30, recorder.max_nanos());
+  EXPECT_DOUBLE_EQ(20.0, recorder.mean_nanos());
+}
+
+TEST(LatencyRecorderTest, RecordsNegativeLatencyAsZero) {
+  LatencyRecorder recorder;
+  recorder.RecordNanos(-5);
+  EXPECT_EQ(0, recorder.min_nanos());
+  EXPECT_EQ(0, recorder.max_nanos());
+}
+
+// Latencies below 64ns get a bucket each, so their percentiles are exact.
+TEST(LatencyRecorderTest, ComputesExactPercentilesForSmallLatencies) {
+  LatencyRecorder recorder;
+  for (int i = 1; i <= 60; i++)
+    recorder.RecordNanos(i);
+
+  EXPECT_EQ(1, recorder.PercentileNanos(0));
+  EXPECT_EQ(30, recorder.PercentileNanos(50));
+  EXPECT_EQ(54, recorder.PercentileNanos(90));
+  EXPECT_EQ(60, recorder.PercentileNanos(100));
+}
+
+// Larger latencies are kept with a relative error of at most 1/32, and
+// percentiles are never understated.
+TEST(LatencyRecorderTest, KeepsLargeLatenciesWithBoundedRelativeError) {
+  const testing::internal::Int64 kLatencies[] = {
+    100, 1000, 123456, 987654321, 4000000000LL
+  };
+  for (size_t i = 0; i < sizeof(kLatencies)/sizeof(kLatencies[0]); i++) {
+    LatencyRecorder recorder;
+    recorder.RecordNanos(kLatencies[i]);
+    // Records a smaller latency so that the largest one doesn't cap the
+    // percentile.
+    recorder.RecordNanos(kLatencies[i] - kLatencies[i] / 64);
+    const testing::internal::Int64 p50 = recorder.PercentileNanos(50);
+    EXPECT_LE(kLatencies[i] - kLatencies[i] / 64, p50);
+    EXPECT_LE(p50 - (kLatencies[i] - kLatencies[i] / 64), kLatencies[i] / 32)
+        << "for latency " << kLatencies[i];
+  }
+}
+
+TEST(LatencyRecorderTest, MergesOtherRecorder) {
+  LatencyRecorder recorder1;
+  recorder1.RecordNanos(10);
+  LatencyRecorder recorder2;
+  recorder2.RecordNanos(5);
+  recorder2.RecordNanos(1000);
+
+  recorder1.Merge(recorder2);
+  EXPECT_EQ(3, recorder1.count());
+  EXPECT_EQ(5, recorder1.min_nanos());
+  EXPECT_EQ(1000, recorder1.max_nanos());
+  EXPECT_EQ(10, recorder1.PercentileNanos(50));
+
+  // Merging an empty recorder changes nothing.
+  recorder1.Merge(LatencyRecorder());
+  EXPECT_EQ(3, recorder1.count());
+  EXPECT_EQ(5, recorder1.min_nanos());
+}
+
+TEST(LatencyRecorderTest, SerializesNonEmptyBuckets) {
+  LatencyRecorder recorder;
+  recorder.RecordNanos(3);
+  recorder.RecordNanos(3);
+  recorder.RecordNanos(71);
+  EXPECT_STREQ("3:2 70:1", recorder.SerializeHistogram().c_str());
+}
+
+TEST(LatencyRecorderTest, SummarizesDistribution) {
+  LatencyRecorder recorder;
+  recorder.RecordNanos(1500);
+  EXPECT_STREQ("count=1 min=1.5us p50=1.5us p90=1.5us p99=1.5us "
+               "p99.9=1.5us max=1.5us", recorder.Summary().c_str());
+}
+
+TEST(LatencyRecorderTest, RecordsHistogramAsProperties) {
+  LatencyRecorder recorder;
+  recorder.RecordNanos(3);
+  recorder.RecordAsProperties("lookup");
+
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  ASSERT_EQ(2, result->test_property_count());
+  const TestProperty& summary = result->GetTestProperty(0);
+  EXPECT_STREQ("lookup_latency_summary", summary.key());
+  EXPECT_PRED_FORMAT2(testing::IsSubstring, "count=1 ", summary.value());
+  const TestProperty& histogram = result->GetTestProperty(1);
+  EXPECT_STREQ("lookup_latency_histogram", histogram.key());
+  EXPECT_STREQ("3:1", histogram.value());
+}
+
+TEST(LatencyTimerTest, RecordsElapsedTime) {
+  LatencyRecorder recorder;
+  {
+    LatencyTimer timer(&recorder);
+  }
+  EXPECT_EQ(1, recorder.count());
+  EXPECT_LE(0, recorder.min_nanos());
+}
+
+TEST(LatencyRecorderTest, NowNanosIsMonotonic) {
+  const testing::internal::Int64 start = LatencyRecorder::NowNanos();
+  EXPECT_LE(start, LatencyRecorder::NowNanos());
+}
+
+// A recorder whose 99th percentile is 2us, for the assertion tests.
+static LatencyRecorder* MakeRecorder() {
+  static LatencyRecorder* recorder = NULL;
+  if (recorder == NULL) {
+    recorder = new LatencyRecorder;
+    for (int i = 0; i < 99; i++)
+      recorder->RecordNanos(1000);
+    recorder->RecordNanos(2000);
+  }
+  return recorder;
+}
+
+TEST(ExpectPercentileLtTest, SucceedsWhenPercentileIsLower) {
+  EXPECT_PERCENTILE_LT(*MakeRecorder(), 99, 1.5);
+  ASSERT_PERCENTILE_LT(*MakeRecorder(), 100, 2.5);
+}
+
+TEST(ExpectPercentileLtTest, FailsWhenPercentileIsNotLower) {
+  EXPECT_NONFATAL_FAILURE(EXPECT_PERCENTILE_LT(*MakeRecorder(), 100, 2),
+                          "Expected: the 100th percentile of the latencies in "
+                          "*MakeRecorder() is less than 2us\n"
+                          "  Actual: 2.0us\n"
+                          "Latencies: count=100 ");
+  EXPECT_FATAL_FAILURE(ASSERT_PERCENTILE_LT(*MakeRecorder(), 99.9, 1),
+                       "the 99.9th percentile");
+}
+
+TEST(ExpectPercentileLtTest, FailsWhenNothingWasRecorded) {
+  EXPECT_NONFATAL_FAILURE(EXPECT_PERCENTILE_LT(LatencyRecorder(), 50, 1),
+                          "Actual: no latency has been recorded");
+}
+
+}  // namespace
@@ -38,7 +38,12 @@
 namespace {
 
 using testing::Message;
+using testing::StaticAssertTypeEq;
+using testing::internal::Notification;
+using testing::internal::ThreadWithParam;
 using testing::internal::linked_ptr;
+using testing::internal::refcounted_ptr;
+using testing::internal::scoped_ptr;
 
 int num;
 Message* history = NULL;
@@ -152,4 +157,104 @@ TEST_F(LinkedPtrTest, GeneralTest) {
   );
 }
 
+// Counts its live instances.
+class Counted {
+ public:
+  explicit Counted(int* live_count) : live_count_(live_count) {
+    ++*live_count_;
+  }
+  ~Counted() { --*live_count_; }
+
+ private:
+  int* const live_count_;
+};
+
+TEST(RefcountedPtrTest, DefinesElementType) {
+  StaticAssertTypeEq<int, refcounted_ptr<int>::element_type>();
+}
+
+TEST(RefcountedPtrTest, DeletesTheObjectWithTheLastCopy) {
+  int live_count = 0;
+  {
+    refcounted_ptr<Counted> p(new Counted(&live_count));
+    EXPECT_EQ(1, p.use_count());
+    {
+      const refcounted_ptr<Counted> copy(p);
+      EXPECT_EQ(p.get(), copy.get());
+      EXPECT_EQ(2, p.use_count());
+
+      refcounted_ptr<Counted> assigned;
+      EXPECT_TRUE(assigned.get() == NULL);
+      EXPECT_EQ(0, assigned.use_count());
+      assigned = copy;
+      EXPECT_EQ(3, p.use_count());
+    }
+    EXPECT_EQ(1, p.use_count());
+    EXPECT_EQ(1, live_count);
+
+    // Self-assignment keeps the object.
+    p = p;
+    EXPECT_EQ(1, p.use_count());
+    EXPECT_EQ(1, live_count);
+  }
+  EXPECT_EQ(0, live_count);
+}
+
+TEST(RefcountedPtrTest, ResetReleasesTheOldObject) {
+  int live_count = 0;
+  refcounted_ptr<Counted> p(new Counted(&live_count));
+  const refcounted_ptr<Counted> copy(p);
+  p.reset(new Counted(&live_count));
+  EXPECT_EQ(2, live_count);
+  EXPECT_NE(copy.get(), p.get());
+  EXPECT_EQ(1, copy.use_count());
+
+  p.reset();
+  EXPECT_TRUE(p.get() == NULL);
+  EXPECT_EQ(1, live_count);
+}
+
+TEST(RefcountedPtrTest, WorksWithAConstElementType) {
+  refcounted_ptr<const int> p(new int(5));
+  const refcounted_ptr<const int> copy(p);
+  EXPECT_EQ(5, *copy);
+}
+
+#if GTEST_IS_THREADSAFE
+
+// Copies and destroys a shared refcounted_ptr many times.
+void CopyRefcountedPtr(refcounted_ptr<Counted>* p) {
+  for (int i = 0; i < 10000; ++i) {
+    refcounted_ptr<Counted> copy(*p);
+    refcounted_ptr<Counted> assigned;
+    assigned = copy;
+  }
+}
+
+TEST(RefcountedPtrTest, CanBeCopiedInSeveralThreadsAtOnce) {
+  int live_count = 0;
+  refcounted_ptr<Counted> p(new Counted(&live_count));
+  {
+    const int kThreadCount = 7;
+    scoped_ptr<ThreadWithParam<refcounted_ptr<Counted>*> >
+        threads[kThreadCount];
+    Notification threads_can_start;
+    for (int i = 0; i < kThreadCount; ++i) {
+      threads[i].reset(new ThreadWithParam<refcounted_ptr<Counted>*>(
+          &CopyRefcountedPtr, &p, &threads_can_start));
+    }
+    threads_can_start.Notify();
+    for (int i = 0; i < kThreadCount; ++i)
+      threads[i]->Join();
+  }
+
+  // Lost updates would leave the count off.
+  EXPECT_EQ(1, p.use_count());
+  EXPECT_EQ(1, live_count);
+  p.reset();
+  EXPECT_EQ(0, live_count);
+}
+
+#endif  // GTEST_IS_THREADSAFE
+
 }  // Unnamed namespace
@@ -0,0 +1,125 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+// Checks that building short messages out of strings doesn't allocate.
+// The MessageAllocationBenchmark test records the number of allocations
+// per message for a few typical uses, in hundredths, as test properties,
+// which --gtest_output=xml reports.
+
+#include "gtest/gtest-allocations.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using testing::Message;
+using testing::internal::GetHeapAllocationCount;
+using testing::internal::Int64;
+
+TEST(MessageAllocationTest, EmptyMessageDoesNotAllocate) {
+  EXPECT_NO_HEAP_ALLOCATIONS(Message());
+}
+
+TEST(MessageAllocationTest, StreamingShortStringsDoesNotAllocate) {
+  const ::std::string name("foo");
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    Message msg("a = ");
+    msg << name << " " << static_cast<const char*>(NULL);
+  });
+}
+
+TEST(MessageAllocationTest, CopyingShortMessageDoesNotAllocate) {
+  const Message msg1("Hello");
+  EXPECT_NO_HEAP_ALLOCATIONS(const Message msg2(msg1));
+}
+
+// Streaming a value that needs formatting creates the stringstream once.
+TEST(MessageAllocationTest, StreamIsCreatedOnlyOnce) {
+  Message msg;
+  msg << 1;
+  EXPECT_NO_HEAP_ALLOCATIONS(msg << 2 << 3);
+}
+
+// The number of messages built per scenario in the benchmark.
+const int kIterations = 10000;
+
+// Builds kIterations messages using the given function and returns the
+// average number of allocations per message, times 100.
+Int64 HundredthsOfAllocationsPerMessage(void (*build_message)()) {
+  const Int64 start = GetHeapAllocationCount();
+  for (int i = 0; i < kIterations; i++)
+    build_message();
+  return (GetHeapAllocationCount() - start) * 100 / kIterations;
+}
+
+void BuildEmptyMessage() { Message msg; }
+
+void BuildStringMessage() {
+  Message msg;
+  msg << "Expected: " << "true";
+}
+
+void BuildFormattedMessage() {
+  Message msg;
+  msg << "i = " << 42;
+}
+
+void BuildLongMessage() {
+  Message msg;
+  msg << "This message is too long to fit in the inline buffer of Message.";
+}
+
+void BuildAndCopyStringMessage() {
+  const Message msg1("Expected: true");
+  const Message msg2(msg1);
+}
+
+// Records the allocations per message for typical uses of Message.
+TEST(MessageAllocationTest, MessageAllocationBenchmark) {
+  const struct {
+    const char* name;
+    void (*build_message)();
+  } kScenarios[] = {
+    { "empty", &BuildEmptyMessage },
+    { "strings", &BuildStringMessage },
+    { "formatted", &BuildFormattedMessage },
+    { "long", &BuildLongMessage },
+    { "copy", &BuildAndCopyStringMessage },
+  };
+
+  for (size_t i = 0; i < sizeof(kScenarios)/sizeof(kScenarios[0]); i++) {
+    RecordProperty(kScenarios[i].name, static_cast<int>(
+        HundredthsOfAllocationsPerMessage(kScenarios[i].build_message)));
+  }
+}
+
+}  // namespace
@@ -158,9 +158,54 @@ TEST(MessageTest, StreamsToOStream) {
   EXPECT_STREQ("Hello", testing::internal::StringStreamToString(&ss).c_str());
 }
 
+// Tests that text longer than Message's inline buffer is kept intact.
+TEST(MessageTest, StreamsTextLongerThanBuffer) {
+  const ::std::string long_text(200, 'x');
+  Message msg;
+  msg << "a" << long_text << "b";
+  EXPECT_EQ("a" + long_text + "b", ::std::string(msg.GetString().c_str()));
+}
+
+// Tests that strings and formatted values keep their order when the
+// text moves from the inline buffer to the stringstream.
+TEST(MessageTest, StreamsMixedStringsAndValuesInOrder) {
+  EXPECT_STREQ("x = 5, y = 6",
+               ToCString(Message() << "x = " << 5 << ", y = " << 6));
+}
+
+// Tests copying a Message whose text lives in the stringstream.
+TEST(MessageTest, CopyConstructorCopiesStreamedText) {
+  Message msg1;
+  msg1 << "Value: " << 42;
+  const Message msg2(msg1);
+  msg1 << "!";
+  EXPECT_STREQ("Value: 42", ToCString(msg2));
+  EXPECT_STREQ("Value: 42!", ToCString(msg1));
+}
+
+#if GTEST_LANG_CXX11
+// Tests the move constructor.
+TEST(MessageTest, MoveConstructor) {
+  Message msg1;
+  msg1 << "Value: " << 42;
+  const Message msg2(std::move(msg1));
+  EXPECT_STREQ("Value: 42", ToCString(msg2));
+}
+#endif  // GTEST_LANG_CXX11
+
 // Tests that a Message object doesn't take up too much stack space.
 TEST(MessageTest, DoesNotTakeUpMuchStackSpace) {
   EXPECT_LE(sizeof(Message), 16U);
 }
 
+// Tests that the inline buffer doesn't make a Message larger.  The text
+// shares its 16 bytes with the pointer to the stringstream, and the last
+// byte tells them apart, which leaves room for 15 characters.
+TEST(MessageTest, KeepsShortTextInTheSpaceOfTheStreamPointer) {
+  EXPECT_EQ(16U, sizeof(Message));
+  EXPECT_STREQ("fifteen chars!!", ToCString(Message("fifteen chars!!")));
+  EXPECT_STREQ("fifteen chars!!!",
+               ToCString(Message("fifteen chars!!") << "!"));
+}
+
 }  // namespace
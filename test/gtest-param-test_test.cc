@@ -121,6 +121,24 @@ template <typename T1, typename T2, typename T3, typename T4, typename T5,
   return stream.str();
 }
 
+#  if GTEST_HAS_VARIADIC_COMBINE_
+
+template <typename T1, typename T2, typename T3, typename T4, typename T5,
+          typename T6, typename T7, typename T8, typename T9, typename T10,
+          typename T11, typename T12>
+::std::string PrintValue(
+    const tuple<T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12>& value) {
+  ::std::stringstream stream;
+  stream << "(" << get<0>(value) << ", " << get<1>(value)
+         << ", "<< get<2>(value) << ", " << get<3>(value)
+         << ", "<< get<4>(value) << ", " << get<5>(value)
+         << ", "<< get<6>(value) << ", " << get<7>(value)
+         << ", "<< get<8>(value) << ", " << get<9>(value)
+         << ", "<< get<10>(value) << ", " << get<11>(value) << ")";
+  return stream.str();
+}
+
+#  endif  // GTEST_HAS_VARIADIC_COMBINE_
 # endif  // GTEST_HAS_COMBINE
 
 // Verifies that a sequence generated by the generator and accessed
@@ -440,6 +458,24 @@ TEST(ValuesTest, ValuesWorksForMaxLengthList) {
   VerifyGenerator(gen, expected_values);
 }
 
+# if GTEST_LANG_CXX11
+
+// Tests that the variadic Values() is not limited to 50 parameters.
+TEST(ValuesTest, ValuesWorksForMoreThanFiftyParameters) {
+  const ParamGenerator<int> gen = Values(
+      1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20,
+      21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38,
+      39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56,
+      57, 58, 59, 60);
+
+  int expected_values[60];
+  for (int i = 0; i < 60; i++)
+    expected_values[i] = i + 1;
+  VerifyGenerator(gen, expected_values);
+}
+
+# endif  // GTEST_LANG_CXX11
+
 // Edge case test. Tests that single-parameter Values() generates the sequence
 // with the single value.
 TEST(ValuesTest, ValuesWithSingleParameter) {
@@ -542,6 +578,27 @@ TEST(CombineTest, CombineWithMaxNumberOfParameters) {
   VerifyGenerator(gen, expected_values);
 }
 
+#  if GTEST_HAS_VARIADIC_COMBINE_
+
+// Tests that the variadic Combine() is not limited to 10 generators.
+TEST(CombineTest, CombineWithMoreThanTenParameters) {
+  const ParamGenerator<tuple<int, int, int, int, int, int, int, int, int, int,
+                             int, bool> > gen =
+      Combine(Values(1, 2), Values(2), Values(3), Values(4), Values(5),
+              Values(6), Values(7), Values(8), Values(9), Values(10),
+              Values(11), Bool());
+
+  tuple<int, int, int, int, int, int, int, int, int, int, int, bool>
+      expected_values[] = {
+          make_tuple(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, false),
+          make_tuple(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, true),
+          make_tuple(2, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, false),
+          make_tuple(2, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, true)};
+  VerifyGenerator(gen, expected_values);
+}
+
+#  endif  // GTEST_HAS_VARIADIC_COMBINE_
+
 # endif  // GTEST_HAS_COMBINE
 
 // Tests that an generator produces correct sequence after being
@@ -200,6 +200,29 @@ TEST(ScopedPtrTest, DefinesElementType) {
 
 // TODO(vladl@google.com): Implement THE REST of scoped_ptr tests.
 
+TEST(AtomicIncrementTest, ReturnsTheNewValue) {
+  volatile long counter = 0;
+  EXPECT_EQ(1, AtomicIncrement(&counter));
+  EXPECT_EQ(2, AtomicIncrement(&counter));
+  EXPECT_EQ(1, AtomicDecrement(&counter));
+  EXPECT_EQ(0, AtomicDecrement(&counter));
+  EXPECT_EQ(-1, AtomicDecrement(&counter));
+}
+
+TEST(AtomicCompareAndSwapPointerTest, SetsThePointerOnlyIfItMatches) {
+  int a = 1;
+  int b = 2;
+  int* volatile pointer = NULL;
+  EXPECT_TRUE(AtomicCompareAndSwapPointer(
+      &pointer, static_cast<int*>(NULL), &a) == NULL);
+  EXPECT_EQ(&a, AtomicLoadPointer(&pointer));
+  EXPECT_EQ(&a, AtomicCompareAndSwapPointer(
+      &pointer, static_cast<int*>(NULL), &b));
+  EXPECT_EQ(&a, AtomicLoadPointer(&pointer));
+  EXPECT_EQ(&a, AtomicCompareAndSwapPointer(&pointer, &a, &b));
+  EXPECT_EQ(&b, AtomicLoadPointer(&pointer));
+}
+
 TEST(GtestCheckSyntaxTest, BehavesLikeASingleStatement) {
   if (AlwaysFalse())
     GTEST_CHECK_(false) << "This should never be executed; "
@@ -1083,6 +1106,58 @@ TEST(MutexTest, OnlyOneThreadCanLockAtATime) {
   EXPECT_EQ(kCycleCount * kThreadCount, locked_counter.value());
 }
 
+TEST(NotificationTest, WaitReturnsImmediatelyWhenAlreadyNotified) {
+  Notification notification;
+  notification.Notify();
+  notification.WaitForNotification();
+}
+
+// The state shared by the threads in the Barrier tests.
+struct BarrierTestState {
+  explicit BarrierTestState(int thread_count)
+      : barrier(thread_count),
+        arrived_count(0),
+        min_arrived_count_after_wait(thread_count + 1) {}
+
+  Barrier barrier;
+  Mutex mutex;  // Protects the fields below.
+  int arrived_count;  // The number of threads that reached the barrier.
+  // The smallest arrived_count seen by a thread released by the barrier.
+  int min_arrived_count_after_wait;
+};
+
+void WaitOnBarrierTwice(BarrierTestState* state) {
+  {
+    MutexLock lock(&state->mutex);
+    state->arrived_count++;
+  }
+  state->barrier.Wait();
+  {
+    MutexLock lock(&state->mutex);
+    if (state->arrived_count < state->min_arrived_count_after_wait)
+      state->min_arrived_count_after_wait = state->arrived_count;
+  }
+  // Waits again to check that the barrier can be reused.
+  state->barrier.Wait();
+}
+
+TEST(BarrierTest, ReleasesThreadsOnlyAfterAllHaveArrived) {
+  const int kThreadCount = 7;
+  BarrierTestState state(kThreadCount);
+  {
+    scoped_ptr<ThreadWithParam<BarrierTestState*> > threads[kThreadCount];
+    for (int i = 0; i < kThreadCount; ++i) {
+      threads[i].reset(new ThreadWithParam<BarrierTestState*>(
+          &WaitOnBarrierTwice, &state, NULL));
+    }
+    for (int i = 0; i < kThreadCount; ++i)
+      threads[i]->Join();
+  }
+
+  EXPECT_EQ(kThreadCount, state.arrived_count);
+  EXPECT_EQ(kThreadCount, state.min_arrived_count_after_wait);
+}
+
 template <typename T>
 void RunFromThread(void (func)(T), T param) {
   ThreadWithParam<T> thread(func, param, NULL);
@@ -1206,6 +1281,52 @@ TEST(ThreadLocalTest, ThreadLocalMutationsAffectOnlyCurrentThread) {
   EXPECT_TRUE(result.c_str() == NULL);
 }
 
+#if GTEST_HAS_COMPILER_TLS
+
+// Tests that ThreadLocal objects keep working once there are more of them
+// than can be cached in compiler-provided TLS.
+TEST(ThreadLocalTest, WorksWhenThereAreMoreObjectsThanCacheEntries) {
+  const int kCount = kThreadLocalCacheSize + 2;
+  ThreadLocal<int>* thread_locals[kCount];
+  for (int i = 0; i < kCount; i++) {
+    thread_locals[i] = new ThreadLocal<int>(i);
+    thread_locals[i]->set(thread_locals[i]->get() * 2);
+  }
+
+  for (int i = 0; i < kCount; i++) {
+    EXPECT_EQ(i * 2, thread_locals[i]->get());
+    delete thread_locals[i];
+  }
+}
+
+// Tests that the cache index of a dead ThreadLocal is given to the next
+// one, under a new ID.
+TEST(ThreadLocalTest, ReusesCacheIndicesOfDeadObjects) {
+  unsigned int id1 = 0;
+  const int index1 = NewThreadLocalCacheIndex(&id1);
+  ASSERT_LT(index1, kThreadLocalCacheSize);
+  ReleaseThreadLocalCacheIndex(index1);
+
+  unsigned int id2 = 0;
+  const int index2 = NewThreadLocalCacheIndex(&id2);
+  ReleaseThreadLocalCacheIndex(index2);
+  EXPECT_EQ(index1, index2);
+  EXPECT_NE(0U, id1);
+  EXPECT_NE(id1, id2);
+}
+
+// Tests that a ThreadLocal reusing a cache index doesn't see the values
+// of the ThreadLocal that had it before.
+TEST(ThreadLocalTest, DoesNotSeeValuesOfDeadObjectWithTheSameIndex) {
+  for (int i = 0; i < 2 * kThreadLocalCacheSize; i++) {
+    ThreadLocal<int> thread_local_int(i);
+    EXPECT_EQ(i, thread_local_int.get());
+    thread_local_int.set(-1);
+  }
+}
+
+#endif  // GTEST_HAS_COMPILER_TLS
+
 #endif  // GTEST_IS_THREADSAFE
 
 }  // namespace internal
@@ -0,0 +1,147 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// Checks that internal::String, StringPiece and FilePath don't allocate
+// where they shouldn't.  The AssertionFailureAllocationBenchmark test
+// records the number of allocations per failed assertion for a few
+// typical assertions, in hundredths, as test properties, which
+// --gtest_output=xml reports.
+
+#include "gtest/gtest-allocations.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "gtest/gtest-spi.h"
+
+namespace {
+
+using testing::TestPartResultArray;
+using testing::internal::FilePath;
+using testing::internal::GetHeapAllocationCount;
+using testing::internal::Int64;
+using testing::internal::String;
+using testing::internal::StringPiece;
+
+// Longer than what String stores inline.
+const char kLongString[] = "a string that's too long to be stored inline";
+
+TEST(StringAllocationTest, ShortStringDoesNotAllocate) {
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    String str("fifteen chars!!");
+    String copy(str);
+    copy = str;
+    copy = "";
+  });
+}
+
+TEST(StringAllocationTest, LongStringAllocatesOncePerCopy) {
+  const String str(kLongString);
+  EXPECT_ALLOCATIONS_LE(1, String copy(str));
+  String copy;
+  EXPECT_ALLOCATIONS_LE(1, copy = str);
+}
+
+TEST(StringAllocationTest, ShortFormatDoesNotAllocate) {
+  EXPECT_NO_HEAP_ALLOCATIONS(String::Format("%s.%s", "Foo", "Bar"));
+}
+
+#if GTEST_LANG_CXX11
+TEST(StringAllocationTest, MoveDoesNotAllocate) {
+  String str(kLongString);
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    String moved(static_cast<String&&>(str));
+    str = static_cast<String&&>(moved);
+  });
+  EXPECT_STREQ(kLongString, str.c_str());
+}
+#endif  // GTEST_LANG_CXX11
+
+TEST(StringPieceAllocationTest, ViewsDoNotAllocate) {
+  const String str(kLongString);
+  const ::std::string std_str(kLongString);
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    const StringPiece piece(str);
+    const StringPiece std_piece(std_str);
+    const StringPiece c_piece(kLongString);
+    EXPECT_TRUE(piece.StartsWith(std_piece.Prefix(8)));
+    EXPECT_TRUE(c_piece.EndsWith(piece.RemovePrefix(8)));
+  });
+}
+
+TEST(FilePathAllocationTest, ShortPathsDoNotAllocate) {
+  const FilePath path("dir/file.xml");
+  EXPECT_NO_HEAP_ALLOCATIONS({
+    path.RemoveDirectoryName();
+    path.RemoveFileName();
+    path.RemoveExtension("xml");
+    FilePath("dir/").RemoveTrailingPathSeparator();
+  });
+}
+
+// The number of failures made per scenario in the benchmark.
+const int kIterations = 10000;
+
+void FailExpectEq() { EXPECT_EQ(1, 2); }
+void FailExpectTrue() { EXPECT_TRUE(false) << "with a message"; }
+void FailExpectStrEq() { EXPECT_STREQ("expected", "actual"); }
+void FailAddFailure() { ADD_FAILURE() << "failure"; }
+
+// Makes kIterations failures using the given function, and returns the
+// average number of allocations per failure, times 100.  The failures
+// are recorded in a TestPartResultArray, so each one is copied once
+// just like Google Test copies it into the TestResult.
+Int64 HundredthsOfAllocationsPerFailure(void (*fail)()) {
+  TestPartResultArray results;
+  testing::ScopedFakeTestPartResultReporter reporter(&results);
+  const Int64 start = GetHeapAllocationCount();
+  for (int i = 0; i < kIterations; i++)
+    fail();
+  return (GetHeapAllocationCount() - start) * 100 / kIterations;
+}
+
+// Records the allocations per failure for typical failed assertions.
+TEST(AssertionFailureAllocationBenchmark, AllocationsPerFailure) {
+  const struct {
+    const char* name;
+    void (*fail)();
+  } kScenarios[] = {
+    { "expect_eq", &FailExpectEq },
+    { "expect_true", &FailExpectTrue },
+    { "expect_streq", &FailExpectStrEq },
+    { "add_failure", &FailAddFailure },
+  };
+
+  for (size_t i = 0; i < sizeof(kScenarios)/sizeof(kScenarios[0]); i++) {
+    RecordProperty(kScenarios[i].name, static_cast<int>(
+        HundredthsOfAllocationsPerFailure(kScenarios[i].fail)));
+  }
+}
+
+}  // namespace
@@ -165,6 +165,70 @@ TYPED_TEST(NumericTest, DefaultIsZero) {
 
 }  // namespace library1
 
+# if GTEST_LANG_CXX11
+
+// Tests that with variadic templates Types<...> is not limited to 50
+// types.
+
+template <int N>
+struct IntConstant {
+  enum { value = N };
+};
+
+typedef Types<
+    IntConstant<1>, IntConstant<2>, IntConstant<3>, IntConstant<4>,
+    IntConstant<5>, IntConstant<6>, IntConstant<7>, IntConstant<8>,
+    IntConstant<9>, IntConstant<10>, IntConstant<11>, IntConstant<12>,
+    IntConstant<13>, IntConstant<14>, IntConstant<15>, IntConstant<16>,
+    IntConstant<17>, IntConstant<18>, IntConstant<19>, IntConstant<20>,
+    IntConstant<21>, IntConstant<22>, IntConstant<23>, IntConstant<24>,
+    IntConstant<25>, IntConstant<26>, IntConstant<27>, IntConstant<28>,
+    IntConstant<29>, IntConstant<30>, IntConstant<31>, IntConstant<32>,
+    IntConstant<33>, IntConstant<34>, IntConstant<35>, IntConstant<36>,
+    IntConstant<37>, IntConstant<38>, IntConstant<39>, IntConstant<40>,
+    IntConstant<41>, IntConstant<42>, IntConstant<43>, IntConstant<44>,
+    IntConstant<45>, IntConstant<46>, IntConstant<47>, IntConstant<48>,
+    IntConstant<49>, IntConstant<50>, IntConstant<51>, IntConstant<52>,
+    IntConstant<53>, IntConstant<54>, IntConstant<55>, IntConstant<56>,
+    IntConstant<57>, IntConstant<58>, IntConstant<59>, IntConstant<60> >
+    SixtyTypes;
+
+template <typename T>
+class ManyTypesTest : public Test {
+ public:
+  static int test_count_;
+};
+
+template <typename T>
+int ManyTypesTest<T>::test_count_ = 0;
+
+TYPED_TEST_CASE(ManyTypesTest, SixtyTypes);
+
+TYPED_TEST(ManyTypesTest, IsInstantiatedForEveryType) {
+  const int value = TypeParam::value;
+  EXPECT_GE(value, 1);
+  EXPECT_LE(value, 60);
+  EXPECT_EQ(0, TestFixture::test_count_++);
+}
+
+TEST(ManyTypesTest, RegistersOneTestCasePerType) {
+  const testing::UnitTest* const unit_test = testing::UnitTest::GetInstance();
+  const testing::TestCase* last_test_case = NULL;
+  int test_cases = 0;
+  for (int i = 0; i < unit_test->total_test_case_count(); i++) {
+    const testing::TestCase* test_case = unit_test->GetTestCase(i);
+    if (strncmp(test_case->name(), "ManyTypesTest/", 14) == 0) {
+      test_cases++;
+      last_test_case = test_case;
+    }
+  }
+  EXPECT_EQ(60, test_cases);
+  ASSERT_TRUE(last_test_case != NULL);
+  EXPECT_STREQ("ManyTypesTest/59", last_test_case->name());
+}
+
+# endif  // GTEST_LANG_CXX11
+
 #endif  // GTEST_HAS_TYPED_TEST
 
 // This #ifdef block tests type-parameterized tests.
@@ -86,11 +86,15 @@ class GTestEnvVarTest(gtest_test_utils.TestCase):
 
     TestFlag('break_on_failure', '1', '0')
     TestFlag('color', 'yes', 'auto')
+    TestFlag('fail_on_leak_bytes', '4096', '-1')
     TestFlag('filter', 'FooTest.Bar', '*')
+    TestFlag('max_failures_per_test', '10', '100')
     TestFlag('output', 'xml:tmp/foo.xml', '')
     TestFlag('print_time', '0', '1')
     TestFlag('repeat', '999', '1')
+    TestFlag('startup_profile', '1', '0')
     TestFlag('throw_on_failure', '1', '0')
+    TestFlag('update_golden_files', '1', '0')
     TestFlag('death_test_style', 'threadsafe', 'fast')
     TestFlag('catch_exceptions', '0', '1')
 
@@ -81,6 +81,16 @@ void PrintFlag(const char* flag) {
     return;
   }
 
+  if (strcmp(flag, "fail_on_leak_bytes") == 0) {
+    cout << GTEST_FLAG(fail_on_leak_bytes);
+    return;
+  }
+
+  if (strcmp(flag, "max_failures_per_test") == 0) {
+    cout << GTEST_FLAG(max_failures_per_test);
+    return;
+  }
+
   if (strcmp(flag, "output") == 0) {
     cout << GTEST_FLAG(output);
     return;
@@ -101,11 +111,21 @@ void PrintFlag(const char* flag) {
     return;
   }
 
+  if (strcmp(flag, "startup_profile") == 0) {
+    cout << GTEST_FLAG(startup_profile);
+    return;
+  }
+
   if (strcmp(flag, "throw_on_failure") == 0) {
     cout << GTEST_FLAG(throw_on_failure);
     return;
   }
 
+  if (strcmp(flag, "update_golden_files") == 0) {
+    cout << GTEST_FLAG(update_golden_files);
+    return;
+  }
+
   cout << "Invalid flag name " << flag
        << ".  Valid names are break_on_failure, color, filter, etc.\n";
   exit(1);
@@ -0,0 +1,118 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// The Google C++ Testing Framework (Google Test)
+//
+// Tests --gtest_fail_on_leak_bytes: a test that leaks must fail, while
+// a test that frees what it allocates must pass, however much Google
+// Test itself allocates to record its results.  The heap usage is
+// measured by the heap profiler gtest_allocations installs.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+char* g_leaked_block = NULL;
+
+TEST(FailOnLeakTest, LeaksABlock) {
+  g_leaked_block = new char[1000];
+}
+
+TEST(FailOnLeakTest, FreesEverything) {
+  delete[] new char[1000];
+}
+
+TEST(FailOnLeakTest, RecordsProperties) {
+  RecordProperty("first_key", std::string(1000, 'x').c_str());
+  RecordProperty("second_key", 42);
+}
+
+TEST(FailOnLeakTest, HasAFailure) {
+  ADD_FAILURE() << "Expected failure with a long message: "
+                << std::string(1000, 'x');
+}
+
+// Returns the result of the given test of FailOnLeakTest.
+const testing::TestResult& ResultOf(const char* test_name) {
+  const testing::TestCase* const test_case =
+      testing::UnitTest::GetInstance()->GetTestCase(0);
+  for (int i = 0; i < test_case->total_test_count(); ++i) {
+    const testing::TestInfo* const test_info = test_case->GetTestInfo(i);
+    if (strcmp(test_info->name(), test_name) == 0)
+      return *test_info->result();
+  }
+  printf("Test %s not found.\n", test_name);
+  exit(1);
+}
+
+// Verifies that the given test has the given number of failures, and
+// prints a message and exits the program if it doesn't.
+void CheckFailureCount(const char* test_name, int expected_count) {
+  const testing::TestResult& result = ResultOf(test_name);
+  if (result.total_part_count() != expected_count) {
+    printf("FailOnLeakTest.%s has %d failure(s); expected %d.\n",
+           test_name, result.total_part_count(), expected_count);
+    exit(1);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  testing::GTEST_FLAG(fail_on_leak_bytes) = 0;
+
+  if (RUN_ALL_TESTS() == 0) {
+    printf("RUN_ALL_TESTS() should fail, as a test leaks.\n");
+    return 1;
+  }
+
+  CheckFailureCount("LeaksABlock", 1);
+  const testing::TestResult& leaking = ResultOf("LeaksABlock");
+  if (leaking.heap_growth_bytes() != 1000 ||
+      strstr(leaking.GetTestPartResult(0).message(),
+             "The heap grew by 1000 bytes") == NULL) {
+    printf("FailOnLeakTest.LeaksABlock should fail for 1000 leaked bytes.\n");
+    return 1;
+  }
+  delete[] g_leaked_block;
+
+  // Google Test's own allocations aren't leaks of the test.
+  CheckFailureCount("FreesEverything", 0);
+  CheckFailureCount("RecordsProperties", 0);
+  CheckFailureCount("HasAFailure", 1);
+
+  printf("PASS\n");
+  return 0;
+}
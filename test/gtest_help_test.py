@@ -71,10 +71,14 @@ HELP_REGEX = re.compile(
     FLAG_PREFIX + r'random_seed=.*' +
     FLAG_PREFIX + r'color=.*' +
     FLAG_PREFIX + r'print_time.*' +
+    FLAG_PREFIX + r'startup_profile.*' +
     FLAG_PREFIX + r'output=.*' +
     FLAG_PREFIX + r'break_on_failure.*' +
     FLAG_PREFIX + r'throw_on_failure.*' +
-    FLAG_PREFIX + r'catch_exceptions=0.*',
+    FLAG_PREFIX + r'catch_exceptions=0.*' +
+    FLAG_PREFIX + r'max_failures_per_test=.*' +
+    FLAG_PREFIX + r'fail_on_leak_bytes=.*' +
+    FLAG_PREFIX + r'update_golden_files.*',
     re.DOTALL)
 
 
@@ -0,0 +1,145 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Measures how much heap memory Google Test itself uses per registered
+// test: registering a large number of synthetic value-parameterized
+// tests, and running them.  It must be linked with gtest_allocations,
+// whose heap profiler counts the bytes requested from operator new
+// (not including the allocator's own per-block overhead, which the
+// allocation counts give an idea of).
+//
+// Usage: gtest_memory_benchmark_ [NUMBER_OF_TESTS]
+//
+// The results are printed to stdout as comma-separated values, one
+// metric per line after a header line, so that they can be collected
+// and compared across revisions.
+
+#include "gtest/gtest.h"
+#include "gtest/gtest-allocations.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+namespace testing {
+namespace {
+
+using internal::GetHeapProfiler;
+using internal::HeapUsage;
+using internal::Int64;
+using internal::StreamableToString;
+using internal::String;
+
+// How many synthetic tests go into each synthetic test case.
+const int kTestsPerTestCase = 1000;
+
+// The test body every synthetic test shares.
+class EmptyTest : public Test {
+ protected:
+  virtual void TestBody() {}
+};
+
+HeapUsage GetHeapUsage() {
+  return GetHeapProfiler()->GetHeapUsage();
+}
+
+// Prints one result line for the heap usage between before and after.
+void PrintMetric(const char* metric, int tests, const HeapUsage& before,
+                 const HeapUsage& after) {
+  const Int64 bytes = after.live_bytes - before.live_bytes;
+  const Int64 allocations = after.allocation_count - before.allocation_count;
+  printf("%s,%d,%s,%.1f,%.2f\n", metric, tests,
+         StreamableToString(bytes).c_str(),
+         static_cast<double>(bytes) / tests,
+         static_cast<double>(allocations) / tests);
+  fflush(stdout);
+}
+
+// Registers test_count tests the way INSTANTIATE_TEST_CASE_P() does,
+// kTestsPerTestCase to a test case, and reports the heap memory the
+// registered tests take.  Like the tests INSTANTIATE_TEST_CASE_P()
+// creates, the tests in each test case are named Test/0, Test/1, and so
+// on.  Building the names isn't measured.
+void RunMemoryBenchmark(int test_count) {
+  std::vector<std::string> test_case_names;
+  std::vector<std::string> test_names;
+  std::vector<std::string> value_params;
+  for (int i = 0; i < test_count; i++) {
+    if (i % kTestsPerTestCase == 0) {
+      test_case_names.push_back(String::Format(
+          "Instantiation/SyntheticTest%d", i / kTestsPerTestCase).c_str());
+    }
+    if (i < kTestsPerTestCase) {
+      test_names.push_back(String::Format("Test/%d", i).c_str());
+      value_params.push_back(String::Format("%d", i).c_str());
+    }
+  }
+
+  // The console output would dominate the run, so it goes without it.
+  TestEventListeners& listeners = UnitTest::GetInstance()->listeners();
+  delete listeners.Release(listeners.default_result_printer());
+
+  printf("metric,tests,total_bytes,bytes_per_test,allocations_per_test\n");
+  const HeapUsage before = GetHeapUsage();
+  for (int i = 0; i < test_count; i++) {
+    internal::MakeAndRegisterTestInfo(
+        test_case_names[i / kTestsPerTestCase].c_str(),
+        test_names[i % kTestsPerTestCase].c_str(), NULL,
+        value_params[i % kTestsPerTestCase].c_str(),
+        internal::GetTestTypeId(),
+        Test::SetUpTestCase, Test::TearDownTestCase,
+        new internal::TestFactoryImpl<EmptyTest>);
+  }
+  const HeapUsage registered = GetHeapUsage();
+  PrintMetric("registered", test_count, before, registered);
+
+  GTEST_CHECK_(RUN_ALL_TESTS() == 0) << "A synthetic test failed.";
+  PrintMetric("after_run", test_count, before, GetHeapUsage());
+}
+
+}  // namespace
+}  // namespace testing
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  const int test_count = argc > 1 ? atoi(argv[1]) : 1000;
+  if (test_count <= 0) {
+    fprintf(stderr, "Usage: %s [NUMBER_OF_TESTS]\n", argv[0]);
+    return 1;
+  }
+  if (testing::internal::GetHeapProfiler() == NULL) {
+    fprintf(stderr, "%s must be linked with gtest_allocations.\n", argv[0]);
+    return 1;
+  }
+
+  testing::RunMemoryBenchmark(test_count);
+  return 0;
+}
@@ -0,0 +1,384 @@
+// Copyright 2013, Google Inc.
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Measures the overhead of Google Test itself: registering, filtering
+// and running a large number of empty tests, passing and failing
+// assertions, SCOPED_TRACE(), converting wide strings to UTF-8, the XML
+// and streaming result printers, and copying shared pointers (such as
+// the one inside a ParamGenerator) in several threads at once.
+//
+// Usage: gtest_overhead_benchmark_ [NUMBER_OF_TESTS]
+//
+// The results are printed to stdout as comma-separated values, one
+// metric per line after a header line, so that they can be collected
+// and compared across revisions.
+
+#include "gtest/gtest.h"
+#include "gtest/gtest-spi.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+# include <arpa/inet.h>
+# include <netinet/in.h>
+# include <sys/socket.h>
+# include <unistd.h>
+#endif  // GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+
+// We must define this macro in order to #include
+// gtest-internal-inl.h.  This is how Google Test prevents a user from
+// accidentally depending on its internal implementation.
+#define GTEST_IMPLEMENTATION_ 1
+#include "src/gtest-internal-inl.h"
+#undef GTEST_IMPLEMENTATION_
+
+namespace testing {
+namespace {
+
+using internal::GetUnitTestImpl;
+using internal::Int64;
+using internal::StreamableToString;
+using internal::String;
+using internal::UnitTestImpl;
+
+// How many synthetic tests go into each synthetic test case.
+const int kTestsPerTestCase = 1000;
+
+// The workloads below run at full scale with at least this many tests,
+// and are scaled down in proportion with fewer, so that a smoke run with
+// a handful of tests is quick.
+const int kFullScaleTestCount = 1000;
+
+// How many times the assertion and SCOPED_TRACE() loops run at full
+// scale.
+const int kPassingAssertionIterations = 10000000;
+const int kFailingAssertionIterations = 100000;
+const int kScopedTraceIterations = 1000000;
+
+// How long the wide strings converted to UTF-8 are at full scale, and
+// how many times they are converted.
+const int kWideStringLength = 1000000;
+const int kWideStringIterations = 20;
+
+// How many threads copy a shared pointer at once, and how many copies
+// each makes at full scale.
+const int kCopyThreads = 4;
+const int kCopiesPerThread = 1000000;
+
+// The test body every synthetic test shares.
+class EmptyTest : public Test {
+ protected:
+  virtual void TestBody() {}
+};
+
+// Prints one result line.
+void PrintMetric(const char* metric, int tests, int iterations,
+                 Int64 total_nanos) {
+  printf("%s,%d,%d,%s,%.3f\n", metric, tests, iterations,
+         StreamableToString(total_nanos).c_str(),
+         static_cast<double>(total_nanos) / (iterations > 0 ? iterations : 1));
+  fflush(stdout);
+}
+
+// Returns full_count scaled down for a run with test_count tests.
+int Scaled(int full_count, int test_count) {
+  if (test_count >= kFullScaleTestCount)
+    return full_count;
+  const Int64 count =
+      static_cast<Int64>(full_count) * test_count / kFullScaleTestCount;
+  return count > 0 ? static_cast<int>(count) : 1;
+}
+
+// Registers test_count empty tests, kTestsPerTestCase to a test case.
+// Only the registration itself is timed, not building the names.
+Int64 RegisterSyntheticTests(int test_count) {
+  std::vector<std::string> test_case_names;
+  std::vector<std::string> test_names;
+  for (int i = 0; i < test_count; i++) {
+    if (i % kTestsPerTestCase == 0) {
+      test_case_names.push_back(
+          String::Format("Synthetic%d", i / kTestsPerTestCase).c_str());
+    }
+    test_names.push_back(String::Format("Test%d", i).c_str());
+  }
+
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < test_count; i++) {
+    internal::MakeAndRegisterTestInfo(
+        test_case_names[i / kTestsPerTestCase].c_str(),
+        test_names[i].c_str(), NULL, NULL, internal::GetTestTypeId(),
+        Test::SetUpTestCase, Test::TearDownTestCase,
+        new internal::TestFactoryImpl<EmptyTest>);
+  }
+  return LatencyRecorder::NowNanos() - start;
+}
+
+// Times FilterTests() with a filter that has both positive and
+// negative patterns, then restores the default filter.
+Int64 TimeFilterTests() {
+  const String saved_filter = GTEST_FLAG(filter);
+  GTEST_FLAG(filter) = "Synthetic*.Test*7*:Synthetic1*.*-*.Test*77*";
+  const Int64 start = LatencyRecorder::NowNanos();
+  GetUnitTestImpl()->FilterTests(UnitTestImpl::IGNORE_SHARDING_PROTOCOL);
+  const Int64 elapsed = LatencyRecorder::NowNanos() - start;
+  GTEST_FLAG(filter) = saved_filter;
+  return elapsed;
+}
+
+// Times one RUN_ALL_TESTS() over all synthetic tests.
+Int64 TimeRunAllTests() {
+  const Int64 start = LatencyRecorder::NowNanos();
+  GTEST_CHECK_(RUN_ALL_TESTS() == 0) << "A synthetic test failed.";
+  return LatencyRecorder::NowNanos() - start;
+}
+
+Int64 TimePassingAssertions(int iterations) {
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < iterations; i++) {
+    EXPECT_EQ(i, i);
+  }
+  return LatencyRecorder::NowNanos() - start;
+}
+
+// The failures are intercepted, so they neither print nor fail the
+// program.
+Int64 TimeFailingAssertions(int iterations) {
+  TestPartResultArray failures;
+  ScopedFakeTestPartResultReporter reporter(
+      ScopedFakeTestPartResultReporter::INTERCEPT_ONLY_CURRENT_THREAD,
+      &failures);
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < iterations; i++) {
+    EXPECT_EQ(i, i + 1);
+  }
+  return LatencyRecorder::NowNanos() - start;
+}
+
+Int64 TimeScopedTraces(int iterations) {
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < iterations; i++) {
+    SCOPED_TRACE("benchmark");
+  }
+  return LatencyRecorder::NowNanos() - start;
+}
+
+// Times converting a wide string of the given length to UTF-8,
+// kWideStringIterations times, the way {ASSERT|EXPECT}_STREQ print wide
+// strings.  Every non_ascii_period-th character is a non-ASCII one (0
+// for none).
+Int64 TimeWideStringToUtf8(int length, int non_ascii_period) {
+  std::vector<wchar_t> wide(length + 1);
+  for (int i = 0; i < length; i++) {
+    wide[i] = static_cast<wchar_t>(
+        non_ascii_period != 0 && i % non_ascii_period == 0 ?
+        0x4E00 + i % 0x5000 : 'a' + i % 26);
+  }
+  wide[length] = L'\0';
+
+  size_t total_length = 0;
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < kWideStringIterations; i++) {
+    total_length += String::ShowWideCString(&wide[0]).length();
+  }
+  const Int64 elapsed = LatencyRecorder::NowNanos() - start;
+  GTEST_CHECK_(total_length >= static_cast<size_t>(length));
+  return elapsed;
+}
+
+#if GTEST_IS_THREADSAFE
+
+// What the copying threads share.
+template <typename Pointer>
+struct CopyState {
+  CopyState(const Pointer& a_pointer, int a_copies_per_thread)
+      : pointer(a_pointer),
+        copies_per_thread(a_copies_per_thread),
+        barrier(kCopyThreads + 1) {}
+
+  const Pointer pointer;
+  const int copies_per_thread;
+  // Releases the threads and the timer together.
+  internal::Barrier barrier;
+};
+
+template <typename Pointer>
+void CopyPointer(CopyState<Pointer>* state) {
+  state->barrier.Wait();
+  for (int i = 0; i < state->copies_per_thread; i++) {
+    const Pointer copy(state->pointer);
+  }
+}
+
+// Times kCopyThreads threads copying and destroying the same pointer
+// copies_per_thread times each.
+template <typename Pointer>
+Int64 TimeConcurrentCopies(const Pointer& pointer, int copies_per_thread) {
+  typedef internal::ThreadWithParam<CopyState<Pointer>*> CopyThread;
+  CopyState<Pointer> state(pointer, copies_per_thread);
+  internal::scoped_ptr<CopyThread> threads[kCopyThreads];
+  for (int i = 0; i < kCopyThreads; i++)
+    threads[i].reset(new CopyThread(&CopyPointer<Pointer>, &state, NULL));
+
+  state.barrier.Wait();
+  const Int64 start = LatencyRecorder::NowNanos();
+  for (int i = 0; i < kCopyThreads; i++)
+    threads[i]->Join();
+  return LatencyRecorder::NowNanos() - start;
+}
+
+#endif  // GTEST_IS_THREADSAFE
+
+#if GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+
+// Accepts one connection on listen_fd and discards everything sent
+// over it until the sender closes it.
+void DiscardStreamedResults(int listen_fd) {
+  const int fd = accept(listen_fd, NULL, NULL);
+  GTEST_CHECK_(fd != -1) << "accept() failed.";
+  char buffer[4096];
+  while (read(fd, buffer, sizeof(buffer)) > 0) {}
+  close(fd);
+}
+
+// Listens on an ephemeral loopback port and returns the socket.
+// Stores the port number in *port.
+int ListenOnLoopback(int* port) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  GTEST_CHECK_(fd != -1) << "socket() failed.";
+  sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t length = sizeof(address);
+  GTEST_CHECK_(
+      bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0 &&
+      listen(fd, 1) == 0 &&
+      getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) == 0)
+      << "Cannot listen on the loopback interface.";
+  *port = ntohs(address.sin_port);
+  return fd;
+}
+
+#endif  // GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+
+// Runs all the measurements with test_count synthetic tests.
+void RunOverheadBenchmark(int test_count) {
+  printf("metric,tests,iterations,total_ns,ns_per_iteration\n");
+  PrintMetric("registration", test_count, test_count,
+              RegisterSyntheticTests(test_count));
+  PrintMetric("filter", test_count, test_count, TimeFilterTests());
+
+  // The console output would dominate everything else, so the runs
+  // below go without it.
+  TestEventListeners& listeners = UnitTest::GetInstance()->listeners();
+  delete listeners.Release(listeners.default_result_printer());
+
+  const Int64 run_nanos = TimeRunAllTests();
+  PrintMetric("empty_test_run", test_count, test_count, run_nanos);
+
+  const int passing_assertions =
+      Scaled(kPassingAssertionIterations, test_count);
+  PrintMetric("passing_assertion", test_count, passing_assertions,
+              TimePassingAssertions(passing_assertions));
+  const int failing_assertions =
+      Scaled(kFailingAssertionIterations, test_count);
+  PrintMetric("failing_assertion", test_count, failing_assertions,
+              TimeFailingAssertions(failing_assertions));
+  const int scoped_traces = Scaled(kScopedTraceIterations, test_count);
+  PrintMetric("scoped_trace", test_count, scoped_traces,
+              TimeScopedTraces(scoped_traces));
+
+  // Per wide character converted.
+  const int wide_length = Scaled(kWideStringLength, test_count);
+  const int wide_chars = wide_length * kWideStringIterations;
+  PrintMetric("wide_string_to_utf8_ascii", test_count, wide_chars,
+              TimeWideStringToUtf8(wide_length, 0));
+  PrintMetric("wide_string_to_utf8_mixed", test_count, wide_chars,
+              TimeWideStringToUtf8(wide_length, 8));
+  PrintMetric("wide_string_to_utf8_cjk", test_count, wide_chars,
+              TimeWideStringToUtf8(wide_length, 1));
+
+#if GTEST_IS_THREADSAFE
+  // Per copy, across all threads.
+  const int copies_per_thread = Scaled(kCopiesPerThread, test_count);
+  const int copies = kCopyThreads * copies_per_thread;
+  PrintMetric("linked_ptr_concurrent_copy", test_count, copies,
+              TimeConcurrentCopies(internal::linked_ptr<int>(new int(0)),
+                                   copies_per_thread));
+# if GTEST_HAS_PARAM_TEST
+  PrintMetric("param_generator_concurrent_copy", test_count, copies,
+              TimeConcurrentCopies(Range(0, 10), copies_per_thread));
+# endif  // GTEST_HAS_PARAM_TEST
+#endif  // GTEST_IS_THREADSAFE
+
+  // The output metrics are what a run with the printer costs on top of
+  // the run without it.
+  const char* const xml_file = "gtest_overhead_benchmark.xml";
+  GTEST_FLAG(output) = std::string("xml:") + xml_file;
+  GetUnitTestImpl()->ConfigureXmlOutput();
+  PrintMetric("xml_output", test_count, test_count,
+              TimeRunAllTests() - run_nanos);
+  delete listeners.Release(listeners.default_xml_generator());
+  GTEST_FLAG(output) = "";
+  remove(xml_file);
+
+#if GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+  int port = 0;
+  const int listen_fd = ListenOnLoopback(&port);
+  internal::ThreadWithParam<int> sink(&DiscardStreamedResults, listen_fd, NULL);
+  GTEST_FLAG(stream_result_to) =
+      String::Format("127.0.0.1:%d", port).c_str();
+  GetUnitTestImpl()->ConfigureStreamingOutput();
+  PrintMetric("stream_output", test_count, test_count,
+              TimeRunAllTests() - run_nanos);
+  sink.Join();
+  close(listen_fd);
+#endif  // GTEST_CAN_STREAM_RESULTS_ && GTEST_IS_THREADSAFE
+}
+
+}  // namespace
+}  // namespace testing
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+
+  const int test_count = argc > 1 ? atoi(argv[1]) : 1000;
+  if (test_count <= 0) {
+    fprintf(stderr, "Usage: %s [NUMBER_OF_TESTS]\n", argv[0]);
+    return 1;
+  }
+
+  testing::RunOverheadBenchmark(test_count);
+  return 0;
+}
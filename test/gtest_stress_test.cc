@@ -34,7 +34,9 @@
 
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 // We must define this macro in order to #include
@@ -116,10 +118,19 @@ void ManyAsserts(int id) {
 }
 
 void CheckTestFailureCount(int expected_failures) {
+  // Failures reported by other threads only reach the TestResult when
+  // they are merged, which otherwise happens at the end of the test.
+  internal::GetUnitTestImpl()->MergeTestPartResultsFromOtherThreads();
+
+  // Identical failures beyond --gtest_max_failures_per_test are counted
+  // as repeats rather than recorded.
   const TestInfo* const info = UnitTest::GetInstance()->current_test_info();
   const TestResult* const result = info->result();
-  GTEST_CHECK_(expected_failures == result->total_part_count())
-      << "Logged " << result->total_part_count() << " failures "
+  int failures = result->total_part_count() + result->omitted_failure_count();
+  for (int i = 0; i < result->total_part_count(); i++)
+    failures += result->GetTestPartRepeatCount(i);
+  GTEST_CHECK_(expected_failures == failures)
+      << "Logged " << failures << " failures "
       << " vs. " << expected_failures << " expected";
 }
 
@@ -161,6 +172,215 @@ TEST(StressTest, CanUseScopedTraceAndAssertionsInManyThreads) {
   CheckTestFailureCount(kThreadCount*kThreadCount);
 }
 
+// How many iterations each thread runs in the throughput benchmark.
+const int kBenchmarkIterations = 10000;
+
+// Runs passing assertions inside a scoped trace, the pattern of a hot
+// property-test loop.  Each iteration pushes and pops the per-thread
+// trace stack, so its cost is dominated by ThreadLocal access.
+class PassingAssertsBody : public StressTestBody {
+ public:
+  virtual void Run(int thread_index, int iteration) {
+    SCOPED_TRACE_LAZY(iteration);
+    EXPECT_EQ(iteration, iteration);
+    ASSERT_LE(0, thread_index);
+  }
+};
+
+// How many times the throughput benchmark is run.  The median run is
+// reported, as thread start-up makes single runs noisy.
+const int kBenchmarkRepetitions = 5;
+
+// Measures the throughput of assertions made from many threads at once,
+// and records the median of kBenchmarkRepetitions runs as the
+// assertions_per_ms property.
+TEST(StressTest, AssertionThroughputInManyThreads) {
+  PassingAssertsBody body;
+  std::vector<internal::TimeInMillis> elapsed_times;
+  for (int i = 0; i < kBenchmarkRepetitions; i++) {
+    const internal::TimeInMillis start = internal::GetTimeInMillis();
+    RunStressTest(kThreadCount, kBenchmarkIterations, &body);
+    elapsed_times.push_back(internal::GetTimeInMillis() - start);
+  }
+  std::sort(elapsed_times.begin(), elapsed_times.end());
+  const internal::TimeInMillis elapsed =
+      elapsed_times[kBenchmarkRepetitions / 2];
+
+  // Each iteration makes two assertions.
+  const internal::TimeInMillis assertions =
+      static_cast<internal::TimeInMillis>(kThreadCount) *
+      kBenchmarkIterations * 2;
+  const int assertions_per_ms = static_cast<int>(
+      assertions / (elapsed > 0 ? elapsed : 1));
+  printf("%d threads made %d assertions in %d ms (%d assertions/ms, "
+         "median of %d runs)\n",
+         kThreadCount, static_cast<int>(assertions),
+         static_cast<int>(elapsed), assertions_per_ms,
+         kBenchmarkRepetitions);
+  RecordProperty("assertions_per_ms", assertions_per_ms);
+  CheckTestFailureCount(0);
+}
+
+// Counts the iterations run by RunStressTest().
+class CountingBody : public StressTestBody {
+ public:
+  CountingBody() : count_(0) {}
+
+  virtual void Run(int /* thread_index */, int /* iteration */) {
+    internal::MutexLock lock(&mutex_);
+    count_++;
+  }
+
+  int count() const { return count_; }
+
+ private:
+  internal::Mutex mutex_;
+  int count_;
+};
+
+TEST(RunStressTestTest, RunsAllIterationsOnAllThreads) {
+  CountingBody body;
+  const std::vector<StressTestThreadResult> results =
+      RunStressTest(4, 100, &body);
+
+  GTEST_CHECK_(body.count() == 4 * 100) << "Ran " << body.count();
+  GTEST_CHECK_(results.size() == 4) << "Got " << results.size();
+  for (int i = 0; i < 4; i++) {
+    GTEST_CHECK_(results[i].iteration_count == 100);
+    GTEST_CHECK_(results[i].failure_count == 0);
+    // Timed in nanoseconds, so even a short run takes a measurable time.
+    GTEST_CHECK_(results[i].elapsed_time_nanos > 0);
+  }
+
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  GTEST_CHECK_(result->test_property_count() == 4);
+  GTEST_CHECK_(String(result->GetTestProperty(3).key()) == "stress_thread_3");
+  const String value = result->GetTestProperty(3).value();
+  GTEST_CHECK_(strstr(value.c_str(), "100 iterations in ") == value.c_str() &&
+               value.EndsWith(" ms, 0 failures")) << value;
+  CheckTestFailureCount(0);
+}
+
+// Fails in iteration 2 of thread 1, fatally if is_fatal_ is true.
+class FailingOnceBody : public StressTestBody {
+ public:
+  explicit FailingOnceBody(bool is_fatal) : is_fatal_(is_fatal) {}
+
+  virtual void Run(int thread_index, int iteration) {
+    const bool should_fail = thread_index == 1 && iteration == 2;
+    if (is_fatal_) {
+      ASSERT_FALSE(should_fail) << "Expected fatal failure.";
+    } else {
+      EXPECT_FALSE(should_fail) << "Expected non-fatal failure.";
+    }
+  }
+
+ private:
+  const bool is_fatal_;
+};
+
+TEST(RunStressTestTest, AttributesFailuresToThreads) {
+  FailingOnceBody body(false);
+  const std::vector<StressTestThreadResult> results =
+      RunStressTest(3, 5, &body);
+
+  for (int i = 0; i < 3; i++) {
+    GTEST_CHECK_(results[i].iteration_count == 5);
+    GTEST_CHECK_(results[i].failure_count == (i == 1 ? 1 : 0));
+  }
+
+  // The failure is added to the test as soon as RunStressTest() returns.
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  GTEST_CHECK_(result->total_part_count() == 1);
+  GTEST_CHECK_(strstr(result->GetTestPartResult(0).message(),
+                      "stress test thread #1, iteration #2") != NULL)
+      << result->GetTestPartResult(0).message();
+}
+
+TEST(RunStressTestTest, FatalFailureStopsOnlyItsThread) {
+  FailingOnceBody body(true);
+  const std::vector<StressTestThreadResult> results =
+      RunStressTest(3, 5, &body);
+
+  for (int i = 0; i < 3; i++) {
+    GTEST_CHECK_(results[i].iteration_count == (i == 1 ? 2 : 5))
+        << "Thread " << i << " ran " << results[i].iteration_count;
+    GTEST_CHECK_(results[i].failure_count == (i == 1 ? 1 : 0));
+  }
+  CheckTestFailureCount(1);
+}
+
+#if GTEST_HAS_EXCEPTIONS
+
+// Throws in iteration 2 of thread 1.
+class ThrowingOnceBody : public StressTestBody {
+ public:
+  virtual void Run(int thread_index, int iteration) {
+    if (thread_index == 1 && iteration == 2)
+      throw std::runtime_error("Expected exception.");
+  }
+};
+
+TEST(RunStressTestTest, ExceptionStopsOnlyItsThread) {
+  ThrowingOnceBody body;
+  const std::vector<StressTestThreadResult> results =
+      RunStressTest(3, 5, &body);
+
+  for (int i = 0; i < 3; i++) {
+    GTEST_CHECK_(results[i].iteration_count == (i == 1 ? 2 : 5))
+        << "Thread " << i << " ran " << results[i].iteration_count;
+    GTEST_CHECK_(results[i].failure_count == (i == 1 ? 1 : 0));
+  }
+
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  GTEST_CHECK_(result->total_part_count() == 1);
+  GTEST_CHECK_(strstr(result->GetTestPartResult(0).message(),
+                      "\"Expected exception.\" thrown in "
+                      "the stress test body") != NULL)
+      << result->GetTestPartResult(0).message();
+}
+
+#endif  // GTEST_HAS_EXCEPTIONS
+
+// Does some work that touches no shared state, so it should scale.
+class IndependentWorkBody : public StressTestBody {
+ public:
+  virtual void Run(int /* thread_index */, int iteration) {
+    volatile int sum = 0;
+    for (int i = 0; i < 1000; i++)
+      sum += i * iteration;
+  }
+};
+
+TEST(MeasureThreadScalingTest, MeasuresPowersOfTwoUpToMaxThreadCount) {
+  IndependentWorkBody body;
+  const ThreadScalingResult scaling = MeasureThreadScaling(5, 1000, &body);
+
+  const int kExpectedThreadCounts[] = { 1, 2, 4, 5 };
+  GTEST_CHECK_(scaling.point_count() == 4) << scaling.point_count();
+  for (int i = 0; i < 4; i++) {
+    const ThreadScalingPoint& point = scaling.GetPoint(i);
+    GTEST_CHECK_(point.thread_count == kExpectedThreadCounts[i]);
+    GTEST_CHECK_(point.ops_per_second > 0);
+    GTEST_CHECK_(point.efficiency > 0);
+  }
+  GTEST_CHECK_(scaling.EfficiencyAt(1) == 1.0);
+  GTEST_CHECK_(scaling.OpsPerSecondAt(4) == scaling.GetPoint(2).ops_per_second);
+
+  // The curve is recorded as properties.
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  GTEST_CHECK_(result->test_property_count() == 4);
+  GTEST_CHECK_(String(result->GetTestProperty(3).key()) == "thread_scaling_5");
+  GTEST_CHECK_(strstr(result->GetTestProperty(0).value(),
+                      " ops/s, efficiency 1.00") != NULL)
+      << result->GetTestProperty(0).value();
+  CheckTestFailureCount(0);
+}
+
 void FailingThread(bool is_fatal) {
   if (is_fatal)
     FAIL() << "Fatal failure in some other thread. "
@@ -195,6 +415,25 @@ TEST(NoFatalFailureTest, AssertNoFatalFailureIgnoresFailuresInOtherThreads) {
   CheckTestFailureCount(1);
 }
 
+TEST(NonFatalFailureTest, FailuresInOtherThreadsAreBufferedUntilMerged) {
+  GenerateFatalFailureInAnotherThread(false);
+  const TestResult* const result =
+      UnitTest::GetInstance()->current_test_info()->result();
+  GTEST_CHECK_(result->total_part_count() == 0)
+      << "Failures in other threads should be buffered per thread";
+  CheckTestFailureCount(1);
+}
+
+TEST(FatalFailureTest, HasFailureSeesFailuresInOtherThreadsBeforeMerge) {
+  GenerateFatalFailureInAnotherThread(true);
+  GTEST_CHECK_(Test::HasFatalFailure())
+      << "A buffered fatal failure should be visible before the merge";
+  GTEST_CHECK_(Test::HasFailure());
+  GTEST_CHECK_(!Test::HasNonfatalFailure());
+  CheckTestFailureCount(1);
+  GTEST_CHECK_(Test::HasFatalFailure());
+}
+
 TEST(FatalFailureTest, ExpectFatalFailureIgnoresFailuresInOtherThreads) {
   // This statement should fail, since the current thread doesn't generate a
   // fatal failure, only another one does.
@@ -44,17 +44,21 @@ TEST(CommandLineFlagsTest, CanBeAccessedInCodeOnceGTestHIsIncluded) {
       || testing::GTEST_FLAG(break_on_failure)
       || testing::GTEST_FLAG(catch_exceptions)
       || testing::GTEST_FLAG(color) != "unknown"
+      || testing::GTEST_FLAG(fail_on_leak_bytes) > 0
       || testing::GTEST_FLAG(filter) != "unknown"
       || testing::GTEST_FLAG(list_tests)
+      || testing::GTEST_FLAG(max_failures_per_test) > 0
       || testing::GTEST_FLAG(output) != "unknown"
       || testing::GTEST_FLAG(print_time)
       || testing::GTEST_FLAG(random_seed)
       || testing::GTEST_FLAG(repeat) > 0
       || testing::GTEST_FLAG(show_internal_stack_frames)
       || testing::GTEST_FLAG(shuffle)
+      || testing::GTEST_FLAG(startup_profile)
       || testing::GTEST_FLAG(stack_trace_depth) > 0
       || testing::GTEST_FLAG(stream_result_to) != "unknown"
-      || testing::GTEST_FLAG(throw_on_failure);
+      || testing::GTEST_FLAG(throw_on_failure)
+      || testing::GTEST_FLAG(update_golden_files);
   EXPECT_TRUE(dummy || !dummy);  // Suppresses warning that dummy is unused.
 }
 
@@ -75,6 +79,13 @@ TEST(CommandLineFlagsTest, CanBeAccessedInCodeOnceGTestHIsIncluded) {
 
 #include <map>
 
+#if GTEST_CAN_STREAM_RESULTS_
+# include <arpa/inet.h>  // NOLINT
+# include <netinet/in.h>  // NOLINT
+# include <sys/socket.h>  // NOLINT
+# include <unistd.h>  // NOLINT
+#endif  // GTEST_CAN_STREAM_RESULTS_
+
 namespace testing {
 namespace internal {
 
@@ -118,24 +129,30 @@ using testing::GTEST_FLAG(break_on_failure);
 using testing::GTEST_FLAG(catch_exceptions);
 using testing::GTEST_FLAG(color);
 using testing::GTEST_FLAG(death_test_use_fork);
+using testing::GTEST_FLAG(fail_on_leak_bytes);
 using testing::GTEST_FLAG(filter);
 using testing::GTEST_FLAG(list_tests);
+using testing::GTEST_FLAG(max_failures_per_test);
 using testing::GTEST_FLAG(output);
 using testing::GTEST_FLAG(print_time);
 using testing::GTEST_FLAG(random_seed);
 using testing::GTEST_FLAG(repeat);
 using testing::GTEST_FLAG(show_internal_stack_frames);
 using testing::GTEST_FLAG(shuffle);
+using testing::GTEST_FLAG(startup_profile);
 using testing::GTEST_FLAG(stack_trace_depth);
 using testing::GTEST_FLAG(stream_result_to);
 using testing::GTEST_FLAG(throw_on_failure);
+using testing::GTEST_FLAG(update_golden_files);
 using testing::IsNotSubstring;
 using testing::IsSubstring;
 using testing::Message;
 using testing::ScopedFakeTestPartResultReporter;
+using testing::LatencyRecorder;
 using testing::StaticAssertTypeEq;
 using testing::Test;
 using testing::TestCase;
+using testing::TestEventListener;
 using testing::TestEventListeners;
 using testing::TestPartResult;
 using testing::TestPartResultArray;
@@ -145,19 +162,28 @@ using testing::UnitTest;
 using testing::kMaxStackTraceDepth;
 using testing::internal::AddReference;
 using testing::internal::AlwaysFalse;
+using testing::internal::AlignmentOf;
 using testing::internal::AlwaysTrue;
 using testing::internal::AppendUserMessage;
+using testing::internal::Arena;
 using testing::internal::ArrayAwareFind;
 using testing::internal::ArrayEq;
+using testing::internal::CmpHelperEQ;
+using testing::internal::CmpHelperSTREQ;
 using testing::internal::CodePointToUtf8;
 using testing::internal::CompileAssertTypesEqual;
 using testing::internal::CopyArray;
 using testing::internal::CountIf;
 using testing::internal::EqFailure;
+using testing::internal::FilePath;
 using testing::internal::FloatingPoint;
 using testing::internal::ForEach;
+using testing::internal::FormatNanosAsSeconds;
+using testing::internal::FormatOmittedFailureNote;
+using testing::internal::FormatRepeatedFailureNote;
 using testing::internal::FormatTimeInMillisAsSeconds;
 using testing::internal::GTestFlagSaver;
+using testing::internal::GetCurrentExecutableName;
 using testing::internal::GetCurrentOsStackTraceExceptTop;
 using testing::internal::GetElementOr;
 using testing::internal::GetNextRandomSeed;
@@ -167,6 +193,7 @@ using testing::internal::GetTypeId;
 using testing::internal::GetUnitTestImpl;
 using testing::internal::ImplicitlyConvertible;
 using testing::internal::Int32;
+using testing::internal::Int64;
 using testing::internal::Int32FromEnvOrDie;
 using testing::internal::IsAProtocolMessage;
 using testing::internal::IsContainer;
@@ -183,10 +210,24 @@ using testing::internal::Shuffle;
 using testing::internal::ShuffleRange;
 using testing::internal::SkipPrefix;
 using testing::internal::StreamableToString;
+using testing::internal::StartupProfile;
+using testing::internal::StartupStage;
 using testing::internal::String;
+using testing::internal::StringPiece;
+using testing::internal::StringPool;
 using testing::internal::TestEventListenersAccessor;
+using testing::internal::TestPhaseName;
+using testing::internal::kFlagParsingStage;
+using testing::internal::kListenerSetUpStage;
+using testing::internal::kPostFlagParsingInitStage;
+using testing::internal::kStartupStageCount;
+using testing::internal::kStaticRegistrationStage;
+using testing::internal::kTestFilteringStage;
 using testing::internal::TestResultAccessor;
 using testing::internal::UInt32;
+using testing::internal::UnitTestOptions;
+using testing::internal::Utf8LengthOfWideChars;
+using testing::internal::WideCharsToUtf8;
 using testing::internal::WideStringToUtf8;
 using testing::internal::kCopy;
 using testing::internal::kMaxRandomSeed;
@@ -308,6 +349,97 @@ TEST(FormatTimeInMillisAsSecondsTest, FormatsNegativeNumber) {
   EXPECT_EQ("-3", FormatTimeInMillisAsSeconds(-3000));
 }
 
+// Tests FormatNanosAsSeconds().
+
+TEST(FormatNanosAsSecondsTest, FormatsWithMicrosecondPrecision) {
+  EXPECT_EQ("0.000000", FormatNanosAsSeconds(0));
+  EXPECT_EQ("0.000125", FormatNanosAsSeconds(125000));
+  EXPECT_EQ("0.000125", FormatNanosAsSeconds(125400));
+  EXPECT_EQ("1.500000", FormatNanosAsSeconds(1500000000));
+}
+
+// Tests TestPhaseName().
+
+TEST(TestPhaseNameTest, NamesEveryPhase) {
+  EXPECT_STREQ("constructor", TestPhaseName(TestResult::kConstructorPhase));
+  EXPECT_STREQ("set_up", TestPhaseName(TestResult::kSetUpPhase));
+  EXPECT_STREQ("test_body", TestPhaseName(TestResult::kTestBodyPhase));
+  EXPECT_STREQ("tear_down", TestPhaseName(TestResult::kTearDownPhase));
+  EXPECT_STREQ("destructor", TestPhaseName(TestResult::kDestructorPhase));
+}
+
+#if GTEST_CAN_STREAM_RESULTS_
+
+// Tests the events the listener installed by --gtest_stream_result_to
+// sends, by connecting it to a socket listening on the loopback
+// interface.
+class StreamingListenerTest : public Test {
+ protected:
+  StreamingListenerTest() : server_fd_(-1) {}
+
+  virtual void SetUp() {
+    server_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(-1, server_fd_);
+
+    // Lets the system pick a free port.
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    ASSERT_EQ(0, bind(server_fd_, reinterpret_cast<sockaddr*>(&address),
+                      length));
+    ASSERT_EQ(0, listen(server_fd_, 1));
+    ASSERT_EQ(0, getsockname(server_fd_, reinterpret_cast<sockaddr*>(&address),
+                             &length));
+    port_ = StreamableToString(ntohs(address.sin_port)).c_str();
+  }
+
+  virtual void TearDown() {
+    if (server_fd_ != -1)
+      close(server_fd_);
+  }
+
+  // Accepts the listener's connection and returns everything streamed
+  // over it until the listener closed it.
+  std::string ReadStream() {
+    std::string stream;
+    const int fd = accept(server_fd_, NULL, NULL);
+    if (fd == -1)
+      return stream;
+
+    char buffer[256];
+    ssize_t size;
+    while ((size = read(fd, buffer, sizeof(buffer))) > 0)
+      stream.append(buffer, static_cast<size_t>(size));
+    close(fd);
+    return stream;
+  }
+
+  int server_fd_;
+  std::string port_;
+};
+
+TEST_F(StreamingListenerTest, StreamsPhaseTimesOnTestEnd) {
+  TestEventListener* const listener =
+      testing::internal::NewStreamingListener("127.0.0.1", port_);
+  listener->OnTestEnd(*UnitTest::GetInstance()->current_test_info());
+  delete listener;  // Closes the connection.
+
+  // The test body and what follows haven't run yet, so they took no time.
+  const std::string stream = ReadStream();
+  EXPECT_PRED_FORMAT2(IsSubstring, "gtest_streaming_protocol_version=1.0\n"
+                      "event=TestEnd&passed=1&elapsed_time=0ms"
+                      "&constructor_time=", stream);
+  EXPECT_PRED_FORMAT2(IsSubstring, "ns&set_up_time=", stream);
+  EXPECT_PRED_FORMAT2(IsSubstring, "ns&test_body_time=0ns&tear_down_time=0ns"
+                      "&destructor_time=0ns\n", stream);
+  EXPECT_PRED_FORMAT2(IsNotSubstring, "(null)", stream);
+}
+
+#endif  // GTEST_CAN_STREAM_RESULTS_
+
 #if GTEST_CAN_COMPARE_NULL
 
 # ifdef __BORLANDC__
@@ -540,6 +672,84 @@ TEST(WideStringToUtf8Test, ConcatenatesCodepointsCorrectly) {
 }
 #endif  // !GTEST_WIDE_STRING_USES_UTF16_
 
+// Converts the num_chars wide characters at str to UTF-8 with
+// WideCharsToUtf8(), checking that Utf8LengthOfWideChars() predicts the
+// length of the result.
+::std::string ConvertWideCharsToUtf8(const wchar_t* str, size_t num_chars) {
+  const size_t length = Utf8LengthOfWideChars(str, num_chars);
+  ::std::vector<char> buffer(length + 1);
+  const char* const end = WideCharsToUtf8(str, num_chars, &buffer[0]);
+  EXPECT_EQ(length, static_cast<size_t>(end - &buffer[0]));
+  return ::std::string(&buffer[0], length);
+}
+
+// Tests that the bulk conversion agrees with converting one code point at
+// a time, whatever the mix of ASCII runs and other characters.
+TEST(WideCharsToUtf8Test, AgreesWithCodePointToUtf8) {
+  testing::internal::Random random(42);
+  ::std::vector<wchar_t> wide;
+  ::std::string expected;
+  while (wide.size() < 10000) {
+    // Alternates runs of ASCII with runs of one- to three-byte UTF-8
+    // characters, none of which is a surrogate.
+    const bool ascii = random.Generate(2) == 0;
+    for (UInt32 n = random.Generate(40); n != 0; n--) {
+      const UInt32 code_point = ascii ? 1 + random.Generate(0x7F) :
+          0x80 + random.Generate(0xD800 - 0x80);
+      char buffer[32];
+      wide.push_back(static_cast<wchar_t>(code_point));
+      expected += CodePointToUtf8(code_point, buffer);
+    }
+  }
+
+  EXPECT_EQ(expected, ConvertWideCharsToUtf8(&wide[0], wide.size()));
+  wide.push_back(L'\0');
+  EXPECT_STREQ(expected.c_str(), WideStringToUtf8(&wide[0], -1).c_str());
+}
+
+// Tests that characters that start or end a block of the ASCII fast path
+// are converted correctly.
+TEST(WideCharsToUtf8Test, HandlesNonAsciiCharactersAtBlockBoundaries) {
+  wchar_t wide[48];
+  for (int i = 0; i < 48; i++) {
+    wide[i] = L'a';
+  }
+  wide[15] = 0xE9;
+  wide[16] = 0x20AC;
+  wide[47] = 0xE9;
+  const ::std::string a15(15, 'a');
+  EXPECT_EQ(a15 + "\xC3\xA9" "\xE2\x82\xAC" + a15 + a15 + "\xC3\xA9",
+            ConvertWideCharsToUtf8(wide, 48));
+
+#if GTEST_WIDE_STRING_USES_UTF16_
+  // A surrogate pair that straddles two blocks.
+  wide[15] = 0xD801;
+  wide[16] = 0xDC00;
+  EXPECT_EQ(a15 + "\xF0\x90\x90\x80" + a15 + a15 + "\xC3\xA9",
+            ConvertWideCharsToUtf8(wide, 48));
+#else
+  wide[15] = 0x10400;
+  wide[16] = L'a';
+  EXPECT_EQ(a15 + "\xF0\x90\x90\x80" "a" + a15 + a15 + "\xC3\xA9",
+            ConvertWideCharsToUtf8(wide, 48));
+#endif  // GTEST_WIDE_STRING_USES_UTF16_
+}
+
+// Tests that WideCharsToUtf8() converts L'\0' instead of stopping.
+TEST(WideCharsToUtf8Test, ConvertsNulCharacters) {
+  EXPECT_EQ(::std::string("a\0b", 3), ConvertWideCharsToUtf8(L"a\0b", 3));
+  EXPECT_EQ("", ConvertWideCharsToUtf8(L"", 0));
+}
+
+#if !GTEST_WIDE_STRING_USES_UTF16_
+// Tests that Utf8LengthOfWideChars() accounts for how invalid code points
+// are printed.
+TEST(WideCharsToUtf8Test, ConvertsInvalidCodePoints) {
+  EXPECT_EQ("(Invalid Unicode 0xABCDFF)a(Invalid Unicode 0x7FFFFFFF)",
+            ConvertWideCharsToUtf8(L"\xABCDFF" L"a" L"\x7FFFFFFF", 3));
+}
+#endif  // !GTEST_WIDE_STRING_USES_UTF16_
+
 // Tests the Random class.
 
 TEST(RandomDeathTest, GeneratesCrashesOnInvalidRange) {
@@ -1156,6 +1366,211 @@ TEST(StringTest, CanBeAssignedSelf) {
   EXPECT_STREQ("hello", dest.c_str());
 }
 
+// Tests copying Strings around the length up to which the content is
+// stored in the String object itself.
+TEST(StringTest, CopiesShortAndLongStrings) {
+  for (size_t length = 0; length <= 40; length++) {
+    const ::std::string content(length, 'x');
+    const String str(content.c_str());
+    String copy(str);
+    EXPECT_EQ(length, copy.length());
+    EXPECT_STREQ(content.c_str(), copy.c_str());
+    EXPECT_NE(str.c_str(), copy.c_str());
+
+    String assigned("a string that's too long to be stored inline");
+    assigned = str;
+    EXPECT_EQ(length, assigned.length());
+    EXPECT_STREQ(content.c_str(), assigned.c_str());
+
+    copy = String();
+    EXPECT_TRUE(copy.c_str() == NULL);
+    copy = assigned;
+    EXPECT_STREQ(content.c_str(), copy.c_str());
+  }
+}
+
+// Tests that a String doesn't grow by more than its inline buffer, as the
+// length of a String on the heap shares the buffer's bytes, and that
+// an inline String keeps its length even when it has embedded NULs.
+TEST(StringTest, KeepsTheLengthInTheInlineBuffer) {
+  EXPECT_LE(sizeof(String), sizeof(const char*) + 2 * sizeof(size_t));
+
+  const String str("a\0b", 3);
+  EXPECT_EQ(3u, str.length());
+  const String copy(str);
+  EXPECT_EQ(3u, copy.length());
+  EXPECT_EQ('b', copy.c_str()[2]);
+}
+
+#if GTEST_LANG_CXX11
+// Tests that moving a String leaves the source NULL.
+TEST(StringTest, CanBeMoved) {
+  const char* const kContents[] = {
+    "", "short", "a string that's too long to be stored inline"
+  };
+  for (size_t i = 0; i < sizeof(kContents)/sizeof(kContents[0]); i++) {
+    String source(kContents[i]);
+    String moved(static_cast<String&&>(source));
+    EXPECT_STREQ(kContents[i], moved.c_str());
+    EXPECT_TRUE(source.c_str() == NULL);
+    EXPECT_EQ(0u, source.length());
+
+    String assigned("to be replaced");
+    assigned = static_cast<String&&>(moved);
+    EXPECT_STREQ(kContents[i], assigned.c_str());
+    EXPECT_TRUE(moved.c_str() == NULL);
+
+    // Use explicit function call notation here to suppress self-move
+    // warnings.
+    assigned.operator=(static_cast<String&&>(assigned));
+    EXPECT_STREQ(kContents[i], assigned.c_str());
+  }
+}
+#endif  // GTEST_LANG_CXX11
+
+// Tests the StringPiece constructors.
+TEST(StringPieceTest, Constructors) {
+  EXPECT_EQ(0u, StringPiece().length());
+  EXPECT_EQ(0u, StringPiece(static_cast<const char*>(NULL)).length());
+  EXPECT_EQ(0u, StringPiece(String()).length());
+
+  const char* const c_str = "hello";
+  EXPECT_EQ(c_str, StringPiece(c_str).data());
+  EXPECT_EQ(5u, StringPiece(c_str).length());
+  EXPECT_EQ(3u, StringPiece(c_str, 3).length());
+
+  const String str("hello");
+  EXPECT_EQ(str.c_str(), StringPiece(str).data());
+  EXPECT_EQ(5u, StringPiece(str).length());
+
+  const ::std::string std_str("a\0b", 3);
+  EXPECT_EQ(std_str.data(), StringPiece(std_str).data());
+  EXPECT_EQ(3u, StringPiece(std_str).length());
+}
+
+// Tests the StringPiece accessors and comparisons.
+TEST(StringPieceTest, ViewsPartsOfTheString) {
+  const StringPiece piece("TestCase.Test");
+  EXPECT_FALSE(piece.empty());
+  EXPECT_EQ('T', piece[0]);
+  EXPECT_STREQ(".Test", piece.RemovePrefix(8).ToString().c_str());
+  EXPECT_STREQ("TestCase", piece.Prefix(8).ToString().c_str());
+  EXPECT_TRUE(piece.RemovePrefix(piece.length()).empty());
+
+  EXPECT_TRUE(piece.StartsWith("TestCase."));
+  EXPECT_TRUE(piece.StartsWith(""));
+  EXPECT_FALSE(piece.StartsWith("Test."));
+  EXPECT_FALSE(piece.Prefix(4).StartsWith("TestCase"));
+
+  EXPECT_TRUE(piece.EndsWith(".Test"));
+  EXPECT_TRUE(piece.EndsWith(piece));
+  EXPECT_FALSE(piece.EndsWith("Case"));
+  EXPECT_FALSE(piece.Prefix(8).EndsWith(".Test"));
+}
+
+// Tests that Arena hands out aligned, consecutive, non-overlapping
+// blocks.
+TEST(ArenaTest, AllocatesAlignedBlocksInOrder) {
+  Arena arena(1024);
+  char* const a = static_cast<char*>(arena.Allocate(3, 1));
+  char* const b = static_cast<char*>(arena.Allocate(5, 1));
+  char* const c = static_cast<char*>(arena.Allocate(8, 8));
+  EXPECT_EQ(a + 3, b);
+  EXPECT_EQ(b + 5, c);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(c) % 8);
+
+  memset(a, 'a', 3);
+  memset(b, 'b', 5);
+  memset(c, 'c', 8);
+  EXPECT_EQ(std::string(3, 'a'), std::string(a, 3));
+  EXPECT_EQ(std::string(5, 'b'), std::string(b, 5));
+}
+
+// Tests that Arena starts a new chunk when the current one is full, and
+// gives big blocks chunks of their own without abandoning the current one.
+TEST(ArenaTest, AllocatesBeyondAChunk) {
+  Arena arena(1024);
+  char* const first = static_cast<char*>(arena.Allocate(200, 1));
+  char* const big = static_cast<char*>(arena.Allocate(5000, 1));
+  char* const second = static_cast<char*>(arena.Allocate(200, 1));
+  EXPECT_EQ(first + 200, second);
+  memset(big, 'x', 5000);
+
+  std::vector<char*> blocks;
+  for (int i = 0; i < 100; i++) {
+    blocks.push_back(static_cast<char*>(arena.Allocate(100, 16)));
+    EXPECT_EQ(0u, reinterpret_cast<size_t>(blocks.back()) % 16);
+    memset(blocks.back(), i, 100);
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(std::string(100, static_cast<char>(i)),
+              std::string(blocks[i], 100));
+  }
+}
+
+// Tests that AlignmentOf gives the alignment of a type.
+TEST(AlignmentOfTest, GivesTheAlignmentOfAType) {
+  const size_t char_alignment = AlignmentOf<char>::value;
+  EXPECT_EQ(1u, char_alignment);
+
+  // The tests live in the registration arena, aligned as a TestInfo.
+  const size_t test_info_alignment = AlignmentOf<testing::TestInfo>::value;
+  EXPECT_EQ(0u, test_info_alignment % AlignmentOf<void*>::value);
+  EXPECT_EQ(0u, reinterpret_cast<size_t>(
+      UnitTest::GetInstance()->current_test_info()) % test_info_alignment);
+}
+
+// Tests that StringPool keeps one copy of each distinct string.
+TEST(StringPoolTest, InternsEqualStringsToTheSameCopy) {
+  StringPool pool;
+  EXPECT_TRUE(pool.Intern(NULL) == NULL);
+  EXPECT_EQ(0u, pool.size());
+
+  char name[] = "TestCase";
+  const char* const interned = pool.Intern(name);
+  EXPECT_STREQ("TestCase", interned);
+  EXPECT_NE(name, interned);
+  EXPECT_EQ(interned, pool.Intern("TestCase"));
+  EXPECT_EQ(interned, pool.Intern(interned));
+
+  // The copy doesn't change with the original.
+  name[0] = 'B';
+  EXPECT_STREQ("TestCase", interned);
+  EXPECT_NE(interned, pool.Intern(name));
+
+  EXPECT_STREQ("", pool.Intern(""));
+  EXPECT_EQ(pool.Intern(""), pool.Intern(""));
+  EXPECT_EQ(3u, pool.size());
+}
+
+// Tests that StringPool keeps strings longer than its chunks, and the
+// strings around them, intact.
+TEST(StringPoolTest, InternsLongStrings) {
+  StringPool pool;
+  const std::string long_string(100000, 'x');
+  const char* const before = pool.Intern("before");
+  const char* const interned = pool.Intern(long_string.c_str());
+  const char* const after = pool.Intern("after");
+  EXPECT_EQ(long_string, interned);
+  EXPECT_STREQ("before", before);
+  EXPECT_STREQ("after", after);
+  EXPECT_EQ(interned, pool.Intern(long_string.c_str()));
+}
+
+// Tests that StringPool still finds every string after growing.
+TEST(StringPoolTest, FindsStringsAfterGrowing) {
+  StringPool pool;
+  std::vector<const char*> interned;
+  for (int i = 0; i < 10000; i++)
+    interned.push_back(pool.Intern(String::Format("Test/%d", i).c_str()));
+  EXPECT_EQ(10000u, pool.size());
+  for (int i = 0; i < 10000; i++) {
+    const String name = String::Format("Test/%d", i);
+    ASSERT_STREQ(name.c_str(), interned[i]);
+    ASSERT_EQ(interned[i], pool.Intern(name.c_str()));
+  }
+}
+
 // Sun Studio < 12 incorrectly rejects this code due to an overloading
 // ambiguity.
 #if !(defined(__SUNPRO_CC) && __SUNPRO_CC < 0x590)
@@ -1169,28 +1584,53 @@ TEST(StringTest, Streams) {
 
 // Tests that String::Format() works.
 TEST(StringTest, FormatWorks) {
-  // Normal case: the format spec is valid, the arguments match the
-  // spec, and the result is < 4095 characters.
+  // Normal case: the format spec is valid and the arguments match the
+  // spec.
   EXPECT_STREQ("Hello, 42", String::Format("%s, %d", "Hello", 42).c_str());
-
-  // Edge case: the result is 4095 characters.
-  char buffer[4096];
-  const size_t kSize = sizeof(buffer);
-  memset(buffer, 'a', kSize - 1);
-  buffer[kSize - 1] = '\0';
-  EXPECT_STREQ(buffer, String::Format("%s", buffer).c_str());
-
-  // The result needs to be 4096 characters, exceeding Format()'s limit.
-  EXPECT_STREQ("<formatting error or buffer exceeded>",
-               String::Format("x%s", buffer).c_str());
+  EXPECT_STREQ("", String::Format("%s", "").c_str());
+
+  // Results around and well beyond the size of Format()'s stack buffer
+  // are formatted in full.
+  for (size_t size = 250; size <= 260; ++size) {
+    const ::std::string expected(size, 'a');
+    const String actual = String::Format("%s", expected.c_str());
+    EXPECT_EQ(size, actual.length());
+    EXPECT_STREQ(expected.c_str(), actual.c_str());
+  }
+  const ::std::string long_string(100000, 'b');
+  const String long_result = String::Format("x%sy%d", long_string.c_str(), 7);
+  EXPECT_EQ(long_string.length() + 3, long_result.length());
+  EXPECT_STREQ(("x" + long_string + "y7").c_str(), long_result.c_str());
 
 #if GTEST_OS_LINUX
   // On Linux, invalid format spec should lead to an error message.
   // In other environment (e.g. MSVC on Windows), String::Format() may
   // simply ignore a bad format spec, so this assertion is run on
   // Linux only.
-  EXPECT_STREQ("<formatting error or buffer exceeded>",
-               String::Format("%").c_str());
+  EXPECT_STREQ("<formatting error>", String::Format("%").c_str());
+#endif
+}
+
+// Tests that String::AppendFormat() appends to the existing content.
+TEST(StringTest, AppendFormatWorks) {
+  ::std::string output("Hello");
+  EXPECT_TRUE(String::AppendFormat(&output, ", %d", 42));
+  EXPECT_EQ("Hello, 42", output);
+
+  EXPECT_TRUE(String::AppendFormat(&output, "%s", ""));
+  EXPECT_EQ("Hello, 42", output);
+
+  // A result longer than AppendFormat()'s stack buffer.
+  const ::std::string long_string(100000, 'c');
+  EXPECT_TRUE(String::AppendFormat(&output, "[%s]", long_string.c_str()));
+  EXPECT_EQ("Hello, 42[" + long_string + "]", output);
+
+#if GTEST_OS_LINUX
+  // An invalid format spec leaves the output alone (see FormatWorks
+  // for why this only runs on Linux).
+  output = "unchanged";
+  EXPECT_FALSE(String::AppendFormat(&output, "%"));
+  EXPECT_EQ("unchanged", output);
 #endif
 }
 
@@ -1212,6 +1652,13 @@ TEST(StringTest, ShowWideCStringQuoted) {
                String::ShowWideCStringQuoted(L"").c_str());
   EXPECT_STREQ("L\"foo\"",
                String::ShowWideCStringQuoted(L"foo").c_str());
+
+  // Long strings are not truncated.
+  ::std::vector<wchar_t> long_string(10000, L'x');
+  long_string.push_back(L'\0');
+  EXPECT_EQ("L\"" + ::std::string(10000, 'x') + "\"",
+            ::std::string(String::ShowWideCStringQuoted(
+                &long_string[0]).c_str()));
 }
 
 # if GTEST_OS_WINDOWS_MOBILE
@@ -1473,6 +1920,73 @@ TEST_F(ExpectNonfatalFailureTest, AcceptsMacroThatExpandsToUnprotectedComma) {
   }, "");
 }
 
+// Tests SCOPED_TRACE_LAZY().
+
+// Tests that SCOPED_TRACE_LAZY() shows the value the traced variable has
+// when the failure happens.
+TEST(ScopedTraceLazyTest, StreamsValueAtTimeOfFailure) {
+  TestPartResultArray results;
+  {
+    ScopedFakeTestPartResultReporter reporter(&results);
+    ::std::string label = "initial";
+    SCOPED_TRACE_LAZY(label);
+    label = "updated";
+    ADD_FAILURE() << "Failure";
+  }
+
+  ASSERT_EQ(1, results.size());
+  const char* const message = results.GetTestPartResult(0).message();
+  EXPECT_PRED_FORMAT2(IsSubstring, "Google Test trace:", message);
+  EXPECT_PRED_FORMAT2(IsSubstring, " updated", message);
+  EXPECT_PRED_FORMAT2(IsNotSubstring, "initial", message);
+}
+
+// Tests that SCOPED_TRACE_LAZY() works in a loop and is undone when the
+// control leaves its scope.
+TEST(ScopedTraceLazyTest, WorksInLoopAndObeysScopes) {
+  TestPartResultArray results;
+  {
+    ScopedFakeTestPartResultReporter reporter(&results);
+    for (int i = 0; i < 3; i++) {
+      SCOPED_TRACE_LAZY(i);
+      EXPECT_NE(1, i) << "Failure in loop";
+    }
+    ADD_FAILURE() << "Failure after loop";
+  }
+
+  ASSERT_EQ(2, results.size());
+  EXPECT_PRED_FORMAT2(IsSubstring, "Google Test trace:",
+                      results.GetTestPartResult(0).message());
+  EXPECT_PRED_FORMAT2(IsNotSubstring, "Google Test trace:",
+                      results.GetTestPartResult(1).message());
+}
+
+// Tests that SCOPED_TRACE_LAZY() and SCOPED_TRACE() can be nested, with
+// the innermost trace shown first.
+TEST(ScopedTraceLazyTest, CanBeNestedWithScopedTrace) {
+  TestPartResultArray results;
+  {
+    ScopedFakeTestPartResultReporter reporter(&results);
+    const char* const outer = "outer lazy trace";
+    SCOPED_TRACE_LAZY(outer);
+    SCOPED_TRACE("middle trace");
+    const int inner = 12345;
+    SCOPED_TRACE_LAZY(inner);
+    ADD_FAILURE() << "Failure";
+  }
+
+  ASSERT_EQ(1, results.size());
+  const ::std::string message = results.GetTestPartResult(0).message();
+  const size_t inner_pos = message.find(" 12345");
+  const size_t middle_pos = message.find(" middle trace");
+  const size_t outer_pos = message.find(" outer lazy trace");
+  ASSERT_NE(::std::string::npos, inner_pos);
+  ASSERT_NE(::std::string::npos, middle_pos);
+  ASSERT_NE(::std::string::npos, outer_pos);
+  EXPECT_LT(inner_pos, middle_pos);
+  EXPECT_LT(middle_pos, outer_pos);
+}
+
 #if GTEST_IS_THREADSAFE
 
 typedef ScopedFakeTestPartResultReporterWithThreadsTest
@@ -1511,8 +2025,6 @@ TEST(TestPropertyTest, SetValue) {
 // The test fixture for testing TestResult.
 class TestResultTest : public Test {
  protected:
-  typedef std::vector<TestPartResult> TPRVector;
-
   // We make use of 2 TestPartResult objects,
   TestPartResult * pr1, * pr2;
 
@@ -1537,24 +2049,14 @@ class TestResultTest : public Test {
     r1 = new TestResult();
     r2 = new TestResult();
 
-    // In order to test TestResult, we need to modify its internal
-    // state, in particular the TestPartResult vector it holds.
-    // test_part_results() returns a const reference to this vector.
-    // We cast it to a non-const object s.t. it can be modified (yes,
-    // this is a hack).
-    TPRVector* results1 = const_cast<TPRVector*>(
-        &TestResultAccessor::test_part_results(*r1));
-    TPRVector* results2 = const_cast<TPRVector*>(
-        &TestResultAccessor::test_part_results(*r2));
-
     // r0 is an empty TestResult.
 
     // r1 contains a single SUCCESS TestPartResult.
-    results1->push_back(*pr1);
+    TestResultAccessor::AddTestPartResult(r1, *pr1);
 
     // r2 contains a SUCCESS, and a FAILURE.
-    results2->push_back(*pr1);
-    results2->push_back(*pr2);
+    TestResultAccessor::AddTestPartResult(r2, *pr1);
+    TestResultAccessor::AddTestPartResult(r2, *pr2);
   }
 
   virtual void TearDown() {
@@ -1613,6 +2115,135 @@ TEST_F(TestResultDeathTest, GetTestPartResult) {
   EXPECT_DEATH_IF_SUPPORTED(r2->GetTestPartResult(-1), "");
 }
 
+// Tests that --gtest_max_failures_per_test folds floods of failures by
+// default.
+TEST(TestResultFloodControlTest, IsOnByDefault) {
+  EXPECT_EQ(100, GTEST_FLAG(max_failures_per_test));
+}
+
+// Tests that TestResult records every test part result when
+// --gtest_max_failures_per_test is 0.
+TEST(TestResultFloodControlTest, RecordsEverythingWithoutALimit) {
+  GTEST_FLAG(max_failures_per_test) = 0;
+  TestResult test_result;
+  const TestPartResult failure(TestPartResult::kNonFatalFailure,
+                               "foo/bar.cc", 5, "Failure!");
+  for (int i = 0; i < 1000; i++)
+    EXPECT_TRUE(TestResultAccessor::AddTestPartResult(&test_result, failure));
+  EXPECT_EQ(1000, test_result.total_part_count());
+  EXPECT_EQ(0, test_result.GetTestPartRepeatCount(999));
+  EXPECT_EQ(0, test_result.omitted_failure_count());
+}
+
+// Tests that, once the limit is reached, TestResult counts the failures
+// identical to a recorded one instead of recording them.
+TEST(TestResultFloodControlTest, CountsIdenticalFailuresBeyondTheLimit) {
+  GTEST_FLAG(max_failures_per_test) = 2;
+  TestResult test_result;
+  const TestPartResult failure(TestPartResult::kNonFatalFailure,
+                               "foo/bar.cc", 5, "Failure!");
+  const TestPartResult fatal_failure(TestPartResult::kFatalFailure,
+                                     "foo/bar.cc", 5, "Fatal failure!");
+  const TestPartResult other_failure(TestPartResult::kNonFatalFailure,
+                                     "foo/bar.cc", 6, "Other failure!");
+  EXPECT_TRUE(TestResultAccessor::AddTestPartResult(&test_result, failure));
+  EXPECT_TRUE(TestResultAccessor::AddTestPartResult(&test_result, failure));
+  for (int i = 0; i < 1000; i++)
+    EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result, failure));
+
+  // Failures at a new location or of a new type are only counted.
+  EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                     other_failure));
+  EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                     fatal_failure));
+  EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                     fatal_failure));
+
+  ASSERT_EQ(2, test_result.total_part_count());
+  EXPECT_EQ(0, test_result.GetTestPartRepeatCount(0));
+  EXPECT_EQ(1000, test_result.GetTestPartRepeatCount(1));
+  EXPECT_EQ(3, test_result.omitted_failure_count());
+  EXPECT_TRUE(test_result.HasFatalFailure());
+  EXPECT_TRUE(test_result.HasNonfatalFailure());
+
+  TestResultAccessor::ClearTestPartResults(&test_result);
+  EXPECT_EQ(0, test_result.total_part_count());
+  EXPECT_EQ(0, test_result.omitted_failure_count());
+  EXPECT_FALSE(test_result.Failed());
+}
+
+// Tests that a test whose only failures were omitted still fails.
+TEST(TestResultFloodControlTest, OmittedFailuresFailTheTest) {
+  GTEST_FLAG(max_failures_per_test) = 1;
+  TestResult test_result;
+  const TestPartResult success(TestPartResult::kSuccess,
+                               "foo/bar.cc", 4, "");
+  const TestPartResult fatal_failure(TestPartResult::kFatalFailure,
+                                     "foo/bar.cc", 5, "Fatal failure!");
+  EXPECT_TRUE(TestResultAccessor::AddTestPartResult(&test_result, success));
+  EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                     fatal_failure));
+  EXPECT_EQ(1, test_result.total_part_count());
+  EXPECT_EQ(1, test_result.omitted_failure_count());
+  EXPECT_TRUE(test_result.Failed());
+  EXPECT_TRUE(test_result.HasFatalFailure());
+  EXPECT_FALSE(test_result.HasNonfatalFailure());
+}
+
+// Tests that the repeats are counted for the right failure when many
+// distinct failures have been recorded.
+TEST(TestResultFloodControlTest, FindsIdenticalFailuresAmongMany) {
+  GTEST_FLAG(max_failures_per_test) = 500;
+  TestResult test_result;
+  for (int line = 1; line <= 500; line++) {
+    const TestPartResult failure(
+        line % 2 == 0 ? TestPartResult::kNonFatalFailure :
+        TestPartResult::kFatalFailure,
+        line % 3 == 0 ? "foo/bar.cc" : "foo/baz.cc", line, "Failure!");
+    EXPECT_TRUE(TestResultAccessor::AddTestPartResult(&test_result, failure));
+  }
+  for (int line = 1; line <= 500; line++) {
+    const TestPartResult failure(
+        line % 2 == 0 ? TestPartResult::kNonFatalFailure :
+        TestPartResult::kFatalFailure,
+        line % 3 == 0 ? "foo/bar.cc" : "foo/baz.cc", line, "Failure!");
+    for (int i = 0; i < line % 4; i++) {
+      EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                         failure));
+    }
+  }
+  // Same line, other file.
+  const TestPartResult other_file(TestPartResult::kNonFatalFailure,
+                                  "foo/qux.cc", 2, "Failure!");
+  EXPECT_FALSE(TestResultAccessor::AddTestPartResult(&test_result,
+                                                     other_file));
+
+  ASSERT_EQ(500, test_result.total_part_count());
+  for (int i = 0; i < 500; i++)
+    EXPECT_EQ((i + 1) % 4, test_result.GetTestPartRepeatCount(i));
+  EXPECT_EQ(1, test_result.omitted_failure_count());
+}
+
+// Tests FormatRepeatedFailureNote().
+TEST(FormatRepeatedFailureNoteTest, FormatsCountWithThousandsSeparators) {
+  EXPECT_STREQ("... and 1 more identical failure",
+               FormatRepeatedFailureNote(1).c_str());
+  EXPECT_STREQ("... and 999 more identical failures",
+               FormatRepeatedFailureNote(999).c_str());
+  EXPECT_STREQ("... and 1,000 more identical failures",
+               FormatRepeatedFailureNote(1000).c_str());
+  EXPECT_STREQ("... and 9,999,990 more identical failures",
+               FormatRepeatedFailureNote(9999990).c_str());
+}
+
+// Tests FormatOmittedFailureNote().
+TEST(FormatOmittedFailureNoteTest, FormatsCountWithThousandsSeparators) {
+  EXPECT_STREQ("... and 1 more failure",
+               FormatOmittedFailureNote(1).c_str());
+  EXPECT_STREQ("... and 1,000 more failures",
+               FormatOmittedFailureNote(1000).c_str());
+}
+
 // Tests TestResult has no properties when none are added.
 TEST(TestResultPropertyTest, NoPropertiesFoundWhenNoneAreAdded) {
   TestResult test_result;
@@ -1732,6 +2363,24 @@ TEST(TestResultPropertyTest, AddFailureWhenUsingReservedKeyCalledClassname) {
   ExpectNonFatalFailureRecordingPropertyWithReservedKey("classname");
 }
 
+// Attempting to record a property named after a phase time, which the
+// XML output writes as an attribute of the testcase tag, should fail.
+TEST(TestResultPropertyTest, AddFailureWhenUsingReservedPhaseTimeKeys) {
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("constructor_time");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("set_up_time");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("test_body_time");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("tear_down_time");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("destructor_time");
+}
+
+// Attempting to record a property named after a heap usage attribute of
+// the testcase tag should fail.
+TEST(TestResultPropertyTest, AddFailureWhenUsingReservedHeapUsageKeys) {
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("heap_peak_bytes");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("heap_growth_bytes");
+  ExpectNonFatalFailureRecordingPropertyWithReservedKey("heap_allocations");
+}
+
 // Tests that GTestFlagSaver works on Windows and Mac.
 
 class GTestFlagSaverTest : public Test {
@@ -1747,16 +2396,20 @@ class GTestFlagSaverTest : public Test {
     GTEST_FLAG(catch_exceptions) = false;
     GTEST_FLAG(death_test_use_fork) = false;
     GTEST_FLAG(color) = "auto";
+    GTEST_FLAG(fail_on_leak_bytes) = -1;
     GTEST_FLAG(filter) = "";
     GTEST_FLAG(list_tests) = false;
+    GTEST_FLAG(max_failures_per_test) = 0;
     GTEST_FLAG(output) = "";
     GTEST_FLAG(print_time) = true;
     GTEST_FLAG(random_seed) = 0;
     GTEST_FLAG(repeat) = 1;
     GTEST_FLAG(shuffle) = false;
     GTEST_FLAG(stack_trace_depth) = kMaxStackTraceDepth;
+    GTEST_FLAG(startup_profile) = false;
     GTEST_FLAG(stream_result_to) = "";
     GTEST_FLAG(throw_on_failure) = false;
+    GTEST_FLAG(update_golden_files) = false;
   }
 
   // Restores the Google Test flags that the tests have modified.  This will
@@ -1774,32 +2427,40 @@ class GTestFlagSaverTest : public Test {
     EXPECT_FALSE(GTEST_FLAG(catch_exceptions));
     EXPECT_STREQ("auto", GTEST_FLAG(color).c_str());
     EXPECT_FALSE(GTEST_FLAG(death_test_use_fork));
+    EXPECT_EQ(-1, GTEST_FLAG(fail_on_leak_bytes));
     EXPECT_STREQ("", GTEST_FLAG(filter).c_str());
     EXPECT_FALSE(GTEST_FLAG(list_tests));
+    EXPECT_EQ(0, GTEST_FLAG(max_failures_per_test));
     EXPECT_STREQ("", GTEST_FLAG(output).c_str());
     EXPECT_TRUE(GTEST_FLAG(print_time));
     EXPECT_EQ(0, GTEST_FLAG(random_seed));
     EXPECT_EQ(1, GTEST_FLAG(repeat));
     EXPECT_FALSE(GTEST_FLAG(shuffle));
     EXPECT_EQ(kMaxStackTraceDepth, GTEST_FLAG(stack_trace_depth));
+    EXPECT_FALSE(GTEST_FLAG(startup_profile));
     EXPECT_STREQ("", GTEST_FLAG(stream_result_to).c_str());
     EXPECT_FALSE(GTEST_FLAG(throw_on_failure));
+    EXPECT_FALSE(GTEST_FLAG(update_golden_files));
 
     GTEST_FLAG(also_run_disabled_tests) = true;
     GTEST_FLAG(break_on_failure) = true;
     GTEST_FLAG(catch_exceptions) = true;
     GTEST_FLAG(color) = "no";
     GTEST_FLAG(death_test_use_fork) = true;
+    GTEST_FLAG(fail_on_leak_bytes) = 100;
     GTEST_FLAG(filter) = "abc";
     GTEST_FLAG(list_tests) = true;
+    GTEST_FLAG(max_failures_per_test) = 10;
     GTEST_FLAG(output) = "xml:foo.xml";
     GTEST_FLAG(print_time) = false;
     GTEST_FLAG(random_seed) = 1;
     GTEST_FLAG(repeat) = 100;
     GTEST_FLAG(shuffle) = true;
     GTEST_FLAG(stack_trace_depth) = 1;
+    GTEST_FLAG(startup_profile) = true;
     GTEST_FLAG(stream_result_to) = "localhost:1234";
     GTEST_FLAG(throw_on_failure) = true;
+    GTEST_FLAG(update_golden_files) = true;
   }
  private:
   // For saving Google Test flags during this test case.
@@ -1993,6 +2654,37 @@ TEST(Int32FromEnvOrDieDeathTest, AbortsOnInt32Overflow) {
       ".*");
 }
 
+// Tests that SplitFilter() splits a filter at its first '-'.
+TEST(SplitFilterTest, SplitsAtFirstDash) {
+  String positive;
+  const char* negative = NULL;
+
+  UnitTestOptions::SplitFilter("Foo.*:Bar.*", &positive, &negative);
+  EXPECT_STREQ("Foo.*:Bar.*", positive.c_str());
+  EXPECT_STREQ("", negative);
+
+  UnitTestOptions::SplitFilter("Foo.*-Foo.Bar:Foo.Baz-Qux", &positive,
+                               &negative);
+  EXPECT_STREQ("Foo.*", positive.c_str());
+  EXPECT_STREQ("Foo.Bar:Foo.Baz-Qux", negative);
+
+  // An empty positive part selects all tests.
+  UnitTestOptions::SplitFilter("-Foo.Bar", &positive, &negative);
+  EXPECT_STREQ("*", positive.c_str());
+  EXPECT_STREQ("Foo.Bar", negative);
+}
+
+// Tests that FullNameMatchesFilter() requires a positive pattern to
+// match and no negative pattern to match.
+TEST(FullNameMatchesFilterTest, HonorsPositiveAndNegativePatterns) {
+  EXPECT_TRUE(UnitTestOptions::FullNameMatchesFilter("Foo.Bar", "Foo.*", ""));
+  EXPECT_TRUE(UnitTestOptions::FullNameMatchesFilter("Foo.Bar", "Baz.*:Foo.*",
+                                                     "Foo.Baz"));
+  EXPECT_FALSE(UnitTestOptions::FullNameMatchesFilter("Foo.Bar", "Baz.*", ""));
+  EXPECT_FALSE(UnitTestOptions::FullNameMatchesFilter("Foo.Bar", "*",
+                                                      "Foo.Baz:*.Bar"));
+}
+
 // Tests that ShouldRunTestOnShard() selects all tests
 // where there is 1 shard.
 TEST(ShouldRunTestOnShardTest, IsPartitionWhenThereIsOneShard) {
@@ -2563,6 +3255,228 @@ TEST(StringAssertionTest, STRNE_Wide) {
                           "abc");
 }
 
+// Tests for {ASSERT|EXPECT}_BUFFER_EQ and {ASSERT|EXPECT}_ARRAYS_EQ.
+
+TEST(BufferEqTest, SucceedsForEqualBuffers) {
+  ::std::vector<unsigned char> a(10000), b(10000);
+  for (size_t i = 0; i != a.size(); i++) {
+    a[i] = b[i] = static_cast<unsigned char>(i % 251);
+  }
+  EXPECT_BUFFER_EQ(&a[0], &b[0], a.size());
+  ASSERT_BUFFER_EQ(&a[0], &b[0], a.size());
+}
+
+TEST(BufferEqTest, SucceedsForEmptyBuffers) {
+  EXPECT_BUFFER_EQ(NULL, NULL, 0);
+  EXPECT_BUFFER_EQ("a", "b", 0);
+}
+
+static unsigned char buffer_eq_expected[100];
+static unsigned char buffer_eq_actual[100];
+
+TEST(BufferEqTest, ReportsMismatchCountAndFirstOffset) {
+  memset(buffer_eq_actual, 0, sizeof(buffer_eq_actual));
+  buffer_eq_actual[40] = 0xAB;
+  buffer_eq_actual[90] = 0xCD;
+
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_BUFFER_EQ(buffer_eq_expected, buffer_eq_actual, 100),
+      "2 of 100 bytes differ, the first at offset 40");
+  EXPECT_FATAL_FAILURE(
+      ASSERT_BUFFER_EQ(buffer_eq_expected, buffer_eq_actual,
+                       sizeof(buffer_eq_actual)),
+      "2 of sizeof(buffer_eq_actual) (100) bytes differ");
+}
+
+TEST(BufferEqTest, PrintsBytesAroundFirstMismatch) {
+  memset(buffer_eq_actual, 0, sizeof(buffer_eq_actual));
+  buffer_eq_actual[40] = 0xAB;
+
+  // The dump covers the 16-byte rows before, at and after offset 40.
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_BUFFER_EQ(buffer_eq_expected, buffer_eq_actual, 100),
+      "Expected bytes at offset 16: 48-byte object <00-00 00-00");
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_BUFFER_EQ(buffer_eq_expected, buffer_eq_actual, 100),
+      "  Actual bytes at offset 16: 48-byte object <00-00 00-00 00-00 "
+      "00-00 00-00 00-00 00-00 00-00 00-00 00-00 00-00 00-00 AB-00 ");
+
+  // The dump is clipped to the buffers.
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_BUFFER_EQ(buffer_eq_expected, buffer_eq_actual, 42),
+      "Expected bytes at offset 16: 26-byte object <");
+}
+
+TEST(ArraysEqTest, SucceedsForEqualArrays) {
+  ::std::vector<int> a(10000), b(10000);
+  for (size_t i = 0; i != a.size(); i++) {
+    a[i] = b[i] = static_cast<int>(i);
+  }
+  EXPECT_ARRAYS_EQ(&a[0], &b[0], a.size());
+  ASSERT_ARRAYS_EQ(&a[0], &b[0], a.size());
+
+  const double c[] = {0.5, -0.0, 1e300};
+  const double d[] = {0.5, 0.0, 1e300};
+  EXPECT_ARRAYS_EQ(c, d, 3);
+}
+
+static const int arrays_eq_expected[] = {1, 2, 3, 4, 5};
+static const int arrays_eq_actual[] = {1, 2, 7, 4, 9};
+
+TEST(ArraysEqTest, ReportsMismatchCountAndFirstElement) {
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_ARRAYS_EQ(arrays_eq_expected, arrays_eq_actual, 5),
+      "Value of: arrays_eq_actual\n"
+      "Expected: arrays_eq_expected\n"
+      "2 of 5 elements differ, the first at index 2\n"
+      "  Actual: 7\n"
+      "Expected: 3\n"
+      "Expected bytes at offset 0: 20-byte object <");
+  EXPECT_FATAL_FAILURE(
+      ASSERT_ARRAYS_EQ(arrays_eq_expected, arrays_eq_actual, 5),
+      "2 of 5 elements differ");
+}
+
+TEST(ArraysEqTest, PrintsElementsAroundFirstMismatchOfNonPlainElements) {
+  const ::std::string expected[] = {"a", "b", "c", "d", "e", "f"};
+  const ::std::string actual[] = {"a", "b", "c", "x", "e", "f"};
+
+  // The elements are printed, not the bytes of the strings.
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_ARRAYS_EQ(expected, actual, 6),
+      "1 of 6 elements differ, the first at index 3\n"
+      "  Actual: \"x\"\n"
+      "Expected: \"d\"\n"
+      "Expected elements at index 1: "
+      "{ \"b\", \"c\", \"d\", \"e\", \"f\" }\n"
+      "  Actual elements at index 1: "
+      "{ \"b\", \"c\", \"x\", \"e\", \"f\" }");
+
+  // The printed elements are clipped to the arrays.
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_ARRAYS_EQ(expected, actual, 4),
+      "Expected elements at index 1: { \"b\", \"c\", \"d\" }");
+}
+
+TEST(ArraysEqTest, UsesEqualityOperator) {
+  static const double nans[] = {0.0, std::numeric_limits<double>::quiet_NaN()};
+  EXPECT_NONFATAL_FAILURE(EXPECT_ARRAYS_EQ(nans, nans, 2),
+                          "1 of 2 elements differ, the first at index 1");
+}
+
+// Tests {ASSERT|EXPECT}_MATCHES_GOLDEN_FILE.
+
+class GoldenFileTest : public Test {
+ protected:
+  GoldenFileTest()
+      : directory_(String::Format("%s%s_golden" GTEST_PATH_SEP_,
+                                  TempDir().c_str(),
+                                  GetCurrentExecutableName().c_str())),
+        golden_(FilePath::ConcatPaths(directory_, FilePath("test.golden"))) {}
+
+  virtual void SetUp() { RemoveGoldenFile(); }
+  virtual void TearDown() { RemoveGoldenFile(); }
+
+  static String TempDir() {
+#if GTEST_OS_WINDOWS_MOBILE
+    return String("\\temp\\");
+#elif GTEST_OS_WINDOWS
+    const char* const temp_dir = testing::internal::posix::GetEnv("TEMP");
+    return temp_dir == NULL || temp_dir[0] == '\0' ?
+        String("\\temp\\") : String::Format("%s\\", temp_dir);
+#else
+    return String("/tmp/");
+#endif  // GTEST_OS_WINDOWS_MOBILE
+  }
+
+  // Returns count lines of the form "line 00042\n".
+  static ::std::string MakeLines(int count) {
+    ::std::string lines;
+    for (int i = 0; i < count; i++) {
+      lines += String::Format("line %05d\n", i).c_str();
+    }
+    return lines;
+  }
+
+  void WriteGoldenFile(const ::std::string& contents) {
+    ASSERT_TRUE(directory_.CreateDirectoriesRecursively());
+    ASSERT_TRUE(golden_.WriteFileAtomically(contents.data(), contents.size()));
+  }
+
+  void RemoveGoldenFile() {
+    remove(golden_.c_str());
+    testing::internal::posix::RmDir(directory_.c_str());
+  }
+
+  const FilePath directory_;
+  const FilePath golden_;
+  GTestFlagSaver saver_;
+};
+
+TEST_F(GoldenFileTest, SucceedsForMatchingFile) {
+  const ::std::string data = MakeLines(20000);
+  WriteGoldenFile(data);
+  EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), data);
+  ASSERT_MATCHES_GOLDEN_FILE(::std::string(golden_.c_str()), data);
+
+  WriteGoldenFile("");
+  EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "");
+}
+
+TEST_F(GoldenFileTest, ReportsFirstDifference) {
+  // The data spans several comparison chunks; the difference is in the
+  // third one.
+  const ::std::string golden = MakeLines(20000);
+  ::std::string data = golden;
+  data[15000*11 + 7] = 'X';  // "line 15000" becomes "line 15X00".
+  WriteGoldenFile(golden);
+
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), data),
+      "Value of: data\n  Actual: 220000 bytes\n"
+      "Expected: the contents of golden file ");
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), data),
+      "test.golden (220000 bytes)\n"
+      "The first difference is at offset 165007 (line 15001, column 8)\n"
+      "Expected bytes at offset 164975: \"97\\nline 14998\\nline 14999\\n"
+      "line 15000\\nline 15001\\nline 15002\\nline 1\"\n"
+      "  Actual bytes at offset 164975: \"97\\nline 14998\\nline 14999\\n"
+      "line 15X00\\nline 15001\\nline 15002\\nline 1\"\n"
+      "Run with --gtest_update_golden_files");
+}
+
+TEST_F(GoldenFileTest, ReportsSizeDifference) {
+  WriteGoldenFile("abc\n");
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "abc\nde"),
+      "(4 bytes)\n"
+      "The first difference is at offset 4 (line 2, column 1)\n"
+      "Expected bytes at offset 0: \"abc\\n\"\n"
+      "  Actual bytes at offset 0: \"abc\\nde\"");
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), ""),
+      "The first difference is at offset 0 (line 1, column 1)");
+}
+
+TEST_F(GoldenFileTest, FailsForMissingFile) {
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "abc"),
+      "test.golden: it does not exist.\n"
+      "Run with --gtest_update_golden_files to create it");
+}
+
+TEST_F(GoldenFileTest, UpdatesGoldenFileWhenRequested) {
+  GTEST_FLAG(update_golden_files) = true;
+  EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "new\n");
+  EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "newer\n");
+
+  GTEST_FLAG(update_golden_files) = false;
+  EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "newer\n");
+  EXPECT_NONFATAL_FAILURE(EXPECT_MATCHES_GOLDEN_FILE(golden_.c_str(), "new\n"),
+                          "offset 3");
+}
+
 // Tests for ::testing::IsSubstring().
 
 // Tests that IsSubstring() returns the correct result when the input
@@ -2939,6 +3853,69 @@ TEST_F(FloatTest, FloatLEFails) {
 #endif  // !GTEST_OS_SYMBIAN && !defined(__BORLANDC__)
 }
 
+// Tests that *_FLOAT_ARRAY_EQ succeed when the arrays are pairwise
+// almost equal.
+TEST_F(FloatTest, ArrayEQSucceeds) {
+  const float expected[] = {1.0f, 0.0f, values_.infinity, -2.0f};
+  const float actual[] = {values_.close_to_one, values_.close_to_positive_zero,
+                          values_.close_to_infinity, -2.0f};
+  EXPECT_FLOAT_ARRAY_EQ(expected, actual, 4);
+  ASSERT_FLOAT_ARRAY_EQ(expected, actual, 4);
+  EXPECT_FLOAT_ARRAY_EQ(NULL, NULL, 0);
+}
+
+// Tests that *_FLOAT_ARRAY_EQ report every differing element in one
+// failure.
+TEST_F(FloatTest, ArrayEQFails) {
+  static float expected[3];
+  static float actual[3];
+  expected[0] = expected[1] = expected[2] = 1.0f;
+  actual[0] = 1.0f;
+  actual[1] = values_.further_from_one;
+  actual[2] = values_.nan1;
+
+  EXPECT_NONFATAL_FAILURE(EXPECT_FLOAT_ARRAY_EQ(expected, actual, 3),
+                          "2 of 3 elements differ by more than 4 ULP's\n"
+                          "The largest difference is NaN at index 2");
+  EXPECT_FATAL_FAILURE(ASSERT_FLOAT_ARRAY_EQ(expected, actual, 3),
+                          "The differing elements are:\n"
+                          "  index 1: expected 1, actual 1.0000");
+}
+
+// Tests *_FLOAT_ARRAY_NEAR.
+TEST_F(FloatTest, ArrayNear) {
+  static const float expected[] = {1.0f, 2.0f, -3.0f};
+  static const float actual[] = {1.0625f, 1.9375f, -3.0f};
+  EXPECT_FLOAT_ARRAY_NEAR(expected, actual, 3, 0.125f);
+  ASSERT_FLOAT_ARRAY_NEAR(expected, actual, 3, 0.125f);
+
+  EXPECT_NONFATAL_FAILURE(EXPECT_FLOAT_ARRAY_NEAR(expected, actual, 3, 0.0f),
+                          "2 of 3 elements differ by more than 0.0f (0)\n"
+                          "The largest difference is 0.0625 at index 0");
+  EXPECT_FATAL_FAILURE(ASSERT_FLOAT_ARRAY_NEAR(expected, actual, 3, 0.0f),
+                       "2 of 3 elements differ");
+}
+
+// Tests *_FLOAT_ARRAY_NEAR_ULPS.
+TEST_F(FloatTest, ArrayNearUlps) {
+  static float expected[3];
+  static float actual[3];
+  expected[0] = expected[1] = expected[2] = 1.0f;
+  actual[0] = 1.0f;
+  actual[1] = values_.close_to_one;
+  actual[2] = values_.further_from_one;
+  const size_t max_ulps = FloatingPoint<float>::kMaxUlps + 1;
+  EXPECT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, 3, max_ulps);
+  ASSERT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, 3, max_ulps);
+
+  EXPECT_NONFATAL_FAILURE(EXPECT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, 3, 0),
+                          "2 of 3 elements differ by more than 0 ULP's\n"
+                          "The largest difference is 5 ULP's at index 2");
+  EXPECT_FATAL_FAILURE(
+      ASSERT_FLOAT_ARRAY_NEAR_ULPS(expected, actual, 3, max_ulps - 1),
+      "1 of 3 elements differ by more than max_ulps - 1 (4) ULP's");
+}
+
 // Instantiates FloatingPointTest for testing *_DOUBLE_EQ.
 typedef FloatingPointTest<double> DoubleTest;
 
@@ -3111,6 +4088,70 @@ TEST_F(DoubleTest, DoubleLEFails) {
 #endif  // !GTEST_OS_SYMBIAN && !defined(__BORLANDC__)
 }
 
+// Tests that *_DOUBLE_ARRAY_EQ succeed when the arrays are pairwise
+// almost equal.
+TEST_F(DoubleTest, ArrayEQSucceeds) {
+  const double expected[] = {1.0, 0.0, values_.infinity, -2.0};
+  const double actual[] = {values_.close_to_one, -0.0,
+                           values_.close_to_infinity, -2.0};
+  EXPECT_DOUBLE_ARRAY_EQ(expected, actual, 4);
+  ASSERT_DOUBLE_ARRAY_EQ(expected, actual, 4);
+}
+
+// Tests that *_DOUBLE_ARRAY_EQ fail for NaNs, even if they have the
+// same bits.
+TEST_F(DoubleTest, ArrayEQFailsForNaN) {
+  static double nans[2];
+  nans[0] = 0.0;
+  nans[1] = values_.nan1;
+  EXPECT_NONFATAL_FAILURE(EXPECT_DOUBLE_ARRAY_EQ(nans, nans, 2),
+                          "1 of 2 elements differ");
+  EXPECT_FATAL_FAILURE(ASSERT_DOUBLE_ARRAY_EQ(nans, nans, 2),
+                       "The largest difference is NaN at index 1");
+}
+
+// Tests that *_DOUBLE_ARRAY_NEAR report the largest difference and
+// only the first few differing elements.
+TEST_F(DoubleTest, ArrayNear) {
+  static double expected[100];
+  static double actual[100];
+  for (int i = 0; i < 100; i++) {
+    expected[i] = i;
+    actual[i] = i + (i % 2 == 0 ? 0.0 : 0.5);
+  }
+  EXPECT_DOUBLE_ARRAY_NEAR(expected, actual, 100, 0.5);
+
+  actual[77] = 80;
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_DOUBLE_ARRAY_NEAR(expected, actual, 100, 0.25),
+      "50 of 100 elements differ by more than 0.25\n"
+      "The largest difference is 3 at index 77: expected 77, actual 80\n"
+      "The first differing elements are:\n"
+      "  index 1: expected 1, actual 1.5\n");
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_DOUBLE_ARRAY_NEAR(expected, actual, 100, 0.25),
+      "  index 19: expected 19, actual 19.5");
+  EXPECT_FATAL_FAILURE(ASSERT_DOUBLE_ARRAY_NEAR(expected, actual, 100, 1.0),
+                       "1 of 100 elements differ by more than 1.0 (1)");
+}
+
+// Tests *_DOUBLE_ARRAY_NEAR_ULPS.
+TEST_F(DoubleTest, ArrayNearUlps) {
+  static double expected[2];
+  static double actual[2];
+  expected[0] = expected[1] = 1.0;
+  actual[0] = values_.further_from_one;
+  actual[1] = values_.nan1;
+  EXPECT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, 1, 5);
+  ASSERT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, 1, 5);
+
+  EXPECT_NONFATAL_FAILURE(EXPECT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, 2, 5),
+                          "1 of 2 elements differ by more than 5 ULP's\n"
+                          "The largest difference is NaN at index 1");
+  EXPECT_FATAL_FAILURE(ASSERT_DOUBLE_ARRAY_NEAR_ULPS(expected, actual, 1, 4),
+                       "1 of 1 elements differ by more than 4 ULP's");
+}
+
 
 // Verifies that a test or test case whose name starts with DISABLED_ is
 // not run.
@@ -3522,6 +4563,287 @@ TEST(AssertionTest, EqFailure) {
       msg5.c_str());
 }
 
+// Tests that a failed EXPECT_STREQ appends a diff of the lines of the
+// strings when either spans several lines.
+TEST(AssertionTest, StrEqFailureWithDiff) {
+  const char* const left =
+      "1\n2XXX\n3\n5\n6\n7\n8\n9\n10\n11\n12XXX\n13\n14\n15";
+  const char* const right = "1\n2\n3\n4\n5\n6\n7\n8\n9\n11\n12\n13\n14";
+  const String msg(
+      CmpHelperSTREQ("left", "right", left, right).failure_message());
+  EXPECT_STREQ(
+      "Value of: right\n"
+      "  Actual: \"1\n2\n3\n4\n5\n6\n7\n8\n9\n11\n12\n13\n14\"\n"
+      "Expected: left\n"
+      "Which is: "
+      "\"1\n2XXX\n3\n5\n6\n7\n8\n9\n10\n11\n12XXX\n13\n14\n15\"\n"
+      "With diff:\n"
+      "@@ -1,5 +1,6 @@\n"
+      " 1\n"
+      "-2XXX\n"
+      "+2\n"
+      " 3\n"
+      "+4\n"
+      " 5\n"
+      " 6\n"
+      "@@ -7,8 +8,6 @@\n"
+      " 8\n"
+      " 9\n"
+      "-10\n"
+      " 11\n"
+      "-12XXX\n"
+      "+12\n"
+      " 13\n"
+      " 14\n"
+      "-15\n",
+      msg.c_str());
+}
+
+// Tests that EXPECT_EQ diffs multi-line strings, and vectors and other
+// containers element by element.
+TEST(AssertionTest, EqFailureDiffsStringsAndContainers) {
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_EQ(::std::string("a\nb\nc"), ::std::string("a\nx\nc")),
+      "With diff:\n@@ -1,3 +1,3 @@\n a\n-b\n+x\n c\n");
+  EXPECT_NONFATAL_FAILURE(EXPECT_STREQ("a\nb", "a\nc"),
+                          "With diff:\n@@ -1,2 +1,2 @@\n a\n-b\n+c\n");
+
+  static ::std::vector<int> expected, actual;
+  expected.clear();
+  for (int i = 0; i < 100000; i++)
+    expected.push_back(i);
+  actual = expected;
+  actual[50000] = -1;
+  EXPECT_NONFATAL_FAILURE(EXPECT_EQ(expected, actual),
+                          "With diff:\n"
+                          "@@ -49999,5 +49999,5 @@\n"
+                          " 49998\n"
+                          " 49999\n"
+                          "-50000\n"
+                          "+-1\n"
+                          " 50001\n"
+                          " 50002\n");
+
+  actual = expected;
+  actual.push_back(7);
+  EXPECT_FATAL_FAILURE(ASSERT_EQ(expected, actual),
+                       "@@ -99999,2 +99999,3 @@\n"
+                       " 99998\n"
+                       " 99999\n"
+                       "+7\n");
+
+  static ::std::map<int, char> expected_map, actual_map;
+  expected_map[1] = 'a';
+  expected_map[2] = 'b';
+  actual_map = expected_map;
+  actual_map[3] = 'c';
+  EXPECT_NONFATAL_FAILURE(EXPECT_EQ(expected_map, actual_map),
+                          "With diff:\n"
+                          "@@ -1,2 +1,3 @@\n"
+                          " (1, 'a' (97, 0x61))\n"
+                          " (2, 'b' (98, 0x62))\n"
+                          "+(3, 'c' (99, 0x63))\n");
+}
+
+// Tests that EqFailure() itself doesn't diff the printed values, so that
+// a container of multi-line strings gets only the diff of its elements.
+TEST(AssertionTest, EqFailureDiffsContainersOfStringsOnce) {
+  const ::std::vector< ::std::string> expected(1, "x\ny");
+  const ::std::vector< ::std::string> actual(1, "x\nz");
+  const String msg(
+      CmpHelperEQ("expected", "actual", expected, actual).failure_message());
+  EXPECT_STREQ(
+      "Value of: actual\n"
+      "  Actual: { \"x\\nz\" }\n"
+      "Expected: expected\n"
+      "Which is: { \"x\\ny\" }\n"
+      "With diff:\n"
+      "@@ -1,1 +1,1 @@\n"
+      "-\"x\\ny\"\n"
+      "+\"x\\nz\"\n",
+      msg.c_str());
+}
+
+// Tests that wide strings are diffed line by line without their L"
+// quoting.
+TEST(AssertionTest, WideStringEqFailureWithDiff) {
+#if GTEST_HAS_STD_WSTRING
+  EXPECT_NONFATAL_FAILURE(
+      EXPECT_EQ(::std::wstring(L"a\nb"), ::std::wstring(L"a\nc")),
+      "With diff:\n@@ -1,2 +1,2 @@\n a\n-b\n+c\n");
+#endif  // GTEST_HAS_STD_WSTRING
+  EXPECT_NONFATAL_FAILURE(EXPECT_STREQ(L"a\nb", L"a\nc"),
+                          "With diff:\n@@ -1,2 +1,2 @@\n a\n-b\n+c\n");
+}
+
+// Tests that the diff of two entirely different large vectors is
+// reported quickly and cut short.
+TEST(AssertionTest, EqFailureDiffIsBounded) {
+  static ::std::vector<int> expected, actual;
+  expected.clear();
+  actual.clear();
+  for (int i = 0; i < 100000; i++) {
+    expected.push_back(i);
+    actual.push_back(-i - 1);
+  }
+  EXPECT_NONFATAL_FAILURE(EXPECT_EQ(expected, actual),
+                          "(only 10000 elements were compared)");
+  EXPECT_NONFATAL_FAILURE(EXPECT_EQ(expected, actual),
+                          "more lines of diff not shown)");
+}
+
+namespace edit_distance_test {
+
+using testing::internal::edit_distance::CalculateOptimalEdits;
+using testing::internal::edit_distance::CreateUnifiedDiff;
+using testing::internal::edit_distance::EditType;
+using testing::internal::edit_distance::kAdd;
+using testing::internal::edit_distance::kMatch;
+using testing::internal::edit_distance::kRemove;
+
+// Returns the sequence of ids spelled by a string, for brevity.
+::std::vector<size_t> Ids(const char* str) {
+  return ::std::vector<size_t>(str, str + strlen(str));
+}
+
+// Returns the number of edits of a shortest edit script with only
+// adds and removes, computed the slow and simple way.
+size_t EditDistance(const ::std::vector<size_t>& left,
+                    const ::std::vector<size_t>& right) {
+  ::std::vector< ::std::vector<size_t> > costs(
+      left.size() + 1, ::std::vector<size_t>(right.size() + 1));
+  for (size_t i = 0; i <= left.size(); i++) {
+    for (size_t j = 0; j <= right.size(); j++) {
+      if (i == 0 || j == 0) {
+        costs[i][j] = i + j;
+      } else if (left[i - 1] == right[j - 1]) {
+        costs[i][j] = costs[i - 1][j - 1];
+      } else {
+        costs[i][j] = 1 + ::std::min(costs[i - 1][j], costs[i][j - 1]);
+      }
+    }
+  }
+  return costs[left.size()][right.size()];
+}
+
+// Returns true iff 'edits' turns 'left' into 'right'.  Stores the
+// number of adds and removes in *cost.
+bool IsEditScript(const ::std::vector<EditType>& edits,
+                  const ::std::vector<size_t>& left,
+                  const ::std::vector<size_t>& right,
+                  size_t* cost) {
+  size_t l = 0, r = 0;
+  *cost = 0;
+  for (size_t i = 0; i != edits.size(); i++) {
+    if (edits[i] == kMatch) {
+      if (l == left.size() || r == right.size() || left[l] != right[r])
+        return false;
+      l++;
+      r++;
+    } else if (edits[i] == kRemove) {
+      if (l++ == left.size())
+        return false;
+      ++*cost;
+    } else {
+      if (r++ == right.size())
+        return false;
+      ++*cost;
+    }
+  }
+  return l == left.size() && r == right.size();
+}
+
+TEST(EditDistanceTest, HandlesTrivialInputs) {
+  size_t cost = 0;
+  EXPECT_TRUE(CalculateOptimalEdits(Ids(""), Ids("")).empty());
+  EXPECT_TRUE(IsEditScript(CalculateOptimalEdits(Ids("abc"), Ids("abc")),
+                           Ids("abc"), Ids("abc"), &cost));
+  EXPECT_EQ(0u, cost);
+  EXPECT_TRUE(IsEditScript(CalculateOptimalEdits(Ids(""), Ids("ab")),
+                           Ids(""), Ids("ab"), &cost));
+  EXPECT_EQ(2u, cost);
+  EXPECT_TRUE(IsEditScript(CalculateOptimalEdits(Ids("ab"), Ids("")),
+                           Ids("ab"), Ids(""), &cost));
+  EXPECT_EQ(2u, cost);
+}
+
+TEST(EditDistanceTest, FindsShortestEditScripts) {
+  const char* const kCases[][2] = {
+    {"abcabba", "cbabac"},
+    {"xaxcxabc", "abcy"},
+    {"abcdefgh", "axcyegzh"},
+    {"aaaaaaaa", "aaaba"},
+    {"abcd", "dcba"},
+  };
+  for (size_t i = 0; i != sizeof(kCases)/sizeof(kCases[0]); i++) {
+    const ::std::vector<size_t> left = Ids(kCases[i][0]);
+    const ::std::vector<size_t> right = Ids(kCases[i][1]);
+    size_t cost = 0;
+    EXPECT_TRUE(IsEditScript(CalculateOptimalEdits(left, right),
+                             left, right, &cost)) << kCases[i][0];
+    EXPECT_EQ(EditDistance(left, right), cost) << kCases[i][0];
+  }
+
+  // Random sequences over small alphabets have many equal elements,
+  // which exercises the search for the middle snake.
+  testing::internal::Random random(42);
+  for (int i = 0; i < 500; i++) {
+    ::std::vector<size_t> left(random.Generate(30)), right(random.Generate(30));
+    const size_t alphabet = 1 + random.Generate(4);
+    for (size_t j = 0; j != left.size(); j++)
+      left[j] = random.Generate(alphabet);
+    for (size_t j = 0; j != right.size(); j++)
+      right[j] = random.Generate(alphabet);
+
+    size_t cost = 0;
+    ASSERT_TRUE(IsEditScript(CalculateOptimalEdits(left, right),
+                             left, right, &cost));
+    ASSERT_EQ(EditDistance(left, right), cost);
+  }
+}
+
+TEST(EditDistanceTest, GivesUpGracefullyWhenOverBudget) {
+  ::std::vector<size_t> left, right;
+  for (size_t i = 0; i < 100000; i++) {
+    left.push_back(i % 7);
+    right.push_back(i % 11);
+  }
+  size_t cost = 0;
+  EXPECT_TRUE(IsEditScript(CalculateOptimalEdits(left, right, 1000),
+                           left, right, &cost));
+  EXPECT_LE(cost, left.size() + right.size());
+}
+
+TEST(EditDistanceTest, CreatesUnifiedDiffWithContext) {
+  ::std::vector< ::std::string> left, right;
+  for (int i = 1; i <= 20; i++) {
+    left.push_back(StreamableToString(i).c_str());
+    right.push_back(StreamableToString(i).c_str());
+  }
+  right[4] = "five";
+  right.erase(right.begin() + 15);
+
+  EXPECT_STREQ("@@ -4,3 +4,3 @@\n"
+               " 4\n"
+               "-5\n"
+               "+five\n"
+               " 6\n"
+               "@@ -15,3 +15,2 @@\n"
+               " 15\n"
+               "-16\n"
+               " 17\n",
+               CreateUnifiedDiff(left, right, 1).c_str());
+  EXPECT_STREQ("@@ -14,1 +13,0 @@\n"
+               "-16\n",
+               CreateUnifiedDiff(::std::vector< ::std::string>(
+                                     left.begin() + 15, left.begin() + 16),
+                                 ::std::vector< ::std::string>(),
+                                 0, 14).c_str());
+  EXPECT_STREQ("", CreateUnifiedDiff(left, left).c_str());
+}
+
+}  // namespace edit_distance_test
+
 // Tests AppendUserMessage(), used for implementing the *EQ* macros.
 TEST(AssertionTest, AppendUserMessage) {
   const String foo("foo");
@@ -5125,6 +6447,16 @@ TEST_F(TestInfoTest, Names) {
   ASSERT_STREQ("Names", test_info->name());
 }
 
+// Tests that the tests of a test case share its name.
+TEST_F(TestInfoTest, SharesTheTestCaseName) {
+  const TestInfo* const names = GetTestInfo("Names");
+  const TestInfo* const result = GetTestInfo("result");
+
+  EXPECT_EQ(names->test_case_name(), result->test_case_name());
+  EXPECT_EQ(UnitTest::GetInstance()->current_test_case()->name(),
+            names->test_case_name());
+}
+
 // Tests TestInfo::result().
 TEST_F(TestInfoTest, result) {
   const TestInfo* const test_info = GetTestInfo("result");
@@ -5199,6 +6531,94 @@ TEST_F(SetUpTestCaseTest, Test2) {
   EXPECT_STREQ("123", shared_resource_);
 }
 
+// Tests timing the phases of running a test.
+
+// Busy-waits for at least the given number of nanoseconds.
+static void SpinForNanos(Int64 nanos) {
+  const Int64 start = LatencyRecorder::NowNanos();
+  while (LatencyRecorder::NowNanos() - start < nanos) {}
+}
+
+const Int64 kPhaseNanos = 2000000;
+
+class PhaseTimingTest : public Test {
+ protected:
+  static void SetUpTestCase() { SpinForNanos(kPhaseNanos); }
+
+  PhaseTimingTest() { SpinForNanos(kPhaseNanos); }
+
+  virtual void SetUp() { SpinForNanos(2 * kPhaseNanos); }
+};
+
+TEST_F(PhaseTimingTest, SpendsTimeInEachPhase) {
+  SpinForNanos(3 * kPhaseNanos);
+}
+
+// The phase times of a test are only complete once it has finished, so
+// this checks the result of the previous test.
+TEST_F(PhaseTimingTest, RecordsThePhaseTimesOfThePreviousTest) {
+  const TestCase* const test_case = UnitTest::GetInstance()->current_test_case();
+  EXPECT_LE(kPhaseNanos, test_case->set_up_time_nanos());
+
+  const TestResult& previous = *test_case->GetTestInfo(0)->result();
+  EXPECT_LE(kPhaseNanos,
+            previous.phase_time_nanos(TestResult::kConstructorPhase));
+  EXPECT_LE(2 * kPhaseNanos,
+            previous.phase_time_nanos(TestResult::kSetUpPhase));
+  EXPECT_LE(3 * kPhaseNanos,
+            previous.phase_time_nanos(TestResult::kTestBodyPhase));
+  EXPECT_LE(0, previous.phase_time_nanos(TestResult::kTearDownPhase));
+  EXPECT_LE(0, previous.phase_time_nanos(TestResult::kDestructorPhase));
+}
+
+// Tests StartupProfile.
+
+TEST(StartupProfileTest, ChargesNestedStagesSeparately) {
+  StartupProfile profile;
+  EXPECT_FALSE(profile.in_stage());
+
+  const StartupStage outer_paused_stage =
+      profile.BeginStage(kPostFlagParsingInitStage);
+  EXPECT_EQ(kStartupStageCount, outer_paused_stage);
+  SpinForNanos(kPhaseNanos);
+  const StartupStage inner_paused_stage =
+      profile.BeginStage(kListenerSetUpStage);
+  EXPECT_EQ(kPostFlagParsingInitStage, inner_paused_stage);
+  SpinForNanos(2 * kPhaseNanos);
+  profile.EndStage(inner_paused_stage);
+  profile.EndStage(outer_paused_stage);
+
+  EXPECT_FALSE(profile.in_stage());
+  EXPECT_LE(kPhaseNanos, profile.nanos(kPostFlagParsingInitStage));
+  EXPECT_LE(2 * kPhaseNanos, profile.nanos(kListenerSetUpStage));
+  EXPECT_EQ(1, profile.call_count(kPostFlagParsingInitStage));
+  EXPECT_EQ(1, profile.call_count(kListenerSetUpStage));
+  EXPECT_EQ(0, profile.nanos(kFlagParsingStage));
+  EXPECT_EQ(0, profile.call_count(kFlagParsingStage));
+}
+
+TEST(StartupProfileTest, FormatsEveryStage) {
+  const StartupProfile profile;
+  const String table = profile.Format();
+  EXPECT_PRED_FORMAT2(IsSubstring, "static test registration", table.c_str());
+  EXPECT_PRED_FORMAT2(IsSubstring, "test filtering", table.c_str());
+  EXPECT_PRED_FORMAT2(IsSubstring, "total", table.c_str());
+}
+
+// Static test registration is only timed when GTEST_STARTUP_PROFILE
+// asks for it, so that registering tests doesn't read the clock and the
+// heap usage otherwise.
+TEST(StartupProfileTest, CountsStaticTestRegistrationsOnlyWhenAsked) {
+  const StartupProfile& profile = *GetUnitTestImpl()->startup_profile();
+  if (testing::internal::BoolFromGTestEnv("startup_profile", false)) {
+    EXPECT_LT(100, profile.call_count(kStaticRegistrationStage));
+  } else {
+    EXPECT_EQ(0, profile.call_count(kStaticRegistrationStage));
+    EXPECT_EQ(0, profile.nanos(kStaticRegistrationStage));
+  }
+  EXPECT_EQ(1, profile.call_count(kTestFilteringStage));
+}
+
 // The InitGoogleTestTest test case tests testing::InitGoogleTest().
 
 // The Flags struct stores a copy of all Google Test flags.
@@ -5208,16 +6628,20 @@ struct Flags {
             break_on_failure(false),
             catch_exceptions(false),
             death_test_use_fork(false),
+            fail_on_leak_bytes(-1),
             filter(""),
             list_tests(false),
+            max_failures_per_test(0),
             output(""),
             print_time(true),
             random_seed(0),
             repeat(1),
             shuffle(false),
             stack_trace_depth(kMaxStackTraceDepth),
+            startup_profile(false),
             stream_result_to(""),
-            throw_on_failure(false) {}
+            throw_on_failure(false),
+            update_golden_files(false) {}
 
   // Factory methods.
 
@@ -5253,6 +6677,14 @@ struct Flags {
     return flags;
   }
 
+  // Creates a Flags struct where the gtest_fail_on_leak_bytes flag has
+  // the given value.
+  static Flags FailOnLeakBytes(Int32 fail_on_leak_bytes) {
+    Flags flags;
+    flags.fail_on_leak_bytes = fail_on_leak_bytes;
+    return flags;
+  }
+
   // Creates a Flags struct where the gtest_filter flag has the given
   // value.
   static Flags Filter(const char* filter) {
@@ -5269,6 +6701,14 @@ struct Flags {
     return flags;
   }
 
+  // Creates a Flags struct where the gtest_max_failures_per_test flag has
+  // the given value.
+  static Flags MaxFailuresPerTest(Int32 max_failures_per_test) {
+    Flags flags;
+    flags.max_failures_per_test = max_failures_per_test;
+    return flags;
+  }
+
   // Creates a Flags struct where the gtest_output flag has the given
   // value.
   static Flags Output(const char* output) {
@@ -5317,6 +6757,14 @@ struct Flags {
     return flags;
   }
 
+  // Creates a Flags struct where the gtest_startup_profile flag has the
+  // given value.
+  static Flags StartupProfile(bool startup_profile) {
+    Flags flags;
+    flags.startup_profile = startup_profile;
+    return flags;
+  }
+
   // Creates a Flags struct where the GTEST_FLAG(stream_result_to) flag has
   // the given value.
   static Flags StreamResultTo(const char* stream_result_to) {
@@ -5333,21 +6781,33 @@ struct Flags {
     return flags;
   }
 
+  // Creates a Flags struct where the gtest_update_golden_files flag has
+  // the given value.
+  static Flags UpdateGoldenFiles(bool update_golden_files) {
+    Flags flags;
+    flags.update_golden_files = update_golden_files;
+    return flags;
+  }
+
   // These fields store the flag values.
   bool also_run_disabled_tests;
   bool break_on_failure;
   bool catch_exceptions;
   bool death_test_use_fork;
+  Int32 fail_on_leak_bytes;
   const char* filter;
   bool list_tests;
+  Int32 max_failures_per_test;
   const char* output;
   bool print_time;
   Int32 random_seed;
   Int32 repeat;
   bool shuffle;
   Int32 stack_trace_depth;
+  bool startup_profile;
   const char* stream_result_to;
   bool throw_on_failure;
+  bool update_golden_files;
 };
 
 // Fixture for testing InitGoogleTest().
@@ -5359,16 +6819,20 @@ class InitGoogleTestTest : public Test {
     GTEST_FLAG(break_on_failure) = false;
     GTEST_FLAG(catch_exceptions) = false;
     GTEST_FLAG(death_test_use_fork) = false;
+    GTEST_FLAG(fail_on_leak_bytes) = -1;
     GTEST_FLAG(filter) = "";
     GTEST_FLAG(list_tests) = false;
+    GTEST_FLAG(max_failures_per_test) = 0;
     GTEST_FLAG(output) = "";
     GTEST_FLAG(print_time) = true;
     GTEST_FLAG(random_seed) = 0;
     GTEST_FLAG(repeat) = 1;
     GTEST_FLAG(shuffle) = false;
     GTEST_FLAG(stack_trace_depth) = kMaxStackTraceDepth;
+    GTEST_FLAG(startup_profile) = false;
     GTEST_FLAG(stream_result_to) = "";
     GTEST_FLAG(throw_on_failure) = false;
+    GTEST_FLAG(update_golden_files) = false;
   }
 
   // Asserts that two narrow or wide string arrays are equal.
@@ -5389,17 +6853,22 @@ class InitGoogleTestTest : public Test {
     EXPECT_EQ(expected.break_on_failure, GTEST_FLAG(break_on_failure));
     EXPECT_EQ(expected.catch_exceptions, GTEST_FLAG(catch_exceptions));
     EXPECT_EQ(expected.death_test_use_fork, GTEST_FLAG(death_test_use_fork));
+    EXPECT_EQ(expected.fail_on_leak_bytes, GTEST_FLAG(fail_on_leak_bytes));
     EXPECT_STREQ(expected.filter, GTEST_FLAG(filter).c_str());
     EXPECT_EQ(expected.list_tests, GTEST_FLAG(list_tests));
+    EXPECT_EQ(expected.max_failures_per_test,
+              GTEST_FLAG(max_failures_per_test));
     EXPECT_STREQ(expected.output, GTEST_FLAG(output).c_str());
     EXPECT_EQ(expected.print_time, GTEST_FLAG(print_time));
     EXPECT_EQ(expected.random_seed, GTEST_FLAG(random_seed));
     EXPECT_EQ(expected.repeat, GTEST_FLAG(repeat));
     EXPECT_EQ(expected.shuffle, GTEST_FLAG(shuffle));
     EXPECT_EQ(expected.stack_trace_depth, GTEST_FLAG(stack_trace_depth));
+    EXPECT_EQ(expected.startup_profile, GTEST_FLAG(startup_profile));
     EXPECT_STREQ(expected.stream_result_to,
                  GTEST_FLAG(stream_result_to).c_str());
     EXPECT_EQ(expected.throw_on_failure, GTEST_FLAG(throw_on_failure));
+    EXPECT_EQ(expected.update_golden_files, GTEST_FLAG(update_golden_files));
   }
 
   // Parses a command line (specified by argc1 and argv1), then
@@ -6045,6 +7514,54 @@ TEST_F(InitGoogleTestTest, ShuffleTrue) {
   GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::Shuffle(true), false);
 }
 
+// Tests parsing --gtest_max_failures_per_test=number.
+TEST_F(InitGoogleTestTest, MaxFailuresPerTest) {
+  const char* argv[] = {
+    "foo.exe",
+    "--gtest_max_failures_per_test=100",
+    NULL
+  };
+
+  const char* argv2[] = {
+    "foo.exe",
+    NULL
+  };
+
+  GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::MaxFailuresPerTest(100), false);
+}
+
+// Tests parsing --gtest_fail_on_leak_bytes=number.
+TEST_F(InitGoogleTestTest, FailOnLeakBytes) {
+  const char* argv[] = {
+    "foo.exe",
+    "--gtest_fail_on_leak_bytes=4096",
+    NULL
+  };
+
+  const char* argv2[] = {
+    "foo.exe",
+    NULL
+  };
+
+  GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::FailOnLeakBytes(4096), false);
+}
+
+// Tests parsing --gtest_startup_profile.
+TEST_F(InitGoogleTestTest, StartupProfile) {
+  const char* argv[] = {
+    "foo.exe",
+    "--gtest_startup_profile",
+    NULL
+  };
+
+  const char* argv2[] = {
+    "foo.exe",
+    NULL
+  };
+
+  GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::StartupProfile(true), false);
+}
+
 // Tests parsing --gtest_stack_trace_depth=number.
 TEST_F(InitGoogleTestTest, StackTraceDepth) {
   const char* argv[] = {
@@ -6126,6 +7643,22 @@ TEST_F(InitGoogleTestTest, ThrowOnFailureTrue) {
   GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::ThrowOnFailure(true), false);
 }
 
+// Tests parsing --gtest_update_golden_files.
+TEST_F(InitGoogleTestTest, UpdateGoldenFiles) {
+  const char* argv[] = {
+    "foo.exe",
+    "--gtest_update_golden_files",
+    NULL
+  };
+
+  const char* argv2[] = {
+    "foo.exe",
+    NULL
+  };
+
+  GTEST_TEST_PARSING_FLAGS_(argv, argv2, Flags::UpdateGoldenFiles(true), false);
+}
+
 #if GTEST_OS_WINDOWS
 // Tests parsing wide strings.
 TEST_F(InitGoogleTestTest, WideStrings) {
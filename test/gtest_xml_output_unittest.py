@@ -55,20 +55,20 @@ else:
   STACK_TRACE_TEMPLATE = ''
 
 EXPECTED_NON_EMPTY_XML = """<?xml version="1.0" encoding="UTF-8"?>
-<testsuites tests="23" failures="4" disabled="2" errors="0" time="*" name="AllTests">
-  <testsuite name="SuccessfulTest" tests="1" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="Succeeds" status="run" time="*" classname="SuccessfulTest"/>
+<testsuites tests="23" failures="4" disabled="2" errors="0" time="*" set_up_time="*" tear_down_time="*" name="AllTests">
+  <testsuite name="SuccessfulTest" tests="1" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="Succeeds" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="SuccessfulTest"/>
   </testsuite>
-  <testsuite name="FailedTest" tests="1" failures="1" disabled="0" errors="0" time="*">
-    <testcase name="Fails" status="run" time="*" classname="FailedTest">
+  <testsuite name="FailedTest" tests="1" failures="1" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="Fails" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="FailedTest">
       <failure message="Value of: 2&#x0A;Expected: 1" type=""><![CDATA[gtest_xml_output_unittest_.cc:*
 Value of: 2
 Expected: 1%(stack)s]]></failure>
     </testcase>
   </testsuite>
-  <testsuite name="MixedResultTest" tests="3" failures="1" disabled="1" errors="0" time="*">
-    <testcase name="Succeeds" status="run" time="*" classname="MixedResultTest"/>
-    <testcase name="Fails" status="run" time="*" classname="MixedResultTest">
+  <testsuite name="MixedResultTest" tests="3" failures="1" disabled="1" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="Succeeds" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="MixedResultTest"/>
+    <testcase name="Fails" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="MixedResultTest">
       <failure message="Value of: 2&#x0A;Expected: 1" type=""><![CDATA[gtest_xml_output_unittest_.cc:*
 Value of: 2
 Expected: 1%(stack)s]]></failure>
@@ -76,59 +76,59 @@ Expected: 1%(stack)s]]></failure>
 Value of: 3
 Expected: 2%(stack)s]]></failure>
     </testcase>
-    <testcase name="DISABLED_test" status="notrun" time="*" classname="MixedResultTest"/>
+    <testcase name="DISABLED_test" status="notrun" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="MixedResultTest"/>
   </testsuite>
-  <testsuite name="XmlQuotingTest" tests="1" failures="1" disabled="0" errors="0" time="*">
-    <testcase name="OutputsCData" status="run" time="*" classname="XmlQuotingTest">
+  <testsuite name="XmlQuotingTest" tests="1" failures="1" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="OutputsCData" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="XmlQuotingTest">
       <failure message="Failed&#x0A;XML output: &lt;?xml encoding=&quot;utf-8&quot;&gt;&lt;top&gt;&lt;![CDATA[cdata text]]&gt;&lt;/top&gt;" type=""><![CDATA[gtest_xml_output_unittest_.cc:*
 Failed
 XML output: <?xml encoding="utf-8"><top><![CDATA[cdata text]]>]]&gt;<![CDATA[</top>%(stack)s]]></failure>
     </testcase>
   </testsuite>
-  <testsuite name="InvalidCharactersTest" tests="1" failures="1" disabled="0" errors="0" time="*">
-    <testcase name="InvalidCharactersInMessage" status="run" time="*" classname="InvalidCharactersTest">
+  <testsuite name="InvalidCharactersTest" tests="1" failures="1" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="InvalidCharactersInMessage" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="InvalidCharactersTest">
       <failure message="Failed&#x0A;Invalid characters in brackets []" type=""><![CDATA[gtest_xml_output_unittest_.cc:*
 Failed
 Invalid characters in brackets []%(stack)s]]></failure>
     </testcase>
   </testsuite>
-  <testsuite name="DisabledTest" tests="1" failures="0" disabled="1" errors="0" time="*">
-    <testcase name="DISABLED_test_not_run" status="notrun" time="*" classname="DisabledTest"/>
+  <testsuite name="DisabledTest" tests="1" failures="0" disabled="1" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="DISABLED_test_not_run" status="notrun" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="DisabledTest"/>
   </testsuite>
-  <testsuite name="PropertyRecordingTest" tests="4" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="OneProperty" status="run" time="*" classname="PropertyRecordingTest" key_1="1"/>
-    <testcase name="IntValuedProperty" status="run" time="*" classname="PropertyRecordingTest" key_int="1"/>
-    <testcase name="ThreeProperties" status="run" time="*" classname="PropertyRecordingTest" key_1="1" key_2="2" key_3="3"/>
-    <testcase name="TwoValuesForOneKeyUsesLastValue" status="run" time="*" classname="PropertyRecordingTest" key_1="2"/>
+  <testsuite name="PropertyRecordingTest" tests="4" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="OneProperty" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="PropertyRecordingTest" key_1="1"/>
+    <testcase name="IntValuedProperty" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="PropertyRecordingTest" key_int="1"/>
+    <testcase name="ThreeProperties" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="PropertyRecordingTest" key_1="1" key_2="2" key_3="3"/>
+    <testcase name="TwoValuesForOneKeyUsesLastValue" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="PropertyRecordingTest" key_1="2"/>
   </testsuite>
-  <testsuite name="NoFixtureTest" tests="3" failures="0" disabled="0" errors="0" time="*">
-     <testcase name="RecordProperty" status="run" time="*" classname="NoFixtureTest" key="1"/>
-     <testcase name="ExternalUtilityThatCallsRecordIntValuedProperty" status="run" time="*" classname="NoFixtureTest" key_for_utility_int="1"/>
-     <testcase name="ExternalUtilityThatCallsRecordStringValuedProperty" status="run" time="*" classname="NoFixtureTest" key_for_utility_string="1"/>
+  <testsuite name="NoFixtureTest" tests="3" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+     <testcase name="RecordProperty" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="NoFixtureTest" key="1"/>
+     <testcase name="ExternalUtilityThatCallsRecordIntValuedProperty" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="NoFixtureTest" key_for_utility_int="1"/>
+     <testcase name="ExternalUtilityThatCallsRecordStringValuedProperty" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="NoFixtureTest" key_for_utility_string="1"/>
   </testsuite>
-  <testsuite name="Single/ValueParamTest" tests="4" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="HasValueParamAttribute/0" value_param="33" status="run" time="*" classname="Single/ValueParamTest" />
-    <testcase name="HasValueParamAttribute/1" value_param="42" status="run" time="*" classname="Single/ValueParamTest" />
-    <testcase name="AnotherTestThatHasValueParamAttribute/0" value_param="33" status="run" time="*" classname="Single/ValueParamTest" />
-    <testcase name="AnotherTestThatHasValueParamAttribute/1" value_param="42" status="run" time="*" classname="Single/ValueParamTest" />
+  <testsuite name="Single/ValueParamTest" tests="4" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="HasValueParamAttribute/0" value_param="33" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/ValueParamTest" />
+    <testcase name="HasValueParamAttribute/1" value_param="42" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/ValueParamTest" />
+    <testcase name="AnotherTestThatHasValueParamAttribute/0" value_param="33" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/ValueParamTest" />
+    <testcase name="AnotherTestThatHasValueParamAttribute/1" value_param="42" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/ValueParamTest" />
   </testsuite>
-  <testsuite name="TypedTest/0" tests="1" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" classname="TypedTest/0" />
+  <testsuite name="TypedTest/0" tests="1" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="TypedTest/0" />
   </testsuite>
-  <testsuite name="TypedTest/1" tests="1" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" classname="TypedTest/1" />
+  <testsuite name="TypedTest/1" tests="1" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="TypedTest/1" />
   </testsuite>
-  <testsuite name="Single/TypeParameterizedTestCase/0" tests="1" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" classname="Single/TypeParameterizedTestCase/0" />
+  <testsuite name="Single/TypeParameterizedTestCase/0" tests="1" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/TypeParameterizedTestCase/0" />
   </testsuite>
-  <testsuite name="Single/TypeParameterizedTestCase/1" tests="1" failures="0" disabled="0" errors="0" time="*">
-    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" classname="Single/TypeParameterizedTestCase/1" />
+  <testsuite name="Single/TypeParameterizedTestCase/1" tests="1" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*">
+    <testcase name="HasTypeParamAttribute" type_param="*" status="run" time="*" constructor_time="*" set_up_time="*" test_body_time="*" tear_down_time="*" destructor_time="*" classname="Single/TypeParameterizedTestCase/1" />
   </testsuite>
 </testsuites>""" % {'stack': STACK_TRACE_TEMPLATE}
 
 
 EXPECTED_EMPTY_XML = """<?xml version="1.0" encoding="UTF-8"?>
-<testsuites tests="0" failures="0" disabled="0" errors="0" time="*" name="AllTests">
+<testsuites tests="0" failures="0" disabled="0" errors="0" time="*" set_up_time="*" tear_down_time="*" name="AllTests">
 </testsuites>"""
 
 GTEST_PROGRAM_PATH = gtest_test_utils.GetTestExecutablePath(GTEST_PROGRAM_NAME)
@@ -149,8 +149,9 @@ class GTestXMLTestCase(gtest_test_utils.TestCase):
     information that may change from run to run.
 
     *  The "time" attribute of <testsuites>, <testsuite> and <testcase>
-       elements is replaced with a single asterisk, if it contains
-       only digit characters.
+       elements, and the phase timing attributes ending in "_time", are
+       replaced with a single asterisk, if they contain only digit
+       characters.
     *  The "type_param" attribute of <testcase> elements is replaced with a
        single asterisk (if it sn non-empty) as it is the type name returned
        by the compiler and is platform dependent.
@@ -161,8 +162,10 @@ class GTestXMLTestCase(gtest_test_utils.TestCase):
     """
 
     if element.tagName in ("testsuites", "testsuite", "testcase"):
-      time = element.getAttributeNode("time")
-      time.value = re.sub(r"^\d+(\.\d+)?$", "*", time.value)
+      for index in range(element.attributes.length):
+        attribute = element.attributes.item(index)
+        if attribute.name == "time" or attribute.name.endswith("_time"):
+          attribute.value = re.sub(r"^\d+(\.\d+)?$", "*", attribute.value)
       type_param = element.getAttributeNode("type_param")
       if type_param and type_param.value:
         type_param.value = "*"